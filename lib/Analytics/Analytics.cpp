@@ -0,0 +1,304 @@
+#include "Analytics.h"
+
+#include <Utils.h>
+#include <math.h>
+#include <stdio.h>
+
+void Welford::add(float x) {
+  m_count++;
+  float delta = x - m_mean;
+  m_mean += delta / m_count;
+  m_m2 += delta * (x - m_mean);
+}
+
+float Welford::variance() const {
+  return m_count > 1 ? m_m2 / (m_count - 1) : 0;
+}
+
+float Welford::stddev() const { return sqrtf(variance()); }
+
+float Ewma::add(float x) {
+  if (!m_ready) {
+    m_value = x;
+    m_ready = true;
+  } else {
+    m_value += m_alpha * (x - m_value);
+  }
+  return m_value;
+}
+
+void SlopeWindow::add(float x) {
+  if (m_count == 0) m_base = x;
+
+  if (full()) {
+    // indeks semua titik tersisa turun satu
+    m_sumX -= m_values[m_head] - m_base;
+    m_sumIX -= m_sumX;
+  } else {
+    m_count++;
+  }
+
+  m_values[m_head] = x;
+  m_sumX += x - m_base;
+  m_sumIX += (m_count - 1) * (x - m_base);
+  m_head = (m_head + 1) % ANALYTICS_WINDOW;
+
+  if (m_head == 0) recompute();
+}
+
+void SlopeWindow::recompute() {
+  // titik tertua berada di m_head saat ring penuh
+  uint8_t start = full() ? m_head : 0;
+  m_base = m_values[(start + m_count - 1) % ANALYTICS_WINDOW];
+  m_sumX = 0;
+  m_sumIX = 0;
+  for (uint8_t i = 0; i < m_count; i++) {
+    float v = m_values[(start + i) % ANALYTICS_WINDOW] - m_base;
+    m_sumX += v;
+    m_sumIX += i * v;
+  }
+}
+
+float SlopeWindow::slope() const {
+  if (m_count < 2) return 0;
+  // sum i dan sum i^2 untuk i = 0..n-1
+  float n = m_count;
+  float sumI = n * (n - 1) / 2;
+  float sumII = (n - 1) * n * (2 * n - 1) / 6;
+  float denom = n * sumII - sumI * sumI;
+  return (n * m_sumIX - sumI * m_sumX) / denom;
+}
+
+bool Hysteresis::update(float x) {
+  if (m_above) {
+    if (!m_active && x > m_enter) m_active = true;
+    if (m_active && x < m_exit) m_active = false;
+  } else {
+    if (!m_active && x < m_enter) m_active = true;
+    if (m_active && x > m_exit) m_active = false;
+  }
+  return m_active;
+}
+
+// constructor
+SensorChannel::SensorChannel(const ChannelConfig& config)
+    : m_cfg(config),
+      m_ewma(config.ewmaAlpha),
+      m_low(config.low, config.low + config.hysteresis, false),
+      m_high(config.high, config.high - config.hysteresis, true),
+      m_lowLimit(config.low),
+      m_highLimit(config.high),
+      m_hoursPerPoint(config.sampleMs * config.decimation / 3600000.0f),
+      m_last(NAN),
+      m_min(INFINITY),
+      m_max(-INFINITY),
+      m_slope(0),
+      m_rejected(0),
+      m_decimate(0),
+      m_outliers(0),
+      m_invalid(0),
+      m_alarms(0) {}
+
+void SensorChannel::setLimits(float low, float high) {
+  m_lowLimit = low;
+  m_highLimit = high;
+  m_low.setThreshold(low, low + m_cfg.hysteresis);
+  m_high.setThreshold(high, high - m_cfg.hysteresis);
+}
+
+void SensorChannel::setSampleInterval(uint32_t ms) {
+  float hoursPerPoint = ms * m_cfg.decimation / 3600000.0f;
+  if (hoursPerPoint == m_hoursPerPoint) return;
+  m_hoursPerPoint = hoursPerPoint;
+  m_window.reset();
+  m_decimate = 0;
+  m_slope = 0;
+}
+
+bool SensorChannel::isOutlier(float x) {
+  if (m_noise.count() < ANALYTICS_WARMUP) return false;
+
+  float sigma = m_noise.stddev();
+  if (sigma < m_cfg.minSigma) sigma = m_cfg.minSigma;
+  if (fabsf(x - m_ewma.value()) <= m_cfg.outlierSigma * sigma) {
+    m_outliers = 0;
+    return false;
+  }
+
+  // lonjakan sesaat dibuang, perubahan yang bertahan diterima
+  if (++m_outliers > ANALYTICS_MAX_OUTLIERS) {
+    m_outliers = 0;
+    return false;
+  }
+  return true;
+}
+
+uint8_t SensorChannel::add(float x) {
+  uint8_t alarms = m_alarms & ~ALARM_INVALID;
+
+  if (isnan(x) || x < m_cfg.validMin || x > m_cfg.validMax) {
+    m_rejected++;
+    if (++m_invalid > ANALYTICS_MAX_OUTLIERS) alarms |= ALARM_INVALID;
+    m_alarms = alarms;
+    return alarms;
+  }
+  m_invalid = 0;
+  if (isOutlier(x)) {
+    m_rejected++;
+    return m_alarms;
+  }
+
+  m_last = x;
+  if (x < m_min) m_min = x;
+  if (x > m_max) m_max = x;
+  m_stats.add(x);
+  if (m_ewma.ready()) m_noise.add(x - m_ewma.value());
+  float smooth = m_ewma.add(x);
+
+  if (++m_decimate >= m_cfg.decimation) {
+    m_decimate = 0;
+    m_window.add(smooth);
+    if (m_window.full()) m_slope = m_window.slope() / m_hoursPerPoint;
+  }
+
+  // batas dibandingkan dengan EWMA agar noise tidak memicu alarm
+  alarms &= ~(ALARM_LOW | ALARM_HIGH);
+  if (!isnan(m_lowLimit) && m_low.update(smooth)) alarms |= ALARM_LOW;
+  if (!isnan(m_highLimit) && m_high.update(smooth)) alarms |= ALARM_HIGH;
+  alarms = (alarms & ~(ALARM_TREND | ALARM_RATE)) | trendAlarms(alarms);
+
+  m_alarms = alarms;
+  return alarms;
+}
+
+uint8_t SensorChannel::trendAlarms(uint8_t limits) {
+  if (!m_window.full()) return 0;
+  uint8_t alarms = m_alarms & (ALARM_TREND | ALARM_RATE);
+
+  // tren selesai jika perkiraan batas mundur ke dua kali horizon, atau
+  // digantikan alarm batas setelah batas benar-benar terlewati
+  float hours = hoursToLimit();
+  if (hours >= 0 && hours < m_cfg.horizonHours) alarms |= ALARM_TREND;
+  if (hours < 0 || hours > 2 * m_cfg.horizonHours ||
+      (limits & (ALARM_LOW | ALARM_HIGH)))
+    alarms &= ~ALARM_TREND;
+
+  // laju selesai setelah turun ke separuh batas
+  float rise = m_cfg.maxRise > 0 ? m_slope / m_cfg.maxRise : 0;
+  float fall = m_cfg.maxFall > 0 ? -m_slope / m_cfg.maxFall : 0;
+  float rate = rise > fall ? rise : fall;
+  if (rate > 1) alarms |= ALARM_RATE;
+  if (rate < 0.5f) alarms &= ~ALARM_RATE;
+
+  return alarms;
+}
+
+float SensorChannel::hoursToLimit() const {
+  if (!m_window.full()) return -1;
+  float value = m_ewma.value();
+  if (m_slope < -m_cfg.minTrend && !isnan(m_lowLimit) && value > m_lowLimit)
+    return (value - m_lowLimit) / -m_slope;
+  if (m_slope > m_cfg.minTrend && !isnan(m_highLimit) && value < m_highLimit)
+    return (m_highLimit - value) / m_slope;
+  return -1;
+}
+
+ChannelSnapshot SensorChannel::snapshot() const {
+  ChannelSnapshot s;
+  s.last = m_last;
+  s.ewma = m_ewma.value();
+  s.mean = m_stats.mean();
+  s.stddev = m_stats.stddev();
+  s.min = m_min;
+  s.max = m_max;
+  s.slopePerHour = m_slope;
+  s.hoursToLimit = hoursToLimit();
+  s.samples = m_stats.count();
+  s.rejected = m_rejected;
+  s.alarms = m_alarms;
+  return s;
+}
+
+namespace Analytics {
+size_t formatAlarms(char* buf, size_t len, uint8_t alarms) {
+  static const char* const NAMES[] = {"rendah", "tinggi", "tren", "laju",
+                                      "sensor"};
+  if (len == 0) return 0;
+  buf[0] = '\0';
+  size_t pos = 0;
+  for (uint8_t i = 0; i < sizeof(NAMES) / sizeof(NAMES[0]); i++) {
+    if (!(alarms & (1 << i))) continue;
+    pos = append(buf, len, pos, "%s%s", pos ? "," : "", NAMES[i]);
+  }
+  if (pos == 0) pos = append(buf, len, pos, "-");
+  return pos;
+}
+
+size_t format(char* buf, size_t len, const char* name, const char* unit,
+              const SensorChannel& channel) {
+  if (len == 0) return 0;
+  ChannelSnapshot s = channel.snapshot();
+  char alarms[40];
+  formatAlarms(alarms, sizeof(alarms), s.alarms);
+
+  size_t pos = append(buf, len, 0,
+                      "%s: %.2f%s (ewma %.2f, tren %+.2f/jam)\n"
+                      "  rata2 %.2f sd %.2f, min %.2f maks %.2f\n",
+                      name, s.last, unit, s.ewma, s.slopePerHour, s.mean,
+                      s.stddev, s.min, s.max);
+  if (s.hoursToLimit >= 0)
+    pos = append(buf, len, pos, "  batas dalam %.1f jam\n", s.hoursToLimit);
+  pos = append(buf, len, pos, "  alarm %s, sampel %lu, dibuang %lu\n", alarms,
+               static_cast<unsigned long>(s.samples),
+               static_cast<unsigned long>(s.rejected));
+  return pos;
+}
+
+size_t formatAlerts(char* buf, size_t len, const char* name, const char* unit,
+                    const SensorChannel& channel, uint8_t alarms) {
+  if (len == 0) return 0;
+  buf[0] = '\0';
+  ChannelSnapshot s = channel.snapshot();
+  size_t pos = 0;
+
+  if (alarms & ALARM_LOW)
+    pos = append(buf, len, pos, "Peringatan: %s di bawah batas aman!: %.2f%s\n",
+                 name, s.ewma, unit);
+  if (alarms & ALARM_HIGH)
+    pos = append(buf, len, pos, "Peringatan: %s di atas batas aman!: %.2f%s\n",
+                 name, s.ewma, unit);
+  if (alarms & ALARM_TREND)
+    pos = append(buf, len, pos,
+                 "Peringatan: %s %s %.2f%s/jam, diperkirakan melewati batas "
+                 "aman dalam %.1f jam\n",
+                 name, s.slopePerHour < 0 ? "turun" : "naik",
+                 fabsf(s.slopePerHour), unit, s.hoursToLimit);
+  if (alarms & ALARM_RATE)
+    pos = append(buf, len, pos,
+                 "Peringatan: %s berubah terlalu cepat: %+.2f%s/jam\n", name,
+                 s.slopePerHour, unit);
+  if (alarms & ALARM_INVALID)
+    pos = append(buf, len, pos, "Peringatan: sensor %s tidak terbaca\n", name);
+  return pos;
+}
+
+size_t alertMessage(char* buf, size_t len, const char* name, const char* unit,
+                    const SensorChannel& channel, uint8_t alarms,
+                    AlertState& state, uint32_t now, uint32_t remindMs) {
+  if (len == 0) return 0;
+  buf[0] = '\0';
+  uint8_t raised = alarms & ~state.reported;
+  bool remind = alarms && now - state.lastSent >= remindMs;
+
+  size_t pos = 0;
+  if (raised || remind) {
+    pos = formatAlerts(buf, len, name, unit, channel, remind ? alarms : raised);
+    if (pos) state.lastSent = now;
+  } else if (!alarms && state.reported) {
+    pos = append(buf, len, 0, "Info: %s kembali normal: %.2f%s", name,
+                 channel.ewma(), unit);
+  }
+  state.reported = alarms;
+  return pos;
+}
+}  // namespace Analytics
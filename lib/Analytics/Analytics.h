@@ -0,0 +1,202 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Analitik sensor inkremental, O(1) per sampel tanpa alokasi: mean/variansi
+ * Welford, EWMA, slope regresi linear pada jendela geser, serta alarm batas,
+ * tren dan laju perubahan yang semuanya memakai histeresis supaya nilai yang
+ * berosilasi di sekitar batas tidak memicu peringatan berulang.
+ */
+
+// jumlah titik slope window, setiap titik adalah EWMA yang didesimasi
+#ifndef ANALYTICS_WINDOW
+#define ANALYTICS_WINDOW 30
+#endif
+
+// sampel awal yang belum dipakai untuk deteksi outlier dan alarm tren
+#define ANALYTICS_WARMUP 10
+// outlier berturut-turut sebanyak ini dianggap perubahan nyata
+#define ANALYTICS_MAX_OUTLIERS 3
+
+// mean dan variansi berjalan (Welford), stabil secara numerik
+class Welford {
+ private:
+  uint32_t m_count;
+  float m_mean;
+  float m_m2;
+
+ public:
+  Welford() : m_count(0), m_mean(0), m_m2(0) {}  // constructor
+  void add(float x);
+  void reset() { *this = Welford(); }
+  uint32_t count() const { return m_count; }
+  float mean() const { return m_mean; }
+  float variance() const;
+  float stddev() const;
+};
+
+class Ewma {
+ private:
+  float m_alpha;
+  float m_value;
+  bool m_ready;
+
+ public:
+  // constructor
+  explicit Ewma(float alpha) : m_alpha(alpha), m_value(0), m_ready(false) {}
+  float add(float x);
+  float value() const { return m_value; }
+  bool ready() const { return m_ready; }
+};
+
+// slope regresi linear pada ANALYTICS_WINDOW titik berjarak sama. Jumlah
+// berjalan digeser per titik, dihitung ulang penuh setiap satu putaran ring
+// agar galat float tidak menumpuk
+class SlopeWindow {
+ private:
+  float m_values[ANALYTICS_WINDOW];
+  uint8_t m_head;
+  uint8_t m_count;
+  float m_base;  // offset agar jumlah tetap kecil
+  float m_sumX;
+  float m_sumIX;
+
+ public:
+  SlopeWindow() : m_head(0), m_count(0), m_base(0), m_sumX(0), m_sumIX(0) {}
+  void add(float x);
+  void reset() { m_head = m_count = 0; }
+  uint8_t count() const { return m_count; }
+  bool full() const { return m_count == ANALYTICS_WINDOW; }
+  // perubahan per titik
+  float slope() const;
+
+ private:
+  void recompute();
+};
+
+// alarm dengan histeresis: aktif saat nilai melewati enter, baru selesai
+// setelah kembali melewati exit
+class Hysteresis {
+ private:
+  float m_enter;
+  float m_exit;
+  bool m_above;  // true: alarm saat nilai > enter
+  bool m_active;
+
+ public:
+  // constructor
+  Hysteresis(float enter, float exit, bool above)
+      : m_enter(enter), m_exit(exit), m_above(above), m_active(false) {}
+  bool update(float x);
+  void setThreshold(float enter, float exit) {
+    m_enter = enter;
+    m_exit = exit;
+  }
+  bool active() const { return m_active; }
+  void clear() { m_active = false; }
+};
+
+enum AnalyticsAlarm : uint8_t {
+  ALARM_LOW = 1 << 0,      // di bawah batas bawah
+  ALARM_HIGH = 1 << 1,     // di atas batas atas
+  ALARM_TREND = 1 << 2,    // diperkirakan melewati batas dalam horizon
+  ALARM_RATE = 1 << 3,     // laju perubahan melebihi batas
+  ALARM_INVALID = 1 << 4,  // sampel di luar rentang sensor
+};
+
+struct ChannelConfig {
+  float validMin;  // sampel di luar rentang ini dibuang (misal -127 DS18B20)
+  float validMax;
+  float low;  // batas aman awal, NAN untuk menonaktifkan
+  float high;
+  float hysteresis;  // jarak exit dari batas
+  float ewmaAlpha;
+  uint32_t sampleMs;   // interval sampling awal
+  uint8_t decimation;  // sampel per titik slope window
+  float horizonHours;  // alarm tren jika batas tercapai dalam waktu ini
+  float minTrend;      // slope minimum (per jam) untuk alarm tren
+  float maxRise;       // laju naik maksimum per jam, 0 = nonaktif
+  float maxFall;       // laju turun maksimum per jam, 0 = nonaktif
+  float outlierSigma;  // sampel dengan |x - ewma| > sigma * stddev dibuang
+  float minSigma;      // batas bawah stddev noise, resolusi sensor
+};
+
+struct ChannelSnapshot {
+  float last;
+  float ewma;
+  float mean;  // sejak boot
+  float stddev;
+  float min;
+  float max;
+  float slopePerHour;
+  float hoursToLimit;  // perkiraan waktu sampai batas, negatif jika tidak ada
+  uint32_t samples;
+  uint32_t rejected;
+  uint8_t alarms;
+};
+
+class SensorChannel {
+ private:
+  const ChannelConfig& m_cfg;
+  Welford m_stats;  // nilai mentah sejak boot
+  Welford m_noise;  // residual terhadap EWMA untuk deteksi outlier
+  Ewma m_ewma;
+  SlopeWindow m_window;
+  Hysteresis m_low;
+  Hysteresis m_high;
+  float m_lowLimit;
+  float m_highLimit;
+  float m_hoursPerPoint;
+  float m_last;
+  float m_min;
+  float m_max;
+  float m_slope;  // per jam
+  uint32_t m_rejected;
+  uint8_t m_decimate;
+  uint8_t m_outliers;
+  uint8_t m_invalid;
+  volatile uint8_t m_alarms;
+
+ public:
+  explicit SensorChannel(const ChannelConfig& config);  // constructor
+
+  // return alarm yang aktif setelah sampel ini
+  uint8_t add(float x);
+  uint8_t alarms() const { return m_alarms; }
+  // batas dan interval bisa diubah saat berjalan (lib/Config)
+  void setLimits(float low, float high);
+  // slope window dikosongkan karena jarak antar titik berubah
+  void setSampleInterval(uint32_t ms);
+  float ewma() const { return m_ewma.value(); }
+  float slopePerHour() const { return m_slope; }
+  float hoursToLimit() const;
+  ChannelSnapshot snapshot() const;
+
+ private:
+  bool isOutlier(float x);
+  uint8_t trendAlarms(uint8_t limits);
+};
+
+// alarm yang sudah dilaporkan ke pengguna, lihat Analytics::alertMessage
+struct AlertState {
+  uint8_t reported;
+  uint32_t lastSent;
+};
+
+namespace Analytics {
+// ringkasan satu baris per channel untuk /status_sensor
+size_t format(char* buf, size_t len, const char* name, const char* unit,
+              const SensorChannel& channel);
+// nama alarm dipisah koma, misal "rendah,tren"
+size_t formatAlarms(char* buf, size_t len, uint8_t alarms);
+// pesan peringatan, satu baris per alarm pada bitmask alarms
+size_t formatAlerts(char* buf, size_t len, const char* name, const char* unit,
+                    const SensorChannel& channel, uint8_t alarms);
+// pesan saat alarm baru aktif, pengingat setiap remindMs selama masih aktif,
+// dan sekali saat kembali normal. 0 jika tidak ada yang perlu dikirim
+size_t alertMessage(char* buf, size_t len, const char* name, const char* unit,
+                    const SensorChannel& channel, uint8_t alarms,
+                    AlertState& state, uint32_t now, uint32_t remindMs);
+}  // namespace Analytics
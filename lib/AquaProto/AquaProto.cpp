@@ -0,0 +1,265 @@
+#include "AquaProto.h"
+
+#include <Utils.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+namespace {
+// "key":nilai diikuti suffix, sensor terputus atau tidak terpasang (NaN)
+// menjadi null agar JSON tetap valid
+size_t appendNumber(char* buf, size_t len, size_t pos, const char* key,
+                    float value, const char* suffix = ",") {
+  if (!isfinite(value))
+    return append(buf, len, pos, "\"%s\":null%s", key, suffix);
+  return append(buf, len, pos, "\"%s\":%.2f%s", key, value, suffix);
+}
+
+const char* const TOPIC_NAMES[] = {
+    "command",        "config",         "sensor", "control",
+    "config/state",   "stats",          "mem",    "trace",
+    "fanout",         "meta",           "shadow/desired",
+    "shadow/reported",
+};
+static_assert(sizeof(TOPIC_NAMES) / sizeof(TOPIC_NAMES[0]) ==
+                  static_cast<size_t>(AquaTopic::COUNT),
+              "TOPIC_NAMES harus sesuai dengan AquaTopic");
+
+AquaDevice parseDevice(const char* name) {
+  if (strcmp(name, "led") == 0) return AquaDevice::LED;
+  if (strcmp(name, "pump") == 0) return AquaDevice::PUMP;
+  return AquaDevice::UNKNOWN;
+}
+
+// "on"/"off" pada key, nilai lain tidak mengubah bit
+void parseRelay(JsonVariantConst tank, const char* key, uint8_t bit,
+                uint8_t& mask) {
+  const char* state = tank[key];
+  if (!state) return;
+  if (strcmp(state, "on") == 0)
+    mask |= bit;
+  else if (strcmp(state, "off") == 0)
+    mask &= ~bit;
+}
+
+size_t appendTanks(char* buf, size_t len, size_t pos, uint8_t led,
+                   uint8_t pump, uint8_t count) {
+  pos = append(buf, len, pos, "\"tanks\":[");
+  for (uint8_t i = 0; i < count; i++) {
+    pos = append(buf, len, pos, "%s{\"led\":\"%s\",\"pump\":\"%s\"}",
+                 i ? "," : "", led & (1 << i) ? "on" : "off",
+                 pump & (1 << i) ? "on" : "off");
+  }
+  return append(buf, len, pos, "]");
+}
+}  // namespace
+
+bool AquaProto::parseCommand(const JsonDocument& doc, AquaCommand& cmd) {
+  cmd.type = AquaCommandType::UNKNOWN;
+  cmd.device = AquaDevice::UNKNOWN;
+  cmd.on = false;
+  cmd.id = doc["id"] | 0;
+  cmd.version = doc["version"] | 0;
+  // nomor tank tidak valid menjadi indeks 0xFF, ditolak oleh firmware
+  int tank = doc["tank"] | 1;
+  cmd.tank = tank >= 1 && tank <= 0xFF ? tank - 1 : 0xFF;
+
+  const char* type = doc["type"];
+  if (!type) return false;
+
+  if (strcmp(type, "heartbeat") == 0) {
+    cmd.type = AquaCommandType::HEARTBEAT;
+    return true;
+  }
+  if (strcmp(type, "control") != 0) return true;
+
+  cmd.type = AquaCommandType::CONTROL;
+  const char* device = doc["device"];
+  const char* state = doc["state"];
+  if (!device || !state) return false;
+
+  cmd.device = parseDevice(device);
+  cmd.on = strcmp(state, "on") == 0;
+  return true;
+}
+
+size_t AquaProto::encodeSensor(char* buf, size_t len, const float* temp,
+                               const float* level, uint8_t count,
+                               uint32_t timestamp) {
+  if (len == 0) return 0;
+  size_t pos = append(buf, len, 0, "{\"type\":\"sensor\",\"tanks\":[");
+  for (uint8_t i = 0; i < count; i++) {
+    pos = append(buf, len, pos, "%s{", i ? "," : "");
+    pos = appendNumber(buf, len, pos, "temp", temp[i]);
+    pos = appendNumber(buf, len, pos, "level", level[i], "}");
+  }
+  return append(buf, len, pos, "],\"timestamp\":%lu}",
+                static_cast<unsigned long>(timestamp));
+}
+
+size_t AquaProto::encodeControlStatus(char* buf, size_t len, uint8_t led,
+                                      uint8_t pump, uint8_t count,
+                                      const CommandTiming* timing,
+                                      uint32_t publishUs) {
+  if (len == 0) return 0;
+
+  size_t pos = append(buf, len, 0, "{\"type\":\"control_status\",");
+  pos = appendTanks(buf, len, pos, led, pump, count);
+  if (!timing || timing->id == 0) return append(buf, len, pos, "}");
+
+  // "lat": us sejak pesan diterima sampai parse, relay, dan publish
+  uint32_t start = timing->receivedUs;
+  return append(buf, len, pos,
+                ",\"id\":%lu,\"lat\":{\"parse\":%lu,\"act\":%lu,"
+                "\"pub\":%lu}}",
+                static_cast<unsigned long>(timing->id),
+                static_cast<unsigned long>(timing->parsedUs - start),
+                static_cast<unsigned long>(timing->actuatedUs - start),
+                static_cast<unsigned long>(publishUs - start));
+}
+
+size_t AquaProto::encodeDashboard(char* buf, size_t len, const char* type,
+                                  const float* temp, const float* level,
+                                  uint8_t led, uint8_t pump, uint8_t count,
+                                  uint32_t timestamp) {
+  if (len == 0 || count == 0) return 0;
+
+  size_t pos = append(buf, len, 0, "{\"type\":\"%s\",\"data\":{", type);
+  if (temp) {
+    pos = appendNumber(buf, len, pos, "temp", temp[0]);
+    pos = appendNumber(buf, len, pos, "level", level[0]);
+  }
+  pos = append(buf, len, pos, "\"led\":\"%s\",\"pump\":\"%s\",",
+               led & 1 ? "on" : "off", pump & 1 ? "on" : "off");
+  if (temp)
+    pos = append(buf, len, pos, "\"timestamp\":%lu,",
+                 static_cast<unsigned long>(timestamp));
+
+  pos = append(buf, len, pos, "\"tanks\":[");
+  for (uint8_t i = 0; i < count; i++) {
+    pos = append(buf, len, pos, "%s{", i ? "," : "");
+    if (temp) {
+      pos = appendNumber(buf, len, pos, "temp", temp[i]);
+      pos = appendNumber(buf, len, pos, "level", level[i]);
+    }
+    pos = append(buf, len, pos, "\"led\":\"%s\",\"pump\":\"%s\"}",
+                 led & (1 << i) ? "on" : "off", pump & (1 << i) ? "on" : "off");
+  }
+  return append(buf, len, pos, "]}}");
+}
+
+size_t AquaProto::encodeShadow(char* buf, size_t len, uint32_t version,
+                               uint8_t led, uint8_t pump, uint8_t count) {
+  if (len == 0) return 0;
+  size_t pos = append(buf, len, 0, "{\"type\":\"shadow\",\"version\":%lu,",
+                      static_cast<unsigned long>(version));
+  pos = appendTanks(buf, len, pos, led, pump, count);
+  return append(buf, len, pos, "}");
+}
+
+bool AquaProto::parseShadow(const JsonDocument& doc, uint32_t& version,
+                            uint8_t& led, uint8_t& pump, uint8_t count) {
+  const char* type = doc["type"];
+  if (!type || strcmp(type, "shadow") != 0) return false;
+  version = doc["version"] | 0;
+  if (version == 0) return false;
+
+  uint8_t i = 0;
+  for (JsonVariantConst tank : doc["tanks"].as<JsonArrayConst>()) {
+    if (i >= count) break;
+    parseRelay(tank, "led", 1 << i, led);
+    parseRelay(tank, "pump", 1 << i, pump);
+    i++;
+  }
+  return true;
+}
+
+size_t AquaProto::encodeMeta(char* buf, size_t len, const char* device,
+                             bool online, uint8_t count, bool control,
+                             const char* ip) {
+  if (len == 0) return 0;
+  size_t pos = append(buf, len, 0, "{\"type\":\"meta\",\"id\":\"%s\",", device);
+  if (!online) return append(buf, len, pos, "\"online\":false}");
+
+  pos = append(buf, len, pos, "\"online\":true,\"tanks\":%u,\"control\":%s",
+               count, control ? "true" : "false");
+  if (ip) pos = append(buf, len, pos, ",\"ip\":\"%s\"", ip);
+  return append(buf, len, pos, "}");
+}
+
+size_t AquaProto::topic(char* buf, size_t len, const char* device,
+                        AquaTopic leaf) {
+  if (leaf >= AquaTopic::COUNT) return 0;
+  int written = snprintf(buf, len, AQUA_TOPIC_ROOT "/%s/%s", device,
+                         TOPIC_NAMES[static_cast<uint8_t>(leaf)]);
+  return written > 0 && static_cast<size_t>(written) < len ? written : 0;
+}
+
+bool AquaProto::parseTopic(const char* topic, char* device, size_t deviceLen,
+                           AquaTopic& leaf) {
+  const size_t rootLen = sizeof(AQUA_TOPIC_ROOT) - 1;
+  if (strncmp(topic, AQUA_TOPIC_ROOT "/", rootLen + 1) != 0) return false;
+
+  const char* id = topic + rootLen + 1;
+  const char* slash = strchr(id, '/');
+  if (!slash || slash == id) return false;
+  size_t idLen = slash - id;
+  if (idLen >= deviceLen) return false;
+
+  for (uint8_t i = 0; i < static_cast<uint8_t>(AquaTopic::COUNT); i++) {
+    if (strcmp(slash + 1, TOPIC_NAMES[i]) != 0) continue;
+    memcpy(device, id, idLen);
+    device[idLen] = '\0';
+    leaf = static_cast<AquaTopic>(i);
+    return true;
+  }
+  return false;
+}
+
+bool AquaProto::topicMatches(const char* filter, const char* topic) {
+  while (*filter) {
+    if (filter[0] == '#') return true;  // termasuk level induknya
+
+    if (filter[0] == '+') {
+      while (*topic && *topic != '/') topic++;
+      filter++;
+    } else {
+      while (*filter && *filter != '/' && *filter == *topic) {
+        filter++;
+        topic++;
+      }
+      if (*filter && *filter != '/') return false;
+      if (*topic && *topic != '/') return false;
+    }
+
+    if (!*filter) return !*topic;
+    // filter dan topik sama-sama di '/'
+    if (*topic != '/') return filter[1] == '#' && !*topic;
+    filter++;
+    topic++;
+  }
+  return !*topic;
+}
+
+bool AquaProto::validDeviceId(const char* device) {
+  size_t len = strlen(device);
+  if (len == 0 || len >= AQUA_DEVICE_ID_SIZE) return false;
+  if (strcmp(device, AQUA_BROADCAST_ID) == 0) return false;
+  return strpbrk(device, "/+#") == nullptr;
+}
+
+const char* AquaProto::deviceName(AquaDevice device) {
+  switch (device) {
+    case AquaDevice::LED:
+      return "led";
+    case AquaDevice::PUMP:
+      return "pump";
+    default:
+      return "?";
+  }
+}
+
+const char* AquaProto::topicName(AquaTopic leaf) {
+  return leaf < AquaTopic::COUNT ? TOPIC_NAMES[static_cast<uint8_t>(leaf)]
+                                 : "?";
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <ArduinoJson.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Skema JSON MQTT Smart Aquarium (lihat header main_mqtt.cpp). Tidak
+ * bergantung pada Arduino agar bisa dipakai ulang di simulator host.
+ *
+ * Perintah kontrol boleh membawa "id" (correlation ID dari bridge). Status
+ * kontrol yang dipublikasikan sebagai jawabannya membawa id yang sama dan
+ * timestamp per tahap di device, dalam us relatif terhadap pesan diterima.
+ *
+ * Nomor tank di JSON dimulai dari 1, di struct dimulai dari 0. Data sensor
+ * dan status kontrol berisi array "tanks" dengan urutan yang sama.
+ *
+ * Setiap perangkat memakai topik sendiri "aquarium/<id>/<leaf>", id berasal
+ * dari chip ID sehingga perintah untuk satu perangkat tidak dikirim broker
+ * ke perangkat lain. "aquarium/all/command" dipakai untuk perintah ke semua
+ * perangkat, dashboard berlangganan dengan wildcard "aquarium/+/sensor".
+ *
+ * Shadow relay memakai payload yang sama untuk desired dan reported:
+ *   {"type":"shadow","version":7,"tanks":[{"led":"on","pump":"off"},...]}
+ * Versi naik setiap kali desired berubah; perangkat hanya menerapkan desired
+ * yang versinya lebih baru dari miliknya (lihat lib/Shadow).
+ */
+
+#define AQUA_TOPIC_ROOT "aquarium"
+#define AQUA_BROADCAST_ID "all"
+#define AQUA_DEVICE_ID_SIZE 24
+#define AQUA_TOPIC_SIZE 56  // root + id + "/shadow/reported"
+
+enum class AquaCommandType : uint8_t {
+  UNKNOWN,
+  HEARTBEAT,
+  CONTROL,
+};
+
+enum class AquaDevice : uint8_t {
+  UNKNOWN,
+  LED,
+  PUMP,
+};
+
+struct AquaCommand {
+  AquaCommandType type;
+  AquaDevice device;
+  bool on;
+  uint8_t tank;  // indeks, "tank" opsional dengan default 1
+  uint32_t id;  // 0 jika perintah tidak membawa correlation ID
+  // versi shadow opsional, 0 berarti perubahan baru tanpa syarat
+  uint32_t version;
+};
+
+enum class AquaTopic : uint8_t {
+  COMMAND,
+  CONFIG,
+  SENSOR,
+  CONTROL,
+  CONFIG_STATE,
+  STATS,
+  MEM,
+  TRACE,
+  FANOUT,
+  META,  // retained, birth saat connect dan last will saat putus
+  SHADOW_DESIRED,   // retained, state relay yang diinginkan
+  SHADOW_REPORTED,  // retained, state relay yang terpasang
+  COUNT,
+};
+
+// waktu absolut micros(), diisi oleh firmware di tiap tahap
+struct CommandTiming {
+  uint32_t id;
+  uint32_t receivedUs;
+  uint32_t parsedUs;
+  uint32_t actuatedUs;
+};
+
+namespace AquaProto {
+// false jika field wajib tidak ada, cmd.type tetap diisi untuk log
+bool parseCommand(const JsonDocument& doc, AquaCommand& cmd);
+
+size_t encodeSensor(char* buf, size_t len, const float* temp,
+                    const float* level, uint8_t count, uint32_t timestamp);
+// led dan pump berupa bitmask per tank. timing boleh nullptr untuk status
+// tanpa perintah (misal saat connect)
+size_t encodeControlStatus(char* buf, size_t len, uint8_t led, uint8_t pump,
+                           uint8_t count, const CommandTiming* timing,
+                           uint32_t publishUs);
+// frame dashboard web {"type":"update","data":{...}}, bentuk sama dengan
+// bridge web/mqtt/server.js. Field tunggal berisi tank 1, "tanks" berisi
+// semua tank. temp dan level nullptr untuk frame status kontrol saja
+size_t encodeDashboard(char* buf, size_t len, const char* type,
+                       const float* temp, const float* level, uint8_t led,
+                       uint8_t pump, uint8_t count, uint32_t timestamp);
+
+// shadow desired atau reported, led dan pump berupa bitmask per tank
+size_t encodeShadow(char* buf, size_t len, uint32_t version, uint8_t led,
+                    uint8_t pump, uint8_t count);
+// led dan pump diisi state sekarang oleh pemanggil, tank yang tidak ada di
+// payload tidak berubah. false jika bukan shadow atau tanpa versi
+bool parseShadow(const JsonDocument& doc, uint32_t& version, uint8_t& led,
+                 uint8_t& pump, uint8_t count);
+
+// birth/last will di aquarium/<id>/meta. ip boleh nullptr, will hanya
+// berisi id dan "online":false
+size_t encodeMeta(char* buf, size_t len, const char* device, bool online,
+                  uint8_t count, bool control, const char* ip);
+
+// "aquarium/<device>/<leaf>", 0 jika buf terlalu kecil
+size_t topic(char* buf, size_t len, const char* device, AquaTopic leaf);
+// kebalikan topic(), false jika bukan topik perangkat yang dikenal
+bool parseTopic(const char* topic, char* device, size_t deviceLen,
+                AquaTopic& leaf);
+// filter langganan MQTT dengan wildcard "+" (satu level) dan "#" (sisa)
+bool topicMatches(const char* filter, const char* topic);
+// id tidak boleh kosong, "all", atau berisi karakter khusus MQTT
+bool validDeviceId(const char* device);
+
+const char* deviceName(AquaDevice device);
+const char* topicName(AquaTopic leaf);
+}  // namespace AquaProto
@@ -0,0 +1,312 @@
+#include "Config.h"
+
+#include <Arduino.h>
+#include <Log.h>
+#include <Utils.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined(ESP32)
+#include <Preferences.h>
+#elif defined(ESP8266)
+#include <EEPROM.h>
+#endif
+
+#define CONFIG_MAGIC 0x41514346  // "AQCF"
+// naikkan jika layout AquaConfig berubah, konfigurasi lama diganti default
+#define CONFIG_VERSION 1
+
+const AquaConfig Config::DEFAULTS = {
+    28,     // tempMin
+    34,     // tempMax
+    80,     // levelMin
+    2000,   // messageUpdateMs
+    3000,   // sensorUpdateMs
+    5000,   // sensorReportMs
+    60000,  // publishMs
+};
+
+namespace {
+struct StoredConfig {
+  uint32_t magic;
+  uint32_t version;
+  AquaConfig config;
+  uint32_t crc;
+};
+
+struct FieldInfo {
+  const char* key;
+  bool isFloat;
+  size_t offset;
+  float min;
+  float max;
+};
+
+const FieldInfo FIELDS[] = {
+    {"suhu_min", true, offsetof(AquaConfig, tempMin), 0, 40},
+    {"suhu_max", true, offsetof(AquaConfig, tempMax), 0, 40},
+    {"air_min", true, offsetof(AquaConfig, levelMin), 0, 100},
+    {"pesan_ms", false, offsetof(AquaConfig, messageUpdateMs), 500, 600000},
+    {"sensor_ms", false, offsetof(AquaConfig, sensorUpdateMs), 1000, 600000},
+    {"lapor_ms", false, offsetof(AquaConfig, sensorReportMs), 1000, 3600000},
+    {"publish_ms", false, offsetof(AquaConfig, publishMs), 1000, 3600000},
+};
+static_assert(sizeof(FIELDS) / sizeof(FIELDS[0]) ==
+                  static_cast<size_t>(ConfigField::COUNT),
+              "FIELDS harus mencakup semua ConfigField");
+
+struct Listener {
+  ConfigListener callback;
+  bool deferred;
+  uint32_t pending;  // configBit() yang belum dikirim dispatch()
+};
+
+AquaConfig current = Config::DEFAULTS;
+Listener listeners[CONFIG_MAX_LISTENERS];
+uint8_t listenerCount = 0;
+#ifdef ESP32
+// get() dipanggil dari semua task, commit dari task perintah
+portMUX_TYPE mux = portMUX_INITIALIZER_UNLOCKED;
+#endif
+
+void lock() {
+#ifdef ESP32
+  portENTER_CRITICAL(&mux);
+#endif
+}
+
+void unlock() {
+#ifdef ESP32
+  portEXIT_CRITICAL(&mux);
+#endif
+}
+
+uint32_t storedCrc(const StoredConfig& s) {
+  return crc32(reinterpret_cast<const uint8_t*>(&s),
+               offsetof(StoredConfig, crc));
+}
+
+float fieldValue(const AquaConfig& config, const FieldInfo& field) {
+  const uint8_t* base = reinterpret_cast<const uint8_t*>(&config);
+  if (field.isFloat)
+    return *reinterpret_cast<const float*>(base + field.offset);
+  return *reinterpret_cast<const uint32_t*>(base + field.offset);
+}
+
+bool load(AquaConfig& config) {
+  StoredConfig stored;
+#if defined(ESP32)
+  Preferences prefs;
+  if (!prefs.begin("config", true)) return false;
+  size_t len = prefs.getBytes("aqua", &stored, sizeof(stored));
+  prefs.end();
+  if (len != sizeof(stored)) return false;
+#elif defined(ESP8266)
+  EEPROM.begin(sizeof(StoredConfig));
+  EEPROM.get(0, stored);
+  EEPROM.end();
+#else
+  return false;
+#endif
+  if (stored.magic != CONFIG_MAGIC || stored.version != CONFIG_VERSION ||
+      stored.crc != storedCrc(stored))
+    return false;
+  config = stored.config;
+  return true;
+}
+
+bool store(const AquaConfig& config) {
+  StoredConfig stored;
+  memset(&stored, 0, sizeof(stored));
+  stored.magic = CONFIG_MAGIC;
+  stored.version = CONFIG_VERSION;
+  stored.config = config;
+  stored.crc = storedCrc(stored);
+#if defined(ESP32)
+  Preferences prefs;
+  if (!prefs.begin("config", false)) return false;
+  size_t len = prefs.putBytes("aqua", &stored, sizeof(stored));
+  prefs.end();
+  return len == sizeof(stored);
+#elif defined(ESP8266)
+  EEPROM.begin(sizeof(StoredConfig));
+  EEPROM.put(0, stored);
+  return EEPROM.end();
+#else
+  // build simulator: hanya di RAM
+  return true;
+#endif
+}
+
+ConfigError validate(const AquaConfig& config) {
+  for (const FieldInfo& field : FIELDS) {
+    float value = fieldValue(config, field);
+    // NaN lolos dari perbandingan rentang dan mematikan alarm SensorChannel
+    if (!isfinite(value)) return ConfigError::INVALID_VALUE;
+    if (value < field.min || value > field.max)
+      return ConfigError::OUT_OF_RANGE;
+  }
+  if (config.tempMin >= config.tempMax) return ConfigError::INCONSISTENT;
+  return ConfigError::NONE;
+}
+
+uint32_t diff(const AquaConfig& a, const AquaConfig& b) {
+  uint32_t changed = 0;
+  for (uint8_t i = 0; i < static_cast<uint8_t>(ConfigField::COUNT); i++) {
+    if (fieldValue(a, FIELDS[i]) != fieldValue(b, FIELDS[i]))
+      changed |= configBit(static_cast<ConfigField>(i));
+  }
+  return changed;
+}
+
+void apply(const AquaConfig& config, uint32_t changed) {
+  lock();
+  current = config;
+  for (uint8_t i = 0; i < listenerCount; i++) {
+    if (listeners[i].deferred) listeners[i].pending |= changed;
+  }
+  unlock();
+
+  for (uint8_t i = 0; i < listenerCount; i++) {
+    if (!listeners[i].deferred) listeners[i].callback(config, changed);
+  }
+}
+}  // namespace
+
+void Config::begin() {
+  AquaConfig config;
+  if (load(config) && validate(config) == ConfigError::NONE) {
+    LOG_I("config: dimuat dari storage");
+  } else {
+    config = DEFAULTS;
+    LOG_I("config: memakai default");
+  }
+  lock();
+  current = config;
+  unlock();
+}
+
+AquaConfig Config::get() {
+  lock();
+  AquaConfig config = current;
+  unlock();
+  return config;
+}
+
+ConfigError Config::set(AquaConfig& draft, const char* key,
+                        const char* value) {
+  if (key == nullptr || value == nullptr || value[0] == '\0')
+    return ConfigError::INVALID_VALUE;
+
+  for (const FieldInfo& field : FIELDS) {
+    if (strcmp(field.key, key) != 0) continue;
+
+    char* end = nullptr;
+    uint8_t* target = reinterpret_cast<uint8_t*>(&draft) + field.offset;
+    if (field.isFloat) {
+      float parsed = strtof(value, &end);
+      if (*end != '\0' || !isfinite(parsed)) return ConfigError::INVALID_VALUE;
+      if (parsed < field.min || parsed > field.max)
+        return ConfigError::OUT_OF_RANGE;
+      *reinterpret_cast<float*>(target) = parsed;
+    } else {
+      if (value[0] == '-') return ConfigError::INVALID_VALUE;
+      unsigned long parsed = strtoul(value, &end, 10);
+      if (*end != '\0') return ConfigError::INVALID_VALUE;
+      if (parsed < field.min || parsed > field.max)
+        return ConfigError::OUT_OF_RANGE;
+      *reinterpret_cast<uint32_t*>(target) = parsed;
+    }
+    return ConfigError::NONE;
+  }
+  return ConfigError::UNKNOWN_KEY;
+}
+
+ConfigError Config::commit(const AquaConfig& draft) {
+  ConfigError error = validate(draft);
+  if (error != ConfigError::NONE) return error;
+
+  uint32_t changed = diff(get(), draft);
+  if (changed == 0) return ConfigError::NONE;
+
+  // storage ditulis dulu, RAM tidak berubah jika penulisan gagal
+  if (!store(draft)) return ConfigError::STORAGE;
+  apply(draft, changed);
+  LOG_I("config: diperbarui, mask %lx", static_cast<unsigned long>(changed));
+  return ConfigError::NONE;
+}
+
+ConfigError Config::reset() { return commit(DEFAULTS); }
+
+bool Config::onChange(ConfigListener listener, bool deferred) {
+  if (listenerCount >= CONFIG_MAX_LISTENERS) return false;
+  lock();
+  listeners[listenerCount] = {listener, deferred, 0};
+  listenerCount++;
+  unlock();
+  return true;
+}
+
+void Config::dispatch() {
+  for (uint8_t i = 0; i < listenerCount; i++) {
+    if (!listeners[i].deferred) continue;
+    lock();
+    uint32_t changed = listeners[i].pending;
+    listeners[i].pending = 0;
+    AquaConfig config = current;
+    unlock();
+    if (changed) listeners[i].callback(config, changed);
+  }
+}
+
+const char* Config::key(ConfigField field) {
+  if (field >= ConfigField::COUNT) return "?";
+  return FIELDS[static_cast<uint8_t>(field)].key;
+}
+
+const char* Config::errorName(ConfigError error) {
+  switch (error) {
+    case ConfigError::NONE:
+      return "ok";
+    case ConfigError::UNKNOWN_KEY:
+      return "key tidak dikenal";
+    case ConfigError::INVALID_VALUE:
+      return "nilai tidak valid";
+    case ConfigError::OUT_OF_RANGE:
+      return "nilai di luar rentang";
+    case ConfigError::INCONSISTENT:
+      return "suhu_min harus lebih kecil dari suhu_max";
+    case ConfigError::STORAGE:
+      return "gagal menyimpan";
+  }
+  return "?";
+}
+
+size_t Config::formatValue(char* buf, size_t len, const AquaConfig& config,
+                           ConfigField field) {
+  if (len == 0) return 0;
+  buf[0] = '\0';
+  if (field >= ConfigField::COUNT) return 0;
+  const FieldInfo& info = FIELDS[static_cast<uint8_t>(field)];
+  float value = fieldValue(config, info);
+  if (info.isFloat) return append(buf, len, 0, "%.2f", value);
+  return append(buf, len, 0, "%lu", static_cast<unsigned long>(value));
+}
+
+size_t Config::format(char* buf, size_t len) {
+  if (len == 0) return 0;
+  buf[0] = '\0';
+  size_t pos = 0;
+  AquaConfig config = get();
+  for (uint8_t i = 0; i < static_cast<uint8_t>(ConfigField::COUNT); i++) {
+    ConfigField field = static_cast<ConfigField>(i);
+    char value[16];
+    char fallback[16];
+    formatValue(value, sizeof(value), config, field);
+    formatValue(fallback, sizeof(fallback), DEFAULTS, field);
+    pos = append(buf, len, pos, "%-10s %8s (default %s)\n", FIELDS[i].key,
+                 value, fallback);
+  }
+  return pos;
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Konfigurasi runtime (batas aman sensor dan interval polling) yang bisa
+ * diubah lewat perintah Telegram atau topik MQTT tanpa flash ulang.
+ *
+ * Disimpan di NVS (ESP32) atau EEPROM emulasi di flash (ESP8266), dimuat
+ * sekali saat boot ke struct di RAM. get() mengembalikan salinan yang
+ * diambil di bawah lock (28 byte, tanpa akses storage), sehingga pembaca di
+ * task lain tidak pernah melihat struct setengah jadi selama commit.
+ */
+
+#define CONFIG_MAX_LISTENERS 4
+
+struct AquaConfig {
+  float tempMin;  // derajat celcius
+  float tempMax;
+  float levelMin;  // persentase
+  uint32_t messageUpdateMs;
+  uint32_t sensorUpdateMs;
+  uint32_t sensorReportMs;
+  uint32_t publishMs;
+};
+
+enum class ConfigField : uint8_t {
+  TEMP_MIN,
+  TEMP_MAX,
+  LEVEL_MIN,
+  MESSAGE_UPDATE,
+  SENSOR_UPDATE,
+  SENSOR_REPORT,
+  PUBLISH,
+  COUNT,
+};
+
+enum class ConfigError : uint8_t {
+  NONE,
+  UNKNOWN_KEY,
+  INVALID_VALUE,
+  OUT_OF_RANGE,
+  INCONSISTENT,  // misal suhu_min >= suhu_max
+  STORAGE,
+};
+
+inline uint32_t configBit(ConfigField field) {
+  return 1UL << static_cast<uint8_t>(field);
+}
+
+// changed berisi configBit() untuk setiap field yang berubah
+typedef void (*ConfigListener)(const AquaConfig& config, uint32_t changed);
+
+namespace Config {
+extern const AquaConfig DEFAULTS;
+
+// muat dari storage, DEFAULTS jika kosong atau rusak
+void begin();
+AquaConfig get();
+
+// ubah satu field pada draft berdasarkan nama key, misal "suhu_min"
+ConfigError set(AquaConfig& draft, const char* key, const char* value);
+// validasi, simpan dan terapkan seluruh draft sekaligus
+ConfigError commit(const AquaConfig& draft);
+ConfigError reset();
+
+// listener dipanggil setelah commit dari konteks yang melakukan commit. Jika
+// deferred, perubahan dikumpulkan dan listener baru dipanggil dispatch()
+// dari task yang memiliki state yang diubah listener
+bool onChange(ConfigListener listener, bool deferred = false);
+// jalankan listener deferred yang punya perubahan tertunda, dari satu task
+void dispatch();
+
+const char* key(ConfigField field);
+const char* errorName(ConfigError error);
+// nilai field sebagai teks, misal "28.00" atau "3000"
+size_t formatValue(char* buf, size_t len, const AquaConfig& config,
+                   ConfigField field);
+// satu baris per field: key, nilai dan default
+size_t format(char* buf, size_t len);
+}  // namespace Config
@@ -0,0 +1,85 @@
+#include "DeviceTopics.h"
+
+#include <Arduino.h>
+#include <Log.h>
+#include <stdio.h>
+#include <string.h>
+
+#define SUBSCRIPTION_COUNT 4
+
+namespace {
+char deviceId[AQUA_DEVICE_ID_SIZE];
+char topics[static_cast<uint8_t>(AquaTopic::COUNT)][AQUA_TOPIC_SIZE];
+char broadcastCommand[AQUA_TOPIC_SIZE];
+char willPayload[48 + AQUA_DEVICE_ID_SIZE];  // meta offline
+uint8_t tankCount = 0;
+bool acceptsControl = false;
+
+TopicSubscription subscriptions[SUBSCRIPTION_COUNT];
+
+void chipId(char* buf, size_t len) {
+#ifdef ESP32
+  // 48 bit MAC di eFuse, unik per chip
+  snprintf(buf, len, "%012llx",
+           static_cast<unsigned long long>(ESP.getEfuseMac()));
+#else
+  snprintf(buf, len, "%06lx", static_cast<unsigned long>(ESP.getChipId()));
+#endif
+}
+}  // namespace
+
+void DeviceTopics::begin(uint8_t count, bool control, const char* id) {
+  if (id && AquaProto::validDeviceId(id)) {
+    snprintf(deviceId, sizeof(deviceId), "%s", id);
+  } else {
+    if (id) LOG_W("MQTT_DEVICE_ID tidak valid, pakai chip ID");
+    chipId(deviceId, sizeof(deviceId));
+  }
+  tankCount = count;
+  acceptsControl = control;
+
+  for (uint8_t i = 0; i < static_cast<uint8_t>(AquaTopic::COUNT); i++)
+    AquaProto::topic(topics[i], sizeof(topics[i]), deviceId,
+                     static_cast<AquaTopic>(i));
+  AquaProto::topic(broadcastCommand, sizeof(broadcastCommand),
+                   AQUA_BROADCAST_ID, AquaTopic::COMMAND);
+  AquaProto::encodeMeta(willPayload, sizeof(willPayload), deviceId, false,
+                        count, control, nullptr);
+
+  subscriptions[0] = {get(AquaTopic::COMMAND), AquaTopic::COMMAND, 0};
+  subscriptions[1] = {broadcastCommand, AquaTopic::COMMAND, 0};
+  subscriptions[2] = {get(AquaTopic::CONFIG), AquaTopic::CONFIG, 1};
+  // retained, dikirim broker segera setelah subscribe
+  subscriptions[3] = {get(AquaTopic::SHADOW_DESIRED),
+                      AquaTopic::SHADOW_DESIRED, 1};
+
+  LOG_I("MQTT device id: %s", deviceId);
+}
+
+const char* DeviceTopics::id() { return deviceId; }
+
+const char* DeviceTopics::get(AquaTopic leaf) {
+  return leaf < AquaTopic::COUNT ? topics[static_cast<uint8_t>(leaf)] : "";
+}
+
+const char* DeviceTopics::will() { return willPayload; }
+
+size_t DeviceTopics::birth(char* buf, size_t len, const char* ip) {
+  return AquaProto::encodeMeta(buf, len, deviceId, true, tankCount,
+                               acceptsControl, ip);
+}
+
+uint8_t DeviceTopics::subscriptionCount() { return SUBSCRIPTION_COUNT; }
+
+const TopicSubscription& DeviceTopics::subscription(uint8_t index) {
+  return subscriptions[index < SUBSCRIPTION_COUNT ? index : 0];
+}
+
+bool DeviceTopics::route(const char* topic, AquaTopic& leaf) {
+  for (const TopicSubscription& sub : subscriptions) {
+    if (!AquaProto::topicMatches(sub.filter, topic)) continue;
+    leaf = sub.leaf;
+    return true;
+  }
+  return false;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <AquaProto.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Topik MQTT milik perangkat ini, "aquarium/<id>/<leaf>" dengan id dari
+ * MQTT_DEVICE_ID (secret.h) atau chip ID. Semua string dibuat sekali di
+ * begin() dan tetap valid selama program berjalan, sehingga bisa diberikan
+ * langsung ke AsyncMqttClient yang hanya menyimpan pointer (setWill,
+ * setClientId).
+ *
+ * Perangkat berlangganan perintah, konfigurasi dan shadow desired-nya
+ * sendiri ditambah perintah broadcast aquarium/all/command. route()
+ * mencocokkan topik masuk dengan tabel langganan memakai aturan wildcard
+ * MQTT, topik lain ditolak.
+ */
+
+struct TopicSubscription {
+  const char* filter;
+  AquaTopic leaf;
+  uint8_t qos;
+};
+
+namespace DeviceTopics {
+// count dan control diumumkan di payload birth. id nullptr berarti chip ID
+void begin(uint8_t count, bool control, const char* id = nullptr);
+const char* id();
+const char* get(AquaTopic leaf);
+
+// payload last will retained di get(AquaTopic::META)
+const char* will();
+// payload birth retained, dikirim setiap kali tersambung ke broker
+size_t birth(char* buf, size_t len, const char* ip);
+
+uint8_t subscriptionCount();
+const TopicSubscription& subscription(uint8_t index);
+// false jika topik bukan langganan perangkat ini
+bool route(const char* topic, AquaTopic& leaf);
+}  // namespace DeviceTopics
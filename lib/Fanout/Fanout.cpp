@@ -0,0 +1,130 @@
+#include "Fanout.h"
+
+#include <Arduino.h>
+#include <Utils.h>
+#include <stdio.h>
+
+namespace {
+Sink* sinks[FANOUT_MAX_SINKS];
+uint8_t sinkCount = 0;
+uint32_t nextSeq = 0;
+
+}  // namespace
+
+// constructor
+Sink::Sink(const char* name, SinkFunc func, uint32_t cadenceMs, void* arg)
+    : m_name(name),
+      m_func(func),
+      m_arg(arg),
+      m_cadenceMs(cadenceMs),
+      m_due(0),
+      m_started(false),
+      m_head(0),
+      m_count(0),
+      m_stats() {
+#ifdef ESP32
+  m_lock = portMUX_INITIALIZER_UNLOCKED;
+#endif
+}
+
+void Sink::lock() {
+#ifdef ESP32
+  portENTER_CRITICAL(&m_lock);
+#endif
+}
+
+void Sink::unlock() {
+#ifdef ESP32
+  portEXIT_CRITICAL(&m_lock);
+#endif
+}
+
+void Sink::offer(const Snapshot& snapshot) {
+  // jadwal fixed-rate agar cadence rata-rata tetap walau periode sampling
+  // tidak habis membagi cadence
+  if (m_started && static_cast<int32_t>(snapshot.timestamp - m_due) < 0) {
+    m_stats.skipped++;
+    return;
+  }
+  m_due = m_started && snapshot.timestamp - m_due < m_cadenceMs
+              ? m_due + m_cadenceMs
+              : snapshot.timestamp + m_cadenceMs;
+  m_started = true;
+
+  lock();
+  if (m_count == FANOUT_QUEUE_SIZE) {
+    m_head = (m_head + 1) & (FANOUT_QUEUE_SIZE - 1);
+    m_count--;
+    m_stats.dropped++;
+  }
+  m_queue[(m_head + m_count) & (FANOUT_QUEUE_SIZE - 1)] = snapshot;
+  m_count++;
+  if (m_count > m_stats.maxDepth) m_stats.maxDepth = m_count;
+  m_stats.accepted++;
+  unlock();
+}
+
+bool Sink::runOnce() {
+  Snapshot snapshot;
+  lock();
+  if (m_count == 0) {
+    unlock();
+    return false;
+  }
+  snapshot = m_queue[m_head];
+  m_head = (m_head + 1) & (FANOUT_QUEUE_SIZE - 1);
+  m_count--;
+  unlock();
+
+  uint32_t start = millis();
+  bool ok = m_func(snapshot, m_arg);
+  uint32_t end = millis();
+
+  if (!ok) {
+    m_stats.failed++;
+    return true;
+  }
+  m_stats.delivered++;
+  m_stats.lastLagMs = end - snapshot.timestamp;
+  if (m_stats.lastLagMs > m_stats.maxLagMs)
+    m_stats.maxLagMs = m_stats.lastLagMs;
+  if (end - start > m_stats.maxRunMs) m_stats.maxRunMs = end - start;
+  return true;
+}
+
+namespace Fanout {
+bool addSink(Sink& sink) {
+  if (sinkCount >= FANOUT_MAX_SINKS) return false;
+  sinks[sinkCount++] = &sink;
+  return true;
+}
+
+void publish(Snapshot& snapshot) {
+  snapshot.seq = nextSeq++;
+  for (uint8_t i = 0; i < sinkCount; i++) sinks[i]->offer(snapshot);
+}
+
+size_t toJson(char* buf, size_t len) {
+  if (len == 0) return 0;
+  size_t pos = append(buf, len, 0, "{\"type\":\"fanout\",\"sinks\":{");
+  for (uint8_t i = 0; i < sinkCount; i++) {
+    SinkStats s = sinks[i]->stats();
+    pos = append(buf, len, pos,
+                 "%s\"%s\":{\"accepted\":%lu,\"skipped\":%lu,\"dropped\":%lu,"
+                 "\"delivered\":%lu,\"failed\":%lu,\"lag_ms\":%lu,"
+                 "\"max_lag_ms\":%lu,\"max_run_ms\":%lu,\"depth\":%u,"
+                 "\"max_depth\":%u}",
+                 i ? "," : "", sinks[i]->name(),
+                 static_cast<unsigned long>(s.accepted),
+                 static_cast<unsigned long>(s.skipped),
+                 static_cast<unsigned long>(s.dropped),
+                 static_cast<unsigned long>(s.delivered),
+                 static_cast<unsigned long>(s.failed),
+                 static_cast<unsigned long>(s.lastLagMs),
+                 static_cast<unsigned long>(s.maxLagMs),
+                 static_cast<unsigned long>(s.maxRunMs), sinks[i]->depth(),
+                 s.maxDepth);
+  }
+  return append(buf, len, pos, "}}");
+}
+}  // namespace Fanout
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <Tanks.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef ESP32
+#include <freertos/FreeRTOS.h>
+#endif
+
+/**
+ * Satu pipeline sampling yang membagikan setiap snapshot ke beberapa sink
+ * (Telegram, MQTT, ThingSpeak). Setiap sink punya antrean terbatas dan
+ * cadence sendiri; publish() hanya menyalin snapshot ke antrean tanpa
+ * menunggu sink, sehingga sink yang lambat atau gagal tidak menahan
+ * sampling maupun sink lain.
+ *
+ * Jika antrean penuh, snapshot terlama dibuang karena data terbaru lebih
+ * berguna. Sink dijalankan dari task/job miliknya sendiri lewat runOnce().
+ */
+
+// snapshot per sink, harus pangkat 2
+#ifndef FANOUT_QUEUE_SIZE
+#define FANOUT_QUEUE_SIZE 4
+#endif
+#define FANOUT_MAX_SINKS 4
+
+static_assert((FANOUT_QUEUE_SIZE & (FANOUT_QUEUE_SIZE - 1)) == 0,
+              "FANOUT_QUEUE_SIZE harus pangkat 2");
+
+// hasil satu putaran sampling semua tank
+struct Snapshot {
+  uint32_t seq;
+  uint32_t timestamp;  // millis() saat sampling
+  uint8_t count;       // jumlah tank
+  uint8_t led;         // bitmask relay per tank
+  uint8_t pump;
+  uint8_t tempAlarms[TANK_MAX];  // AnalyticsAlarm
+  uint8_t levelAlarms[TANK_MAX];
+  float temp[TANK_MAX];
+  float level[TANK_MAX];
+};
+
+// false jika pengiriman gagal, snapshot tidak dikirim ulang karena
+// snapshot berikutnya membawa data yang lebih baru
+typedef bool (*SinkFunc)(const Snapshot& snapshot, void* arg);
+
+struct SinkStats {
+  uint32_t accepted;  // masuk antrean
+  uint32_t skipped;   // dilewati karena belum waktunya (cadence)
+  uint32_t dropped;   // dibuang karena antrean penuh
+  uint32_t delivered;
+  uint32_t failed;
+  uint32_t lastLagMs;  // umur snapshot saat selesai dikirim
+  uint32_t maxLagMs;
+  uint32_t maxRunMs;  // durasi pengiriman terlama
+  uint8_t maxDepth;
+};
+
+class Sink {
+ private:
+  const char* m_name;
+  SinkFunc m_func;
+  void* m_arg;
+  uint32_t m_cadenceMs;
+  uint32_t m_due;  // timestamp snapshot berikutnya yang diterima
+  bool m_started;
+  Snapshot m_queue[FANOUT_QUEUE_SIZE];
+  uint8_t m_head;
+  uint8_t m_count;
+  SinkStats m_stats;
+#ifdef ESP32
+  portMUX_TYPE m_lock;
+#endif
+
+ public:
+  // constructor
+  Sink(const char* name, SinkFunc func, uint32_t cadenceMs,
+       void* arg = nullptr);
+
+  const char* name() const { return m_name; }
+  uint32_t cadence() const { return m_cadenceMs; }
+  void setCadence(uint32_t ms) { m_cadenceMs = ms; }
+
+  // dipanggil dari pipeline sampling, tidak pernah menunggu
+  void offer(const Snapshot& snapshot);
+  // kirim satu snapshot dari antrean, false jika antrean kosong
+  bool runOnce();
+  uint8_t depth() const { return m_count; }
+  SinkStats stats() const { return m_stats; }
+
+ private:
+  void lock();
+  void unlock();
+};
+
+namespace Fanout {
+bool addSink(Sink& sink);
+// isi snapshot.seq lalu tawarkan ke semua sink
+void publish(Snapshot& snapshot);
+
+// {"type":"fanout","sinks":{"mqtt":{"accepted":10,...},...}}
+size_t toJson(char* buf, size_t len);
+}  // namespace Fanout
@@ -0,0 +1,207 @@
+#include "FastBoot.h"
+
+#include <Arduino.h>
+#include <Utils.h>
+#include <stdio.h>
+#include <string.h>
+#ifdef ESP32
+#include <Preferences.h>
+#include <WiFi.h>
+#else
+#include <ESP8266WiFi.h>
+#endif
+
+#define CACHE_MAGIC 0x46424331  // "FBC1"
+
+namespace {
+struct WifiCache {
+  uint32_t magic;
+  uint8_t bssid[6];
+  uint8_t channel;
+  uint8_t hasIp;
+  uint32_t ip;
+  uint32_t gateway;
+  uint32_t subnet;
+  uint32_t dns;
+  uint32_t crc;
+};
+static_assert(sizeof(WifiCache) == FASTBOOT_RTC_BLOCKS * 4,
+              "ukuran cache tidak sesuai dengan blok RTC");
+
+const char* ssid = nullptr;
+const char* password = nullptr;
+FastBootPhase currentPhase = FastBootPhase::IDLE;
+uint32_t phaseStart = 0;
+bool cacheUsed = false;
+WifiCache cache;
+
+uint32_t firstSampleAt = 0;
+uint32_t connectedAt = 0;
+uint32_t onlineAt = 0;
+
+uint32_t cacheCrc(const WifiCache& c) {
+  return crc32(reinterpret_cast<const uint8_t*>(&c), offsetof(WifiCache, crc));
+}
+
+bool loadCache(WifiCache& c) {
+#ifdef ESP32
+  Preferences prefs;
+  if (!prefs.begin("fastboot", true)) return false;
+  size_t len = prefs.getBytes("wifi", &c, sizeof(c));
+  prefs.end();
+  if (len != sizeof(c)) return false;
+#else
+  if (!ESP.rtcUserMemoryRead(FASTBOOT_RTC_OFFSET,
+                             reinterpret_cast<uint32_t*>(&c), sizeof(c)))
+    return false;
+#endif
+  return c.magic == CACHE_MAGIC && c.crc == cacheCrc(c) && c.channel > 0;
+}
+
+void storeCache(WifiCache& c) {
+  c.magic = CACHE_MAGIC;
+  c.crc = cacheCrc(c);
+#ifdef ESP32
+  Preferences prefs;
+  if (!prefs.begin("fastboot", false)) return;
+  prefs.putBytes("wifi", &c, sizeof(c));
+  prefs.end();
+#else
+  ESP.rtcUserMemoryWrite(FASTBOOT_RTC_OFFSET, reinterpret_cast<uint32_t*>(&c),
+                         sizeof(c));
+#endif
+}
+
+void invalidateCache() {
+  cache.magic = 0;
+  storeCache(cache);
+  cache.magic = 0;
+}
+
+// simpan hanya jika berubah, NVS ESP32 ada di flash
+void saveConnection() {
+  WifiCache next;
+  memset(&next, 0, sizeof(next));
+  memcpy(next.bssid, WiFi.BSSID(), sizeof(next.bssid));
+  next.channel = WiFi.channel();
+  next.hasIp = 1;
+  next.ip = static_cast<uint32_t>(WiFi.localIP());
+  next.gateway = static_cast<uint32_t>(WiFi.gatewayIP());
+  next.subnet = static_cast<uint32_t>(WiFi.subnetMask());
+  next.dns = static_cast<uint32_t>(WiFi.dnsIP());
+  next.magic = CACHE_MAGIC;
+  next.crc = cacheCrc(next);
+
+  if (memcmp(&next, &cache, sizeof(next)) == 0) return;
+  cache = next;
+  storeCache(cache);
+}
+
+void enterPhase(FastBootPhase phase) {
+  currentPhase = phase;
+  phaseStart = millis();
+}
+
+void beginScan() {
+#if FASTBOOT_STATIC_IP
+  // kembali ke DHCP jika sebelumnya memakai IP dari cache
+  IPAddress none(0, 0, 0, 0);
+  WiFi.config(none, none, none);
+#endif
+  WiFi.begin(ssid, password);
+  enterPhase(FastBootPhase::SCAN);
+}
+
+uint32_t stamp() {
+  uint32_t now = millis();
+  return now > 0 ? now : 1;
+}
+}  // namespace
+
+void FastBoot::begin(const char* wifiSsid, const char* wifiPassword) {
+  ssid = wifiSsid;
+  password = wifiPassword;
+
+  // konfigurasi WiFi tidak perlu ditulis ulang ke flash setiap boot
+  WiFi.persistent(false);
+  WiFi.mode(WIFI_STA);
+
+  cacheUsed = loadCache(cache);
+  if (!cacheUsed) {
+    memset(&cache, 0, sizeof(cache));
+    beginScan();
+    return;
+  }
+
+#if FASTBOOT_STATIC_IP
+  if (cache.hasIp)
+    WiFi.config(IPAddress(cache.ip), IPAddress(cache.gateway),
+                IPAddress(cache.subnet), IPAddress(cache.dns));
+#endif
+  WiFi.begin(ssid, password, cache.channel, cache.bssid);
+  enterPhase(FastBootPhase::DIRECT);
+}
+
+bool FastBoot::poll() {
+  if (currentPhase == FastBootPhase::IDLE) return false;
+
+  if (WiFi.status() == WL_CONNECTED) {
+    if (currentPhase != FastBootPhase::CONNECTED) {
+      if (connectedAt == 0) connectedAt = stamp();
+      enterPhase(FastBootPhase::CONNECTED);
+      saveConnection();
+    }
+    return true;
+  }
+
+  switch (currentPhase) {
+    case FastBootPhase::CONNECTED:
+      // SDK akan reconnect otomatis, cache diperbarui saat tersambung lagi
+      enterPhase(FastBootPhase::SCAN);
+      break;
+    case FastBootPhase::DIRECT:
+      if (millis() - phaseStart >= FASTBOOT_DIRECT_TIMEOUT) {
+        // AP berpindah channel atau diganti, cache tidak berlaku lagi
+        invalidateCache();
+        WiFi.disconnect();
+        beginScan();
+      }
+      break;
+    default:
+      break;
+  }
+
+  return false;
+}
+
+bool FastBoot::connected() {
+  return currentPhase == FastBootPhase::CONNECTED;
+}
+
+FastBootPhase FastBoot::phase() { return currentPhase; }
+
+bool FastBoot::usedCache() { return cacheUsed; }
+
+void FastBoot::markFirstSample() {
+  if (firstSampleAt == 0) firstSampleAt = stamp();
+}
+
+void FastBoot::markOnline() {
+  if (onlineAt == 0) onlineAt = stamp();
+}
+
+uint32_t FastBoot::firstSampleMs() { return firstSampleAt; }
+
+uint32_t FastBoot::connectedMs() { return connectedAt; }
+
+uint32_t FastBoot::onlineMs() { return onlineAt; }
+
+size_t FastBoot::format(char* buf, size_t len) {
+  int written = snprintf(
+      buf, len, "boot sampel %lu ms, wifi %lu ms, online %lu ms (cache %s)\n",
+      static_cast<unsigned long>(firstSampleAt),
+      static_cast<unsigned long>(connectedAt),
+      static_cast<unsigned long>(onlineAt), cacheUsed ? "ya" : "tidak");
+  if (written < 0) return 0;
+  return static_cast<size_t>(written) < len ? written : (len > 0 ? len - 1 : 0);
+}
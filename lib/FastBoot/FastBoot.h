@@ -0,0 +1,53 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Bring-up WiFi cepat setelah reset atau brownout. BSSID, channel dan
+ * konfigurasi IP dari koneksi terakhir disimpan di RTC user memory (ESP8266)
+ * atau NVS (ESP32), sehingga reconnect bisa langsung ke AP yang sama tanpa
+ * scan channel. Semua fungsi non-blocking, poll() dipanggil berkala dari
+ * loop() atau job scheduler sementara sensor sudah berjalan.
+ */
+
+// lokasi cache di RTC user memory ESP8266 dalam satuan blok 4 byte,
+// modul lain yang memakai RTC memory harus mulai setelah area ini
+#define FASTBOOT_RTC_OFFSET 0
+#define FASTBOOT_RTC_BLOCKS 8
+
+// batas waktu directed connect sebelum kembali ke scan penuh
+#ifndef FASTBOOT_DIRECT_TIMEOUT
+#define FASTBOOT_DIRECT_TIMEOUT 3000
+#endif
+
+// pakai ulang IP dari lease DHCP terakhir agar DHCP ikut dilewati,
+// hanya aman jika router memberikan IP yang tetap untuk perangkat ini
+#ifndef FASTBOOT_STATIC_IP
+#define FASTBOOT_STATIC_IP 0
+#endif
+
+enum class FastBootPhase : uint8_t {
+  IDLE,
+  DIRECT,  // reconnect ke BSSID dan channel dari cache
+  SCAN,    // koneksi normal dengan scan
+  CONNECTED,
+};
+
+namespace FastBoot {
+void begin(const char* ssid, const char* password);
+// return true jika WiFi tersambung
+bool poll();
+bool connected();
+FastBootPhase phase();
+bool usedCache();
+
+// waktu sejak boot dalam ms, 0 jika belum terjadi
+void markFirstSample();
+void markOnline();
+uint32_t firstSampleMs();
+uint32_t connectedMs();
+uint32_t onlineMs();
+
+size_t format(char* buf, size_t len);
+}  // namespace FastBoot
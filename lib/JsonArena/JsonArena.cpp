@@ -0,0 +1,190 @@
+#include "JsonArena.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define HEADER_SIZE JSON_ARENA_ALIGN
+#define NO_BLOCK SIZE_MAX
+
+namespace {
+JsonArena* registered[JSON_ARENA_MAX_REGISTERED];
+uint8_t registeredCount = 0;
+
+inline size_t alignUp(size_t size) {
+  return (size + JSON_ARENA_ALIGN - 1) &
+         ~static_cast<size_t>(JSON_ARENA_ALIGN - 1);
+}
+}  // namespace
+
+// constructor
+JsonArena::JsonArena(const char* name, uint8_t* buffer, size_t capacity)
+    : m_name(name),
+      m_buffer(buffer),
+      m_capacity(capacity),
+      m_top(0),
+      m_lastBlock(NO_BLOCK),
+      m_depth(0),
+      m_stats{0, 0, 0, 0} {
+#ifdef ESP32
+  m_lock = portMUX_INITIALIZER_UNLOCKED;
+#endif
+  if (registeredCount < JSON_ARENA_MAX_REGISTERED)
+    registered[registeredCount++] = this;
+}
+
+void JsonArena::lock() {
+#ifdef ESP32
+  portENTER_CRITICAL(&m_lock);
+#endif
+}
+
+void JsonArena::unlock() {
+#ifdef ESP32
+  portEXIT_CRITICAL(&m_lock);
+#endif
+}
+
+bool JsonArena::owns(const void* ptr) const {
+  const uint8_t* p = static_cast<const uint8_t*>(ptr);
+  return p >= m_buffer && p < m_buffer + m_capacity;
+}
+
+size_t JsonArena::blockSize(const void* ptr) const {
+  uint32_t size;
+  memcpy(&size, static_cast<const uint8_t*>(ptr) - HEADER_SIZE, sizeof(size));
+  return size;
+}
+
+void* JsonArena::bump(size_t size) {
+  size_t need = HEADER_SIZE + alignUp(size);
+  if (need > m_capacity - m_top) return nullptr;
+
+  uint32_t stored = size;
+  memcpy(m_buffer + m_top, &stored, sizeof(stored));
+  m_lastBlock = m_top;
+  m_top += need;
+
+  m_stats.used = m_top;
+  if (m_top > m_stats.peak) m_stats.peak = m_top;
+  return m_buffer + m_lastBlock + HEADER_SIZE;
+}
+
+void* JsonArena::allocate(size_t size) {
+  lock();
+  void* ptr = bump(size);
+  if (!ptr) m_stats.fallbacks++;
+  unlock();
+
+  return ptr ? ptr : malloc(size);
+}
+
+void JsonArena::deallocate(void* ptr) {
+  if (!ptr) return;
+  if (!owns(ptr)) {
+    free(ptr);
+    return;
+  }
+
+  // hanya blok terakhir yang bisa dikembalikan sebelum reset
+  lock();
+  size_t offset = static_cast<uint8_t*>(ptr) - m_buffer - HEADER_SIZE;
+  if (offset == m_lastBlock) {
+    m_top = m_lastBlock;
+    m_lastBlock = NO_BLOCK;
+    m_stats.used = m_top;
+  }
+  unlock();
+}
+
+void* JsonArena::reallocate(void* ptr, size_t newSize) {
+  if (!ptr) return allocate(newSize);
+  if (!owns(ptr)) return realloc(ptr, newSize);
+
+  lock();
+  size_t offset = static_cast<uint8_t*>(ptr) - m_buffer - HEADER_SIZE;
+  if (offset == m_lastBlock &&
+      HEADER_SIZE + alignUp(newSize) <= m_capacity - offset) {
+    // blok terakhir cukup digeser batas atasnya
+    uint32_t stored = newSize;
+    memcpy(m_buffer + offset, &stored, sizeof(stored));
+    m_top = offset + HEADER_SIZE + alignUp(newSize);
+    m_stats.used = m_top;
+    if (m_top > m_stats.peak) m_stats.peak = m_top;
+    unlock();
+    return ptr;
+  }
+
+  size_t oldSize = blockSize(ptr);
+  void* moved = bump(newSize);
+  if (!moved) m_stats.fallbacks++;
+  unlock();
+
+  if (!moved) moved = malloc(newSize);
+  if (moved) memcpy(moved, ptr, oldSize < newSize ? oldSize : newSize);
+  return moved;
+}
+
+void JsonArena::enter() {
+  lock();
+  m_depth++;
+  unlock();
+}
+
+void JsonArena::leave() {
+  lock();
+  if (m_depth > 0 && --m_depth == 0) {
+    m_top = 0;
+    m_lastBlock = NO_BLOCK;
+    m_stats.used = 0;
+    m_stats.resets++;
+  }
+  unlock();
+}
+
+uint8_t JsonArena::count() { return registeredCount; }
+
+const JsonArena* JsonArena::get(uint8_t index) {
+  return index < registeredCount ? registered[index] : nullptr;
+}
+
+size_t JsonArena::format(char* buf, size_t len) {
+  size_t pos = 0;
+  if (len > 0) buf[0] = '\0';
+
+  for (uint8_t i = 0; i < registeredCount && pos < len; i++) {
+    const JsonArena* arena = registered[i];
+    int written = snprintf(
+        buf + pos, len - pos, "json %-6s peak %lu/%lu B fallback %lu\n",
+        arena->m_name, static_cast<unsigned long>(arena->m_stats.peak),
+        static_cast<unsigned long>(arena->m_capacity),
+        static_cast<unsigned long>(arena->m_stats.fallbacks));
+    if (written < 0) break;
+    pos += written;
+  }
+
+  return pos < len ? pos : (len > 0 ? len - 1 : 0);
+}
+
+size_t JsonArena::toJson(char* buf, size_t len) {
+  size_t pos = 0;
+  if (len == 0) return 0;
+
+  pos += snprintf(buf, len, "{\"type\":\"json_arena\"");
+  for (uint8_t i = 0; i < registeredCount && pos < len; i++) {
+    const JsonArena* arena = registered[i];
+    int written = snprintf(
+        buf + pos, len - pos,
+        ",\"%s\":{\"capacity\":%lu,\"peak\":%lu,\"resets\":%lu,"
+        "\"fallbacks\":%lu}",
+        arena->m_name, static_cast<unsigned long>(arena->m_capacity),
+        static_cast<unsigned long>(arena->m_stats.peak),
+        static_cast<unsigned long>(arena->m_stats.resets),
+        static_cast<unsigned long>(arena->m_stats.fallbacks));
+    if (written < 0) break;
+    pos += written;
+  }
+  if (pos < len) pos += snprintf(buf + pos, len - pos, "}");
+
+  return pos < len ? pos : len - 1;
+}
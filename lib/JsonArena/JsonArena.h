@@ -0,0 +1,95 @@
+#pragma once
+
+#include <ArduinoJson.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef ESP32
+#include <freertos/FreeRTOS.h>
+#endif
+
+#define JSON_ARENA_ALIGN 8
+#define JSON_ARENA_MAX_REGISTERED 4
+
+struct JsonArenaStats {
+  uint32_t used;       // pemakaian saat ini
+  uint32_t peak;       // pemakaian tertinggi sejak boot
+  uint32_t resets;     // jumlah pesan yang selesai diproses
+  uint32_t fallbacks;  // alokasi yang terpaksa memakai heap karena arena penuh
+};
+
+/**
+ * Allocator ArduinoJson berbasis bump pointer di atas buffer statis. Memori
+ * hanya dikembalikan saat reset (setelah semua JsonDocument dalam
+ * JsonArenaScope selesai), atau saat blok terakhir dibebaskan/diperbesar
+ * sehingga pola realloc StringBuilder milik ArduinoJson tetap hemat.
+ * Jika arena penuh, alokasi jatuh ke heap dan dicatat sebagai fallback.
+ */
+class JsonArena : public ArduinoJson::Allocator {
+ private:
+  const char* m_name;
+  uint8_t* m_buffer;
+  size_t m_capacity;
+  size_t m_top;
+  size_t m_lastBlock;  // offset header blok terakhir, SIZE_MAX jika kosong
+  uint8_t m_depth;
+  JsonArenaStats m_stats;
+#ifdef ESP32
+  portMUX_TYPE m_lock;
+#endif
+
+ protected:
+  JsonArena(const char* name, uint8_t* buffer, size_t capacity);
+
+ public:
+  void* allocate(size_t size) override;
+  void deallocate(void* ptr) override;
+  void* reallocate(void* ptr, size_t newSize) override;
+
+  void enter();
+  void leave();
+
+  const char* name() const { return m_name; }
+  size_t capacity() const { return m_capacity; }
+  const JsonArenaStats& stats() const { return m_stats; }
+
+  static uint8_t count();
+  static const JsonArena* get(uint8_t index);
+  static size_t format(char* buf, size_t len);
+  static size_t toJson(char* buf, size_t len);
+
+ private:
+  bool owns(const void* ptr) const;
+  void* bump(size_t size);
+  size_t blockSize(const void* ptr) const;
+  void lock();
+  void unlock();
+};
+
+template <size_t N>
+class StaticJsonArena : public JsonArena {
+ private:
+  alignas(JSON_ARENA_ALIGN) uint8_t m_storage[N];
+
+ public:
+  explicit StaticJsonArena(const char* name)
+      : JsonArena(name, m_storage, N) {}
+};
+
+/**
+ * Menandai masa hidup satu pesan. JsonDocument yang memakai arena harus
+ * dideklarasikan setelah scope agar dihancurkan lebih dulu.
+ */
+class JsonArenaScope {
+ private:
+  JsonArena& m_arena;
+
+ public:
+  explicit JsonArenaScope(JsonArena& arena) : m_arena(arena) {
+    m_arena.enter();
+  }
+  ~JsonArenaScope() { m_arena.leave(); }
+
+  JsonArenaScope(const JsonArenaScope&) = delete;
+  JsonArenaScope& operator=(const JsonArenaScope&) = delete;
+};
@@ -0,0 +1,342 @@
+#include "Log.h"
+
+#include <stdio.h>
+
+#include <atomic>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <chrono>
+#endif
+
+// penanda awal frame pada mode LOG_BINARY
+#define FRAME_MAGIC_0 0xA5
+#define FRAME_MAGIC_1 0x5A
+#define FRAME_SIZE (2 + 12 + 4 * LOG_MAX_ARGS + LOG_STR_SIZE)
+
+static_assert(FRAME_SIZE <= LOG_LINE_SIZE, "frame binary melebihi buffer");
+
+namespace {
+// bounded queue Vyukov: producer banyak (task/ISR), consumer satu (drain).
+// seq disimpan relatif terhadap index sel sehingga nilai awal nol sudah
+// valid tanpa inisialisasi
+struct Cell {
+  std::atomic<uint32_t> seq;
+  LogRecord record;
+};
+
+Cell ring[LOG_RING_SIZE];
+std::atomic<uint32_t> head(0);
+uint32_t tail = 0;
+
+std::atomic<uint32_t> droppedCount(0);
+uint32_t writtenCount = 0;
+uint32_t droppedReported = 0;
+
+char line[LOG_LINE_SIZE];
+size_t lineLen = 0;
+size_t lineSent = 0;
+
+void* drainTask = nullptr;
+
+const char LEVEL_CHARS[] = "-EWID";
+
+uint32_t nowMs() {
+#ifdef ARDUINO
+  return millis();
+#else
+  using namespace std::chrono;
+  static const auto start = steady_clock::now();
+  return duration_cast<milliseconds>(steady_clock::now() - start).count();
+#endif
+}
+
+inline uint32_t cellSeq(uint32_t index) {
+  return ring[index].seq.load(std::memory_order_acquire) + index;
+}
+
+inline void setCellSeq(uint32_t index, uint32_t seq) {
+  ring[index].seq.store(seq - index, std::memory_order_release);
+}
+
+bool pop(LogRecord& record) {
+  uint32_t index = tail & (LOG_RING_SIZE - 1);
+  if (static_cast<int32_t>(cellSeq(index) - (tail + 1)) < 0) return false;
+
+  record = ring[index].record;
+  setCellSeq(index, tail + LOG_RING_SIZE);
+  tail++;
+  return true;
+}
+
+size_t uartRoom() {
+#ifdef ARDUINO
+  int room = Serial.availableForWrite();
+  return room > 0 ? room : 0;
+#else
+  return SIZE_MAX;
+#endif
+}
+
+void uartWrite(const char* data, size_t len) {
+#ifdef ARDUINO
+  Serial.write(reinterpret_cast<const uint8_t*>(data), len);
+#else
+  fwrite(data, 1, len, stdout);
+#endif
+}
+
+size_t clampWritten(int written, size_t room) {
+  if (written < 0) return 0;
+  return static_cast<size_t>(written) < room ? written : room - 1;
+}
+
+// satu spesifikasi konversi diformat dengan argumen bertipe sesuai LogArg
+size_t formatArg(char* buf, size_t len, const char* flags, size_t flagsLen,
+                 char conv, const LogRecord& record, uint8_t index) {
+  if (index >= record.argc) return clampWritten(snprintf(buf, len, "?"), len);
+
+  LogArg type = static_cast<LogArg>((record.types >> (index * 2)) & 0x3);
+  uint32_t value = record.args[index];
+
+  char spec[16];
+  if (flagsLen > sizeof(spec) - 4) flagsLen = sizeof(spec) - 4;
+  memcpy(spec, flags, flagsLen);
+  size_t specLen = flagsLen;
+
+  int written;
+  switch (type) {
+    case LogArg::FLOAT: {
+      float f;
+      memcpy(&f, &value, sizeof(f));
+      spec[specLen++] = strchr("eEfFgGaA", conv) ? conv : 'f';
+      spec[specLen] = '\0';
+      written = snprintf(buf, len, spec, static_cast<double>(f));
+      break;
+    }
+    case LogArg::STR:
+      spec[specLen++] = 's';
+      spec[specLen] = '\0';
+      written = snprintf(buf, len, spec, record.str + (value % LOG_STR_SIZE));
+      break;
+    default:
+      if (conv == 'c') {
+        spec[specLen++] = 'c';
+        spec[specLen] = '\0';
+        written = snprintf(buf, len, spec, static_cast<int>(value));
+      } else if (conv == 'p') {
+        written =
+            snprintf(buf, len, "0x%08lx", static_cast<unsigned long>(value));
+      } else {
+        // lebar integer di target dan host berbeda, selalu pakai long
+        spec[specLen++] = 'l';
+        spec[specLen++] = strchr("dixXuo", conv) ? conv : 'd';
+        spec[specLen] = '\0';
+        if (type == LogArg::INT && (conv == 'd' || conv == 'i'))
+          written = snprintf(buf, len, spec,
+                             static_cast<long>(static_cast<int32_t>(value)));
+        else
+          written = snprintf(buf, len, spec, static_cast<unsigned long>(value));
+      }
+      break;
+  }
+
+  return clampWritten(written, len);
+}
+
+#ifndef LOG_BINARY
+size_t renderText(const LogRecord& record, char* buf, size_t len) {
+  uint8_t level = record.level < sizeof(LEVEL_CHARS) - 1 ? record.level : 0;
+  unsigned long timestamp = record.timestamp;
+  size_t pos = clampWritten(
+      snprintf(buf, len, "[%7lu] %c > ", timestamp, LEVEL_CHARS[level]), len);
+  pos += Log::formatMessage(record, buf + pos, len - pos);
+
+  // pesan yang terpotong tetap diakhiri newline
+  if (pos >= len - 2) pos = len - 2;
+  buf[pos++] = '\n';
+  buf[pos] = '\0';
+  return pos;
+}
+#else
+inline void putU32(uint8_t* buf, uint32_t value) {
+  buf[0] = value;
+  buf[1] = value >> 8;
+  buf[2] = value >> 16;
+  buf[3] = value >> 24;
+}
+
+// layout little-endian yang dibaca tools/log_decode.py
+size_t renderBinary(const LogRecord& record, char* buf) {
+  uint8_t* out = reinterpret_cast<uint8_t*>(buf);
+  out[0] = FRAME_MAGIC_0;
+  out[1] = FRAME_MAGIC_1;
+  putU32(out + 2,
+         static_cast<uint32_t>(reinterpret_cast<uintptr_t>(record.fmt)));
+  putU32(out + 6, record.timestamp);
+  out[10] = record.level;
+  out[11] = record.argc;
+  out[12] = record.types;
+  out[13] = record.strLen;
+  for (uint8_t i = 0; i < LOG_MAX_ARGS; i++)
+    putU32(out + 14 + i * 4, i < record.argc ? record.args[i] : 0);
+  memcpy(out + 14 + LOG_MAX_ARGS * 4, record.str, LOG_STR_SIZE);
+  return FRAME_SIZE;
+}
+#endif
+
+size_t render(const LogRecord& record, char* buf, size_t len) {
+#ifdef LOG_BINARY
+  (void)len;
+  return renderBinary(record, buf);
+#else
+  return renderText(record, buf, len);
+#endif
+}
+
+// laporan record yang dibuang diformat seperti record biasa
+bool takeDropReport(LogRecord& record) {
+  uint32_t dropped = droppedCount.load(std::memory_order_relaxed);
+  if (dropped == droppedReported) return false;
+
+  record.fmt = "log: %lu pesan dibuang, ring penuh";
+  record.timestamp = nowMs();
+  record.level = LOG_LEVEL_WARN;
+  record.argc = 0;
+  record.types = 0;
+  record.strLen = 0;
+  Log::detail::put(record, LogArg::UINT, dropped - droppedReported);
+  droppedReported = dropped;
+  return true;
+}
+
+#ifdef ESP32
+void task_logDrain(void*) {
+  while (true) {
+    Log::drain();
+    vTaskDelay(LOG_DRAIN_INTERVAL / portTICK_PERIOD_MS);
+  }
+}
+#endif
+}  // namespace
+
+bool Log::push(LogRecord& record) {
+  record.timestamp = nowMs();
+
+  uint32_t pos = head.load(std::memory_order_relaxed);
+  while (true) {
+    uint32_t index = pos & (LOG_RING_SIZE - 1);
+    int32_t diff = static_cast<int32_t>(cellSeq(index) - pos);
+
+    if (diff == 0) {
+      if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+        break;
+    } else if (diff < 0) {
+      // ring penuh, pemanggil tidak pernah menunggu drain
+      droppedCount.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    } else {
+      pos = head.load(std::memory_order_relaxed);
+    }
+  }
+
+  uint32_t index = pos & (LOG_RING_SIZE - 1);
+  ring[index].record = record;
+  setCellSeq(index, pos + 1);
+  return true;
+}
+
+size_t Log::drain(size_t maxRecords) {
+  size_t done = 0;
+
+  while (true) {
+    // sisa baris sebelumnya ditulis sebatas ruang FIFO UART
+    if (lineSent < lineLen) {
+      size_t room = uartRoom();
+      if (room == 0) break;
+      size_t n = lineLen - lineSent;
+      if (n > room) n = room;
+      uartWrite(line + lineSent, n);
+      lineSent += n;
+      if (lineSent < lineLen) break;
+    }
+
+    if (done >= maxRecords) break;
+
+    LogRecord record;
+    if (!takeDropReport(record) && !pop(record)) break;
+
+    lineLen = render(record, line, sizeof(line));
+    lineSent = 0;
+    writtenCount++;
+    done++;
+  }
+
+  return done;
+}
+
+void Log::flush() {
+  while (drain() > 0 || lineSent < lineLen) {
+#ifdef ARDUINO
+    yield();
+#endif
+  }
+#ifdef ARDUINO
+  Serial.flush();
+#endif
+}
+
+void Log::begin() {
+#ifdef ESP32
+  if (drainTask != nullptr) return;
+
+  TaskHandle_t handle = nullptr;
+  xTaskCreate(task_logDrain, "logDrain", LOG_TASK_STACK, nullptr,
+              tskIDLE_PRIORITY + 1, &handle);
+  drainTask = handle;
+#endif
+}
+
+void* Log::taskHandle() { return drainTask; }
+
+uint32_t Log::written() { return writtenCount; }
+
+uint32_t Log::dropped() {
+  return droppedCount.load(std::memory_order_relaxed);
+}
+
+size_t Log::formatMessage(const LogRecord& record, char* buf, size_t len) {
+  if (len == 0) return 0;
+
+  size_t pos = 0;
+  uint8_t argIndex = 0;
+  const char* p = record.fmt;
+
+  while (*p && pos < len - 1) {
+    if (*p != '%') {
+      buf[pos++] = *p++;
+      continue;
+    }
+    if (p[1] == '%') {
+      buf[pos++] = '%';
+      p += 2;
+      continue;
+    }
+
+    // flags, lebar dan presisi dipakai apa adanya, modifier panjang
+    // (h, l, z, ...) diganti sesuai tipe argumen yang tersimpan
+    const char* flags = p++;
+    while (*p && strchr("-+ #0123456789.", *p)) p++;
+    size_t flagsLen = p - flags;
+    while (*p && strchr("hlLqjzt", *p)) p++;
+    if (!*p) break;
+
+    char conv = *p++;
+    pos += formatArg(buf + pos, len - pos, flags, flagsLen, conv, record,
+                     argIndex++);
+  }
+
+  buf[pos] = '\0';
+  return pos;
+}
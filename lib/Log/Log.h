@@ -0,0 +1,199 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <type_traits>
+
+/**
+ * Logger asinkron. Pemanggil hanya menyalin alamat format string dan
+ * argumennya ke ring buffer lock-free (tanpa formatting, tanpa menunggu
+ * UART), lalu drain() yang berjalan di task/job prioritas rendah memformat
+ * dan menulis ke Serial sebatas ruang FIFO UART yang tersedia.
+ *
+ * Format string harus literal karena alamatnya dipakai sebagai ID pesan.
+ * Argumen string disalin ke record (maksimal LOG_STR_SIZE byte total).
+ * Dengan LOG_BINARY, drain() menulis record mentah yang dibaca oleh
+ * tools/log_decode.py bersama file ELF firmware.
+ */
+
+#define LOG_LEVEL_NONE 0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_WARN 2
+#define LOG_LEVEL_INFO 3
+#define LOG_LEVEL_DEBUG 4
+
+// level di atas LOG_LEVEL dibuang saat compile
+#ifndef LOG_LEVEL
+#ifdef DEBUG_LOG_ENABLE
+#define LOG_LEVEL LOG_LEVEL_DEBUG
+#else
+#define LOG_LEVEL LOG_LEVEL_INFO
+#endif
+#endif
+
+// jumlah record di ring buffer, harus pangkat 2
+#ifndef LOG_RING_SIZE
+#ifdef ESP32
+#define LOG_RING_SIZE 64
+#else
+#define LOG_RING_SIZE 32
+#endif
+#endif
+
+#define LOG_MAX_ARGS 4
+#define LOG_STR_SIZE 48
+#define LOG_LINE_SIZE 160
+#define LOG_DRAIN_INTERVAL 10  // ms
+#define LOG_TASK_STACK 3072
+
+static_assert((LOG_RING_SIZE & (LOG_RING_SIZE - 1)) == 0,
+              "LOG_RING_SIZE harus pangkat 2");
+
+enum class LogArg : uint8_t {
+  INT,
+  UINT,
+  FLOAT,
+  STR,  // nilai argumen adalah offset di LogRecord::str
+};
+
+struct LogRecord {
+  const char* fmt;  // alamat format string, sekaligus ID pesan
+  uint32_t timestamp;
+  uint8_t level;
+  uint8_t argc;
+  uint8_t types;  // LogArg, 2 bit per argumen
+  uint8_t strLen;
+  uint32_t args[LOG_MAX_ARGS];
+  char str[LOG_STR_SIZE];
+};
+
+namespace Log {
+// false jika ring penuh, record dibuang dan dihitung
+bool push(LogRecord& record);
+
+// format dan tulis record selama FIFO UART masih muat, return jumlah record
+size_t drain(size_t maxRecords = LOG_RING_SIZE);
+// tulis semua record dengan blocking, misal sebelum restart
+void flush();
+
+// ESP32: jalankan task drain prioritas rendah. ESP8266: drain() dipanggil
+// dari job scheduler setiap LOG_DRAIN_INTERVAL
+void begin();
+void* taskHandle();
+
+uint32_t written();
+uint32_t dropped();
+
+// format pesan record ke buf tanpa prefix, dipakai juga oleh simulator
+size_t formatMessage(const LogRecord& record, char* buf, size_t len);
+
+namespace detail {
+inline void put(LogRecord& record, LogArg type, uint32_t value) {
+  record.types |= static_cast<uint8_t>(type) << (record.argc * 2);
+  record.args[record.argc++] = value;
+}
+
+template <typename T>
+inline typename std::enable_if<std::is_integral<T>::value &&
+                               std::is_signed<T>::value>::type
+encode(LogRecord& record, T value) {
+  put(record, LogArg::INT, static_cast<uint32_t>(static_cast<int32_t>(value)));
+}
+
+template <typename T>
+inline typename std::enable_if<std::is_integral<T>::value &&
+                               std::is_unsigned<T>::value>::type
+encode(LogRecord& record, T value) {
+  put(record, LogArg::UINT, static_cast<uint32_t>(value));
+}
+
+template <typename T>
+inline typename std::enable_if<std::is_floating_point<T>::value>::type encode(
+    LogRecord& record, T value) {
+  float f = static_cast<float>(value);
+  uint32_t bits;
+  memcpy(&bits, &f, sizeof(bits));
+  put(record, LogArg::FLOAT, bits);
+}
+
+inline void encode(LogRecord& record, const char* value) {
+  // byte terakhir str selalu '\0' untuk string yang tidak muat
+  uint8_t offset = record.strLen;
+  if (offset >= LOG_STR_SIZE - 1) {
+    put(record, LogArg::STR, LOG_STR_SIZE - 1);
+    return;
+  }
+
+  if (!value) value = "(null)";
+  size_t n = strnlen(value, LOG_STR_SIZE - 1 - offset);
+  memcpy(record.str + offset, value, n);
+  record.str[offset + n] = '\0';
+  record.strLen = offset + n + 1;
+  put(record, LogArg::STR, offset);
+}
+
+// untuk %p, alamat dipotong ke 32 bit
+inline void encode(LogRecord& record, const void* value) {
+  put(record, LogArg::UINT,
+      static_cast<uint32_t>(reinterpret_cast<uintptr_t>(value)));
+}
+
+inline void encodeAll(LogRecord&) {}
+
+template <typename T, typename... Rest>
+inline void encodeAll(LogRecord& record, T first, Rest... rest) {
+  encode(record, first);
+  encodeAll(record, rest...);
+}
+}  // namespace detail
+
+template <typename... Args>
+inline void write(uint8_t level, const char* fmt, Args... args) {
+  static_assert(sizeof...(Args) <= LOG_MAX_ARGS, "argumen log terlalu banyak");
+
+  LogRecord record;
+  record.fmt = fmt;
+  record.level = level;
+  record.argc = 0;
+  record.types = 0;
+  record.strLen = 0;
+  record.str[LOG_STR_SIZE - 1] = '\0';
+  detail::encodeAll(record, args...);
+  push(record);
+}
+}  // namespace Log
+
+// "" fmt memastikan format string adalah literal
+#if LOG_LEVEL >= LOG_LEVEL_ERROR
+#define LOG_E(fmt, ...) Log::write(LOG_LEVEL_ERROR, "" fmt, ##__VA_ARGS__)
+#else
+#define LOG_E(...) \
+  do {             \
+  } while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_WARN
+#define LOG_W(fmt, ...) Log::write(LOG_LEVEL_WARN, "" fmt, ##__VA_ARGS__)
+#else
+#define LOG_W(...) \
+  do {             \
+  } while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+#define LOG_I(fmt, ...) Log::write(LOG_LEVEL_INFO, "" fmt, ##__VA_ARGS__)
+#else
+#define LOG_I(...) \
+  do {             \
+  } while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+#define LOG_D(fmt, ...) Log::write(LOG_LEVEL_DEBUG, "" fmt, ##__VA_ARGS__)
+#else
+#define LOG_D(...) \
+  do {             \
+  } while (0)
+#endif
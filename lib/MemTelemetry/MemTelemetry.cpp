@@ -0,0 +1,279 @@
+#include "MemTelemetry.h"
+
+#include <Trace.h>
+#include <Utils.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#endif
+
+namespace {
+MemSample currentSample = {0, 0, 0};
+MemSample bootMinimum = {UINT32_MAX, UINT32_MAX, 0};
+MemSample rolling[MEM_ROLLING_BUCKETS];
+uint8_t rollingIndex = 0;
+uint32_t rollingStart = 0;
+bool hasSample = false;
+
+TaskStackInfo tasks[MEM_MAX_TASKS];
+uint8_t tasksRegistered = 0;
+
+SubsystemCounter counters[static_cast<uint8_t>(MemSubsystem::COUNT)];
+
+bool isDegraded = false;
+uint32_t degradeEntered = 0;
+uint32_t degradeEnterBytes = MEM_DEGRADE_ENTER_BYTES;
+
+const char* const SUBSYSTEM_NAMES[] = {"telek", "mqtt", "sensor"};
+static_assert(sizeof(SUBSYSTEM_NAMES) / sizeof(SUBSYSTEM_NAMES[0]) ==
+                  static_cast<size_t>(MemSubsystem::COUNT),
+              "nama subsistem tidak lengkap");
+
+uint32_t nowMs() {
+#ifdef ARDUINO
+  return millis();
+#else
+  return 0;
+#endif
+}
+
+uint32_t largestFreeBlock() {
+#if defined(ESP32)
+  return ESP.getMaxAllocHeap();
+#elif defined(ESP8266)
+  return ESP.getMaxFreeBlockSize();
+#else
+  return 0;
+#endif
+}
+
+// ukuran heap di trace disimpan dalam satuan 16 byte
+inline uint16_t traceBytes(uint32_t bytes) {
+  return bytes / 16 < 0xFFFF ? bytes / 16 : 0xFFFF;
+}
+
+void resetBucket(MemSample& bucket) {
+  bucket.freeHeap = UINT32_MAX;
+  bucket.largestBlock = UINT32_MAX;
+  bucket.fragmentation = 0;
+}
+
+void keepMinimum(MemSample& target, const MemSample& sample) {
+  if (sample.freeHeap < target.freeHeap) target.freeHeap = sample.freeHeap;
+  if (sample.largestBlock < target.largestBlock)
+    target.largestBlock = sample.largestBlock;
+  // untuk fragmentasi yang disimpan nilai terburuk
+  if (sample.fragmentation > target.fragmentation)
+    target.fragmentation = sample.fragmentation;
+}
+
+uint32_t stackHighWaterMark(const TaskStackInfo& info) {
+#if defined(ESP32)
+  // pada ESP-IDF satuan high-water-mark adalah byte
+  return uxTaskGetStackHighWaterMark(static_cast<TaskHandle_t>(info.handle));
+#elif defined(ESP8266)
+  return ESP.getFreeContStack();
+#else
+  (void)info;
+  return 0;
+#endif
+}
+
+}  // namespace
+
+uint32_t MemTelemetry::freeHeap() {
+#ifdef ARDUINO
+  return ESP.getFreeHeap();
+#else
+  return 0;
+#endif
+}
+
+bool MemTelemetry::registerTask(const char* name, void* handle,
+                                uint32_t stackSize) {
+  if (tasksRegistered >= MEM_MAX_TASKS) return false;
+#ifdef ESP32
+  // handle NULL berarti task pemanggil, hasilnya akan salah
+  if (handle == nullptr) return false;
+#endif
+
+  TaskStackInfo& info = tasks[tasksRegistered++];
+  info.name = name;
+  info.handle = handle;
+  info.stackSize = stackSize;
+  info.minFree = stackSize;
+  return true;
+}
+
+void MemTelemetry::sample() {
+  MemSample sample;
+  sample.freeHeap = freeHeap();
+  sample.largestBlock = largestFreeBlock();
+  sample.fragmentation =
+      sample.freeHeap > 0
+          ? 100 - static_cast<uint8_t>(
+                      static_cast<uint64_t>(sample.largestBlock) * 100 /
+                      sample.freeHeap)
+          : 0;
+
+  uint32_t now = nowMs();
+  if (!hasSample) {
+    for (auto& bucket : rolling) resetBucket(bucket);
+    rollingStart = now;
+    hasSample = true;
+  }
+
+  if (now - rollingStart >= MEM_ROLLING_BUCKET_MS) {
+    rollingIndex = (rollingIndex + 1) % MEM_ROLLING_BUCKETS;
+    resetBucket(rolling[rollingIndex]);
+    rollingStart = now;
+  }
+
+  // hanya titik terendah baru yang dicatat agar trace tidak cepat penuh
+  if (sample.freeHeap < bootMinimum.freeHeap)
+    TRACE(HEAP_LOW, sample.fragmentation, traceBytes(sample.freeHeap));
+
+  currentSample = sample;
+  keepMinimum(bootMinimum, sample);
+  keepMinimum(rolling[rollingIndex], sample);
+
+  for (uint8_t i = 0; i < tasksRegistered; i++) {
+    uint32_t hwm = stackHighWaterMark(tasks[i]);
+    if (hwm < tasks[i].minFree) tasks[i].minFree = hwm;
+  }
+
+  // histeresis agar mode degrade tidak bolak-balik di sekitar batas
+  if (sample.largestBlock == 0) return;
+  uint32_t exitBytes = degradeEnterBytes + MEM_DEGRADE_HYSTERESIS_BYTES;
+  if (!isDegraded && sample.largestBlock < degradeEnterBytes) {
+    isDegraded = true;
+    degradeEntered++;
+    TRACE(DEGRADE, 1, traceBytes(sample.largestBlock));
+  } else if (isDegraded && sample.largestBlock > exitBytes) {
+    isDegraded = false;
+    TRACE(DEGRADE, 0, traceBytes(sample.largestBlock));
+  }
+}
+
+const MemSample& MemTelemetry::current() { return currentSample; }
+
+const MemSample& MemTelemetry::minimumSinceBoot() { return bootMinimum; }
+
+MemSample MemTelemetry::rollingMinimum() {
+  MemSample result;
+  resetBucket(result);
+  for (const auto& bucket : rolling) keepMinimum(result, bucket);
+  return result;
+}
+
+const TaskStackInfo* MemTelemetry::task(uint8_t index) {
+  return index < tasksRegistered ? &tasks[index] : nullptr;
+}
+
+uint8_t MemTelemetry::taskCount() { return tasksRegistered; }
+
+void MemTelemetry::countAlloc(MemSubsystem subsystem, uint32_t bytes) {
+  SubsystemCounter& counter = counters[static_cast<uint8_t>(subsystem)];
+  counter.allocs++;
+  counter.bytes += bytes;
+}
+
+void MemTelemetry::countNetHeap(MemSubsystem subsystem, int32_t delta) {
+  counters[static_cast<uint8_t>(subsystem)].netHeap += delta;
+}
+
+const SubsystemCounter& MemTelemetry::counter(MemSubsystem subsystem) {
+  return counters[static_cast<uint8_t>(subsystem)];
+}
+
+bool MemTelemetry::degraded() { return isDegraded; }
+
+uint32_t MemTelemetry::degradeCount() { return degradeEntered; }
+
+void MemTelemetry::setDegradeThreshold(uint32_t enterBytes) {
+  degradeEnterBytes = enterBytes;
+}
+
+uint32_t MemTelemetry::degradeThreshold() { return degradeEnterBytes; }
+
+size_t MemTelemetry::format(char* buf, size_t len) {
+  if (len == 0) return 0;
+  buf[0] = '\0';
+
+  MemSample hour = rollingMinimum();
+  size_t pos = append(buf, len, 0,
+                      "heap     free %lu blok %lu frag %u%%\n"
+                      "min 1jam free %lu blok %lu frag %u%%\n"
+                      "min boot free %lu blok %lu frag %u%%\n"
+                      "degrade  %s (%lu kali) batas %lu\n",
+                      static_cast<unsigned long>(currentSample.freeHeap),
+                      static_cast<unsigned long>(currentSample.largestBlock),
+                      currentSample.fragmentation,
+                      static_cast<unsigned long>(hour.freeHeap),
+                      static_cast<unsigned long>(hour.largestBlock),
+                      hour.fragmentation,
+                      static_cast<unsigned long>(bootMinimum.freeHeap),
+                      static_cast<unsigned long>(bootMinimum.largestBlock),
+                      bootMinimum.fragmentation, isDegraded ? "AKTIF" : "tidak",
+                      static_cast<unsigned long>(degradeEntered),
+                      static_cast<unsigned long>(degradeEnterBytes));
+
+  for (uint8_t i = 0; i < tasksRegistered; i++) {
+    pos = append(buf, len, pos, "stack %-14s %lu/%lu\n", tasks[i].name,
+                 static_cast<unsigned long>(tasks[i].stackSize -
+                                            tasks[i].minFree),
+                 static_cast<unsigned long>(tasks[i].stackSize));
+  }
+
+  for (uint8_t i = 0; i < static_cast<uint8_t>(MemSubsystem::COUNT); i++) {
+    if (counters[i].allocs == 0 && counters[i].netHeap == 0) continue;
+    pos = append(buf, len, pos, "alloc %-6s n %lu %lu B net %ld B\n",
+                 SUBSYSTEM_NAMES[i],
+                 static_cast<unsigned long>(counters[i].allocs),
+                 static_cast<unsigned long>(counters[i].bytes),
+                 static_cast<long>(counters[i].netHeap));
+  }
+
+  return pos;
+}
+
+size_t MemTelemetry::toJson(char* buf, size_t len) {
+  if (len == 0) return 0;
+  buf[0] = '\0';
+
+  MemSample hour = rollingMinimum();
+  size_t pos = append(
+      buf, len, 0,
+      "{\"type\":\"mem\",\"free\":%lu,\"largest\":%lu,\"frag\":%u,"
+      "\"min_hour\":{\"free\":%lu,\"largest\":%lu},"
+      "\"min_boot\":{\"free\":%lu,\"largest\":%lu},"
+      "\"degraded\":%s,\"degrade_count\":%lu,\"stacks\":{",
+      static_cast<unsigned long>(currentSample.freeHeap),
+      static_cast<unsigned long>(currentSample.largestBlock),
+      currentSample.fragmentation, static_cast<unsigned long>(hour.freeHeap),
+      static_cast<unsigned long>(hour.largestBlock),
+      static_cast<unsigned long>(bootMinimum.freeHeap),
+      static_cast<unsigned long>(bootMinimum.largestBlock),
+      isDegraded ? "true" : "false",
+      static_cast<unsigned long>(degradeEntered));
+
+  for (uint8_t i = 0; i < tasksRegistered; i++) {
+    pos = append(buf, len, pos, "%s\"%s\":{\"size\":%lu,\"min_free\":%lu}",
+                 i == 0 ? "" : ",", tasks[i].name,
+                 static_cast<unsigned long>(tasks[i].stackSize),
+                 static_cast<unsigned long>(tasks[i].minFree));
+  }
+
+  pos = append(buf, len, pos, "},\"alloc\":{");
+  for (uint8_t i = 0; i < static_cast<uint8_t>(MemSubsystem::COUNT); i++) {
+    pos = append(buf, len, pos, "%s\"%s\":{\"n\":%lu,\"bytes\":%lu,\"net\":%ld}",
+                 i == 0 ? "" : ",", SUBSYSTEM_NAMES[i],
+                 static_cast<unsigned long>(counters[i].allocs),
+                 static_cast<unsigned long>(counters[i].bytes),
+                 static_cast<long>(counters[i].netHeap));
+  }
+
+  return append(buf, len, pos, "}}");
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Telemetri memori untuk soak test: free heap, blok bebas terbesar,
+ * fragmentasi, stack high-water-mark per task dan counter alokasi per
+ * subsistem. Jika blok terbesar turun di bawah batas, mode degrade aktif
+ * supaya firmware bisa menghentikan pekerjaan yang butuh alokasi besar
+ * (misal koneksi TLS) sebelum alokasi benar-benar gagal.
+ */
+
+// batas awal sebelum ukuran buffer TLS diketahui, diganti lewat
+// setDegradeThreshold() setelah Telek::probeTls() (lihat tlsBlockNeeded())
+#ifndef MEM_DEGRADE_ENTER_BYTES
+#ifdef ESP32
+#define MEM_DEGRADE_ENTER_BYTES 40000  // kebutuhan satu sesi mbedTLS
+#else
+#define MEM_DEGRADE_ENTER_BYTES 18000  // buffer BearSSL 16K RX + 512 TX
+#endif
+#endif
+
+// mode degrade selesai setelah blok terbesar melewati batas + histeresis
+#ifndef MEM_DEGRADE_HYSTERESIS_BYTES
+#define MEM_DEGRADE_HYSTERESIS_BYTES 4096
+#endif
+
+#define MEM_MAX_TASKS 6
+// nilai minimum bergulir disimpan per 5 menit selama 1 jam terakhir
+#define MEM_ROLLING_BUCKETS 12
+#define MEM_ROLLING_BUCKET_MS (5UL * 60 * 1000)
+
+enum class MemSubsystem : uint8_t {
+  TELEK,
+  MQTT,
+  SENSOR,
+  COUNT,
+};
+
+struct MemSample {
+  uint32_t freeHeap;
+  uint32_t largestBlock;
+  uint8_t fragmentation;  // persen, 0 = tidak terfragmentasi
+};
+
+struct TaskStackInfo {
+  const char* name;
+  void* handle;  // TaskHandle_t pada ESP32
+  uint32_t stackSize;
+  uint32_t minFree;  // stack high-water-mark dalam byte
+};
+
+struct SubsystemCounter {
+  uint32_t allocs;
+  uint32_t bytes;
+  int32_t netHeap;  // selisih free heap setelah MEM_SCOPE, indikasi leak
+};
+
+namespace MemTelemetry {
+// pada ESP32 handle tidak boleh NULL, gunakan xTaskGetCurrentTaskHandle()
+// pada ESP8266 hanya ada satu stack (cont), handle diabaikan
+bool registerTask(const char* name, void* handle, uint32_t stackSize);
+
+void sample();
+const MemSample& current();
+const MemSample& minimumSinceBoot();
+// minimum selama satu jam terakhir
+MemSample rollingMinimum();
+
+const TaskStackInfo* task(uint8_t index);
+uint8_t taskCount();
+
+void countAlloc(MemSubsystem subsystem, uint32_t bytes);
+void countNetHeap(MemSubsystem subsystem, int32_t delta);
+const SubsystemCounter& counter(MemSubsystem subsystem);
+
+bool degraded();
+uint32_t degradeCount();
+// blok bebas terbesar minimum sebelum mode degrade aktif
+void setDegradeThreshold(uint32_t enterBytes);
+uint32_t degradeThreshold();
+
+uint32_t freeHeap();
+
+size_t format(char* buf, size_t len);
+size_t toJson(char* buf, size_t len);
+}  // namespace MemTelemetry
+
+// mencatat selisih free heap sebelum dan sesudah blok kode
+class MemScope {
+ private:
+  MemSubsystem m_subsystem;
+  uint32_t m_before;
+
+ public:
+  explicit MemScope(MemSubsystem subsystem)
+      : m_subsystem(subsystem), m_before(MemTelemetry::freeHeap()) {}
+  ~MemScope() {
+    MemTelemetry::countNetHeap(
+        m_subsystem, static_cast<int32_t>(m_before - MemTelemetry::freeHeap()));
+  }
+
+  MemScope(const MemScope&) = delete;
+  MemScope& operator=(const MemScope&) = delete;
+};
+
+#define MEM_CONCAT_(a, b) a##b
+#define MEM_CONCAT(a, b) MEM_CONCAT_(a, b)
+#define MEM_SCOPE(subsystem) \
+  MemScope MEM_CONCAT(memScope_, __LINE__)(MemSubsystem::subsystem)
+#define MEM_COUNT_ALLOC(subsystem, bytes) \
+  MemTelemetry::countAlloc(MemSubsystem::subsystem, bytes)
@@ -0,0 +1,147 @@
+#include "SampleLog.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+namespace {
+int16_t toCenti(float value) {
+  if (isnan(value)) return SAMPLE_LOG_INVALID;
+  float centi = roundf(value * 100);
+  if (centi > INT16_MAX) return INT16_MAX;
+  if (centi <= SAMPLE_LOG_INVALID) return SAMPLE_LOG_INVALID + 1;
+  return static_cast<int16_t>(centi);
+}
+
+// "27.25", kosong jika tidak valid
+int formatCenti(char* buf, size_t len, int16_t centi) {
+  if (centi == SAMPLE_LOG_INVALID) return snprintf(buf, len, ",");
+  return snprintf(buf, len, ",%.2f", centi / 100.0f);
+}
+}  // namespace
+
+// constructor
+SampleLog::SampleLog() : m_records{}, m_next(0) {
+#ifdef ESP32
+  m_lock = portMUX_INITIALIZER_UNLOCKED;
+#endif
+}
+
+void SampleLog::lock() const {
+#ifdef ESP32
+  portENTER_CRITICAL(&m_lock);
+#endif
+}
+
+void SampleLog::unlock() const {
+#ifdef ESP32
+  portEXIT_CRITICAL(&m_lock);
+#endif
+}
+
+void SampleLog::add(uint8_t tank, float temp, float level, bool led,
+                    bool pump, uint32_t uptimeS) {
+  SampleRecord record = {uptimeS, toCenti(temp), toCenti(level), tank,
+                         static_cast<uint8_t>((led ? 1 : 0) | (pump ? 2 : 0))};
+  lock();
+  m_records[m_next % SAMPLE_LOG_SIZE] = record;
+  m_next++;
+  unlock();
+}
+
+uint32_t SampleLog::first() const {
+  lock();
+  uint32_t next = m_next;
+  unlock();
+  return next > SAMPLE_LOG_SIZE ? next - SAMPLE_LOG_SIZE : 0;
+}
+
+uint32_t SampleLog::end() const {
+  lock();
+  uint32_t next = m_next;
+  unlock();
+  return next;
+}
+
+bool SampleLog::get(uint32_t seq, SampleRecord& record) const {
+  lock();
+  bool valid = seq < m_next && m_next - seq <= SAMPLE_LOG_SIZE;
+  if (valid) record = m_records[seq % SAMPLE_LOG_SIZE];
+  unlock();
+  return valid;
+}
+
+// constructor
+SampleLogCsv::SampleLogCsv()
+    : m_log(nullptr),
+      m_seq(0),
+      m_end(0),
+      m_nowS(0),
+      m_epoch(0),
+      m_line{0},
+      m_linePos(0),
+      m_lineLen(0),
+      m_headerDone(false),
+      m_rows(0),
+      m_skipped(0) {}
+
+void SampleLogCsv::begin(const SampleLog& log, uint32_t uptimeS,
+                         time_t epoch) {
+  m_log = &log;
+  m_seq = log.first();
+  m_end = log.end();
+  m_nowS = uptimeS;
+  m_epoch = epoch;
+  m_linePos = m_lineLen = 0;
+  m_headerDone = false;
+  m_rows = m_skipped = 0;
+}
+
+bool SampleLogCsv::nextLine() {
+  int len;
+  if (!m_headerDone) {
+    m_headerDone = true;
+    len = snprintf(m_line, sizeof(m_line), "%s,tank,suhu_c,tinggi_pct,led,"
+                                           "pompa\n",
+                   m_epoch ? "waktu_unix" : "uptime_s");
+  } else {
+    SampleRecord record;
+    while (m_seq < m_end && !m_log->get(m_seq, record)) {
+      m_seq++;
+      m_skipped++;
+    }
+    if (m_seq >= m_end) return false;
+    m_seq++;
+    m_rows++;
+
+    uint32_t stamp = m_epoch ? m_epoch - (m_nowS - record.uptimeS)
+                             : record.uptimeS;
+    len = snprintf(m_line, sizeof(m_line), "%lu,%u",
+                   static_cast<unsigned long>(stamp), record.tank + 1);
+    len += formatCenti(m_line + len, sizeof(m_line) - len, record.temp);
+    len += formatCenti(m_line + len, sizeof(m_line) - len, record.level);
+    len += snprintf(m_line + len, sizeof(m_line) - len, ",%u,%u\n",
+                    record.relays & 1, (record.relays >> 1) & 1);
+  }
+  m_linePos = 0;
+  m_lineLen = len < static_cast<int>(sizeof(m_line)) ? len
+                                                       : sizeof(m_line) - 1;
+  return true;
+}
+
+size_t SampleLogCsv::read(uint8_t* buf, size_t len) {
+  size_t total = 0;
+  while (total < len) {
+    if (m_linePos >= m_lineLen && !nextLine()) break;
+    size_t n = m_lineLen - m_linePos;
+    if (n > len - total) n = len - total;
+    memcpy(buf + total, m_line + m_linePos, n);
+    m_linePos += n;
+    total += n;
+  }
+  return total;
+}
+
+size_t SampleLogCsv::reader(uint8_t* buf, size_t len, void* ctx) {
+  return static_cast<SampleLogCsv*>(ctx)->read(buf, len);
+}
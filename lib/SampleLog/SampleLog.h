@@ -0,0 +1,97 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+
+#ifdef ESP32
+#include <freertos/FreeRTOS.h>
+#endif
+
+/**
+ * Log sampel sensor dan relay di RAM untuk diunduh sebagai CSV (/unduh_log).
+ * Ring berukuran tetap, record terlama ditimpa. Setiap record diberi nomor
+ * urut sehingga pembaca yang berjalan lebih lama dari interval sampling
+ * (upload dokumen) bisa mendeteksi record yang sudah tertimpa dan
+ * melewatinya.
+ *
+ * Nilai disimpan dalam seperseratus (suhu 27.25°C = 2725), 12 byte per
+ * record: 384 record = 4.5 KB, cukup untuk 6 jam satu tank dengan satu
+ * sampel per menit.
+ */
+
+#ifndef SAMPLE_LOG_SIZE
+#define SAMPLE_LOG_SIZE 384
+#endif
+
+// nilai NaN (sensor terputus) disimpan sebagai ini dan ditulis kosong
+#define SAMPLE_LOG_INVALID INT16_MIN
+
+struct SampleRecord {
+  uint32_t uptimeS;
+  int16_t temp;   // x100 °C
+  int16_t level;  // x100 %
+  uint8_t tank;
+  uint8_t relays;  // bit0 LED, bit1 pompa
+};
+
+class SampleLog {
+ private:
+  SampleRecord m_records[SAMPLE_LOG_SIZE];
+  uint32_t m_next;  // nomor urut record berikutnya
+#ifdef ESP32
+  mutable portMUX_TYPE m_lock;
+#endif
+
+ public:
+  SampleLog();  // constructor
+
+  void add(uint8_t tank, float temp, float level, bool led, bool pump,
+           uint32_t uptimeS);
+
+  // rentang nomor urut [first, end) yang masih ada di ring
+  uint32_t first() const;
+  uint32_t end() const;
+  // false jika record sudah tertimpa atau belum ditulis
+  bool get(uint32_t seq, SampleRecord& record) const;
+
+ private:
+  void lock() const;
+  void unlock() const;
+};
+
+/**
+ * Pembaca CSV bertahap untuk Telek::sendDocument: satu baris diformat ke
+ * buffer kecil setiap kali buffer habis. Record yang ditulis setelah
+ * begin() tidak ikut, record yang tertimpa selama upload dilewati.
+ */
+class SampleLogCsv {
+ private:
+  const SampleLog* m_log;
+  uint32_t m_seq;
+  uint32_t m_end;
+  uint32_t m_nowS;
+  time_t m_epoch;  // 0: jam belum tersinkron, kolom pertama uptime
+  char m_line[64];
+  uint8_t m_linePos;
+  uint8_t m_lineLen;
+  bool m_headerDone;
+  uint32_t m_rows;
+  uint32_t m_skipped;
+
+ public:
+  SampleLogCsv();  // constructor
+
+  // uptimeS dan epoch saat ini untuk mengubah uptime record ke waktu unix
+  void begin(const SampleLog& log, uint32_t uptimeS, time_t epoch);
+  size_t read(uint8_t* buf, size_t len);
+
+  uint32_t rows() const { return m_rows; }
+  uint32_t skipped() const { return m_skipped; }
+
+  // DocumentReader dengan ctx SampleLogCsv*
+  static size_t reader(uint8_t* buf, size_t len, void* ctx);
+
+ private:
+  bool nextLine();
+};
@@ -0,0 +1,416 @@
+#include "Scheduler.h"
+
+#include <Trace.h>
+#include <string.h>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <chrono>
+#include <thread>
+#endif
+
+#define WHEEL_MASK (SCHED_WHEEL_SLOTS - 1)
+#define LEVEL_SPAN(level) (1UL << (SCHED_WHEEL_BITS * ((level) + 1)))
+
+namespace {
+const int8_t LEVEL_READY = -1;
+const int8_t LEVEL_NONE = -2;
+
+inline uint8_t lowestBit(uint64_t mask) {
+  return static_cast<uint8_t>(__builtin_ctzll(mask));
+}
+
+inline uint64_t rotateRight(uint64_t mask, uint8_t n) {
+  n &= 63;
+  return n == 0 ? mask : (mask >> n) | (mask << (64 - n));
+}
+}  // namespace
+
+uint32_t Scheduler::nowMs() {
+#ifdef ARDUINO
+  return millis();
+#else
+  using namespace std::chrono;
+  return static_cast<uint32_t>(
+      duration_cast<milliseconds>(steady_clock::now().time_since_epoch())
+          .count());
+#endif
+}
+
+uint32_t Scheduler::nowUs() {
+#ifdef ARDUINO
+  return micros();
+#else
+  using namespace std::chrono;
+  return static_cast<uint32_t>(
+      duration_cast<microseconds>(steady_clock::now().time_since_epoch())
+          .count());
+#endif
+}
+
+// constructor
+Scheduler::Scheduler()
+    : m_readyHead(INVALID_JOB),
+      m_readyTail(INVALID_JOB),
+      m_now(0),
+      m_started(false) {
+  memset(m_jobs, 0, sizeof(m_jobs));
+  memset(m_slots, INVALID_JOB, sizeof(m_slots));
+  memset(m_occupied, 0, sizeof(m_occupied));
+  for (auto& job : m_jobs) job.level = LEVEL_NONE;
+}
+
+Scheduler::JobId Scheduler::allocate(const char* name, JobKind kind,
+                                     uint32_t periodMs, void* arg) {
+  if (!m_started) {
+    m_now = nowMs();
+    m_started = true;
+  }
+
+  for (JobId id = 0; id < SCHED_MAX_JOBS; id++) {
+    Job& job = m_jobs[id];
+    if (job.active) continue;
+
+    memset(&job, 0, sizeof(job));
+    job.name = name;
+    job.kind = kind;
+    job.active = true;
+    job.level = LEVEL_NONE;
+    job.next = INVALID_JOB;
+    job.periodMs = periodMs > 0 ? periodMs : 1;
+    job.arg = arg;
+    return id;
+  }
+
+  return INVALID_JOB;
+}
+
+Scheduler::JobId Scheduler::scheduleFixedRate(const char* name,
+                                              uint32_t periodMs, JobFunc func,
+                                              void* arg,
+                                              uint32_t initialDelayMs) {
+  JobId id = allocate(name, JobKind::FIXED_RATE, periodMs, arg);
+  if (id == INVALID_JOB) return id;
+
+  m_jobs[id].func = func;
+  m_jobs[id].deadline = nowMs() + initialDelayMs;
+  insert(id);
+  return id;
+}
+
+Scheduler::JobId Scheduler::scheduleFixedDelay(const char* name,
+                                               uint32_t periodMs, JobFunc func,
+                                               void* arg,
+                                               uint32_t initialDelayMs) {
+  JobId id = allocate(name, JobKind::FIXED_DELAY, periodMs, arg);
+  if (id == INVALID_JOB) return id;
+
+  m_jobs[id].func = func;
+  m_jobs[id].deadline = nowMs() + initialDelayMs;
+  insert(id);
+  return id;
+}
+
+Scheduler::JobId Scheduler::spawn(const char* name, CoroutineFunc func,
+                                  void* arg, uint32_t initialDelayMs) {
+  JobId id = allocate(name, JobKind::COROUTINE, 0, arg);
+  if (id == INVALID_JOB) return id;
+
+  m_jobs[id].coFunc = func;
+  m_jobs[id].deadline = nowMs() + initialDelayMs;
+  insert(id);
+  return id;
+}
+
+bool Scheduler::cancel(JobId id) {
+  if (!isActive(id)) return false;
+
+  unlink(id);
+  m_jobs[id].active = false;
+  return true;
+}
+
+bool Scheduler::setPeriod(JobId id, uint32_t periodMs) {
+  if (!isActive(id) || m_jobs[id].kind == JobKind::COROUTINE) return false;
+
+  Job& job = m_jobs[id];
+  job.periodMs = periodMs > 0 ? periodMs : 1;
+
+  // job yang sedang berjalan akan dijadwalkan ulang oleh execute()
+  if (job.level == LEVEL_NONE) return true;
+
+  unlink(id);
+  job.deadline = nowMs() + job.periodMs;
+  insert(id);
+  return true;
+}
+
+bool Scheduler::trigger(JobId id) {
+  if (!isActive(id)) return false;
+  if (m_jobs[id].level == LEVEL_READY) return true;
+
+  unlink(id);
+  m_jobs[id].deadline = nowMs();
+  pushReady(id);
+  return true;
+}
+
+bool Scheduler::setTraced(JobId id, bool traced) {
+  if (!isActive(id)) return false;
+
+  m_jobs[id].traced = traced;
+  return true;
+}
+
+uint8_t Scheduler::jobCount() const {
+  uint8_t count = 0;
+  for (const auto& job : m_jobs) count += job.active ? 1 : 0;
+  return count;
+}
+
+void Scheduler::resetStats() {
+  for (auto& job : m_jobs) memset(&job.stats, 0, sizeof(job.stats));
+}
+
+void Scheduler::pushReady(JobId id) {
+  Job& job = m_jobs[id];
+  job.level = LEVEL_READY;
+  job.next = INVALID_JOB;
+
+  if (m_readyTail == INVALID_JOB)
+    m_readyHead = id;
+  else
+    m_jobs[m_readyTail].next = id;
+  m_readyTail = id;
+}
+
+void Scheduler::insert(JobId id) {
+  Job& job = m_jobs[id];
+  int32_t delta = static_cast<int32_t>(job.deadline - m_now);
+
+  if (delta <= 0) {
+    pushReady(id);
+    return;
+  }
+
+  // deadline di luar jangkauan wheel ditaruh di level tertinggi, saat turun ke
+  // level 0 deadline aslinya akan dicek ulang
+  uint32_t target = job.deadline;
+  uint8_t level = 0;
+  while (level < SCHED_WHEEL_LEVELS - 1 &&
+         static_cast<uint32_t>(delta) >= LEVEL_SPAN(level))
+    level++;
+  if (static_cast<uint32_t>(delta) >= LEVEL_SPAN(level))
+    target = m_now + LEVEL_SPAN(level) - 1;
+
+  uint8_t slot = (target >> (SCHED_WHEEL_BITS * level)) & WHEEL_MASK;
+
+  job.level = level;
+  job.slot = slot;
+  job.next = m_slots[level][slot];
+  m_slots[level][slot] = id;
+  m_occupied[level] |= 1ULL << slot;
+}
+
+void Scheduler::unlink(JobId id) {
+  Job& job = m_jobs[id];
+
+  if (job.level == LEVEL_NONE) return;
+
+  JobId* head = job.level == LEVEL_READY ? &m_readyHead
+                                         : &m_slots[job.level][job.slot];
+  JobId prev = INVALID_JOB;
+  for (JobId cur = *head; cur != INVALID_JOB; cur = m_jobs[cur].next) {
+    if (cur != id) {
+      prev = cur;
+      continue;
+    }
+
+    if (prev == INVALID_JOB)
+      *head = job.next;
+    else
+      m_jobs[prev].next = job.next;
+    break;
+  }
+
+  if (job.level == LEVEL_READY) {
+    if (m_readyTail == id) m_readyTail = prev;
+  } else if (*head == INVALID_JOB) {
+    m_occupied[job.level] &= ~(1ULL << job.slot);
+  }
+
+  job.level = LEVEL_NONE;
+  job.next = INVALID_JOB;
+}
+
+void Scheduler::cascade(uint8_t level) {
+  uint8_t slot = (m_now >> (SCHED_WHEEL_BITS * level)) & WHEEL_MASK;
+  JobId id = m_slots[level][slot];
+
+  m_slots[level][slot] = INVALID_JOB;
+  m_occupied[level] &= ~(1ULL << slot);
+
+  while (id != INVALID_JOB) {
+    JobId next = m_jobs[id].next;
+    insert(id);
+    id = next;
+  }
+}
+
+void Scheduler::advance(uint32_t now) {
+  while (static_cast<int32_t>(now - m_now) > 0) {
+    if (m_occupied[0] == 0) {
+      // level 0 kosong, lompat langsung ke tick sebelum wrap berikutnya
+      bool hasHigher = false;
+      for (uint8_t level = 1; level < SCHED_WHEEL_LEVELS; level++)
+        hasHigher |= m_occupied[level] != 0;
+
+      uint32_t beforeWrap = m_now | WHEEL_MASK;
+      if (!hasHigher || static_cast<int32_t>(now - beforeWrap) <= 0) {
+        m_now = now;
+        break;
+      }
+      m_now = beforeWrap;
+    }
+
+    m_now++;
+
+    if ((m_now & WHEEL_MASK) == 0) {
+      uint8_t top = 1;
+      while (top < SCHED_WHEEL_LEVELS - 1 &&
+             ((m_now >> (SCHED_WHEEL_BITS * top)) & WHEEL_MASK) == 0)
+        top++;
+      for (uint8_t level = top; level >= 1; level--) cascade(level);
+    }
+
+    uint8_t slot = m_now & WHEEL_MASK;
+    if (!(m_occupied[0] & (1ULL << slot))) continue;
+
+    JobId id = m_slots[0][slot];
+    m_slots[0][slot] = INVALID_JOB;
+    m_occupied[0] &= ~(1ULL << slot);
+
+    while (id != INVALID_JOB) {
+      JobId next = m_jobs[id].next;
+      insert(id);  // deadline yang sudah lewat langsung masuk ready list
+      id = next;
+    }
+  }
+}
+
+void Scheduler::execute(JobId id, uint32_t now) {
+  Job& job = m_jobs[id];
+  job.level = LEVEL_NONE;
+  job.next = INVALID_JOB;
+
+  uint32_t late = static_cast<int32_t>(now - job.deadline) > 0
+                      ? now - job.deadline
+                      : 0;
+
+  bool keepRunning = true;
+  if (job.traced) TRACE(TASK_BEGIN, id);
+  uint32_t start = nowUs();
+  if (job.kind == JobKind::COROUTINE)
+    keepRunning = job.coFunc(job.co, job.arg);
+  else
+    job.func(job.arg);
+  uint32_t elapsed = nowUs() - start;
+  if (job.traced)
+    TRACE(TASK_END, id, elapsed / 1000 < 0xFFFF ? elapsed / 1000 : 0xFFFF);
+
+  JobStats& stats = job.stats;
+  stats.runs++;
+  stats.lastRunUs = elapsed;
+  stats.totalRunUs += elapsed;
+  if (elapsed > stats.maxRunUs) stats.maxRunUs = elapsed;
+  stats.lastLateMs = late;
+  if (late > stats.maxLateMs) stats.maxLateMs = late;
+
+  // job dibatalkan dari dalam callback-nya sendiri
+  if (!job.active || job.level != LEVEL_NONE) return;
+
+  if (!keepRunning) {
+    job.active = false;
+    return;
+  }
+
+  uint32_t finished = nowMs();
+  switch (job.kind) {
+    case JobKind::FIXED_RATE:
+      job.deadline += job.periodMs;
+      if (static_cast<int32_t>(finished - job.deadline) >= 0) {
+        // periode yang terlewat dilompati agar job tidak berjalan beruntun
+        uint32_t missed = (finished - job.deadline) / job.periodMs + 1;
+        stats.overruns += missed;
+        job.deadline += missed * job.periodMs;
+      }
+      break;
+    case JobKind::FIXED_DELAY:
+      job.deadline = finished + job.periodMs;
+      break;
+    case JobKind::COROUTINE:
+      job.deadline = finished + job.co.delay;
+      break;
+  }
+
+  insert(id);
+}
+
+uint32_t Scheduler::untilNext() const {
+  if (m_readyHead != INVALID_JOB) return 0;
+
+  uint32_t ticks = SCHED_MAX_IDLE_MS;
+
+  if (m_occupied[0]) {
+    uint64_t ahead = rotateRight(m_occupied[0], (m_now + 1) & WHEEL_MASK);
+    uint32_t next = lowestBit(ahead) + 1;
+    if (next < ticks) ticks = next;
+  }
+
+  for (uint8_t level = 1; level < SCHED_WHEEL_LEVELS; level++) {
+    if (!m_occupied[level]) continue;
+    // job di level atas baru bisa jatuh tempo setelah cascade
+    uint32_t toWrap = SCHED_WHEEL_SLOTS - (m_now & WHEEL_MASK);
+    if (toWrap < ticks) ticks = toWrap;
+    break;
+  }
+
+  uint32_t elapsed = nowMs() - m_now;
+  return ticks > elapsed ? ticks - elapsed : 0;
+}
+
+uint32_t Scheduler::run() {
+  if (!m_started) return SCHED_MAX_IDLE_MS;
+
+  uint32_t now = nowMs();
+  advance(now);
+
+  // job yang dijadwalkan ulang dengan deadline <= now dijalankan pada
+  // pemanggilan run() berikutnya agar satu job tidak memonopoli loop
+  JobId ready[SCHED_MAX_JOBS];
+  uint8_t count = 0;
+  for (JobId id = m_readyHead; id != INVALID_JOB; id = m_jobs[id].next)
+    ready[count++] = id;
+  m_readyHead = m_readyTail = INVALID_JOB;
+
+  for (uint8_t i = 0; i < count; i++) {
+    // bisa saja dibatalkan atau dijadwalkan ulang oleh job sebelumnya
+    if (!m_jobs[ready[i]].active || m_jobs[ready[i]].level != LEVEL_READY)
+      continue;
+    execute(ready[i], now);
+  }
+
+  return untilNext();
+}
+
+void Scheduler::idle(uint32_t ms) const {
+#ifdef ARDUINO
+  if (ms == 0)
+    yield();
+  else
+    delay(ms);
+#else
+  std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+#endif
+}
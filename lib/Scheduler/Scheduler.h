@@ -0,0 +1,166 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// jumlah maksimal job yang bisa didaftarkan, semua slot dialokasikan statis
+#ifndef SCHED_MAX_JOBS
+#define SCHED_MAX_JOBS 12
+#endif
+
+// timer wheel bertingkat: 4 level x 64 slot dengan resolusi 1 ms
+// level 0 = 64 ms, level 1 = 4.1 s, level 2 = 4.4 menit, level 3 = 4.6 jam
+#define SCHED_WHEEL_LEVELS 4
+#define SCHED_WHEEL_BITS 6
+#define SCHED_WHEEL_SLOTS (1 << SCHED_WHEEL_BITS)
+
+// batas waktu tidur maksimal saat tidak ada job yang terjadwal
+#define SCHED_MAX_IDLE_MS 1000
+
+/**
+ * State untuk coroutine stackless (gaya protothread). Variabel lokal di dalam
+ * fungsi coroutine tidak dipertahankan antar resume, gunakan static atau
+ * simpan di argumen.
+ */
+struct Coroutine {
+  uint16_t line;
+  uint32_t delay;
+};
+
+typedef void (*JobFunc)(void* arg);
+// return true jika coroutine masih berjalan, false jika sudah selesai
+typedef bool (*CoroutineFunc)(Coroutine& co, void* arg);
+
+#define CO_BEGIN(co)   \
+  switch ((co).line) { \
+    case 0:
+
+#define CO_SLEEP(co, ms)  \
+  do {                    \
+    (co).line = __LINE__; \
+    (co).delay = (ms);    \
+    return true;          \
+    case __LINE__:;       \
+  } while (0)
+
+#define CO_YIELD(co) CO_SLEEP(co, 0)
+
+// resume setiap `pollMs` sampai kondisi terpenuhi
+#define CO_AWAIT(co, cond, pollMs) \
+  do {                             \
+    (co).line = __LINE__;          \
+    case __LINE__:                 \
+      if (!(cond)) {               \
+        (co).delay = (pollMs);     \
+        return true;               \
+      }                            \
+  } while (0)
+
+#define CO_END(co) \
+  }                \
+  (co).line = 0;   \
+  return false
+
+enum class JobKind : uint8_t {
+  FIXED_RATE,   // deadline berikutnya = deadline sebelumnya + periode
+  FIXED_DELAY,  // deadline berikutnya = selesai dijalankan + periode
+  COROUTINE,    // deadline berikutnya ditentukan oleh CO_SLEEP/CO_YIELD
+};
+
+struct JobStats {
+  uint32_t runs;
+  uint32_t overruns;   // jumlah periode fixed-rate yang terlewat
+  uint32_t lastRunUs;  // durasi eksekusi terakhir
+  uint32_t maxRunUs;
+  uint64_t totalRunUs;
+  uint32_t lastLateMs;  // keterlambatan dari deadline
+  uint32_t maxLateMs;
+};
+
+class Scheduler {
+ public:
+  typedef int8_t JobId;
+  static const JobId INVALID_JOB = -1;
+
+ private:
+  struct Job {
+    const char* name;
+    JobKind kind;
+    bool active;
+    bool traced;  // dicatat ke trace RTC setiap kali berjalan
+    int8_t level;  // posisi di wheel, -1 = ready list, -2 = tidak terjadwal
+    uint8_t slot;
+    JobId next;  // linked list intrusif di dalam slot wheel/ready list
+    uint32_t periodMs;
+    uint32_t deadline;
+    union {
+      JobFunc func;
+      CoroutineFunc coFunc;
+    };
+    void* arg;
+    Coroutine co;
+    JobStats stats;
+  };
+
+  Job m_jobs[SCHED_MAX_JOBS];
+  JobId m_slots[SCHED_WHEEL_LEVELS][SCHED_WHEEL_SLOTS];
+  uint64_t m_occupied[SCHED_WHEEL_LEVELS];
+  JobId m_readyHead;
+  JobId m_readyTail;
+  uint32_t m_now;  // tick terakhir yang sudah diproses wheel
+  bool m_started;
+
+ public:
+  Scheduler();
+
+  JobId scheduleFixedRate(const char* name, uint32_t periodMs, JobFunc func,
+                          void* arg = nullptr, uint32_t initialDelayMs = 0);
+  JobId scheduleFixedDelay(const char* name, uint32_t periodMs, JobFunc func,
+                           void* arg = nullptr, uint32_t initialDelayMs = 0);
+  JobId spawn(const char* name, CoroutineFunc func, void* arg = nullptr,
+              uint32_t initialDelayMs = 0);
+
+  bool cancel(JobId id);
+  bool setPeriod(JobId id, uint32_t periodMs);
+  // jalankan job secepatnya pada pemanggilan run() berikutnya
+  bool trigger(JobId id);
+  // catat awal dan akhir job ke trace RTC (lib/Trace) untuk post-mortem
+  bool setTraced(JobId id, bool traced);
+
+  // jalankan semua job yang sudah jatuh tempo, return sisa waktu (ms) sampai
+  // deadline berikutnya
+  uint32_t run();
+  // tidur sampai deadline berikutnya tanpa busy loop
+  void idle(uint32_t ms) const;
+
+  bool isActive(JobId id) const;
+  uint8_t jobCount() const;
+  const char* jobName(JobId id) const;
+  const JobStats* jobStats(JobId id) const;
+  void resetStats();
+
+  static uint32_t nowMs();
+  static uint32_t nowUs();
+
+ private:
+  JobId allocate(const char* name, JobKind kind, uint32_t periodMs, void* arg);
+  void insert(JobId id);
+  void unlink(JobId id);
+  void pushReady(JobId id);
+  void cascade(uint8_t level);
+  void advance(uint32_t now);
+  void execute(JobId id, uint32_t now);
+  uint32_t untilNext() const;
+};
+
+inline bool Scheduler::isActive(JobId id) const {
+  return id >= 0 && id < SCHED_MAX_JOBS && m_jobs[id].active;
+}
+
+inline const char* Scheduler::jobName(JobId id) const {
+  return isActive(id) ? m_jobs[id].name : nullptr;
+}
+
+inline const JobStats* Scheduler::jobStats(JobId id) const {
+  return isActive(id) ? &m_jobs[id].stats : nullptr;
+}
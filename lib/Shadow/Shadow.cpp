@@ -0,0 +1,223 @@
+#include "Shadow.h"
+
+#include <Arduino.h>
+#include <Log.h>
+#include <Utils.h>
+#include <string.h>
+#ifdef ESP32
+#include <Preferences.h>
+#endif
+
+#define SHADOW_MAGIC 0x41515348  // "AQSH"
+
+namespace {
+struct StoredShadow {
+  uint32_t magic;
+  uint32_t version;
+  uint8_t led;
+  uint8_t pump;
+  uint8_t reserved[2];
+  uint32_t crc;
+};
+static_assert(sizeof(StoredShadow) == SHADOW_RTC_BLOCKS * 4,
+              "ukuran shadow tidak sesuai dengan blok RTC");
+static_assert(SHADOW_RTC_OFFSET >= FASTBOOT_RTC_OFFSET + FASTBOOT_RTC_BLOCKS,
+              "shadow menimpa cache FastBoot di RTC user memory");
+
+TankBank* bank = nullptr;
+ShadowState current = {0, 0, 0};
+bool dirty = false;
+#ifdef ESP32
+// set() dipanggil dari task MQTT, webserver dan loop
+portMUX_TYPE mux = portMUX_INITIALIZER_UNLOCKED;
+#endif
+
+void lock() {
+#ifdef ESP32
+  portENTER_CRITICAL(&mux);
+#endif
+}
+
+void unlock() {
+#ifdef ESP32
+  portEXIT_CRITICAL(&mux);
+#endif
+}
+
+uint32_t storedCrc(const StoredShadow& s) {
+  return crc32(reinterpret_cast<const uint8_t*>(&s),
+               offsetof(StoredShadow, crc));
+}
+
+bool load(ShadowState& state) {
+  StoredShadow stored;
+#ifdef ESP32
+  Preferences prefs;
+  if (!prefs.begin("shadow", true)) return false;
+  size_t len = prefs.getBytes("relay", &stored, sizeof(stored));
+  prefs.end();
+  if (len != sizeof(stored)) return false;
+#else
+  if (!ESP.rtcUserMemoryRead(SHADOW_RTC_OFFSET,
+                             reinterpret_cast<uint32_t*>(&stored),
+                             sizeof(stored)))
+    return false;
+#endif
+  if (stored.magic != SHADOW_MAGIC || stored.crc != storedCrc(stored))
+    return false;
+  state.version = stored.version;
+  state.led = stored.led;
+  state.pump = stored.pump;
+  return true;
+}
+
+bool store(const ShadowState& state) {
+  StoredShadow stored;
+  memset(&stored, 0, sizeof(stored));
+  stored.magic = SHADOW_MAGIC;
+  stored.version = state.version;
+  stored.led = state.led;
+  stored.pump = state.pump;
+  stored.crc = storedCrc(stored);
+#ifdef ESP32
+  Preferences prefs;
+  if (!prefs.begin("shadow", false)) return false;
+  size_t len = prefs.putBytes("relay", &stored, sizeof(stored));
+  prefs.end();
+  return len == sizeof(stored);
+#else
+  return ESP.rtcUserMemoryWrite(SHADOW_RTC_OFFSET,
+                                reinterpret_cast<uint32_t*>(&stored),
+                                sizeof(stored));
+#endif
+}
+
+// relay yang berbeda dari state ditulis, dipanggil dengan lock
+void drive(const ShadowState& state) {
+  for (uint8_t i = 0; i < bank->count(); i++) {
+    bool led = state.led & (1 << i);
+    bool pump = state.pump & (1 << i);
+    if (bank->relay(i, TankRelay::LED) != led)
+      bank->setRelay(i, TankRelay::LED, led);
+    if (bank->relay(i, TankRelay::PUMP) != pump)
+      bank->setRelay(i, TankRelay::PUMP, pump);
+  }
+}
+
+uint8_t validMask() { return (1 << bank->count()) - 1; }
+}  // namespace
+
+void Shadow::begin(TankBank& tanks) {
+  bank = &tanks;
+  ShadowState state;
+  if (load(state)) {
+    state.led &= validMask();
+    state.pump &= validMask();
+    LOG_I("shadow: versi %lu dipulihkan",
+          static_cast<unsigned long>(state.version));
+  } else {
+    state = {0, tanks.relayMask(TankRelay::LED),
+             tanks.relayMask(TankRelay::PUMP)};
+  }
+
+  lock();
+  current = state;
+  drive(current);
+  unlock();
+}
+
+ShadowResult Shadow::set(uint8_t tank, TankRelay relay, bool on,
+                         uint32_t version) {
+  if (!bank || tank >= bank->count()) return ShadowResult::INVALID;
+
+  ShadowResult result = ShadowResult::APPLIED;
+  lock();
+  uint8_t& mask = relay == TankRelay::LED ? current.led : current.pump;
+  bool same = static_cast<bool>(mask & (1 << tank)) == on;
+  if (version != 0 && version < current.version) {
+    result = ShadowResult::STALE;
+  } else if (version != 0 ? version == current.version : same) {
+    result = ShadowResult::DUPLICATE;
+  } else {
+    if (on)
+      mask |= 1 << tank;
+    else
+      mask &= ~(1 << tank);
+    current.version = version != 0 ? version : current.version + 1;
+    bank->setRelay(tank, relay, on);
+    dirty = true;
+  }
+  unlock();
+  return result;
+}
+
+ShadowResult Shadow::apply(const ShadowState& desired) {
+  if (!bank) return ShadowResult::INVALID;
+
+  ShadowResult result = ShadowResult::APPLIED;
+  lock();
+  if (desired.version < current.version) {
+    result = ShadowResult::STALE;
+  } else if (desired.version == current.version) {
+    result = ShadowResult::DUPLICATE;
+  } else {
+    current.version = desired.version;
+    current.led = desired.led & validMask();
+    current.pump = desired.pump & validMask();
+    drive(current);
+    dirty = true;
+  }
+  unlock();
+  return result;
+}
+
+ShadowState Shadow::desired() {
+  lock();
+  ShadowState state = current;
+  unlock();
+  return state;
+}
+
+ShadowState Shadow::reported() {
+  ShadowState state = {0, 0, 0};
+  if (!bank) return state;
+  lock();
+  state.version = current.version;
+  state.led = bank->relayMask(TankRelay::LED);
+  state.pump = bank->relayMask(TankRelay::PUMP);
+  unlock();
+  return state;
+}
+
+uint32_t Shadow::version() { return desired().version; }
+
+bool Shadow::persist() {
+  lock();
+  bool changed = dirty;
+  ShadowState state = current;
+  dirty = false;
+  unlock();
+  if (!changed) return true;
+
+  if (store(state)) return true;
+  LOG_W("shadow: gagal menyimpan versi %lu",
+        static_cast<unsigned long>(state.version));
+  lock();
+  dirty = true;
+  unlock();
+  return false;
+}
+
+const char* Shadow::resultName(ShadowResult result) {
+  switch (result) {
+    case ShadowResult::APPLIED:
+      return "diterapkan";
+    case ShadowResult::DUPLICATE:
+      return "sama";
+    case ShadowResult::STALE:
+      return "versi lama";
+    case ShadowResult::INVALID:
+      return "tank tidak ada";
+  }
+  return "?";
+}
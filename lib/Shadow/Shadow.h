@@ -0,0 +1,63 @@
+#pragma once
+
+#include <FastBoot.h>
+#include <Tanks.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Shadow state relay dengan versi. Desired adalah state relay yang diminta
+ * terakhir beserta versinya, reported adalah relay yang benar-benar
+ * terpasang dan versi desired yang sudah diterapkan.
+ *
+ * Perubahan lokal (Telegram, perintah control, dashboard) menaikkan versi
+ * satu. Desired dari luar (retained aquarium/<id>/shadow/desired) hanya
+ * diterapkan jika versinya lebih baru, sehingga pesan yang sama atau pesan
+ * lama yang dikirim ulang broker tidak mengubah relay. Setelah reconnect
+ * cukup satu round-trip: broker mengirim desired retained saat subscribe,
+ * perangkat menerapkan atau menolaknya lalu mempublikasikan reported.
+ *
+ * Desired disimpan di NVS (ESP32) atau RTC user memory (ESP8266, bertahan
+ * saat reset tapi tidak saat listrik mati) dan diterapkan lagi saat boot,
+ * menggantikan kondisi awal semua relay mati.
+ */
+
+// tepat setelah area FastBoot di RTC user memory ESP8266, dalam blok 4 byte.
+// Trace memakai area setelah shadow
+#define SHADOW_RTC_OFFSET (FASTBOOT_RTC_OFFSET + FASTBOOT_RTC_BLOCKS)
+#define SHADOW_RTC_BLOCKS 4
+
+struct ShadowState {
+  uint32_t version;  // 0: belum pernah diubah
+  uint8_t led;       // bit n: relay tank n menyala
+  uint8_t pump;
+};
+
+enum class ShadowResult : uint8_t {
+  APPLIED,
+  DUPLICATE,  // versi sama, tidak ada yang diubah
+  STALE,      // versi lebih lama dari desired lokal
+  INVALID,    // tank tidak ada
+};
+
+namespace Shadow {
+// setelah tanks.begin(): muat desired tersimpan dan terapkan ke relay
+void begin(TankBank& tanks);
+
+// perubahan lokal. version 0 berarti versi sekarang + 1, selain itu hanya
+// diterapkan jika lebih baru (perintah control dengan "version")
+ShadowResult set(uint8_t tank, TankRelay relay, bool on,
+                 uint32_t version = 0);
+// desired lengkap dari MQTT
+ShadowResult apply(const ShadowState& desired);
+
+ShadowState desired();
+ShadowState reported();
+uint32_t version();
+
+// tulis desired ke storage jika berubah sejak persist() terakhir. Dipanggil
+// dari job loop atau task biasa, bukan dari callback jaringan
+bool persist();
+
+const char* resultName(ShadowResult result);
+}  // namespace Shadow
@@ -0,0 +1,188 @@
+#include "Stats.h"
+
+#ifdef STATS_ENABLE
+
+#include <Utils.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <chrono>
+#endif
+
+#define STATS_SUB_BUCKETS (1 << STATS_SUB_BUCKET_BITS)
+
+namespace {
+Histogram histograms[static_cast<uint8_t>(StatId::COUNT)];
+uint32_t counters[static_cast<uint8_t>(CounterId::COUNT)];
+
+const char* const HISTOGRAM_NAMES[] = {
+    "http_get", "http_post", "json_parse", "dispatch", "sensor_update",
+    "mqtt_publish", "webhook",
+};
+
+const char* const COUNTER_NAMES[] = {
+    "http_error",
+    "json_error",
+    "command_unknown",
+    "command_dropped",
+    "mqtt_publish_fail",
+    "webhook_rejected",
+};
+
+static_assert(sizeof(HISTOGRAM_NAMES) / sizeof(HISTOGRAM_NAMES[0]) ==
+                  static_cast<size_t>(StatId::COUNT),
+              "nama histogram tidak lengkap");
+static_assert(sizeof(COUNTER_NAMES) / sizeof(COUNTER_NAMES[0]) ==
+                  static_cast<size_t>(CounterId::COUNT),
+              "nama counter tidak lengkap");
+
+inline uint8_t bucketIndex(uint32_t us) {
+  if (us < STATS_LINEAR_BUCKETS) return us;
+
+  uint8_t exponent = 31 - __builtin_clz(us);
+  if (exponent > STATS_MAX_EXPONENT) return STATS_BUCKETS - 1;
+
+  uint8_t sub = (us >> (exponent - STATS_SUB_BUCKET_BITS)) &
+                (STATS_SUB_BUCKETS - 1);
+  return STATS_LINEAR_BUCKETS + (exponent - 3) * STATS_SUB_BUCKETS + sub;
+}
+
+// batas atas nilai yang masuk ke bucket
+inline uint32_t bucketUpperBound(uint8_t index) {
+  if (index < STATS_LINEAR_BUCKETS) return index;
+
+  uint8_t rel = index - STATS_LINEAR_BUCKETS;
+  uint8_t exponent = rel / STATS_SUB_BUCKETS + 3;
+  uint8_t sub = rel % STATS_SUB_BUCKETS;
+  uint32_t width = 1UL << (exponent - STATS_SUB_BUCKET_BITS);
+  return (1UL << exponent) + sub * width + width - 1;
+}
+
+}  // namespace
+
+void Histogram::record(uint32_t us) {
+  if (count == 0 || us < min) min = us;
+  if (us > max) max = us;
+  count++;
+  sum += us;
+  buckets[bucketIndex(us)]++;
+}
+
+uint32_t Histogram::percentile(uint8_t pct) const {
+  if (count == 0) return 0;
+
+  uint32_t rank = (static_cast<uint64_t>(count) * pct + 99) / 100;
+  if (rank == 0) rank = 1;
+
+  uint32_t seen = 0;
+  for (uint8_t i = 0; i < STATS_BUCKETS; i++) {
+    seen += buckets[i];
+    if (seen >= rank) {
+      uint32_t bound = bucketUpperBound(i);
+      return bound < max ? bound : max;
+    }
+  }
+
+  return max;
+}
+
+uint32_t Stats::nowUs() {
+#ifdef ARDUINO
+  return micros();
+#else
+  using namespace std::chrono;
+  return static_cast<uint32_t>(
+      duration_cast<microseconds>(steady_clock::now().time_since_epoch())
+          .count());
+#endif
+}
+
+void Stats::record(StatId id, uint32_t us) {
+  histograms[static_cast<uint8_t>(id)].record(us);
+}
+
+void Stats::count(CounterId id, uint32_t n) {
+  counters[static_cast<uint8_t>(id)] += n;
+}
+
+void Stats::reset() {
+  memset(histograms, 0, sizeof(histograms));
+  memset(counters, 0, sizeof(counters));
+}
+
+const Histogram& Stats::histogram(StatId id) {
+  return histograms[static_cast<uint8_t>(id)];
+}
+
+uint32_t Stats::counter(CounterId id) {
+  return counters[static_cast<uint8_t>(id)];
+}
+
+const char* Stats::name(StatId id) {
+  return HISTOGRAM_NAMES[static_cast<uint8_t>(id)];
+}
+
+const char* Stats::name(CounterId id) {
+  return COUNTER_NAMES[static_cast<uint8_t>(id)];
+}
+
+size_t Stats::format(char* buf, size_t len) {
+  if (len == 0) return 0;
+  buf[0] = '\0';
+
+  // satuan ms agar muat di satu pesan Telegram
+  size_t pos = append(buf, len, 0, "%-13s %5s %7s %7s %7s\n", "latency(ms)",
+                      "n", "p50", "p99", "max");
+  for (uint8_t i = 0; i < static_cast<uint8_t>(StatId::COUNT); i++) {
+    const Histogram& h = histograms[i];
+    if (h.count == 0) continue;
+    pos = append(buf, len, pos, "%-13s %5lu %7.1f %7.1f %7.1f\n",
+                 HISTOGRAM_NAMES[i], static_cast<unsigned long>(h.count),
+                 h.percentile(50) / 1000.0f, h.percentile(99) / 1000.0f,
+                 h.max / 1000.0f);
+  }
+
+  for (uint8_t i = 0; i < static_cast<uint8_t>(CounterId::COUNT); i++) {
+    if (counters[i] == 0) continue;
+    pos = append(buf, len, pos, "%-17s %lu\n", COUNTER_NAMES[i],
+                 static_cast<unsigned long>(counters[i]));
+  }
+
+  return pos;
+}
+
+size_t Stats::toJson(char* buf, size_t len) {
+  if (len == 0) return 0;
+  buf[0] = '\0';
+
+  size_t pos = append(buf, len, 0, "{\"type\":\"stats\",\"latency_us\":{");
+  bool first = true;
+  for (uint8_t i = 0; i < static_cast<uint8_t>(StatId::COUNT); i++) {
+    const Histogram& h = histograms[i];
+    if (h.count == 0) continue;
+    pos = append(buf, len, pos,
+                 "%s\"%s\":{\"n\":%lu,\"mean\":%lu,\"p50\":%lu,\"p90\":%lu,"
+                 "\"p99\":%lu,\"max\":%lu}",
+                 first ? "" : ",", HISTOGRAM_NAMES[i],
+                 static_cast<unsigned long>(h.count),
+                 static_cast<unsigned long>(h.mean()),
+                 static_cast<unsigned long>(h.percentile(50)),
+                 static_cast<unsigned long>(h.percentile(90)),
+                 static_cast<unsigned long>(h.percentile(99)),
+                 static_cast<unsigned long>(h.max));
+    first = false;
+  }
+
+  pos = append(buf, len, pos, "},\"counters\":{");
+  for (uint8_t i = 0; i < static_cast<uint8_t>(CounterId::COUNT); i++) {
+    pos = append(buf, len, pos, "%s\"%s\":%lu", i == 0 ? "" : ",",
+                 COUNTER_NAMES[i], static_cast<unsigned long>(counters[i]));
+  }
+
+  return append(buf, len, pos, "}}");
+}
+
+#endif
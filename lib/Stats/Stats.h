@@ -0,0 +1,111 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Histogram latency dan counter untuk hot path firmware. Semua instrumentasi
+ * dipasang lewat macro STATS_*, jika STATS_ENABLE tidak didefinisikan macro
+ * tersebut tidak menghasilkan kode sama sekali.
+ *
+ * Histogram memakai bucket log-linear: nilai 0-7 us masing-masing satu bucket,
+ * di atasnya setiap kelipatan dua dibagi 4 sub-bucket (error relatif <= 12.5%)
+ * sampai sekitar 16.7 detik.
+ */
+
+// daftar hot path yang diukur
+enum class StatId : uint8_t {
+  HTTP_GET,
+  HTTP_POST,
+  JSON_PARSE,
+  COMMAND_DISPATCH,
+  SENSOR_UPDATE,
+  MQTT_PUBLISH,
+  WEBHOOK,
+  COUNT,
+};
+
+enum class CounterId : uint8_t {
+  HTTP_ERROR,
+  JSON_ERROR,
+  COMMAND_UNKNOWN,
+  COMMAND_DROPPED,
+  MQTT_PUBLISH_FAIL,
+  WEBHOOK_REJECTED,
+  COUNT,
+};
+
+#ifdef STATS_ENABLE
+
+#define STATS_LINEAR_BUCKETS 8
+#define STATS_SUB_BUCKET_BITS 2
+#define STATS_MAX_EXPONENT 23
+#define STATS_BUCKETS                                 \
+  (STATS_LINEAR_BUCKETS + (STATS_MAX_EXPONENT - 2) * \
+                              (1 << STATS_SUB_BUCKET_BITS))
+
+struct Histogram {
+  uint32_t buckets[STATS_BUCKETS];
+  uint32_t count;
+  uint32_t min;
+  uint32_t max;
+  uint64_t sum;
+
+  void record(uint32_t us);
+  uint32_t percentile(uint8_t pct) const;
+  uint32_t mean() const { return count ? sum / count : 0; }
+};
+
+namespace Stats {
+// pencatatan tidak memakai lock, pada ESP32 update dari dua task sekaligus
+// pada histogram yang sama bisa kehilangan satu sampel
+void record(StatId id, uint32_t us);
+void count(CounterId id, uint32_t n = 1);
+void reset();
+
+const Histogram& histogram(StatId id);
+uint32_t counter(CounterId id);
+const char* name(StatId id);
+const char* name(CounterId id);
+
+// ringkasan teks untuk Telegram, return panjang string yang ditulis
+size_t format(char* buf, size_t len);
+// ringkasan JSON untuk topik MQTT
+size_t toJson(char* buf, size_t len);
+
+uint32_t nowUs();
+}  // namespace Stats
+
+class StatsScope {
+ private:
+  StatId m_id;
+  uint32_t m_start;
+
+ public:
+  explicit StatsScope(StatId id) : m_id(id), m_start(Stats::nowUs()) {}
+  ~StatsScope() { Stats::record(m_id, Stats::nowUs() - m_start); }
+
+  StatsScope(const StatsScope&) = delete;
+  StatsScope& operator=(const StatsScope&) = delete;
+};
+
+#define STATS_CONCAT_(a, b) a##b
+#define STATS_CONCAT(a, b) STATS_CONCAT_(a, b)
+#define STATS_SCOPE(id) \
+  StatsScope STATS_CONCAT(statsScope_, __LINE__)(StatId::id)
+#define STATS_RECORD(id, us) Stats::record(StatId::id, us)
+#define STATS_COUNT(id) Stats::count(CounterId::id)
+
+#else
+
+#define STATS_SCOPE(id) \
+  do {                  \
+  } while (0)
+#define STATS_RECORD(id, us) \
+  do {                       \
+  } while (0)
+#define STATS_COUNT(id) \
+  do {                  \
+  } while (0)
+
+#endif
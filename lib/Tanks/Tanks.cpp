@@ -0,0 +1,103 @@
+#include "Tanks.h"
+
+#include <Arduino.h>
+#include <DallasTemperature.h>
+#include <Trace.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// constructor
+TankBank::TankBank(const TankPins* pins, uint8_t count)
+    : m_pins(pins),
+      m_count(count < TANK_MAX ? count : TANK_MAX),
+      m_temp(),
+      m_level(),
+      m_led(0),
+      m_pump(0) {}
+
+void TankBank::begin() {
+  for (uint8_t i = 0; i < m_count; i++) {
+    pinMode(m_pins[i].led, OUTPUT);
+    pinMode(m_pins[i].pump, OUTPUT);
+    pinMode(m_pins[i].levelPower, OUTPUT);
+#ifdef ESP32
+    analogSetPinAttenuation(m_pins[i].levelSignal, ADC_11db);
+#endif
+    digitalWrite(m_pins[i].led, HIGH);
+    digitalWrite(m_pins[i].pump, HIGH);
+    digitalWrite(m_pins[i].levelPower, LOW);
+  }
+  m_led = m_pump = 0;
+}
+
+void TankBank::sample(DallasTemperature& sensor) {
+  sampleTemp(sensor);
+  sampleLevel();
+}
+
+void TankBank::sampleTemp(DallasTemperature& sensor) {
+  sensor.requestTemperatures();
+  for (uint8_t i = 0; i < m_count; i++)
+    m_temp[i] = sensor.getTempCByIndex(m_pins[i].tempIndex);
+}
+
+void TankBank::sampleLevel() {
+  for (uint8_t i = 0; i < m_count; i++)
+    digitalWrite(m_pins[i].levelPower, HIGH);
+  delay(TANK_LEVEL_SETTLE_MS);
+  for (uint8_t i = 0; i < m_count; i++) {
+    int raw = analogRead(m_pins[i].levelSignal);
+    digitalWrite(m_pins[i].levelPower, LOW);
+    float percent = (raw / TANK_LEVEL_RAW_FULL) * 100.0f;
+    m_level[i] = percent > 100.0f ? 100.0f : percent;
+  }
+}
+
+bool TankBank::relay(uint8_t tank, TankRelay relay) const {
+  return tank < m_count && (relayMask(relay) & (1 << tank));
+}
+
+uint8_t TankBank::relayMask(TankRelay relay) const {
+  return relay == TankRelay::LED ? m_led : m_pump;
+}
+
+bool TankBank::setRelay(uint8_t tank, TankRelay relay, bool on) {
+  if (tank >= m_count) return false;
+
+  uint8_t& mask = relay == TankRelay::LED ? m_led : m_pump;
+  uint8_t pin = relay == TankRelay::LED ? m_pins[tank].led : m_pins[tank].pump;
+  digitalWrite(pin, on ? LOW : HIGH);
+  if (on)
+    mask |= 1 << tank;
+  else
+    mask &= ~(1 << tank);
+
+  // data: tank << 8 | nyala, dibaca tools/trace_decode.py
+  TRACE(RELAY, static_cast<uint8_t>(relay), tank << 8 | on);
+  return true;
+}
+
+namespace Tanks {
+bool parseTarget(const char* param, uint8_t count, uint8_t& tank,
+                 const char*& action) {
+  tank = 0;
+  action = param;
+  if (param[0] < '0' || param[0] > '9') return count > 0;
+
+  char* end = nullptr;
+  unsigned long number = strtoul(param, &end, 10);
+  if (number < 1 || number > count) return false;
+  tank = number - 1;
+  action = *end == '_' ? end + 1 : end;
+  return true;
+}
+
+size_t label(char* buf, size_t len, const char* name, uint8_t tank,
+             uint8_t count) {
+  if (len == 0) return 0;
+  int written = count > 1 ? snprintf(buf, len, "%s tank %u", name, tank + 1)
+                          : snprintf(buf, len, "%s", name);
+  if (written < 0) return 0;
+  return static_cast<size_t>(written) < len ? written : len - 1;
+}
+}  // namespace Tanks
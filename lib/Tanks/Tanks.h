@@ -0,0 +1,86 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Model perangkat multi-tank. Tabel TankPins dideklarasikan saat kompilasi
+ * di src/tanks.h, satu baris per tank. State runtime disimpan per besaran
+ * (struct-of-arrays) sehingga sampling, analitik dan publish cukup satu
+ * loop linear per array.
+ *
+ * Semua DS18B20 berbagi satu bus OneWire dan dibedakan dengan indeks, jadi
+ * satu konversi suhu untuk semua tank. Probe ketinggian air dinyalakan
+ * bersamaan sehingga waktu settling dibayar sekali per putaran, bukan per
+ * tank.
+ */
+
+// relay disimpan sebagai bitmask per tank
+#ifndef TANK_MAX
+#define TANK_MAX 4
+#endif
+static_assert(TANK_MAX <= 8, "bitmask relay hanya 8 bit");
+
+// pembacaan ADC saat probe terendam penuh
+#define TANK_LEVEL_RAW_FULL 260.0f
+// waktu probe dinyalakan sebelum dibaca
+#define TANK_LEVEL_SETTLE_MS 50
+
+class DallasTemperature;
+
+struct TankPins {
+  uint8_t tempIndex;    // indeks DS18B20 pada bus OneWire bersama
+  uint8_t levelSignal;  // pin ADC probe ketinggian air
+  uint8_t levelPower;
+  uint8_t led;  // relay aktif LOW
+  uint8_t pump;
+};
+
+// urutan sama dengan TraceRelay
+enum class TankRelay : uint8_t {
+  LED,
+  PUMP,
+};
+
+class TankBank {
+ private:
+  const TankPins* m_pins;
+  uint8_t m_count;
+  float m_temp[TANK_MAX];
+  float m_level[TANK_MAX];  // persentase
+  uint8_t m_led;            // bit n: relay tank n menyala
+  uint8_t m_pump;
+
+ public:
+  TankBank(const TankPins* pins, uint8_t count);  // constructor
+
+  // pinMode dan kondisi awal relay mati
+  void begin();
+  // baca suhu dan ketinggian air semua tank
+  void sample(DallasTemperature& sensor);
+  // satu konversi DS18B20 untuk semua tank
+  void sampleTemp(DallasTemperature& sensor);
+  // semua probe dinyalakan bersamaan, satu kali settling
+  void sampleLevel();
+
+  uint8_t count() const { return m_count; }
+  float temp(uint8_t tank) const { return m_temp[tank]; }
+  float level(uint8_t tank) const { return m_level[tank]; }
+  const float* temps() const { return m_temp; }
+  const float* levels() const { return m_level; }
+
+  bool relay(uint8_t tank, TankRelay relay) const;
+  uint8_t relayMask(TankRelay relay) const;
+  // false jika tank tidak ada
+  bool setRelay(uint8_t tank, TankRelay relay, bool on);
+};
+
+namespace Tanks {
+// parameter perintah "2_on" menjadi tank 1 (indeks) dan action "on", tanpa
+// nomor tank ("on") menjadi tank 0. false jika nomor tank tidak ada
+bool parseTarget(const char* param, uint8_t count, uint8_t& tank,
+                 const char*& action);
+// "Suhu air" untuk satu tank, "Suhu air tank 2" jika lebih dari satu
+size_t label(char* buf, size_t len, const char* name, uint8_t tank,
+             uint8_t count);
+}  // namespace Tanks
@@ -0,0 +1,374 @@
+#include "AsyncHttp.h"
+
+#include <Trace.h>
+#include <stdio.h>
+#include <string.h>
+
+// ukuran potongan request yang ditulis per poll()
+#define SEND_CHUNK_SIZE 256
+// data per chunk body stream, ditambah ruang "<hex>\r\n" dan "\r\n"
+#define STREAM_CHUNK_SIZE 1024
+#define STREAM_CHUNK_PREFIX 8
+static_assert(STREAM_CHUNK_PREFIX + STREAM_CHUNK_SIZE + 2 <=
+                  ASYNC_HTTP_BODY_SIZE,
+              "chunk body stream harus muat di buffer response");
+
+// connect, send, headers, body (ms)
+const AsyncHttpTimeouts DEFAULT_TIMEOUTS = {8000, 3000, 8000, 3000};
+
+// constructor
+AsyncHttp::AsyncHttp(WiFiClientSecure* client, const char* host, uint16_t port)
+    : m_client(client),
+      m_host(host),
+      m_port(port),
+      m_timeouts(DEFAULT_TIMEOUTS),
+      m_phase(AsyncHttpPhase::IDLE),
+      m_phaseStart(0),
+      m_requestStart(0),
+      m_sent(0),
+      m_reader(nullptr),
+      m_readerCtx(nullptr),
+      m_chunkPos(0),
+      m_chunkLen(0),
+      m_streamEnded(false),
+      m_lineLen(0),
+      m_statusParsed(false),
+      m_status(0),
+      m_contentLength(-1),
+      m_keepAlive(true),
+      m_bodyLen(0),
+      m_received(0),
+      m_callback(nullptr),
+      m_ctx(nullptr),
+      m_retried(false) {
+  m_body[0] = '\0';
+}
+
+bool AsyncHttp::post(const char* path, const char* contentType,
+                     const String& payload, AsyncHttpCallback callback,
+                     void* ctx) {
+  return begin("POST", path, contentType, &payload, nullptr, nullptr,
+               callback, ctx);
+}
+
+bool AsyncHttp::get(const char* path, AsyncHttpCallback callback, void* ctx) {
+  return begin("GET", path, nullptr, nullptr, nullptr, nullptr, callback,
+               ctx);
+}
+
+bool AsyncHttp::postStream(const char* path, const char* contentType,
+                           AsyncHttpReader reader, void* readerCtx,
+                           AsyncHttpCallback callback, void* ctx) {
+  return begin("POST", path, contentType, nullptr, reader, readerCtx,
+               callback, ctx);
+}
+
+bool AsyncHttp::begin(const char* method, const char* path,
+                      const char* contentType, const String* payload,
+                      AsyncHttpReader reader, void* readerCtx,
+                      AsyncHttpCallback callback, void* ctx) {
+  if (busy()) return false;
+
+  size_t payloadLen = payload ? payload->length() : 0;
+  m_request = String();
+  m_request.reserve(strlen(path) + payloadLen + 160);
+  m_request += method;
+  m_request += ' ';
+  m_request += path;
+  m_request += " HTTP/1.1\r\nHost: ";
+  m_request += m_host;
+  m_request += "\r\nConnection: keep-alive\r\n";
+  if (payload) {
+    m_request += "Content-Type: ";
+    m_request += contentType;
+    m_request += "\r\nContent-Length: ";
+    m_request += payloadLen;
+    m_request += "\r\n";
+  } else if (reader) {
+    m_request += "Content-Type: ";
+    m_request += contentType;
+    m_request += "\r\nTransfer-Encoding: chunked\r\n";
+  }
+  m_request += "\r\n";
+  if (payload) m_request += *payload;
+
+  m_sent = 0;
+  m_reader = reader;
+  m_readerCtx = readerCtx;
+  m_chunkPos = 0;
+  m_chunkLen = 0;
+  m_streamEnded = false;
+  m_lineLen = 0;
+  m_statusParsed = false;
+  m_status = 0;
+  m_contentLength = -1;
+  m_keepAlive = true;
+  m_bodyLen = 0;
+  m_received = 0;
+  m_callback = callback;
+  m_ctx = ctx;
+  m_retried = false;
+  m_requestStart = millis();
+
+  // koneksi keep-alive sebelumnya dipakai ulang tanpa handshake
+  enterPhase(m_client->connected() ? AsyncHttpPhase::SEND
+                                   : AsyncHttpPhase::CONNECT);
+  return true;
+}
+
+void AsyncHttp::enterPhase(AsyncHttpPhase phase) {
+  TRACE(HTTP_PHASE, static_cast<uint8_t>(phase));
+  m_phase = phase;
+  m_phaseStart = millis();
+}
+
+bool AsyncHttp::phaseExpired(uint16_t limitMs) const {
+  return millis() - m_phaseStart >= limitMs;
+}
+
+bool AsyncHttp::poll() {
+  switch (m_phase) {
+    case AsyncHttpPhase::IDLE:
+      break;
+    case AsyncHttpPhase::CONNECT:
+      stepConnect();
+      break;
+    case AsyncHttpPhase::SEND:
+      stepSend();
+      break;
+    case AsyncHttpPhase::RECV_HEADERS:
+      stepHeaders();
+      break;
+    case AsyncHttpPhase::RECV_BODY:
+      stepBody();
+      break;
+  }
+
+  return busy();
+}
+
+void AsyncHttp::abort() {
+  if (!busy()) return;
+
+  m_client->stop();
+  m_request = String();
+  m_phase = AsyncHttpPhase::IDLE;
+}
+
+void AsyncHttp::stepConnect() {
+#ifdef ESP32
+  m_client->setHandshakeTimeout((m_timeouts.connectMs + 999) / 1000);
+#else
+  m_client->setTimeout(m_timeouts.connectMs);
+#endif
+
+  if (!m_client->connect(m_host, m_port)) {
+    finish(phaseExpired(m_timeouts.connectMs) ? AsyncHttpError::TIMEOUT_CONNECT
+                                              : AsyncHttpError::CONNECT_FAILED);
+    return;
+  }
+
+  m_client->setNoDelay(true);
+  enterPhase(AsyncHttpPhase::SEND);
+}
+
+void AsyncHttp::stepSend() {
+  size_t written;
+  if (m_sent < m_request.length()) {
+    size_t remaining = m_request.length() - m_sent;
+    size_t chunk = remaining < SEND_CHUNK_SIZE ? remaining : SEND_CHUNK_SIZE;
+    written = m_client->write(
+        reinterpret_cast<const uint8_t*>(m_request.c_str()) + m_sent, chunk);
+    m_sent += written;
+  } else {
+    written = sendStreamChunk();
+  }
+
+  if (written > 0) {
+    if (sendComplete()) {
+      m_request = String();  // buffer request tidak dibutuhkan lagi
+      enterPhase(AsyncHttpPhase::RECV_HEADERS);
+    } else {
+      // timeout send dihitung dari data terakhir yang terkirim
+      m_phaseStart = millis();
+    }
+    return;
+  }
+
+  if (!m_client->connected()) {
+    // koneksi keep-alive sudah ditutup server, sambung ulang satu kali
+    if (m_sent == 0 && !m_retried) {
+      m_retried = true;
+      m_client->stop();
+      enterPhase(AsyncHttpPhase::CONNECT);
+    } else {
+      finish(AsyncHttpError::CONNECTION_CLOSED);
+    }
+    return;
+  }
+
+  if (phaseExpired(m_timeouts.sendMs)) finish(AsyncHttpError::TIMEOUT_SEND);
+}
+
+bool AsyncHttp::sendComplete() const {
+  if (m_sent < m_request.length()) return false;
+  return m_reader == nullptr || (m_streamEnded && m_chunkPos >= m_chunkLen);
+}
+
+size_t AsyncHttp::sendStreamChunk() {
+  if (m_chunkPos >= m_chunkLen) {
+    if (m_streamEnded) return 0;
+    fillChunk();
+  }
+
+  size_t remaining = m_chunkLen - m_chunkPos;
+  size_t chunk = remaining < SEND_CHUNK_SIZE ? remaining : SEND_CHUNK_SIZE;
+  size_t written = m_client->write(
+      reinterpret_cast<const uint8_t*>(m_body) + m_chunkPos, chunk);
+  m_chunkPos += written;
+  return written;
+}
+
+// data dari reader ditulis setelah ruang prefix, ukuran chunk dalam hex
+// ditulis tepat sebelumnya. Reader yang selesai menghasilkan chunk penutup
+void AsyncHttp::fillChunk() {
+  uint8_t* data = reinterpret_cast<uint8_t*>(m_body) + STREAM_CHUNK_PREFIX;
+  size_t len = m_reader(data, STREAM_CHUNK_SIZE, m_readerCtx);
+  if (len == 0) {
+    m_streamEnded = true;
+    m_chunkLen = snprintf(m_body, sizeof(m_body), "0\r\n\r\n");
+    m_chunkPos = 0;
+    return;
+  }
+
+  char size[STREAM_CHUNK_PREFIX + 1];
+  int prefix =
+      snprintf(size, sizeof(size), "%x\r\n", static_cast<unsigned>(len));
+  m_chunkPos = STREAM_CHUNK_PREFIX - prefix;
+  memcpy(m_body + m_chunkPos, size, prefix);
+  memcpy(data + len, "\r\n", 2);
+  m_chunkLen = STREAM_CHUNK_PREFIX + len + 2;
+}
+
+void AsyncHttp::stepHeaders() {
+  uint16_t budget = ASYNC_HTTP_POLL_BUDGET;
+
+  while (budget-- > 0 && m_client->available() > 0) {
+    int c = m_client->read();
+    if (c < 0) break;
+
+    if (c == '\n') {
+      m_line[m_lineLen] = '\0';
+      headerLine();
+      m_lineLen = 0;
+      if (m_phase != AsyncHttpPhase::RECV_HEADERS) return;
+    } else if (c != '\r' && m_lineLen < sizeof(m_line) - 1) {
+      m_line[m_lineLen++] = c;
+    }
+  }
+
+  if (!m_client->connected() && m_client->available() == 0) {
+    finish(AsyncHttpError::CONNECTION_CLOSED);
+    return;
+  }
+
+  if (phaseExpired(m_timeouts.headersMs))
+    finish(AsyncHttpError::TIMEOUT_HEADERS);
+}
+
+void AsyncHttp::headerLine() {
+  if (!m_statusParsed) {
+    // contoh: HTTP/1.1 200 OK
+    const char* code = strchr(m_line, ' ');
+    m_status = code ? atoi(code + 1) : 0;
+    m_statusParsed = true;
+    if (strncmp(m_line, "HTTP/1.", 7) != 0 || m_status <= 0)
+      finish(AsyncHttpError::BAD_RESPONSE);
+    return;
+  }
+
+  if (m_lineLen == 0) {
+    if (m_contentLength == 0)
+      finish(AsyncHttpError::NONE);
+    else
+      enterPhase(AsyncHttpPhase::RECV_BODY);
+    return;
+  }
+
+  if (strncasecmp(m_line, "Content-Length:", 15) == 0) {
+    m_contentLength = atol(m_line + 15);
+  } else if (strncasecmp(m_line, "Connection:", 11) == 0) {
+    if (strstr(m_line + 11, "close")) m_keepAlive = false;
+  }
+}
+
+void AsyncHttp::stepBody() {
+  uint16_t budget = ASYNC_HTTP_POLL_BUDGET;
+  bool progressed = false;
+
+  while (budget > 0) {
+    int available = m_client->available();
+    if (available <= 0) break;
+
+    size_t want = available < budget ? available : budget;
+    uint8_t scratch[64];
+    uint8_t* target = scratch;
+    if (m_bodyLen < ASYNC_HTTP_BODY_SIZE) {
+      size_t space = ASYNC_HTTP_BODY_SIZE - m_bodyLen;
+      if (want > space) want = space;
+      target = reinterpret_cast<uint8_t*>(m_body + m_bodyLen);
+    } else if (want > sizeof(scratch)) {
+      // body melebihi buffer, sisanya dibuang
+      want = sizeof(scratch);
+    }
+
+    int n = m_client->read(target, want);
+    if (n <= 0) break;
+
+    if (target != scratch) m_bodyLen += n;
+    m_received += n;
+    budget -= n;
+    progressed = true;
+
+    if (m_contentLength >= 0 &&
+        m_received >= static_cast<size_t>(m_contentLength)) {
+      finish(AsyncHttpError::NONE);
+      return;
+    }
+  }
+
+  if (!m_client->connected() && m_client->available() == 0) {
+    // tanpa Content-Length body diakhiri dengan menutup koneksi
+    finish(m_contentLength < 0 ? AsyncHttpError::NONE
+                               : AsyncHttpError::CONNECTION_CLOSED);
+    return;
+  }
+
+  // timeout body dihitung dari data terakhir yang diterima
+  if (progressed)
+    m_phaseStart = millis();
+  else if (phaseExpired(m_timeouts.bodyMs))
+    finish(AsyncHttpError::TIMEOUT_BODY);
+}
+
+void AsyncHttp::finish(AsyncHttpError error) {
+  TRACE(HTTP_DONE, static_cast<uint8_t>(error), m_status);
+  m_body[m_bodyLen] = '\0';
+
+  AsyncHttpResult result;
+  result.error = error;
+  result.status = m_status;
+  result.body = m_body;
+  result.length = m_bodyLen;
+  result.truncated = m_received > m_bodyLen;
+  result.elapsedMs = millis() - m_requestStart;
+
+  if (error != AsyncHttpError::NONE || !m_keepAlive) m_client->stop();
+  m_request = String();
+
+  // fase kembali IDLE sebelum callback agar callback bisa memulai request baru,
+  // body harus sudah diproses sebelum request baru dimulai
+  m_phase = AsyncHttpPhase::IDLE;
+
+  if (m_callback) m_callback(result, m_ctx);
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <Arduino.h>
+#include <WiFiClientSecure.h>
+
+#ifndef ASYNC_HTTP_BODY_SIZE
+#define ASYNC_HTTP_BODY_SIZE 2048
+#endif
+
+// jumlah byte maksimal yang diproses dalam satu kali poll()
+#define ASYNC_HTTP_POLL_BUDGET 512
+
+enum class AsyncHttpPhase : uint8_t {
+  IDLE,
+  CONNECT,  // DNS + TCP + TLS handshake
+  SEND,
+  RECV_HEADERS,
+  RECV_BODY,
+};
+
+enum class AsyncHttpError : uint8_t {
+  NONE,
+  CONNECT_FAILED,
+  TIMEOUT_CONNECT,
+  TIMEOUT_SEND,
+  TIMEOUT_HEADERS,
+  TIMEOUT_BODY,
+  CONNECTION_CLOSED,
+  BAD_RESPONSE,
+};
+
+// body stream postStream(): isi buf maksimal len byte, 0 jika body selesai
+typedef size_t (*AsyncHttpReader)(uint8_t* buf, size_t len, void* ctx);
+
+struct AsyncHttpTimeouts {
+  uint16_t connectMs;
+  uint16_t sendMs;
+  uint16_t headersMs;
+  uint16_t bodyMs;
+};
+
+struct AsyncHttpResult {
+  AsyncHttpError error;
+  int status;  // HTTP status code, 0 jika gagal sebelum response diterima
+  const char* body;
+  size_t length;
+  bool truncated;  // body lebih besar dari ASYNC_HTTP_BODY_SIZE
+  uint32_t elapsedMs;
+};
+
+typedef void (*AsyncHttpCallback)(const AsyncHttpResult& result, void* ctx);
+
+/**
+ * Request HTTP/1.1 yang dijalankan bertahap lewat poll() dari loop() sehingga
+ * firmware tetap responsif selama request berjalan. Koneksi dipertahankan
+ * (keep-alive) agar request berikutnya tidak perlu TLS handshake lagi.
+ *
+ * postStream() mengirim body dengan Transfer-Encoding chunked dari reader.
+ * Setiap chunk disiapkan di buffer response yang belum terpakai selama fase
+ * SEND, sehingga panjang body tidak perlu diketahui di awal dan memori tetap
+ * sama berapapun besarnya.
+ *
+ * Catatan: fase CONNECT TIDAK non-blocking. WiFiClientSecure::connect()
+ * menjalankan DNS, TCP dan seluruh TLS handshake BearSSL/mbedTLS dalam satu
+ * panggilan, sehingga poll() pada fase ini menahan loop() (ESP8266: sekitar
+ * 1-3 detik, paling lama timeout connect). Karena keep-alive, ini hanya
+ * terjadi pada request pertama dan setelah koneksi ditutup server. Fase
+ * SEND, RECV_HEADERS dan RECV_BODY tidak pernah menunggu.
+ */
+class AsyncHttp {
+ private:
+  WiFiClientSecure* m_client;
+  const char* m_host;
+  uint16_t m_port;
+  AsyncHttpTimeouts m_timeouts;
+
+  AsyncHttpPhase m_phase;
+  uint32_t m_phaseStart;
+  uint32_t m_requestStart;
+
+  String m_request;
+  size_t m_sent;
+
+  AsyncHttpReader m_reader;
+  void* m_readerCtx;
+  size_t m_chunkPos;  // chunk body stream di m_body
+  size_t m_chunkLen;
+  bool m_streamEnded;  // chunk penutup sudah disiapkan
+
+  char m_line[96];
+  uint8_t m_lineLen;
+  bool m_statusParsed;
+  int m_status;
+  long m_contentLength;
+  bool m_keepAlive;
+
+  char m_body[ASYNC_HTTP_BODY_SIZE + 1];
+  size_t m_bodyLen;
+  size_t m_received;
+
+  AsyncHttpCallback m_callback;
+  void* m_ctx;
+  bool m_retried;
+
+ public:
+  AsyncHttp(WiFiClientSecure* client, const char* host, uint16_t port = 443);
+
+  void setTimeouts(const AsyncHttpTimeouts& timeouts) { m_timeouts = timeouts; }
+
+  bool post(const char* path, const char* contentType, const String& payload,
+            AsyncHttpCallback callback, void* ctx = nullptr);
+  bool get(const char* path, AsyncHttpCallback callback, void* ctx = nullptr);
+  // reader dipanggil dari poll() sampai mengembalikan 0
+  bool postStream(const char* path, const char* contentType,
+                  AsyncHttpReader reader, void* readerCtx,
+                  AsyncHttpCallback callback, void* ctx = nullptr);
+
+  // maju satu langkah, return true jika request masih berjalan
+  bool poll();
+  void abort();
+
+  bool busy() const { return m_phase != AsyncHttpPhase::IDLE; }
+  AsyncHttpPhase phase() const { return m_phase; }
+
+ private:
+  bool begin(const char* method, const char* path, const char* contentType,
+             const String* payload, AsyncHttpReader reader, void* readerCtx,
+             AsyncHttpCallback callback, void* ctx);
+  void enterPhase(AsyncHttpPhase phase);
+  bool phaseExpired(uint16_t limitMs) const;
+  void stepConnect();
+  void stepSend();
+  size_t sendStreamChunk();
+  void fillChunk();
+  bool sendComplete() const;
+  void stepHeaders();
+  void stepBody();
+  void headerLine();
+  void finish(AsyncHttpError error);
+};
@@ -1,24 +1,127 @@
 #include "CommandRouter.h"
 
+#include <Arduino.h>
+#include <Log.h>
+#include <Stats.h>
 #include <Utils.h>
 
-#include <stdexcept>
-#include <string>
+#include <stdio.h>
+#include <string.h>
 
 // constructor
-CommandRouter::CommandRouter() {}
+CommandRouter::CommandRouter() : m_routeCount(0), m_queueCount(0) {}
 
-CommandRouter::CommandRouter(const CommandMap& handlers)
-    : m_handlers(handlers) {}
+bool CommandRouter::registerCommand(const char* command, HandlerFunc handler,
+                                    RouteClass execClass,
+                                    RoutePriority priority) {
+  Route* route = find(command);
+  if (!route) {
+    if (m_routeCount >= ROUTER_MAX_ROUTES) return false;
+    route = &m_routes[m_routeCount++];
+  }
+  route->entry = {command, handler, execClass, priority};
+  route->stats = {0, 0, 0, 0};
+  return true;
+}
+
+void CommandRouter::setRoutes(const RouteEntry* routes, uint8_t count) {
+  // antrean menyimpan pointer ke route lama
+  m_queueCount = 0;
+  m_routeCount = 0;
+  for (uint8_t i = 0; i < count && i < ROUTER_MAX_ROUTES; i++) {
+    m_routes[m_routeCount].entry = routes[i];
+    m_routes[m_routeCount].stats = {0, 0, 0, 0};
+    m_routeCount++;
+  }
+}
+
+// pencarian linear, tabel perintah bot cukup kecil
+Route* CommandRouter::find(const char* command) {
+  for (uint8_t i = 0; i < m_routeCount; i++) {
+    if (strcmp(m_routes[i].entry.command, command) == 0) return &m_routes[i];
+  }
+  return nullptr;
+}
 
-// destructor
-CommandRouter::~CommandRouter() {}
+bool CommandRouter::dispatch(Telek& telek, const BotCommand& cmd) {
+  STATS_SCOPE(COMMAND_DISPATCH);
+  Route* route = find(cmd.command);
+  if (!route) {
+    STATS_COUNT(COMMAND_UNKNOWN);
+    return false;
+  }
 
-bool CommandRouter::dispatch(Telek& telek, const BotCommand& cmd) const {
-  try {
-    m_handlers.at(cmd.command)(telek, cmd);
+  if (route->entry.execClass == RouteClass::IMMEDIATE) {
+    // relay langsung diubah, balasan tidak ditunggu
+    telek.setDeferred(true);
+    execute(telek, *route, cmd);
+    telek.setDeferred(false);
     return true;
-  } catch (const std::out_of_range& e) {
+  }
+
+  if (m_queueCount >= ROUTER_QUEUE_SIZE) {
+    STATS_COUNT(COMMAND_DROPPED);
+    LOG_W("antrean perintah penuh, %s dibuang", cmd.command);
     return false;
   }
-}
\ No newline at end of file
+
+  PendingCommand& pending = m_queue[m_queueCount++];
+  pending.cmd = cmd;
+  pending.route = route;
+  pending.queuedMs = millis();
+  return true;
+}
+
+uint8_t CommandRouter::runPending(Telek& telek, uint8_t maxCommands) {
+  uint8_t done = 0;
+  while (done < maxCommands && m_queueCount > 0) {
+    // prioritas tertinggi, FIFO untuk prioritas yang sama
+    uint8_t next = 0;
+    for (uint8_t i = 1; i < m_queueCount; i++) {
+      if (m_queue[i].route->entry.priority >
+          m_queue[next].route->entry.priority)
+        next = i;
+    }
+
+    PendingCommand pending = m_queue[next];
+    for (uint8_t i = next; i + 1 < m_queueCount; i++)
+      m_queue[i] = m_queue[i + 1];
+    m_queueCount--;
+
+    RouteStats& stats = pending.route->stats;
+    uint32_t waitMs = millis() - pending.queuedMs;
+    if (waitMs > stats.maxWaitMs) stats.maxWaitMs = waitMs;
+
+    execute(telek, *pending.route, pending.cmd);
+    done++;
+  }
+  return done;
+}
+
+void CommandRouter::execute(Telek& telek, Route& route, const BotCommand& cmd) {
+  uint32_t start = micros();
+  route.entry.handler(telek, cmd);
+  uint32_t elapsed = micros() - start;
+
+  route.stats.calls++;
+  route.stats.totalUs += elapsed;
+  if (elapsed > route.stats.maxUs) route.stats.maxUs = elapsed;
+}
+
+size_t CommandRouter::format(char* buf, size_t len) const {
+  if (len == 0) return 0;
+  buf[0] = '\0';
+
+  size_t pos = append(buf, len, 0, "%-11s %4s %7s %7s %7s\n", "route(ms)", "n",
+                      "mean", "max", "wait");
+  for (uint8_t i = 0; i < m_routeCount; i++) {
+    const RouteStats& stats = m_routes[i].stats;
+    if (stats.calls == 0) continue;
+    pos = append(buf, len, pos, "%-11s %4lu %7.1f %7.1f %7lu\n",
+                 m_routes[i].entry.command,
+                 static_cast<unsigned long>(stats.calls),
+                 stats.totalUs / 1000.0f / stats.calls, stats.maxUs / 1000.0f,
+                 static_cast<unsigned long>(stats.maxWaitMs));
+  }
+  return pos;
+}
@@ -1,26 +1,91 @@
 #pragma once
 
 #include <Telek.h>
+#include <stddef.h>
 
-#include <map>
-#include <string>
+// jumlah perintah WORKER yang bisa antre
+#ifndef ROUTER_QUEUE_SIZE
+#define ROUTER_QUEUE_SIZE 4
+#endif
+// jumlah perintah yang bisa didaftarkan
+#ifndef ROUTER_MAX_ROUTES
+#define ROUTER_MAX_ROUTES 16
+#endif
 
-typedef std::function<void(Telek& telek, const BotCommand& cmd)> HandlerFunc;
-typedef std::map<std::string, HandlerFunc> CommandMap;
+typedef void (*HandlerFunc)(Telek& telek, const BotCommand& cmd);
+
+// IMMEDIATE: dijalankan langsung di dispatch() (aktuator), balasannya
+// diantrekan di outbox Telek dan dikirim lewat Telek::flush()/poll().
+// WORKER: diantrekan dan dijalankan runPending() sesuai prioritas (laporan,
+// help) sehingga tidak menunda perintah aktuator berikutnya
+enum class RouteClass : uint8_t {
+  IMMEDIATE,
+  WORKER,
+};
+
+// urutan eksekusi antrean WORKER, nilai besar didahulukan
+enum class RoutePriority : uint8_t {
+  BACKGROUND,
+  NORMAL,
+  URGENT,
+};
+
+struct RouteStats {
+  uint32_t calls;
+  uint32_t totalUs;
+  uint32_t maxUs;
+  uint32_t maxWaitMs;  // waktu tunggu terlama di antrean WORKER
+};
+
+// satu baris tabel perintah, biasanya array const sehingga tetap di flash
+struct RouteEntry {
+  const char* command;  // "/led", dibandingkan dengan BotCommand::command
+  HandlerFunc handler;
+  RouteClass execClass;
+  RoutePriority priority = RoutePriority::NORMAL;
+};
+
+struct Route {
+  RouteEntry entry;
+  RouteStats stats;
+};
 
 class CommandRouter {
  private:
-  CommandMap m_handlers;
+  struct PendingCommand {
+    BotCommand cmd;
+    Route* route;
+    uint32_t queuedMs;
+  };
+
+  Route m_routes[ROUTER_MAX_ROUTES];
+  uint8_t m_routeCount;
+  PendingCommand m_queue[ROUTER_QUEUE_SIZE];
+  uint8_t m_queueCount;
 
  public:
-  CommandRouter();
-  CommandRouter(const CommandMap& handlers);
-  ~CommandRouter();
+  CommandRouter();  // constructor
+
+  // false jika tabel route penuh
+  bool registerCommand(const char* command, HandlerFunc handler,
+                       RouteClass execClass = RouteClass::WORKER,
+                       RoutePriority priority = RoutePriority::NORMAL);
+  // false jika perintah tidak dikenal atau antrean WORKER penuh
+  bool dispatch(Telek& telek, const BotCommand& cmd);
+  // jalankan maksimal maxCommands perintah WORKER, return jumlah yang jalan
+  uint8_t runPending(Telek& telek, uint8_t maxCommands = 1);
+  uint8_t pending() const { return m_queueCount; }
 
-  void registerCommand(const char* command, HandlerFunc handler) {
-    m_handlers[command] = handler;
+  void setRoutes(const RouteEntry* routes, uint8_t count);
+  template <size_t N>
+  void setRoutes(const RouteEntry (&routes)[N]) {
+    static_assert(N <= ROUTER_MAX_ROUTES, "naikkan ROUTER_MAX_ROUTES");
+    setRoutes(routes, N);
   }
-  bool dispatch(Telek& telek, const BotCommand& cmd) const;
-  void setRoutes(const CommandMap& routes) { m_handlers = routes; }
-  const CommandMap& getRoutes() const { return m_handlers; }
+
+  size_t format(char* buf, size_t len) const;
+
+ private:
+  Route* find(const char* command);
+  void execute(Telek& telek, Route& route, const BotCommand& cmd);
 };
@@ -0,0 +1,124 @@
+#include "LiveMessage.h"
+
+#include <Log.h>
+#include <stdio.h>
+
+// constructor
+LiveMessage::LiveMessage(uint32_t minIntervalMs)
+    : m_minIntervalMs(minIntervalMs),
+      m_messageId(0),
+      m_hash(0),
+      m_lastEditMs(0),
+      m_failures(0),
+      m_active(false),
+      m_creating(false),
+      m_stats{} {}
+
+void LiveMessage::start() {
+  m_active = true;
+  m_messageId = 0;
+  m_hash = 0;
+  m_failures = 0;
+}
+
+void LiveMessage::stop() { m_active = false; }
+
+bool LiveMessage::update(Telek& telek, const char* text, uint32_t nowMs) {
+  if (!m_active || m_creating) return false;
+
+  uint32_t textHash = hash(text);
+  if (textHash == m_hash) {
+    m_stats.unchanged++;
+    return false;
+  }
+  // termasuk pengiriman ulang setelah edit gagal
+  if (m_messageId != 0 && nowMs - m_lastEditMs < m_minIntervalMs) {
+    m_stats.throttled++;
+    return false;
+  }
+
+  // dicatat sebelum request karena pada mode blocking callback dipanggil
+  // sebelum sendMessage/editMessage return
+  uint32_t previousHash = m_hash;
+  uint32_t previousEditMs = m_lastEditMs;
+  m_hash = textHash;
+  m_lastEditMs = nowMs;
+  bool queued;
+  if (m_messageId == 0) {
+    m_creating = true;
+    queued = telek.sendMessage(text, onResult, this);
+  } else {
+    queued = telek.editMessage(m_messageId, text, onResult, this);
+  }
+
+  if (!queued) {
+    m_hash = previousHash;
+    m_lastEditMs = previousEditMs;
+    m_creating = false;
+  }
+  return queued;
+}
+
+// FNV-1a, 0 dicadangkan untuk "belum ada teks"
+uint32_t LiveMessage::hash(const char* text) {
+  uint32_t h = 2166136261UL;
+  while (*text) {
+    h ^= static_cast<uint8_t>(*text++);
+    h *= 16777619UL;
+  }
+  return h ? h : 1;
+}
+
+void LiveMessage::onResult(Telek& telek, TelekMethod method, bool ok,
+                           int32_t messageId, void* ctx) {
+  LiveMessage* self = static_cast<LiveMessage*>(ctx);
+
+  if (method == TelekMethod::SEND_MESSAGE) {
+    self->m_creating = false;
+    if (!ok || messageId <= 0) {
+      self->m_stats.failed++;
+      self->m_hash = 0;
+      return;
+    }
+    self->m_stats.edits++;
+    // live status dihentikan selama pesan dibuat
+    if (!self->m_active) return;
+    self->m_messageId = messageId;
+    self->m_failures = 0;
+    telek.pinMessage(messageId);
+    LOG_I("live status: pesan %ld dipin", static_cast<long>(messageId));
+    return;
+  }
+
+  // hasil edit pesan lama yang sudah dibuat ulang
+  if (messageId != self->m_messageId) return;
+
+  if (ok) {
+    self->m_stats.edits++;
+    self->m_failures = 0;
+    return;
+  }
+
+  // teks dikirim ulang setelah interval edit
+  self->m_stats.failed++;
+  self->m_hash = 0;
+  if (++self->m_failures >= LIVE_MESSAGE_MAX_FAILURES) {
+    LOG_W("live status: edit gagal %u kali, pesan dibuat ulang",
+          self->m_failures);
+    self->m_messageId = 0;
+    self->m_failures = 0;
+  }
+}
+
+size_t LiveMessage::format(char* buf, size_t len) const {
+  int written =
+      snprintf(buf, len, "live %-5s pesan %ld edit %lu sama %lu tunda %lu "
+                         "gagal %lu\n",
+               m_active ? "aktif" : "mati", static_cast<long>(m_messageId),
+               static_cast<unsigned long>(m_stats.edits),
+               static_cast<unsigned long>(m_stats.unchanged),
+               static_cast<unsigned long>(m_stats.throttled),
+               static_cast<unsigned long>(m_stats.failed));
+  if (written < 0) return 0;
+  return static_cast<size_t>(written) < len ? written : (len > 0 ? len - 1 : 0);
+}
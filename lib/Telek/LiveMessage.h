@@ -0,0 +1,62 @@
+#pragma once
+
+#include <Telek.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Satu pesan status yang dipin di chat dan diperbarui di tempat dengan
+ * editMessageText, menggantikan pesan baru setiap kali status dicek.
+ *
+ * update() dipanggil berkala dengan teks hasil render terbaru. Teks dengan
+ * hash yang sama dengan edit terakhir dilewati tanpa request, dan edit
+ * dibatasi satu per minIntervalMs; teks yang tertunda terkirim pada
+ * update() berikutnya setelah interval lewat. Pesan dibuat dan dipin pada
+ * update() pertama setelah start(), dan dibuat ulang jika edit gagal
+ * berturut-turut (misal pesan dihapus pengguna).
+ */
+
+// edit gagal berturut-turut sebelum pesan dibuat ulang
+#ifndef LIVE_MESSAGE_MAX_FAILURES
+#define LIVE_MESSAGE_MAX_FAILURES 3
+#endif
+
+struct LiveMessageStats {
+  uint32_t edits;      // sendMessage dan editMessageText yang berhasil
+  uint32_t unchanged;  // dilewati karena hash sama
+  uint32_t throttled;  // ditunda karena interval edit
+  uint32_t failed;
+};
+
+class LiveMessage {
+ private:
+  uint32_t m_minIntervalMs;
+  int32_t m_messageId;
+  uint32_t m_hash;  // 0: belum ada teks yang terkirim
+  uint32_t m_lastEditMs;
+  uint8_t m_failures;
+  bool m_active;
+  bool m_creating;  // menunggu message_id dari sendMessage
+  LiveMessageStats m_stats;
+
+ public:
+  explicit LiveMessage(uint32_t minIntervalMs);
+
+  // pesan baru dibuat dan dipin pada update() berikutnya
+  void start();
+  // pesan lama dibiarkan di chat
+  void stop();
+  bool active() const { return m_active; }
+  int32_t messageId() const { return m_messageId; }
+
+  // true jika request dikirim atau diantrekan di Telek
+  bool update(Telek& telek, const char* text, uint32_t nowMs);
+
+  const LiveMessageStats& stats() const { return m_stats; }
+  size_t format(char* buf, size_t len) const;
+
+ private:
+  static uint32_t hash(const char* text);
+  static void onResult(Telek& telek, TelekMethod method, bool ok,
+                       int32_t messageId, void* ctx);
+};
@@ -0,0 +1,92 @@
+#include "MultipartUpload.h"
+
+#include <string.h>
+
+#define BOUNDARY "aqua-telek-9f2c4e1b"
+
+const char MULTIPART_CONTENT_TYPE[] = "multipart/form-data; boundary=" BOUNDARY;
+const char MULTIPART_TAIL[] = "\r\n--" BOUNDARY "--\r\n";
+
+// constructor
+MultipartUpload::MultipartUpload()
+    : m_pos(0),
+      m_reader(nullptr),
+      m_readerCtx(nullptr),
+      m_documentBytes(0),
+      m_stage(Stage::DONE) {}
+
+void MultipartUpload::begin(const char* chatId, const char* filename,
+                            const char* caption, DocumentReader reader,
+                            void* readerCtx) {
+  m_head = String();
+  m_head.reserve(256);
+  m_head += "--" BOUNDARY "\r\n"
+            "Content-Disposition: form-data; name=\"chat_id\"\r\n\r\n";
+  m_head += chatId;
+  if (caption && caption[0]) {
+    m_head += "\r\n--" BOUNDARY "\r\n"
+              "Content-Disposition: form-data; name=\"caption\"\r\n\r\n";
+    m_head += caption;
+  }
+  m_head += "\r\n--" BOUNDARY "\r\n"
+            "Content-Disposition: form-data; name=\"document\"; filename=\"";
+  m_head += filename;
+  m_head += "\"\r\nContent-Type: application/octet-stream\r\n\r\n";
+
+  m_pos = 0;
+  m_reader = reader;
+  m_readerCtx = readerCtx;
+  m_documentBytes = 0;
+  m_stage = Stage::HEAD;
+}
+
+size_t MultipartUpload::copyText(const char* text, size_t textLen,
+                                 uint8_t* buf, size_t len) {
+  size_t n = textLen - m_pos < len ? textLen - m_pos : len;
+  memcpy(buf, text + m_pos, n);
+  m_pos += n;
+  return n;
+}
+
+// buf diisi penuh kecuali di akhir body, reader boleh mengembalikan kurang
+// dari yang diminta (misal satu baris CSV)
+size_t MultipartUpload::read(uint8_t* buf, size_t len) {
+  size_t total = 0;
+  while (total < len && m_stage != Stage::DONE) {
+    switch (m_stage) {
+      case Stage::HEAD:
+        total += copyText(m_head.c_str(), m_head.length(), buf + total,
+                          len - total);
+        if (m_pos >= m_head.length()) {
+          m_head = String();
+          m_pos = 0;
+          m_stage = Stage::BODY;
+        }
+        break;
+      case Stage::BODY: {
+        size_t n = m_reader(buf + total, len - total, m_readerCtx);
+        if (n == 0) {
+          m_stage = Stage::TAIL;
+          break;
+        }
+        m_documentBytes += n;
+        total += n;
+        break;
+      }
+      case Stage::TAIL:
+        total += copyText(MULTIPART_TAIL, sizeof(MULTIPART_TAIL) - 1,
+                          buf + total, len - total);
+        if (m_pos >= sizeof(MULTIPART_TAIL) - 1) m_stage = Stage::DONE;
+        break;
+      case Stage::DONE:
+        break;
+    }
+  }
+  return total;
+}
+
+const char* MultipartUpload::contentType() { return MULTIPART_CONTENT_TYPE; }
+
+size_t MultipartUpload::reader(uint8_t* buf, size_t len, void* ctx) {
+  return static_cast<MultipartUpload*>(ctx)->read(buf, len);
+}
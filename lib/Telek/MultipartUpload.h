@@ -0,0 +1,47 @@
+#pragma once
+
+#include <Arduino.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Body multipart/form-data untuk sendDocument yang dibaca bertahap: field
+ * chat_id dan caption, header part document, isi dokumen dari reader, lalu
+ * boundary penutup. Yang disimpan hanya header part (puluhan byte), isi
+ * dokumen langsung ditulis reader ke buffer chunk AsyncHttp sehingga memori
+ * tidak bergantung pada ukuran dokumen.
+ */
+
+// isi buf maksimal len byte, 0 jika dokumen selesai. Sama dengan
+// AsyncHttpReader
+typedef size_t (*DocumentReader)(uint8_t* buf, size_t len, void* ctx);
+
+class MultipartUpload {
+ private:
+  enum class Stage : uint8_t { HEAD, BODY, TAIL, DONE };
+
+  String m_head;
+  size_t m_pos;
+  DocumentReader m_reader;
+  void* m_readerCtx;
+  size_t m_documentBytes;
+  Stage m_stage;
+
+ public:
+  MultipartUpload();
+
+  // filename tanpa tanda kutip, caption boleh nullptr
+  void begin(const char* chatId, const char* filename, const char* caption,
+             DocumentReader reader, void* readerCtx);
+  // return 0 setelah boundary penutup terbaca
+  size_t read(uint8_t* buf, size_t len);
+  size_t documentBytes() const { return m_documentBytes; }
+
+  static const char* contentType();
+  // AsyncHttpReader dengan ctx MultipartUpload*
+  static size_t reader(uint8_t* buf, size_t len, void* ctx);
+
+ private:
+  size_t copyText(const char* text, size_t textLen, uint8_t* buf,
+                  size_t len);
+};
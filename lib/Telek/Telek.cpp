@@ -6,37 +6,16 @@
 #include <ESP8266HTTPClient.h>
 #include <ESP8266WiFi.h>
 #endif
+#include <JsonArena.h>
+#include <Log.h>
+#include <MemTelemetry.h>
+#include <Stats.h>
+#include <Trace.h>
 #include <Utils.h>
 #include <WiFiClientSecure.h>
 
 #include "Telek.h"
 
-// Log macros for ESP8266
-#ifndef ESP32
-#ifdef DEBUG_LOG_ENABLE
-#define log_d(fmt, ...)                \
-  do {                                 \
-    Serial.print("[DEBUG] > ");        \
-    Serial.printf(fmt, ##__VA_ARGS__); \
-    Serial.println();                  \
-  } while (0)
-#else
-#define log_d(...)
-#endif
-#define log_e(fmt, ...)                \
-  do {                                 \
-    Serial.print("[ERROR] > ");        \
-    Serial.printf(fmt, ##__VA_ARGS__); \
-    Serial.println();                  \
-  } while (0)
-#define log_i(fmt, ...)                \
-  do {                                 \
-    Serial.print("[INFO] > ");         \
-    Serial.printf(fmt, ##__VA_ARGS__); \
-    Serial.println();                  \
-  } while (0)
-#endif
-
 // root CA untuk domain telegram bot API api.telegram.org
 const char Go_Daddy_G2_Cert[] = R"CERT(
 -----BEGIN CERTIFICATE-----
@@ -68,14 +47,90 @@ LPAvTK33sefOT6jEm0pUBsV/fdUID+Ic/n4XuKxe9tQWskMJDE32p2u0mYRlynqI
 X509List cert(Go_Daddy_G2_Cert);
 #endif
 
+// buffer RX 1 KB + TX 512 B jika server mendukung MFLN, dibanding default
+// BearSSL 16 KB + 512 B per koneksi
+const TlsProfile DEFAULT_TLS_PROFILE = {TlsVerify::TRUST_ANCHOR, 1024, 512,
+                                        true};
+
+// ukuran record TLS maksimal jika MFLN tidak disetujui server
+#define TLS_FULL_RECORD_SIZE 16384
+// BearSSL menambah header/MAC record ke buffer RX yang diminta
+#define TLS_RECORD_OVERHEAD 325
+// br_ssl_client_context + x509 minimal, alokasi terbesar selain buffer RX
+#define TLS_CONTEXT_BYTES 4096
+// cadangan untuk alokasi kecil lain selama handshake
+#define TLS_HEAP_MARGIN 1280
+
+// waktu minimal yang dianggap valid untuk cek masa berlaku sertifikat,
+// dipakai jika jam belum tersinkron NTP (2025-01-01)
+#ifndef TELEK_CERT_EPOCH
+#define TELEK_CERT_EPOCH 1735689600
+#endif
+
+// arena JSON untuk semua request/response bot, cukup untuk satu update
+// getUpdates dengan limit 1
+#ifndef TELEK_JSON_ARENA_SIZE
+#define TELEK_JSON_ARENA_SIZE 4096
+#endif
+StaticJsonArena<TELEK_JSON_ARENA_SIZE> telekArena("telek");
+
 namespace ApiMethod {
 const char GETME[] = "getMe";
 const char SEND_MESSAGE[] = "sendMessage";
 const char GET_UPDATES[] = "getUpdates";
+const char SET_WEBHOOK[] = "setWebhook";
+const char DELETE_WEBHOOK[] = "deleteWebhook";
+const char EDIT_MESSAGE_TEXT[] = "editMessageText";
+const char PIN_CHAT_MESSAGE[] = "pinChatMessage";
+const char SEND_DOCUMENT[] = "sendDocument";
 }  // namespace ApiMethod
 
+// urutan sama dengan TelekMethod
+const char* const OUTBOX_METHODS[] = {ApiMethod::SEND_MESSAGE,
+                                      ApiMethod::EDIT_MESSAGE_TEXT,
+                                      ApiMethod::PIN_CHAT_MESSAGE,
+                                      ApiMethod::GETME,
+                                      ApiMethod::SET_WEBHOOK};
+
+inline const char* methodName(TelekMethod method) {
+  return OUTBOX_METHODS[static_cast<uint8_t>(method)];
+}
+
+const char JSON_CONTENT_TYPE[] = "application/json";
+const char GET_UPDATES_PAYLOAD[] =
+    R"({"limit":1,"offset":-1,"allowed_updates":["message"]})";
+
+inline bool isHttpOk(int code) { return code >= 200 && code < 400; }
+
+// message_id adalah field pertama objek result, dicari tanpa parse JSON
+// agar response yang terpotong buffer async tetap terbaca
+int32_t parseMessageId(const char* response) {
+  static const char KEY[] = "\"message_id\":";
+  const char* found = strstr(response, KEY);
+  return found ? strtol(found + sizeof(KEY) - 1, nullptr, 10) : 0;
+}
+
+// username bot dari response getMe, tanpa parse JSON seperti parseMessageId
+void logBotName(const char* response) {
+  static const char KEY[] = "\"username\":\"";
+  const char* found = strstr(response, KEY);
+  if (found == nullptr) return;
+  const char* name = found + sizeof(KEY) - 1;
+  const char* end = strchr(name, '"');
+  LOG_I("Bot telegram sudah berjalan dengan nama: %.*s",
+        end ? static_cast<int>(end - name) : 0, name);
+}
+
 // destructor
 Telek::~Telek() {
+  if (m_async != nullptr) {
+    delete m_async;
+    m_async = nullptr;
+  }
+#ifdef ESP8266
+  delete m_tlsSession;
+  delete m_pinnedKey;
+#endif
   if (m_WiFiClient != nullptr) {
     delete m_WiFiClient;
     m_WiFiClient = nullptr;
@@ -84,17 +139,147 @@ Telek::~Telek() {
 
 // constructor
 Telek::Telek(const char* token)
-    : m_token(token), m_lastUpdateId(0), m_chatId{0} {
+    : m_token(token),
+      m_lastUpdateId(0),
+      m_chatId{0},
+      m_async(nullptr),
+      m_inflight(),
+      m_outboxHead(0),
+      m_outboxCount(0),
+      m_deferred(false),
+#ifdef ESP32
+      m_deferredTask(nullptr),
+#endif
+      m_lastWasSend(false),
+      m_updateRequested(false),
+      m_pendingBody(nullptr),
+      m_updateCallback(nullptr),
+      m_updateCtx(nullptr),
+      m_reply(nullptr),
+      m_uploadPending(false),
+      m_uploadActive(false),
+      m_uploadOk(false),
+      m_tls(DEFAULT_TLS_PROFILE),
+      m_tlsReady(false),
+      m_mflnProbed(false),
+      m_mflnSupported(false) {
   m_WiFiClient = new WiFiClientSecure;
+#ifdef ESP8266
+  m_tlsSession = new BearSSL::Session;
+  m_pinnedKey = nullptr;
+#endif
+}
+
+void Telek::setTlsProfile(const TlsProfile& profile) {
+  m_tls = profile;
+  m_tlsReady = false;
+  m_mflnProbed = false;
+  m_mflnSupported = false;
+}
+
+void Telek::setPinnedKey(const char* pem) {
+#ifdef ESP8266
+  if (m_pinnedKey != nullptr) delete m_pinnedKey;
+  m_pinnedKey = new BearSSL::PublicKey(pem);
+  m_tlsReady = false;
+#else
+  (void)pem;
+  LOG_E("public key pinning tidak didukung, memakai root CA");
+#endif
+}
+
+bool Telek::probeTls() {
+#ifdef ESP8266
+  if (!m_mflnProbed) {
+    m_mflnSupported = WiFiClientSecure::probeMaxFragmentLength(
+        API_HOST, 443, m_tls.rxBufferSize);
+    m_mflnProbed = true;
+    m_tlsReady = false;
+    LOG_I("TLS: MFLN %u %s", m_tls.rxBufferSize,
+          m_mflnSupported ? "didukung" : "tidak didukung, buffer 16 KB");
+  }
+#endif
+  return m_mflnSupported;
+}
+
+// murah, tidak membuka koneksi. Sebelum probeTls() buffer RX dibuat penuh
+// 16 KB karena belum diketahui apakah server menerima MFLN
+void Telek::prepareTls() {
+  if (m_tlsReady) return;
+  m_tlsReady = true;
+
+#ifdef ESP32
+  // mbedTLS pada Arduino-ESP32 tidak menyediakan MFLN maupun session cache
+  if (m_tls.verify == TlsVerify::INSECURE)
+    m_WiFiClient->setInsecure();
+  else
+    m_WiFiClient->setCACert(Go_Daddy_G2_Cert);
+#elif defined(ESP8266)
+  switch (m_tls.verify) {
+    case TlsVerify::INSECURE:
+      m_WiFiClient->setInsecure();
+      break;
+    case TlsVerify::PINNED_KEY:
+      if (m_pinnedKey != nullptr) {
+        m_WiFiClient->setKnownKey(m_pinnedKey);
+        break;
+      }
+      LOG_E("public key belum diset, memakai root CA");
+      // fallthrough
+    case TlsVerify::TRUST_ANCHOR:
+      m_WiFiClient->setTrustAnchors(&cert);
+      if (time(nullptr) < TELEK_CERT_EPOCH) {
+        LOG_E("jam belum tersinkron NTP, masa berlaku sertifikat dicek "
+              "terhadap waktu build");
+        m_WiFiClient->setX509Time(TELEK_CERT_EPOCH);
+      }
+      break;
+  }
+
+  m_WiFiClient->setBufferSizes(
+      m_mflnSupported ? m_tls.rxBufferSize : TLS_FULL_RECORD_SIZE,
+      m_tls.txBufferSize);
+  m_WiFiClient->setSession(m_tls.sessionCache ? m_tlsSession : nullptr);
+#else
+  // build simulator: koneksi palsu tanpa TLS
+  (void)m_tls;
+#endif
+}
+
+// tanpa MFLN hasilnya sama dengan batas default 18000 B, dengan MFLN 1 KB
+// cukup blok untuk context BearSSL
+uint32_t Telek::tlsBlockNeeded() const {
 #ifdef ESP32
-  m_WiFiClient->setCACert(Go_Daddy_G2_Cert);
+  // mbedTLS tidak mendukung MFLN, kebutuhan satu sesi tetap
+  return MEM_DEGRADE_ENTER_BYTES;
 #else
-  m_WiFiClient->setInsecure();
-  // m_WiFiClient->setTrustAnchors(&cert);
+  uint32_t rx = (m_mflnSupported ? m_tls.rxBufferSize : TLS_FULL_RECORD_SIZE) +
+                TLS_RECORD_OVERHEAD;
+  uint32_t block = rx > TLS_CONTEXT_BYTES ? rx : TLS_CONTEXT_BYTES;
+  return block + TLS_HEAP_MARGIN;
 #endif
 }
 
+size_t Telek::formatTls(char* buf, size_t len) const {
+  static const char* const VERIFY_NAMES[] = {"insecure", "anchor", "pinned"};
+  uint16_t rx = TLS_FULL_RECORD_SIZE;
+#ifdef ESP8266
+  if (m_mflnSupported) rx = m_tls.rxBufferSize;
+#endif
+
+  int written = snprintf(buf, len, "tls %-6s rx %u tx %u B mfln %s\n",
+                         VERIFY_NAMES[static_cast<uint8_t>(m_tls.verify)], rx,
+                         m_tls.txBufferSize, m_mflnSupported ? "ya" : "tidak");
+  if (written < 0) return 0;
+  return static_cast<size_t>(written) < len ? written : (len > 0 ? len - 1 : 0);
+}
+
 String Telek::HTTPGet(const char* apiMethod) {
+  // koneksi sedang dipakai request async
+  if (m_async && m_async->busy()) return EMPTY_RESPONSE;
+  prepareTls();
+
+  STATS_SCOPE(HTTP_GET);
   HTTPClient client;
   String res;
 
@@ -102,11 +287,16 @@ String Telek::HTTPGet(const char* apiMethod) {
 
   client.begin(*m_WiFiClient, url);
 
+  TRACE(HTTP_PHASE, TRACE_HTTP_BLOCKING);
   int code = client.GET();
-  if (!(code >= 200 && code < 400))
+  TRACE(HTTP_DONE, 0, code > 0 ? code : 0);
+  if (!isHttpOk(code)) {
+    STATS_COUNT(HTTP_ERROR);
     res = EMPTY_RESPONSE;
-  else
+  } else {
     res = client.getString();
+    MEM_COUNT_ALLOC(TELEK, res.length());
+  }
 
   client.end();
 
@@ -114,20 +304,29 @@ String Telek::HTTPGet(const char* apiMethod) {
 }
 
 String Telek::HTTPPost(const char* apiMethod, const String& payload) {
+  if (m_async && m_async->busy()) return EMPTY_RESPONSE;
+  prepareTls();
+
+  STATS_SCOPE(HTTP_POST);
   HTTPClient client;
   String res;
 
   String url = buildURL(apiMethod);
 
   client.begin(*m_WiFiClient, url);
-  client.addHeader("Content-Type", "application/json");
+  client.addHeader("Content-Type", JSON_CONTENT_TYPE);
 
+  TRACE(HTTP_PHASE, TRACE_HTTP_BLOCKING);
   int code = client.POST(payload);
+  TRACE(HTTP_DONE, 0, code > 0 ? code : 0);
 
-  if (!(code >= 200 && code < 400))
+  if (!isHttpOk(code)) {
+    STATS_COUNT(HTTP_ERROR);
     res = EMPTY_RESPONSE;
-  else
+  } else {
     res = client.getString();
+    MEM_COUNT_ALLOC(TELEK, res.length());
+  }
 
   client.end();
 
@@ -135,16 +334,18 @@ String Telek::HTTPPost(const char* apiMethod, const String& payload) {
 }
 
 BotInfo Telek::getBotInfo() {
+  MEM_SCOPE(TELEK);
   BotInfo me = {0};
 
   String res = HTTPGet(ApiMethod::GETME);
 
   if (res == EMPTY_RESPONSE || res.isEmpty()) return me;
 
-  JsonDocument doc;
+  JsonArenaScope arenaScope(telekArena);
+  JsonDocument doc(&telekArena);
   DeserializationError err = deserializeJson(doc, res);
   if (err) {
-    log_e("json deserialization error: %s", err.c_str());
+    LOG_E("json deserialization error: %s", err.c_str());
     return me;
   }
 
@@ -158,27 +359,42 @@ BotInfo Telek::getBotInfo() {
   return me;
 }
 
-void Telek::sendMessage(const String& msg) {
-  if (msg.length() < 1) return;
+bool Telek::requestBotInfo(MessageCallback callback, void* ctx) {
+  return submit(TelekMethod::GET_ME, EMPTY_RESPONSE, 0, callback, ctx);
+}
 
+String Telek::buildMessagePayload(const String& msg, const char* method,
+                                  int32_t messageId) {
   String message;
-  JsonDocument doc;
+  JsonArenaScope arenaScope(telekArena);
+  JsonDocument doc(&telekArena);
+  if (method) doc["method"] = method;
   doc["chat_id"] = m_chatId;
+  if (messageId > 0) doc["message_id"] = messageId;
   doc["text"] = msg;
   doc["parse_mode"] = "markdown";
 
   serializeJson(doc, message);
+  MEM_COUNT_ALLOC(TELEK, message.length());
 
-  log_d("message payload: %s", message.c_str());
+  return message;
+}
 
-  String res = HTTPPost(ApiMethod::SEND_MESSAGE, message);
+void Telek::sendMessage(const String& msg) {
+  MEM_SCOPE(TELEK);
+  if (msg.length() < 1) return;
 
-  if (res == EMPTY_RESPONSE || res.isEmpty()) {
-    log_e("gagal mengirim pesan");
+  if (m_reply && m_reply->isEmpty()) {
+    *m_reply = buildMessagePayload(msg, ApiMethod::SEND_MESSAGE);
+    LOG_D("balasan webhook: %s", m_reply->c_str());
     return;
   }
 
-  log_i("pesan berhasil dikirim");
+  String message = buildMessagePayload(msg);
+
+  LOG_D("message payload: %s", message.c_str());
+
+  submit(TelekMethod::SEND_MESSAGE, message, 0, nullptr, nullptr);
 }
 
 void Telek::sendMessage(const char* chatId, const String& msg) {
@@ -186,60 +402,390 @@ void Telek::sendMessage(const char* chatId, const String& msg) {
   sendMessage(msg);
 }
 
+bool Telek::sendMessage(const String& msg, MessageCallback callback,
+                        void* ctx) {
+  MEM_SCOPE(TELEK);
+  if (msg.length() < 1) return false;
+
+  return submit(TelekMethod::SEND_MESSAGE, buildMessagePayload(msg), 0,
+                callback, ctx);
+}
+
+bool Telek::editMessage(int32_t messageId, const String& msg,
+                        MessageCallback callback, void* ctx) {
+  MEM_SCOPE(TELEK);
+  if (msg.length() < 1 || messageId <= 0) return false;
+
+  return submit(TelekMethod::EDIT_MESSAGE_TEXT,
+                buildMessagePayload(msg, nullptr, messageId), messageId,
+                callback, ctx);
+}
+
+bool Telek::pinMessage(int32_t messageId) {
+  MEM_SCOPE(TELEK);
+  if (messageId <= 0) return false;
+
+  String payload;
+  {
+    JsonArenaScope arenaScope(telekArena);
+    JsonDocument doc(&telekArena);
+    doc["chat_id"] = m_chatId;
+    doc["message_id"] = messageId;
+    doc["disable_notification"] = true;
+    serializeJson(doc, payload);
+  }
+  return submit(TelekMethod::PIN_CHAT_MESSAGE, payload, messageId, nullptr,
+                nullptr);
+}
+
+bool Telek::sendDocument(const char* filename, DocumentReader reader,
+                         void* ctx, const char* caption) {
+  MEM_SCOPE(TELEK);
+  if (uploading()) return false;
+
+  m_upload.begin(m_chatId, filename, caption, reader, ctx);
+  if (m_async) {
+    m_uploadPending = true;
+    return true;
+  }
+
+  // koneksi HTTPClient ditutup dulu, upload memakai client TLS yang sama
+  // lewat AsyncHttp yang dijalankan sampai selesai
+  prepareTls();
+  m_WiFiClient->stop();
+  AsyncHttp* http = new AsyncHttp(m_WiFiClient, API_HOST);
+  bool started = startUpload(*http);
+  if (started) {
+    while (http->poll()) delay(1);
+  }
+  delete http;
+  m_WiFiClient->stop();
+  return started && m_uploadOk;
+}
+
+bool Telek::startUpload(AsyncHttp& http) {
+  String path = buildPath(ApiMethod::SEND_DOCUMENT);
+  if (!http.postStream(path.c_str(), MultipartUpload::contentType(),
+                       MultipartUpload::reader, &m_upload, onAsyncUpload,
+                       this))
+    return false;
+  m_uploadPending = false;
+  m_uploadActive = true;
+  return true;
+}
+
+// mode async dan deferred mengantrekan request, selain itu dikirim langsung
+// dan callback dipanggil sebelum return
+bool Telek::submit(TelekMethod method, const String& payload,
+                   int32_t messageId, MessageCallback callback, void* ctx) {
+  OutboxEntry entry = {payload, method, messageId, callback, ctx};
+  if (m_async || deferred()) {
+    if (enqueue(entry)) return true;
+    LOG_E("antrean pesan penuh, pesan dibuang");
+    return false;
+  }
+
+  String res = HTTPPost(methodName(method), payload);
+  bool ok = !(res == EMPTY_RESPONSE || res.isEmpty());
+  if (ok)
+    LOG_I("%s berhasil", methodName(method));
+  else
+    LOG_E("gagal mengirim %s", methodName(method));
+  complete(entry, ok, res.c_str());
+  return true;
+}
+
+void Telek::complete(const OutboxEntry& entry, bool ok,
+                     const char* response) {
+  if (ok && entry.method == TelekMethod::GET_ME) logBotName(response);
+  if (entry.callback == nullptr) return;
+
+  int32_t messageId = entry.messageId;
+  if (ok && entry.method == TelekMethod::SEND_MESSAGE)
+    messageId = parseMessageId(response);
+  entry.callback(*this, entry.method, ok, messageId, entry.ctx);
+}
+
 bool Telek::getMessageUpdate(MessageBody* msgBody) {
-  String res =
-      HTTPPost(ApiMethod::GET_UPDATES,
-               R"({"limit":1,"offset":-1,"allowed_updates":["message"]})");
+  MEM_SCOPE(TELEK);
+  String res = HTTPPost(ApiMethod::GET_UPDATES, GET_UPDATES_PAYLOAD);
   if (res == EMPTY_RESPONSE || res.isEmpty()) {
-    log_e("tidak ada response dari API");
+    LOG_E("tidak ada response dari API");
     return false;
   }
 
-  JsonDocument doc;
-  DeserializationError err = deserializeJson(doc, res);
+  return parseUpdate(res.c_str(), res.length(), msgBody);
+}
+
+bool Telek::setWebhook(const char* url, const char* secret) {
+  MEM_SCOPE(TELEK);
+  String payload;
+  {
+    JsonArenaScope arenaScope(telekArena);
+    JsonDocument doc(&telekArena);
+    doc["url"] = url;
+    if (secret) doc["secret_token"] = secret;
+    // server di perangkat hanya melayani satu koneksi
+    doc["max_connections"] = 1;
+    doc["allowed_updates"].add("message");
+    // perintah yang menumpuk selama offline tidak dijalankan saat boot
+    doc["drop_pending_updates"] = true;
+    serializeJson(doc, payload);
+  }
+  if (m_async || deferred())
+    return submit(TelekMethod::SET_WEBHOOK, payload, 0, nullptr, nullptr);
+
+  String res = HTTPPost(ApiMethod::SET_WEBHOOK, payload);
+  if (res.indexOf("\"ok\":true") < 0) {
+    LOG_E("gagal memasang webhook");
+    return false;
+  }
+  LOG_I("webhook terpasang: %s", url);
+  return true;
+}
+
+bool Telek::deleteWebhook() {
+  String res = HTTPPost(ApiMethod::DELETE_WEBHOOK, EMPTY_RESPONSE);
+  return res.indexOf("\"ok\":true") >= 0;
+}
+
+bool Telek::parseUpdate(const char* json, size_t len, MessageBody* msgBody) {
+  JsonArenaScope arenaScope(telekArena);
+  JsonDocument doc(&telekArena);
+  DeserializationError err;
+  {
+    STATS_SCOPE(JSON_PARSE);
+    err = deserializeJson(doc, json, len);
+  }
   if (err) {
-    log_e("json deserialization error: %s\n", err.c_str());
+    STATS_COUNT(JSON_ERROR);
+    LOG_E("json deserialization error: %s", err.c_str());
     return false;
   }
 
   JsonArrayConst result = doc["result"];
   if (!(result && result.size() > 0)) return false;
 
-  JsonObjectConst first = result[0];
+  return readUpdate(result[0].as<JsonObjectConst>(), msgBody);
+}
+
+bool Telek::parseWebhookUpdate(const char* json, size_t len,
+                               MessageBody* msgBody) {
+  MEM_SCOPE(TELEK);
+  JsonArenaScope arenaScope(telekArena);
+  JsonDocument doc(&telekArena);
+  DeserializationError err;
+  {
+    STATS_SCOPE(JSON_PARSE);
+    err = deserializeJson(doc, json, len);
+  }
+  if (err) {
+    STATS_COUNT(JSON_ERROR);
+    LOG_E("json deserialization error: %s", err.c_str());
+    return false;
+  }
 
-  // mencegah pengguna lain untuk memakai bot
-  auto userId = first["from"]["id"].as<const char*>();
-  if (userId && !streq(userId, m_chatId)) return false;
+  return readUpdate(doc.as<JsonObjectConst>(), msgBody);
+}
 
+// satu objek Update, dari getUpdates maupun body webhook
+template <typename T>
+bool Telek::readUpdate(T update, MessageBody* msgBody) {
   // mencegah agar hanya pesan terakhir dan baru dikirm yang akan diproses
-  auto update_id = first["update_id"].as<uint32_t>();
+  auto update_id = update["update_id"].template as<uint32_t>();
   if (update_id > m_lastUpdateId) {
     m_lastUpdateId = update_id;
   } else {
     return false;
   }
 
+  // mencegah pengguna lain untuk memakai bot, id pengirim berupa angka
+  JsonObjectConst msg = update["message"];
+  long long userId = msg["from"]["id"] | 0LL;
+  if (userId != atoll(m_chatId)) return false;
+
   // jika parameter yang diberikan sama dengan nullptr
   // maka hanya update message id terakhir saja
   if (msgBody == nullptr) return false;
 
-  JsonObjectConst msg = first["message"];
-  strncpy(msgBody->message, msg["text"].as<const char*>(),
-          sizeof(msgBody->message) - 1);
-  strncpy(msgBody->sender, msg["from"]["username"].as<const char*>(),
+  // pesan tanpa teks (stiker, foto) dianggap kosong
+  strncpy(msgBody->message, msg["text"] | "", sizeof(msgBody->message) - 1);
+  strncpy(msgBody->sender, msg["from"]["username"] | "",
           sizeof(msgBody->sender) - 1);
 
   return true;
 }
 
+void Telek::enableAsync() {
+  if (m_async == nullptr) m_async = new AsyncHttp(m_WiFiClient, API_HOST);
+}
+
+void Telek::setDeferred(bool deferred) {
+  m_deferred = deferred;
+#ifdef ESP32
+  m_deferredTask = deferred ? xTaskGetCurrentTaskHandle() : nullptr;
+#endif
+}
+
+bool Telek::deferred() const {
+#ifdef ESP32
+  return m_deferred && m_deferredTask == xTaskGetCurrentTaskHandle();
+#else
+  return m_deferred;
+#endif
+}
+
+bool Telek::enqueue(const OutboxEntry& entry) {
+  if (m_outboxCount >= TELEK_OUTBOX_SIZE) return false;
+
+  uint8_t tail = (m_outboxHead + m_outboxCount) % TELEK_OUTBOX_SIZE;
+  m_outbox[tail] = entry;
+  m_outboxCount++;
+  return true;
+}
+
+bool Telek::requestMessageUpdate(MessageBody* msgBody, UpdateCallback callback,
+                                 void* ctx) {
+  if (m_async == nullptr || m_updateRequested) return false;
+
+  m_updateRequested = true;
+  m_pendingBody = msgBody;
+  m_updateCallback = callback;
+  m_updateCtx = ctx;
+  return true;
+}
+
+bool Telek::poll() {
+  if (m_async == nullptr) return false;
+
+  if (!m_async->poll() &&
+      (m_outboxCount > 0 || m_updateRequested || m_uploadPending)) {
+    prepareTls();
+    // pesan keluar didahulukan daripada getUpdates, tetapi getUpdates
+    // diselipkan setiap satu pesan agar perintah aktuator tidak menunggu
+    // seluruh antrean balasan terkirim. Dokumen menunggu antrean pesan kosong
+    bool sendTurn = !(m_updateRequested && m_lastWasSend);
+    if (sendTurn && m_outboxCount > 0) {
+      OutboxEntry& entry = m_outbox[m_outboxHead];
+      String path = buildPath(methodName(entry.method));
+      if (m_async->post(path.c_str(), JSON_CONTENT_TYPE, entry.payload,
+                        onAsyncSent, this)) {
+        // payload sudah disalin AsyncHttp, callback dipanggil onAsyncSent
+        m_inflight = {String(), entry.method, entry.messageId, entry.callback,
+                      entry.ctx};
+        entry = OutboxEntry();
+        m_outboxHead = (m_outboxHead + 1) % TELEK_OUTBOX_SIZE;
+        m_outboxCount--;
+        m_lastWasSend = true;
+      }
+    } else if (sendTurn && m_uploadPending) {
+      if (startUpload(*m_async)) m_lastWasSend = true;
+    } else if (m_updateRequested) {
+      String path = buildPath(ApiMethod::GET_UPDATES);
+      if (m_async->post(path.c_str(), JSON_CONTENT_TYPE, GET_UPDATES_PAYLOAD,
+                        onAsyncUpdate, this))
+        m_lastWasSend = false;
+    }
+  }
+
+  return m_async->busy() || m_outboxCount > 0 || m_updateRequested ||
+         m_uploadPending;
+}
+
+uint8_t Telek::flush(uint8_t maxMessages) {
+  if (m_async) return 0;
+
+  uint8_t sent = 0;
+  while (sent < maxMessages && m_outboxCount > 0) {
+    // dikeluarkan dulu dari antrean karena callback bisa mengantrekan
+    // request baru, misal pinMessage setelah sendMessage
+    OutboxEntry entry = m_outbox[m_outboxHead];
+    m_outbox[m_outboxHead] = OutboxEntry();
+    m_outboxHead = (m_outboxHead + 1) % TELEK_OUTBOX_SIZE;
+    m_outboxCount--;
+    sent++;
+
+    String res = HTTPPost(methodName(entry.method), entry.payload);
+    bool ok = !(res == EMPTY_RESPONSE || res.isEmpty());
+    if (ok)
+      LOG_I("%s berhasil", methodName(entry.method));
+    else
+      LOG_E("gagal mengirim %s", methodName(entry.method));
+    complete(entry, ok, res.c_str());
+  }
+  return sent;
+}
+
+void Telek::onAsyncSent(const AsyncHttpResult& result, void* ctx) {
+  Telek* self = static_cast<Telek*>(ctx);
+  OutboxEntry entry = self->m_inflight;
+  self->m_inflight = OutboxEntry();
+  STATS_RECORD(HTTP_POST, result.elapsedMs * 1000UL);
+
+  bool ok = result.error == AsyncHttpError::NONE && isHttpOk(result.status);
+  if (ok) {
+    LOG_I("%s berhasil (%lu ms)", methodName(entry.method),
+          static_cast<unsigned long>(result.elapsedMs));
+  } else {
+    STATS_COUNT(HTTP_ERROR);
+    LOG_E("gagal mengirim %s (error %d, status %d)", methodName(entry.method),
+          static_cast<int>(result.error), result.status);
+  }
+  self->complete(entry, ok, ok ? result.body : "");
+}
+
+void Telek::onAsyncUpload(const AsyncHttpResult& result, void* ctx) {
+  Telek* self = static_cast<Telek*>(ctx);
+  self->m_uploadActive = false;
+  STATS_RECORD(HTTP_POST, result.elapsedMs * 1000UL);
+
+  self->m_uploadOk =
+      result.error == AsyncHttpError::NONE && isHttpOk(result.status);
+  if (self->m_uploadOk) {
+    LOG_I("dokumen terkirim, %lu byte (%lu ms)",
+          static_cast<unsigned long>(self->m_upload.documentBytes()),
+          static_cast<unsigned long>(result.elapsedMs));
+  } else {
+    STATS_COUNT(HTTP_ERROR);
+    LOG_E("gagal mengirim dokumen (error %d, status %d)",
+          static_cast<int>(result.error), result.status);
+  }
+}
+
+void Telek::onAsyncUpdate(const AsyncHttpResult& result, void* ctx) {
+  Telek* self = static_cast<Telek*>(ctx);
+  self->m_updateRequested = false;
+  STATS_RECORD(HTTP_POST, result.elapsedMs * 1000UL);
+
+  if (result.error != AsyncHttpError::NONE || !isHttpOk(result.status)) {
+    STATS_COUNT(HTTP_ERROR);
+    LOG_E("tidak ada response dari API (error %d, status %d)",
+          static_cast<int>(result.error), result.status);
+    return;
+  }
+  if (result.truncated) {
+    LOG_E("response getUpdates terpotong");
+    return;
+  }
+
+  MEM_SCOPE(TELEK);
+  MEM_COUNT_ALLOC(TELEK, result.length);
+  MessageBody* body = self->m_pendingBody;
+  if (self->parseUpdate(result.body, result.length, body) &&
+      self->m_updateCallback)
+    self->m_updateCallback(*self, body, self->m_updateCtx);
+}
+
 bool Telek::parseCommand(BotCommand& cmd, const char* message) const {
   if (!message || !message[0]) return false;
 
   // slash command terdiri dari dua string yang dipisah dengan character
-  // underscore '_' /led_on, /suhu_lapor
+  // underscore '_' /led_on, /suhu_lapor, opsional diikuti nilai setelah
+  // spasi /config_suhu_min 27.5
 
   char buff[32];
   snprintf(buff, sizeof(buff), "%s", message);
+  memset(&cmd, 0, sizeof(cmd));
 
   char* token = strtok(buff, "_");  // slash command seperti /led, /suhu
   if (token != NULL)
@@ -250,5 +796,8 @@ bool Telek::parseCommand(BotCommand& cmd, const char* message) const {
   token = strtok(NULL, " ");  // value atau parameter nya
   if (token != NULL) strncpy(cmd.parameter, token, sizeof(cmd.parameter) - 1);
 
+  token = strtok(NULL, " ");
+  if (token != NULL) strncpy(cmd.value, token, sizeof(cmd.value) - 1);
+
   return true;
 }
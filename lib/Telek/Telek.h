@@ -2,7 +2,16 @@
 
 #include <WiFiClientSecure.h>
 
-#define BASE_API_URL "https://api.telegram.org/bot"
+#ifdef ESP32
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#endif
+
+#include "AsyncHttp.h"
+#include "MultipartUpload.h"
+
+#define API_HOST "api.telegram.org"
+#define BASE_API_URL "https://" API_HOST "/bot"
 
 #define EMPTY_RESPONSE "{}"
 
@@ -13,6 +22,7 @@ struct BotInfo {
 struct BotCommand {
   char command[16];
   char parameter[16];
+  char value[16];  // argumen setelah spasi, misal /config_suhu_min 27.5
 };
 
 struct MessageBody {
@@ -20,6 +30,51 @@ struct MessageBody {
   char message[32];
 };
 
+// jumlah pesan yang bisa antre saat mode async aktif
+#ifndef TELEK_OUTBOX_SIZE
+#define TELEK_OUTBOX_SIZE 4
+#endif
+
+// profil TLS, buffer dan session cache hanya berlaku pada ESP8266 (BearSSL)
+enum class TlsVerify : uint8_t {
+  INSECURE,      // tanpa verifikasi sertifikat server
+  TRUST_ANCHOR,  // verifikasi dengan root CA Go Daddy G2
+  PINNED_KEY,    // verifikasi dengan public key server, lihat setPinnedKey()
+};
+
+struct TlsProfile {
+  TlsVerify verify;
+  uint16_t rxBufferSize;  // Max Fragment Length yang diminta: 512..4096
+  uint16_t txBufferSize;
+  bool sessionCache;  // simpan sesi agar handshake berikutnya cukup resume
+};
+
+enum class TelekMethod : uint8_t {
+  SEND_MESSAGE,
+  EDIT_MESSAGE_TEXT,
+  PIN_CHAT_MESSAGE,
+  GET_ME,
+  SET_WEBHOOK,
+};
+
+class Telek;
+
+// dipanggil dari poll() saat ada pesan baru hasil requestMessageUpdate()
+typedef void (*UpdateCallback)(Telek& telek, MessageBody* msgBody, void* ctx);
+// hasil request yang dikirim dengan callback. messageId berisi message_id
+// dari response sendMessage, atau pesan yang diedit
+typedef void (*MessageCallback)(Telek& telek, TelekMethod method, bool ok,
+                                int32_t messageId, void* ctx);
+
+// satu request di outbox, dikirim oleh poll() atau flush()
+struct OutboxEntry {
+  String payload;
+  TelekMethod method;
+  int32_t messageId;
+  MessageCallback callback;
+  void* ctx;
+};
+
 class Telek {
  private:
   const char* m_token;
@@ -27,22 +82,135 @@ class Telek {
   char m_chatId[12];
   WiFiClientSecure* m_WiFiClient;
 
+  // mode async: request dijalankan bertahap lewat poll()
+  AsyncHttp* m_async;
+  OutboxEntry m_outbox[TELEK_OUTBOX_SIZE];
+  OutboxEntry m_inflight;
+  uint8_t m_outboxHead;
+  uint8_t m_outboxCount;
+  bool m_deferred;
+#ifdef ESP32
+  // hanya task yang memanggil setDeferred(true) yang mengantrekan pesan
+  volatile TaskHandle_t m_deferredTask;
+#endif
+  bool m_lastWasSend;
+  bool m_updateRequested;
+  MessageBody* m_pendingBody;
+  UpdateCallback m_updateCallback;
+  void* m_updateCtx;
+  // mode webhook: pesan pertama ditulis ke response webhook
+  String* m_reply;
+  // satu dokumen sendDocument, pada mode async dimulai setelah outbox kosong
+  MultipartUpload m_upload;
+  bool m_uploadPending;
+  bool m_uploadActive;
+  bool m_uploadOk;  // hasil upload terakhir
+
+  TlsProfile m_tls;
+  bool m_tlsReady;
+  bool m_mflnProbed;
+  bool m_mflnSupported;
+#ifdef ESP8266
+  BearSSL::Session* m_tlsSession;
+  BearSSL::PublicKey* m_pinnedKey;
+#endif
+
  public:
   explicit Telek(const char* token);
   ~Telek();
 
   bool parseCommand(BotCommand& cmd, const char* message) const;
   BotInfo getBotInfo();
+  // getMe lewat antrean, username dicatat di log saat response diterima.
+  // Mode blocking: callback dipanggil sebelum return
+  bool requestBotInfo(MessageCallback callback, void* ctx = nullptr);
   void sendMessage(const String& msg);
   void sendMessage(const char* chatId, const String& msg);
+  // callback menerima message_id untuk editMessage(). Return false jika
+  // antrean penuh, callback tidak dipanggil
+  bool sendMessage(const String& msg, MessageCallback callback, void* ctx);
+  // ganti teks pesan yang sudah terkirim, Telegram menolak teks yang sama
+  bool editMessage(int32_t messageId, const String& msg,
+                   MessageCallback callback = nullptr, void* ctx = nullptr);
+  // pin tanpa notifikasi
+  bool pinMessage(int32_t messageId);
+  // kirim dokumen sebagai multipart/form-data chunked, isi dibaca bertahap
+  // dari reader (misal SampleLogCsv::reader). Mode async: dokumen dikirim
+  // poll() setelah antrean pesan kosong, reader dan ctx harus tetap valid
+  // sampai uploading() false. Mode blocking: dikirim sebelum return, return
+  // false jika upload gagal. Return false jika masih ada upload lain
+  bool sendDocument(const char* filename, DocumentReader reader, void* ctx,
+                    const char* caption = nullptr);
+  bool uploading() const { return m_uploadPending || m_uploadActive; }
   bool getMessageUpdate(MessageBody* msgBody);
 
+  // mode webhook: Telegram mengirim update ke URL ini, getUpdates tidak bisa
+  // dipakai selama webhook terpasang sampai deleteWebhook(). Mode async dan
+  // deferred: hanya masuk antrean, return false jika antrean penuh
+  bool setWebhook(const char* url, const char* secret);
+  bool deleteWebhook();
+  // body POST webhook berisi satu objek Update, bukan array result
+  bool parseWebhookUpdate(const char* json, size_t len, MessageBody* msgBody);
+  // selama reply tidak null, sendMessage pertama menjadi method call di
+  // reply dan dikirim Telegram tanpa request terpisah. Pesan berikutnya
+  // dikirim seperti biasa
+  void captureReply(String* reply) { m_reply = reply; }
+
   void setChatId(const char* chatId);
 
+  // setelah enableAsync(), sendMessage hanya memasukkan pesan ke antrean dan
+  // semua request dijalankan oleh poll() yang dipanggil berkala dari loop()
+  void enableAsync();
+  bool isAsync() const { return m_async != nullptr; }
+  bool requestMessageUpdate(MessageBody* msgBody, UpdateCallback callback,
+                            void* ctx = nullptr);
+  // return true selama masih ada request yang berjalan atau antre
+  bool poll();
+  uint8_t pendingMessages() const { return m_outboxCount; }
+
+  // mode blocking: selama deferred, sendMessage hanya mengantrekan pesan yang
+  // kemudian dikirim flush(). Pada mode async flush() tidak melakukan apa-apa.
+  // ESP32: deferred hanya berlaku untuk task pemanggil, pesan dari task lain
+  // tetap dikirim langsung sehingga outbox dan flush() hanya dipakai satu
+  // task
+  void setDeferred(bool deferred);
+  uint8_t flush(uint8_t maxMessages = TELEK_OUTBOX_SIZE);
+
+  // diterapkan sebelum koneksi berikutnya dibuka, MFLN perlu diprobe ulang
+  void setTlsProfile(const TlsProfile& profile);
+  // ESP8266: cek sekali apakah server menerima Max Fragment Length sehingga
+  // buffer RX cukup rxBufferSize. Blocking selama satu koneksi TLS, dipanggil
+  // saat startup setelah WiFi tersambung, tidak pernah dari poll(). Tanpa
+  // probe semua koneksi memakai buffer RX 16 KB
+  bool probeTls();
+  // blok heap bebas terbesar yang dibutuhkan satu koneksi dengan buffer hasil
+  // probe, untuk MemTelemetry::setDegradeThreshold()
+  uint32_t tlsBlockNeeded() const;
+  const TlsProfile& tlsProfile() const { return m_tls; }
+  void setPinnedKey(const char* pem);
+  size_t formatTls(char* buf, size_t len) const;
+
  private:
+  void prepareTls();
   String HTTPGet(const char* apiMethod);
   String HTTPPost(const char* apiMethod, const String& payload);
   String buildURL(const char* apiMethod);
+  String buildPath(const char* apiMethod);
+  String buildMessagePayload(const String& msg, const char* method = nullptr,
+                             int32_t messageId = 0);
+  bool parseUpdate(const char* json, size_t len, MessageBody* msgBody);
+  template <typename T>
+  bool readUpdate(T update, MessageBody* msgBody);
+  bool submit(TelekMethod method, const String& payload, int32_t messageId,
+              MessageCallback callback, void* ctx);
+  bool enqueue(const OutboxEntry& entry);
+  bool deferred() const;
+  void complete(const OutboxEntry& entry, bool ok, const char* response);
+  bool startUpload(AsyncHttp& http);
+
+  static void onAsyncSent(const AsyncHttpResult& result, void* ctx);
+  static void onAsyncUpload(const AsyncHttpResult& result, void* ctx);
+  static void onAsyncUpdate(const AsyncHttpResult& result, void* ctx);
 };
 
 inline void Telek::setChatId(const char* chatId) {
@@ -51,4 +219,8 @@ inline void Telek::setChatId(const char* chatId) {
 
 inline String Telek::buildURL(const char* apiMethod) {
   return String(BASE_API_URL) + m_token + "/" + apiMethod;
+}
+
+inline String Telek::buildPath(const char* apiMethod) {
+  return String("/bot") + m_token + "/" + apiMethod;
 }
\ No newline at end of file
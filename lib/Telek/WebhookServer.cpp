@@ -0,0 +1,236 @@
+#include "WebhookServer.h"
+
+#include <Log.h>
+#include <Stats.h>
+#include <string.h>
+
+// ukuran potongan response yang ditulis per poll()
+#define SEND_CHUNK_SIZE 256
+
+namespace {
+const char* statusText(int status) {
+  switch (status) {
+    case 200:
+      return "OK";
+    case 400:
+      return "Bad Request";
+    case 401:
+      return "Unauthorized";
+    case 404:
+      return "Not Found";
+    case 405:
+      return "Method Not Allowed";
+    case 408:
+      return "Request Timeout";
+    case 411:
+      return "Length Required";
+    case 413:
+      return "Payload Too Large";
+    default:
+      return "Error";
+  }
+}
+}  // namespace
+
+// constructor
+WebhookServer::WebhookServer(uint16_t port, const char* path,
+                             const char* secret)
+    : m_server(port),
+      m_path(path),
+      m_secret(secret),
+      m_handler(nullptr),
+      m_ctx(nullptr),
+      m_phase(WebhookPhase::IDLE),
+      m_requestStart(0),
+      m_lineLen(0),
+      m_requestParsed(false),
+      m_secretOk(false),
+      m_status(0),
+      m_contentLength(-1),
+      m_bodyLen(0),
+      m_sent(0) {
+  m_body[0] = '\0';
+}
+
+void WebhookServer::begin(WebhookHandler handler, void* ctx) {
+  m_handler = handler;
+  m_ctx = ctx;
+  m_server.begin();
+}
+
+bool WebhookServer::poll() {
+  if (m_phase != WebhookPhase::IDLE &&
+      millis() - m_requestStart >= WEBHOOK_TIMEOUT) {
+    LOG_W("webhook timeout");
+    if (m_phase == WebhookPhase::SEND)
+      close();
+    else
+      respond(408, String());
+  }
+
+  switch (m_phase) {
+    case WebhookPhase::IDLE:
+      accept();
+      break;
+    case WebhookPhase::RECV_HEADERS:
+      stepHeaders();
+      break;
+    case WebhookPhase::RECV_BODY:
+      stepBody();
+      break;
+    case WebhookPhase::SEND:
+      stepSend();
+      break;
+  }
+
+  return busy();
+}
+
+void WebhookServer::accept() {
+  m_client = m_server.accept();
+  if (!m_client.connected()) return;
+
+  m_client.setNoDelay(true);
+  m_lineLen = 0;
+  m_requestParsed = false;
+  m_secretOk = m_secret == nullptr;
+  m_status = 0;
+  m_contentLength = -1;
+  m_bodyLen = 0;
+  m_requestStart = millis();
+  m_phase = WebhookPhase::RECV_HEADERS;
+}
+
+void WebhookServer::stepHeaders() {
+  uint16_t budget = WEBHOOK_POLL_BUDGET;
+
+  while (budget-- > 0 && m_client.available() > 0) {
+    int c = m_client.read();
+    if (c < 0) break;
+
+    if (c == '\n') {
+      m_line[m_lineLen] = '\0';
+      headerLine();
+      m_lineLen = 0;
+      if (m_phase != WebhookPhase::RECV_HEADERS) return;
+    } else if (c != '\r' && m_lineLen < sizeof(m_line) - 1) {
+      m_line[m_lineLen++] = c;
+    }
+  }
+
+  if (!m_client.connected() && m_client.available() == 0) close();
+}
+
+void WebhookServer::headerLine() {
+  if (!m_requestParsed) {
+    // contoh: POST /telegram HTTP/1.1
+    m_requestParsed = true;
+    char* path = strchr(m_line, ' ');
+    char* version = path ? strchr(path + 1, ' ') : nullptr;
+    if (!version) {
+      m_status = 400;
+      return;
+    }
+    *version = '\0';
+    if (strncmp(m_line, "POST ", 5) != 0)
+      m_status = 405;
+    else if (strcmp(path + 1, m_path) != 0)
+      m_status = 404;
+    return;
+  }
+
+  if (m_lineLen == 0) {
+    // request yang ditolak dijawab tanpa membaca body
+    if (m_status == 0 && !m_secretOk) m_status = 401;
+    if (m_status == 0 && m_contentLength < 0) m_status = 411;
+    if (m_status == 0 && m_contentLength > WEBHOOK_BODY_SIZE) m_status = 413;
+
+    if (m_status != 0) {
+      STATS_COUNT(WEBHOOK_REJECTED);
+      LOG_W("webhook ditolak: %d", m_status);
+      respond(m_status, String());
+    } else {
+      m_phase = WebhookPhase::RECV_BODY;
+      stepBody();
+    }
+    return;
+  }
+
+  if (strncasecmp(m_line, "Content-Length:", 15) == 0) {
+    m_contentLength = atol(m_line + 15);
+  } else if (m_secret && strncasecmp(m_line, WEBHOOK_SECRET_HEADER ":",
+                                     strlen(WEBHOOK_SECRET_HEADER) + 1) == 0) {
+    const char* value = m_line + strlen(WEBHOOK_SECRET_HEADER) + 1;
+    while (*value == ' ') value++;
+    m_secretOk = strcmp(value, m_secret) == 0;
+  }
+}
+
+void WebhookServer::stepBody() {
+  size_t remaining = m_contentLength - m_bodyLen;
+  uint16_t budget = WEBHOOK_POLL_BUDGET;
+
+  while (remaining > 0 && budget > 0) {
+    int available = m_client.available();
+    if (available <= 0) break;
+
+    size_t want = remaining < static_cast<size_t>(available) ? remaining
+                                                               : available;
+    if (want > budget) want = budget;
+    int n = m_client.read(reinterpret_cast<uint8_t*>(m_body + m_bodyLen),
+                          want);
+    if (n <= 0) break;
+
+    m_bodyLen += n;
+    remaining -= n;
+    budget -= n;
+  }
+
+  if (remaining > 0) {
+    if (!m_client.connected() && m_client.available() == 0) close();
+    return;
+  }
+
+  m_body[m_bodyLen] = '\0';
+  String reply;
+  if (m_handler) {
+    STATS_SCOPE(WEBHOOK);
+    m_handler(m_body, m_bodyLen, reply, m_ctx);
+  }
+  respond(200, reply);
+}
+
+void WebhookServer::respond(int status, const String& body) {
+  m_response = String();
+  m_response.reserve(body.length() + 128);
+  m_response += "HTTP/1.1 ";
+  m_response += status;
+  m_response += ' ';
+  m_response += statusText(status);
+  m_response += "\r\nConnection: close\r\n";
+  if (body.length() > 0) m_response += "Content-Type: application/json\r\n";
+  m_response += "Content-Length: ";
+  m_response += body.length();
+  m_response += "\r\n\r\n";
+  m_response += body;
+
+  m_sent = 0;
+  m_phase = WebhookPhase::SEND;
+}
+
+void WebhookServer::stepSend() {
+  size_t remaining = m_response.length() - m_sent;
+  size_t chunk = remaining < SEND_CHUNK_SIZE ? remaining : SEND_CHUNK_SIZE;
+
+  size_t written = m_client.write(
+      reinterpret_cast<const uint8_t*>(m_response.c_str()) + m_sent, chunk);
+  m_sent += written;
+
+  if (m_sent >= m_response.length() || !m_client.connected()) close();
+}
+
+void WebhookServer::close() {
+  m_client.stop();
+  m_response = String();
+  m_phase = WebhookPhase::IDLE;
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <Arduino.h>
+#ifdef ESP32
+#include <WiFi.h>
+#else
+#include <ESP8266WiFi.h>
+#endif
+
+#ifndef WEBHOOK_BODY_SIZE
+#define WEBHOOK_BODY_SIZE 2048
+#endif
+
+// batas satu request dari accept sampai response terkirim
+#define WEBHOOK_TIMEOUT 3000
+// jumlah byte maksimal yang diproses dalam satu kali poll()
+#define WEBHOOK_POLL_BUDGET 512
+#define WEBHOOK_SECRET_HEADER "X-Telegram-Bot-Api-Secret-Token"
+
+enum class WebhookPhase : uint8_t {
+  IDLE,
+  RECV_HEADERS,
+  RECV_BODY,
+  SEND,
+};
+
+// body berisi satu objek Update dari Telegram. reply boleh diisi satu
+// method call JSON ({"method":"sendMessage",...}) yang dijalankan Telegram
+// sebagai balasan tanpa request terpisah
+typedef void (*WebhookHandler)(const char* body, size_t len, String& reply,
+                               void* ctx);
+
+/**
+ * Server HTTP/1.1 minimal untuk menerima update webhook Telegram, satu
+ * koneksi pada satu waktu dan dijalankan bertahap lewat poll() seperti
+ * AsyncHttp. TLS diterminasi oleh reverse proxy di LAN, jadi server hanya
+ * HTTP dan request diverifikasi dengan header secret token dari setWebhook.
+ *
+ * Hanya POST ke path yang terdaftar dengan Content-Length yang diterima,
+ * request lain langsung dijawab 4xx lalu koneksi ditutup.
+ */
+class WebhookServer {
+ private:
+  WiFiServer m_server;
+  WiFiClient m_client;
+  const char* m_path;
+  const char* m_secret;
+  WebhookHandler m_handler;
+  void* m_ctx;
+
+  WebhookPhase m_phase;
+  uint32_t m_requestStart;
+
+  char m_line[128];
+  uint8_t m_lineLen;
+  bool m_requestParsed;
+  bool m_secretOk;
+  int m_status;  // status error yang akan dikirim, 0 jika request valid
+  long m_contentLength;
+
+  char m_body[WEBHOOK_BODY_SIZE + 1];
+  size_t m_bodyLen;
+
+  String m_response;
+  size_t m_sent;
+
+ public:
+  // constructor
+  WebhookServer(uint16_t port, const char* path, const char* secret = nullptr);
+
+  void begin(WebhookHandler handler, void* ctx = nullptr);
+  // maju satu langkah, return true selama request masih berjalan
+  bool poll();
+  bool busy() const { return m_phase != WebhookPhase::IDLE; }
+
+ private:
+  void accept();
+  void stepHeaders();
+  void stepBody();
+  void stepSend();
+  void headerLine();
+  void respond(int status, const String& body);
+  void close();
+};
@@ -0,0 +1,178 @@
+#include "Trace.h"
+
+#ifdef TRACE_ENABLE
+
+#include <stdio.h>
+
+#include <atomic>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#endif
+#ifdef ESP32
+#include <esp_attr.h>
+#include <esp_system.h>
+#elif defined(ESP8266)
+#include <Shadow.h>
+#include <user_interface.h>
+#endif
+
+#define TRACE_MAGIC 0x54524331  // "TRC1"
+#define TRACE_MASK (TRACE_CAPACITY - 1)
+
+namespace {
+// semua field 32 bit karena RTC memory ESP8266 hanya bisa diakses per word
+struct TraceBuffer {
+  uint32_t magic;
+  uint32_t head;  // jumlah record yang pernah ditulis
+  uint32_t bootCount;
+  uint32_t reserved;
+  TraceRecord records[TRACE_CAPACITY];
+};
+
+#if defined(ESP32)
+RTC_NOINIT_ATTR TraceBuffer rtcBuffer;
+volatile TraceBuffer* const store = &rtcBuffer;
+#elif defined(ESP8266)
+// RTC user memory dimulai di 0x60001200 (blok 64 RTC memory sistem), ditulis
+// langsung agar satu event cukup beberapa store tanpa panggilan SDK
+#define RTC_USER_MEMORY 0x60001200
+// RTC user memory dalam satuan blok 4 byte: cache FastBoot, shadow, trace
+#define TRACE_RTC_OFFSET (SHADOW_RTC_OFFSET + SHADOW_RTC_BLOCKS)
+static_assert(TRACE_RTC_OFFSET >= SHADOW_RTC_OFFSET + SHADOW_RTC_BLOCKS,
+              "trace menimpa shadow di RTC user memory");
+static_assert(TRACE_RTC_OFFSET * 4 + sizeof(TraceBuffer) <= 512,
+              "trace melebihi RTC user memory");
+volatile TraceBuffer* const store = reinterpret_cast<volatile TraceBuffer*>(
+    RTC_USER_MEMORY + TRACE_RTC_OFFSET * 4);
+#else
+TraceBuffer hostBuffer;
+volatile TraceBuffer* const store = &hostBuffer;
+#endif
+
+bool started = false;
+std::atomic<uint32_t> nextSeq(0);
+
+TraceRecord previousRecords[TRACE_CAPACITY];
+uint16_t previousTotal = 0;
+uint32_t bootReason = 0;
+
+const char* const EVENT_NAMES[] = {
+    "none",      "boot",      "task+",   "task-", "http",
+    "http_done", "mqtt_up",   "mqtt_dn", "wifi",  "relay",
+    "heap_low",  "degrade",   "mark",
+};
+static_assert(sizeof(EVENT_NAMES) / sizeof(EVENT_NAMES[0]) ==
+                  static_cast<size_t>(TraceEvent::MARK) + 1,
+              "nama event tidak lengkap");
+
+uint32_t nowUs() {
+#ifdef ARDUINO
+  return micros();
+#else
+  return 0;
+#endif
+}
+
+uint32_t readResetReason() {
+#if defined(ESP32)
+  return static_cast<uint32_t>(esp_reset_reason());
+#elif defined(ESP8266)
+  return ESP.getResetInfoPtr()->reason;
+#else
+  return 0;
+#endif
+}
+}  // namespace
+
+void Trace::begin() {
+  bool valid = store->magic == TRACE_MAGIC;
+  uint32_t bootCount = 0;
+
+  previousTotal = 0;
+  if (valid) {
+    uint32_t head = store->head;
+    uint32_t count = head < TRACE_CAPACITY ? head : TRACE_CAPACITY;
+    for (uint32_t i = 0; i < count; i++) {
+      volatile const TraceRecord& slot =
+          store->records[(head - count + i) & TRACE_MASK];
+      previousRecords[i].time = slot.time;
+      previousRecords[i].info = slot.info;
+    }
+    previousTotal = count;
+    bootCount = store->bootCount + 1;
+  }
+
+  store->magic = 0;
+  store->head = 0;
+  store->bootCount = bootCount;
+  store->magic = TRACE_MAGIC;
+
+  nextSeq.store(0);
+  bootReason = readResetReason();
+  started = true;
+  record(TraceEvent::BOOT, static_cast<uint8_t>(bootReason));
+}
+
+void Trace::record(TraceEvent event, uint8_t arg, uint16_t data) {
+  if (!started) return;
+
+  uint32_t seq = nextSeq.fetch_add(1, std::memory_order_relaxed);
+  volatile TraceRecord& slot = store->records[seq & TRACE_MASK];
+  slot.time = nowUs();
+  slot.info = static_cast<uint32_t>(event) << 24 |
+              static_cast<uint32_t>(arg) << 16 | data;
+  store->head = seq + 1;
+}
+
+uint16_t Trace::previousCount() { return previousTotal; }
+
+const TraceRecord* Trace::previous(uint16_t index) {
+  return index < previousTotal ? &previousRecords[index] : nullptr;
+}
+
+uint32_t Trace::resetReason() { return bootReason; }
+
+uint16_t Trace::hexDump(char* buf, size_t len, uint16_t first) {
+  size_t pos = 0;
+  if (len > 0) buf[0] = '\0';
+
+  uint16_t i = first;
+  // 16 hex + spasi + '\0'
+  for (; i < previousTotal && pos + 18 <= len; i++) {
+    pos += snprintf(buf + pos, len - pos, "%08lx%08lx ",
+                    static_cast<unsigned long>(previousRecords[i].time),
+                    static_cast<unsigned long>(previousRecords[i].info));
+  }
+  return i;
+}
+
+void Trace::dumpPrevious() {
+#ifdef ARDUINO
+  if (previousTotal == 0) return;
+
+  Serial.printf("trace sebelum reset (alasan %lu, %u event):\n",
+                static_cast<unsigned long>(bootReason), previousTotal);
+
+  uint32_t start = previousRecords[0].time;
+  for (uint16_t i = 0; i < previousTotal; i++) {
+    const TraceRecord& r = previousRecords[i];
+    uint8_t event = r.info >> 24;
+    Serial.printf("  +%10lu us %-9s arg %3u data %5u  %08lx%08lx\n",
+                  static_cast<unsigned long>(r.time - start),
+                  eventName(static_cast<TraceEvent>(event)),
+                  static_cast<unsigned>((r.info >> 16) & 0xFF),
+                  static_cast<unsigned>(r.info & 0xFFFF),
+                  static_cast<unsigned long>(r.time),
+                  static_cast<unsigned long>(r.info));
+  }
+#endif
+}
+
+const char* Trace::eventName(TraceEvent event) {
+  uint8_t index = static_cast<uint8_t>(event);
+  return index <= static_cast<uint8_t>(TraceEvent::MARK) ? EVENT_NAMES[index]
+                                                          : "?";
+}
+
+#endif
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Trace event biner di RTC memory yang tetap utuh setelah reset (watchdog,
+ * panic, brownout, software reset), tetapi tidak setelah power-on. Saat
+ * boot, Trace::begin() menyalin trace sesi sebelumnya ke RAM untuk dikirim
+ * lewat serial, MQTT atau Telegram, lalu memulai trace baru.
+ *
+ * Satu record 8 byte: waktu (micros) dan info = event | arg | data. Dump
+ * berupa token hex 16 karakter per record yang dibaca tools/trace_decode.py.
+ */
+
+// jumlah record, harus pangkat 2
+#ifndef TRACE_CAPACITY
+#ifdef ESP32
+#define TRACE_CAPACITY 256
+#else
+#define TRACE_CAPACITY 32  // 16 + 256 B dari 464 B setelah FastBoot dan Shadow
+#endif
+#endif
+
+static_assert((TRACE_CAPACITY & (TRACE_CAPACITY - 1)) == 0,
+              "TRACE_CAPACITY harus pangkat 2");
+
+// urutan harus sama dengan tools/trace_decode.py
+enum class TraceEvent : uint8_t {
+  NONE,
+  BOOT,             // arg: alasan reset
+  TASK_BEGIN,       // arg: id job/task
+  TASK_END,         // arg: id job/task, data: durasi ms
+  HTTP_PHASE,       // arg: AsyncHttpPhase, TRACE_HTTP_BLOCKING = HTTPClient
+  HTTP_DONE,        // arg: AsyncHttpError, data: status HTTP
+  MQTT_CONNECT,     // arg: session present
+  MQTT_DISCONNECT,  // arg: AsyncMqttClientDisconnectReason
+  WIFI,             // arg: 1 tersambung, 0 terputus
+  RELAY,            // arg: TraceRelay, data: tank << 8 | 1 nyala, 0 mati
+  HEAP_LOW,         // arg: fragmentasi %, data: free heap / 16
+  DEGRADE,          // arg: 1 masuk, 0 keluar, data: blok terbesar / 16
+  MARK,             // bebas dipakai saat debugging
+};
+
+enum class TraceRelay : uint8_t {
+  LED,
+  PUMP,
+};
+
+#define TRACE_HTTP_BLOCKING 0xFF
+
+struct TraceRecord {
+  uint32_t time;  // micros()
+  uint32_t info;  // event << 24 | arg << 16 | data
+};
+
+#ifdef TRACE_ENABLE
+
+namespace Trace {
+// panggil paling awal di setup(), sebelum event pertama
+void begin();
+void record(TraceEvent event, uint8_t arg = 0, uint16_t data = 0);
+
+// trace sesi sebelumnya, urut dari yang terlama
+uint16_t previousCount();
+const TraceRecord* previous(uint16_t index);
+uint32_t resetReason();
+
+// tulis token hex mulai dari record ke-first, return index record berikutnya
+uint16_t hexDump(char* buf, size_t len, uint16_t first);
+// cetak trace sesi sebelumnya ke Serial, blocking, hanya untuk saat boot
+void dumpPrevious();
+
+const char* eventName(TraceEvent event);
+}  // namespace Trace
+
+#define TRACE(event, ...) Trace::record(TraceEvent::event, ##__VA_ARGS__)
+
+#else
+
+#define TRACE(event, ...) \
+  do {                    \
+  } while (0)
+
+#endif
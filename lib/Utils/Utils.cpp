@@ -0,0 +1,27 @@
+#include "Utils.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+
+size_t append(char* buf, size_t len, size_t pos, const char* fmt, ...) {
+  if (pos >= len) return pos;
+
+  va_list args;
+  va_start(args, fmt);
+  int written = vsnprintf(buf + pos, len - pos, fmt, args);
+  va_end(args);
+
+  if (written < 0) return pos;
+  pos += written;
+  return pos < len ? pos : len - 1;
+}
+
+uint32_t crc32(const uint8_t* data, size_t len) {
+  uint32_t crc = 0xFFFFFFFF;
+  while (len--) {
+    crc ^= *data++;
+    for (uint8_t i = 0; i < 8; i++)
+      crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+  }
+  return ~crc;
+}
@@ -1,7 +1,18 @@
 #pragma once
 
+#include <stddef.h>
+#include <stdint.h>
 #include <string.h>
 
 inline bool streq(const char* str1, const char* str2) {
   return strcmp(str1, str2) == 0;
 }
+
+// snprintf ke buf + pos yang tidak melewati akhir buffer saat dipanggil
+// berurutan, return posisi baru (paling jauh len - 1)
+size_t append(char* buf, size_t len, size_t pos, const char* fmt, ...)
+    __attribute__((format(printf, 4, 5)));
+
+// CRC-32 (IEEE, reflected) untuk memvalidasi data tersimpan di NVS, EEPROM
+// atau RTC user memory
+uint32_t crc32(const uint8_t* data, size_t len);
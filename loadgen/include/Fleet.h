@@ -0,0 +1,142 @@
+#pragma once
+
+#include <AquaProto.h>
+#include <netinet/in.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "MqttConn.h"
+
+// relay per node berupa bitmask 8 bit seperti TankBank di firmware
+#define LOADGEN_TANK_MAX 8
+
+/**
+ * Armada node akuarium virtual terhadap satu broker MQTT, semuanya di satu
+ * event loop epoll. Setiap node memakai skema topik dan encoder payload
+ * firmware (lib/AquaProto) dengan ID perangkat sendiri: birth retained di
+ * aquarium/<id>/meta dengan last will offline, data sensor berkala di
+ * aquarium/<id>/sensor, status kontrol retained di aquarium/<id>/control,
+ * dan menjawab perintah di aquarium/<id>/command seperti main_mqtt.cpp.
+ *
+ * Satu koneksi pengamat berperan seperti bridge web/mqtt/server.js:
+ * berlangganan aquarium/+/..., mengirim perintah kontrol dengan correlation
+ * id ke satu node acak, mengukur round-trip sampai status kontrol kembali,
+ * dan mengukur latency pengiriman data sensor dari timestamp payload (jam
+ * monotonic yang sama, resolusi 1 ms). Saat selesai, meta dan status
+ * retained milik node dihapus dari broker.
+ */
+
+namespace LoadGen {
+
+struct FleetOptions {
+  std::string host;
+  uint16_t port;
+  const char* user;
+  const char* password;
+  uint32_t nodes;
+  uint8_t tanks;         // tank per node
+  uint32_t intervalMs;   // jeda publish data sensor per node
+  uint32_t durationS;
+  double commandRate;    // perintah kontrol per detik dari pengamat
+  size_t maxQueue;       // antrean byte per koneksi sebelum publish dibuang
+  uint32_t rampPerS;     // koneksi node baru per detik
+  uint32_t reportS;
+  uint32_t seed;
+};
+
+extern const FleetOptions DEFAULT_FLEET;
+
+struct FleetCounters {
+  uint64_t published;    // data sensor masuk antrean koneksi
+  uint64_t dropped;      // dibuang karena antrean melebihi maxQueue
+  uint64_t received;     // data sensor yang sampai di pengamat
+  uint64_t commands;
+  uint64_t replies;      // status kontrol dengan id yang sedang ditunggu
+  uint64_t timeouts;     // perintah tanpa satu pun jawaban
+  uint64_t births;       // meta online yang sampai di pengamat
+  uint64_t disconnects;
+  uint64_t stalls;       // write() berhenti karena socket penuh
+};
+
+// sampel latency dalam ms
+class Samples {
+ private:
+  std::vector<double> m_values;
+
+ public:
+  void add(double ms) { m_values.push_back(ms); }
+  void merge(const Samples& other);
+  void clear() { m_values.clear(); }
+  size_t count() const { return m_values.size(); }
+  // p dalam 0..100, NaN jika belum ada sampel
+  double percentile(double p) const;
+};
+
+struct Node;
+struct Observer;
+
+class Fleet {
+ private:
+  FleetOptions m_opt;
+  sockaddr_in m_broker;
+  int m_epoll;
+  uint64_t m_startUs;
+  std::mt19937 m_rng;
+
+  std::vector<std::unique_ptr<Node>> m_nodes;
+  std::unique_ptr<Observer> m_observer;
+
+  FleetCounters m_total;
+  FleetCounters m_last;  // m_total saat laporan sebelumnya
+  Samples m_rtt;         // round-trip perintah, interval berjalan
+  Samples m_delivery;    // publish node sampai diterima pengamat
+  Samples m_rttAll;
+  Samples m_deliveryAll;
+  size_t m_queuePeak;    // antrean terbesar satu koneksi, interval berjalan
+  size_t m_queuePeakAll;
+  double m_lagPeak;      // keterlambatan jadwal publish di event loop (ms)
+  double m_lagPeakAll;
+  uint64_t m_nextReportUs;
+  uint64_t m_lastReportUs;
+
+ public:
+  explicit Fleet(const FleetOptions& options);
+  ~Fleet();
+
+  // false jika broker tidak bisa dijangkau
+  bool run();
+  // aman dipanggil dari signal handler
+  static void stop();
+
+ private:
+  bool resolve();
+  void tick(uint64_t now);
+  void tickNode(Node& node, uint64_t now);
+  void tickObserver(uint64_t now);
+  void event(uint32_t key, uint32_t events);
+
+  void open(MqttConn& conn, uint32_t key, const std::string& clientId,
+            bool& wantWrite);
+  void drop(MqttConn& conn, uint64_t& reconnectUs);
+  void watch(MqttConn& conn, uint32_t key, bool& wantWrite);
+
+  void onConnected(Node& node);
+  void onCommand(Node& node, const char* payload, size_t len);
+  void publishSensor(Node& node);
+  void publishControlStatus(Node& node, const CommandTiming* timing);
+  void onObserved(const std::string& topic, const char* payload,
+                  size_t len);
+  void sendCommand(uint64_t now);
+
+  uint32_t elapsedMs(uint64_t now) const;
+  uint32_t connectedNodes() const;
+  void report(uint64_t now);
+  void summary(uint64_t now);
+  void shutdown();
+};
+}  // namespace LoadGen
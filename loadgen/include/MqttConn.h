@@ -0,0 +1,85 @@
+#pragma once
+
+#include <netinet/in.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * Klien MQTT 3.1.1 minimal untuk load generator: satu koneksi TCP
+ * non-blocking yang digerakkan oleh event loop epoll dari luar. Hanya QoS 0
+ * dan tanpa retry, paket yang tidak dikenal dilewati. Last will (QoS 0)
+ * dipasang lewat setWill() sebelum open(), seperti AsyncMqttClient.
+ *
+ * Paket keluar ditampung di antrean byte per koneksi dan ditulis sampai
+ * socket penuh (EAGAIN). Ukuran antrean itu yang dipakai sebagai ukuran
+ * backpressure broker.
+ */
+
+namespace LoadGen {
+
+typedef std::function<void(const std::string& topic, const char* payload,
+                           size_t len)>
+    PublishHandler;
+
+class MqttConn {
+ private:
+  int m_fd;
+  bool m_tcpUp;      // connect() non-blocking selesai
+  bool m_connected;  // CONNACK sukses diterima
+  std::vector<uint8_t> m_out;
+  size_t m_outPos;
+  std::vector<uint8_t> m_in;
+  uint16_t m_packetId;
+  uint64_t m_lastSendUs;
+  uint64_t m_stalls;  // write() berhenti karena socket penuh
+  std::string m_willTopic;
+  std::string m_willPayload;
+  bool m_willRetain;
+
+ public:
+  MqttConn();
+  ~MqttConn();
+  MqttConn(const MqttConn&) = delete;
+  MqttConn& operator=(const MqttConn&) = delete;
+
+  // berlaku untuk open() berikutnya, topic kosong = tanpa will
+  void setWill(const std::string& topic, const std::string& payload,
+               bool retain);
+  // membuka socket non-blocking, CONNECT dikirim setelah TCP tersambung
+  bool open(const sockaddr_in& broker, const std::string& clientId,
+            const char* user, const char* password, uint16_t keepAlive);
+  void close();
+
+  int fd() const { return m_fd; }
+  bool connected() const { return m_connected; }
+  size_t queued() const { return m_out.size() - m_outPos; }
+  // EPOLLOUT dibutuhkan selama connect() atau antrean belum selesai
+  bool wantsWrite() const { return m_fd >= 0 && (!m_tcpUp || queued() > 0); }
+  uint64_t lastSendUs() const { return m_lastSendUs; }
+  uint64_t stalls() const { return m_stalls; }
+
+  void subscribe(const char* topic);
+  void publish(const char* topic, const char* payload, size_t len,
+               bool retain);
+  void ping();
+  // putus bersih: broker tidak mengirim will
+  void disconnect();
+
+  // dipanggil saat EPOLLOUT / EPOLLIN, false jika koneksi harus ditutup
+  bool onWritable();
+  bool onReadable(const PublishHandler& handler);
+
+ private:
+  void begin(uint8_t header, size_t remaining);
+  void putString(const char* str, size_t len);
+  void putU16(uint16_t value);
+  bool flush();
+  bool parse(const PublishHandler& handler);
+};
+
+uint64_t nowUs();
+}  // namespace LoadGen
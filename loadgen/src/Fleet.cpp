@@ -0,0 +1,656 @@
+#include "Fleet.h"
+
+#include <ArduinoJson.h>
+#include <arpa/inet.h>
+#include <math.h>
+#include <netdb.h>
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
+// perintah untuk semua perangkat, lihat DeviceTopics
+#define TOPIC_BROADCAST AQUA_TOPIC_ROOT "/" AQUA_BROADCAST_ID "/command"
+
+#define KEEP_ALIVE_S 30
+#define RECONNECT_DELAY_US 2000000  // sama dengan reconnect timer firmware
+#define COMMAND_TIMEOUT_US 5000000
+#define SHUTDOWN_US 2000000  // batas waktu menghapus data retained
+#define TICK_US 1000  // resolusi jadwal publish dan perintah
+#define MAX_EVENTS 256
+#define OBSERVER_KEY UINT32_MAX
+
+namespace LoadGen {
+
+const FleetOptions DEFAULT_FLEET = {
+    "127.0.0.1",  // host
+    1883,         // port
+    nullptr,      // user
+    nullptr,      // password
+    100,          // nodes
+    1,            // tanks
+    5000,         // intervalMs, sensorReportMs firmware
+    60,           // durationS
+    2.0,          // commandRate
+    64 * 1024,    // maxQueue
+    100,          // rampPerS
+    5,            // reportS
+    1,            // seed
+};
+
+namespace {
+volatile sig_atomic_t stopRequested = 0;
+
+// perintah yang menunggu status kontrol dengan id yang sama
+struct Pending {
+  uint64_t sentUs;
+  uint32_t replies;
+};
+}  // namespace
+
+struct Node {
+  MqttConn conn;
+  uint32_t index;
+  char id[AQUA_DEVICE_ID_SIZE];
+  // aquarium/<id>/..., dibuat sekali saat start
+  char topicCommand[AQUA_TOPIC_SIZE];
+  char topicSensor[AQUA_TOPIC_SIZE];
+  char topicControl[AQUA_TOPIC_SIZE];
+  char topicMeta[AQUA_TOPIC_SIZE];
+  bool wantWrite;
+  bool online;  // CONNACK sudah diproses
+  uint64_t nextConnectUs;
+  uint64_t nextPublishUs;
+  uint8_t led;
+  uint8_t pump;
+  float temp[LOADGEN_TANK_MAX];
+  float level[LOADGEN_TANK_MAX];
+};
+
+struct Observer {
+  MqttConn conn;
+  bool wantWrite;
+  bool online;
+  uint64_t nextConnectUs;
+  uint64_t nextCommandUs;
+  uint32_t nextId;
+  std::unordered_map<uint32_t, Pending> pending;
+  std::unordered_set<std::string> discovered;  // ID dari meta online
+};
+
+void Samples::merge(const Samples& other) {
+  m_values.insert(m_values.end(), other.m_values.begin(),
+                  other.m_values.end());
+}
+
+double Samples::percentile(double p) const {
+  if (m_values.empty()) return NAN;
+  std::vector<double> sorted(m_values);
+  size_t rank = static_cast<size_t>(p / 100 * (sorted.size() - 1) + 0.5);
+  std::nth_element(sorted.begin(), sorted.begin() + rank, sorted.end());
+  return sorted[rank];
+}
+
+// constructor
+Fleet::Fleet(const FleetOptions& options)
+    : m_opt(options),
+      m_broker(),
+      m_epoll(-1),
+      m_startUs(0),
+      m_rng(options.seed),
+      m_total(),
+      m_last(),
+      m_queuePeak(0),
+      m_queuePeakAll(0),
+      m_lagPeak(0),
+      m_lagPeakAll(0),
+      m_nextReportUs(0),
+      m_lastReportUs(0) {
+  if (m_opt.tanks < 1) m_opt.tanks = 1;
+  if (m_opt.tanks > LOADGEN_TANK_MAX) m_opt.tanks = LOADGEN_TANK_MAX;
+  if (m_opt.rampPerS == 0) m_opt.rampPerS = 1;
+  if (m_opt.reportS == 0) m_opt.reportS = 1;
+}
+
+Fleet::~Fleet() {
+  if (m_epoll >= 0) close(m_epoll);
+}
+
+void Fleet::stop() { stopRequested = 1; }
+
+bool Fleet::resolve() {
+  addrinfo hints = {};
+  hints.ai_family = AF_INET;
+  hints.ai_socktype = SOCK_STREAM;
+  addrinfo* result = nullptr;
+  if (getaddrinfo(m_opt.host.c_str(), nullptr, &hints, &result) != 0 ||
+      !result) {
+    fprintf(stderr, "broker %s tidak ditemukan\n", m_opt.host.c_str());
+    return false;
+  }
+  m_broker = *reinterpret_cast<sockaddr_in*>(result->ai_addr);
+  m_broker.sin_port = htons(m_opt.port);
+  freeaddrinfo(result);
+  return true;
+}
+
+bool Fleet::run() {
+  if (!resolve()) return false;
+
+  // satu fd per node ditambah pengamat, epoll, dan stdio
+  rlimit limit;
+  if (getrlimit(RLIMIT_NOFILE, &limit) == 0) {
+    rlim_t need = m_opt.nodes + 16;
+    if (limit.rlim_cur < need) {
+      limit.rlim_cur = std::min(need, limit.rlim_max);
+      setrlimit(RLIMIT_NOFILE, &limit);
+    }
+    if (limit.rlim_cur < need)
+      fprintf(stderr, "peringatan: batas fd %lu, butuh %lu\n",
+              static_cast<unsigned long>(limit.rlim_cur),
+              static_cast<unsigned long>(need));
+  }
+
+  m_epoll = epoll_create1(EPOLL_CLOEXEC);
+  if (m_epoll < 0) return false;
+
+  m_startUs = nowUs();
+  m_lastReportUs = m_startUs;
+  m_nextReportUs = m_startUs + m_opt.reportS * 1000000ULL;
+
+  // pengamat tersambung lebih dulu agar data node pertama ikut terukur
+  m_observer.reset(new Observer());
+  m_observer->wantWrite = false;
+  m_observer->online = false;
+  m_observer->nextConnectUs = m_startUs;
+  m_observer->nextCommandUs = 0;
+  m_observer->nextId = 1;
+
+  std::uniform_real_distribution<float> temp(25, 29);
+  std::uniform_real_distribution<float> level(70, 95);
+  uint64_t rampUs = 1000000 / m_opt.rampPerS;
+  for (uint32_t i = 0; i < m_opt.nodes; i++) {
+    std::unique_ptr<Node> node(new Node());
+    node->index = i;
+    // ID unik per proses agar beberapa loadgen bisa berbagi broker
+    snprintf(node->id, sizeof(node->id), "load-%d-%u",
+             static_cast<int>(getpid()), i);
+    AquaProto::topic(node->topicCommand, sizeof(node->topicCommand),
+                     node->id, AquaTopic::COMMAND);
+    AquaProto::topic(node->topicSensor, sizeof(node->topicSensor), node->id,
+                     AquaTopic::SENSOR);
+    AquaProto::topic(node->topicControl, sizeof(node->topicControl),
+                     node->id, AquaTopic::CONTROL);
+    AquaProto::topic(node->topicMeta, sizeof(node->topicMeta), node->id,
+                     AquaTopic::META);
+    char will[48 + AQUA_DEVICE_ID_SIZE];
+    size_t willLen = AquaProto::encodeMeta(will, sizeof(will), node->id,
+                                           false, 0, false, nullptr);
+    node->conn.setWill(node->topicMeta, std::string(will, willLen), true);
+    node->wantWrite = false;
+    node->online = false;
+    node->nextConnectUs = m_startUs + 100000 + i * rampUs;
+    node->nextPublishUs = 0;
+    node->led = 0;
+    node->pump = 0;
+    for (uint8_t t = 0; t < m_opt.tanks; t++) {
+      node->temp[t] = temp(m_rng);
+      node->level[t] = level(m_rng);
+    }
+    m_nodes.push_back(std::move(node));
+  }
+
+  printf("loadgen: %u node x %u tank -> %s:%u, publish tiap %u ms, "
+         "%.1f perintah/s, %u s\n",
+         m_opt.nodes, m_opt.tanks, m_opt.host.c_str(), m_opt.port,
+         m_opt.intervalMs, m_opt.commandRate, m_opt.durationS);
+
+  uint64_t endUs = m_startUs + m_opt.durationS * 1000000ULL;
+  epoll_event events[MAX_EVENTS];
+  uint64_t now = m_startUs;
+  uint64_t nextTickUs = now;
+  bool reached = false;
+  while (now < endUs && !stopRequested) {
+    if (now >= nextTickUs) {
+      tick(now);
+      nextTickUs = now + TICK_US;
+    }
+    if (m_observer->online) reached = true;
+
+    int n = epoll_wait(m_epoll, events, MAX_EVENTS, TICK_US / 1000);
+    for (int i = 0; i < n; i++) event(events[i].data.u32, events[i].events);
+    now = nowUs();
+  }
+
+  summary(now);
+  shutdown();
+  if (!reached)
+    fprintf(stderr, "pengamat tidak pernah tersambung ke broker\n");
+  return reached;
+}
+
+void Fleet::tick(uint64_t now) {
+  tickObserver(now);
+  for (std::unique_ptr<Node>& node : m_nodes) tickNode(*node, now);
+  if (now >= m_nextReportUs) {
+    report(now);
+    m_nextReportUs += m_opt.reportS * 1000000ULL;
+  }
+}
+
+void Fleet::tickNode(Node& node, uint64_t now) {
+  MqttConn& conn = node.conn;
+  if (conn.fd() < 0) {
+    if (now < node.nextConnectUs) return;
+    // client ID sama dengan ID perangkat seperti firmware
+    open(conn, node.index, node.id, node.wantWrite);
+    node.online = false;
+    if (conn.fd() < 0) node.nextConnectUs = now + RECONNECT_DELAY_US;
+    return;
+  }
+  if (!node.online) return;
+
+  if (now >= node.nextPublishUs) {
+    double lag = (now - node.nextPublishUs) / 1000.0;
+    m_lagPeak = std::max(m_lagPeak, lag);
+    publishSensor(node);
+    node.nextPublishUs += m_opt.intervalMs * 1000ULL;
+    // event loop tertinggal jauh: jadwal digeser, tidak dikejar
+    if (node.nextPublishUs < now)
+      node.nextPublishUs = now + m_opt.intervalMs * 1000ULL;
+  }
+
+  if (conn.queued() == 0 &&
+      now - conn.lastSendUs() >= KEEP_ALIVE_S * 1000000ULL / 2)
+    conn.ping();
+  m_queuePeak = std::max(m_queuePeak, conn.queued());
+  watch(conn, node.index, node.wantWrite);
+}
+
+void Fleet::tickObserver(uint64_t now) {
+  Observer& observer = *m_observer;
+  MqttConn& conn = observer.conn;
+  if (conn.fd() < 0) {
+    if (now < observer.nextConnectUs) return;
+    char clientId[48];
+    snprintf(clientId, sizeof(clientId), "aqua-load-%d-observer",
+             static_cast<int>(getpid()));
+    open(conn, OBSERVER_KEY, clientId, observer.wantWrite);
+    observer.online = false;
+    if (conn.fd() < 0) observer.nextConnectUs = now + RECONNECT_DELAY_US;
+    return;
+  }
+  if (!observer.online) return;
+
+  for (auto it = observer.pending.begin(); it != observer.pending.end();) {
+    if (now - it->second.sentUs < COMMAND_TIMEOUT_US) {
+      ++it;
+      continue;
+    }
+    if (it->second.replies == 0) m_total.timeouts++;
+    it = observer.pending.erase(it);
+  }
+
+  if (m_opt.commandRate > 0 && now >= observer.nextCommandUs &&
+      connectedNodes() > 0) {
+    sendCommand(now);
+    uint64_t gap = static_cast<uint64_t>(1000000 / m_opt.commandRate);
+    observer.nextCommandUs = std::max(observer.nextCommandUs + gap, now);
+  }
+
+  if (conn.queued() == 0 &&
+      now - conn.lastSendUs() >= KEEP_ALIVE_S * 1000000ULL / 2)
+    conn.ping();
+  watch(conn, OBSERVER_KEY, observer.wantWrite);
+}
+
+void Fleet::event(uint32_t key, uint32_t events) {
+  bool isObserver = key == OBSERVER_KEY;
+  if (!isObserver && key >= m_nodes.size()) return;
+  Node* node = isObserver ? nullptr : m_nodes[key].get();
+  MqttConn& conn = isObserver ? m_observer->conn : node->conn;
+  // event lain di batch yang sama setelah koneksi ditutup
+  if (conn.fd() < 0) return;
+  bool& wantWrite = isObserver ? m_observer->wantWrite : node->wantWrite;
+  uint64_t& reconnectUs =
+      isObserver ? m_observer->nextConnectUs : node->nextConnectUs;
+  bool wasConnected = conn.connected();
+
+  bool ok = !(events & EPOLLERR);
+  if (ok && (events & EPOLLOUT)) ok = conn.onWritable();
+  if (ok && (events & (EPOLLIN | EPOLLHUP | EPOLLRDHUP))) {
+    if (isObserver)
+      ok = conn.onReadable([this](const std::string& topic,
+                                  const char* payload, size_t len) {
+        onObserved(topic, payload, len);
+      });
+    else
+      ok = conn.onReadable([this, node](const std::string& topic,
+                                        const char* payload, size_t len) {
+        if (topic == node->topicCommand || topic == TOPIC_BROADCAST)
+          onCommand(*node, payload, len);
+      });
+  }
+  if (!ok) {
+    drop(conn, reconnectUs);
+    if (isObserver)
+      m_observer->online = false;
+    else
+      node->online = false;
+    return;
+  }
+
+  if (!wasConnected && conn.connected()) {
+    if (isObserver) {
+      m_observer->online = true;
+      m_observer->nextCommandUs = nowUs();
+      // seperti bridge: semua perangkat lewat wildcard
+      char filter[AQUA_TOPIC_SIZE];
+      for (AquaTopic leaf :
+           {AquaTopic::SENSOR, AquaTopic::CONTROL, AquaTopic::META}) {
+        AquaProto::topic(filter, sizeof(filter), "+", leaf);
+        conn.subscribe(filter);
+      }
+    } else {
+      onConnected(*node);
+    }
+  }
+  watch(conn, key, wantWrite);
+}
+
+void Fleet::open(MqttConn& conn, uint32_t key, const std::string& clientId,
+                 bool& wantWrite) {
+  if (!conn.open(m_broker, clientId, m_opt.user, m_opt.password,
+                 KEEP_ALIVE_S))
+    return;
+
+  // EPOLLOUT sampai connect() non-blocking selesai
+  epoll_event ev = {};
+  ev.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP;
+  ev.data.u32 = key;
+  if (epoll_ctl(m_epoll, EPOLL_CTL_ADD, conn.fd(), &ev) < 0) conn.close();
+  wantWrite = true;
+}
+
+void Fleet::drop(MqttConn& conn, uint64_t& reconnectUs) {
+  if (conn.fd() >= 0) epoll_ctl(m_epoll, EPOLL_CTL_DEL, conn.fd(), nullptr);
+  conn.close();
+  m_total.disconnects++;
+  reconnectUs = nowUs() + RECONNECT_DELAY_US;
+}
+
+// EPOLLOUT hanya selama antrean koneksi belum kosong
+void Fleet::watch(MqttConn& conn, uint32_t key, bool& wantWrite) {
+  if (conn.fd() < 0) return;
+  bool want = conn.wantsWrite();
+  if (want == wantWrite) return;
+
+  epoll_event ev = {};
+  ev.events = EPOLLIN | EPOLLRDHUP;
+  if (want) ev.events |= EPOLLOUT;
+  ev.data.u32 = key;
+  if (epoll_ctl(m_epoll, EPOLL_CTL_MOD, conn.fd(), &ev) == 0)
+    wantWrite = want;
+}
+
+void Fleet::onConnected(Node& node) {
+  node.online = true;
+  node.conn.subscribe(node.topicCommand);
+  node.conn.subscribe(TOPIC_BROADCAST);
+
+  // seperti firmware saat connect: birth retained, lalu status relay
+  // retained tanpa id
+  char meta[128];
+  size_t len = AquaProto::encodeMeta(meta, sizeof(meta), node.id, true,
+                                     m_opt.tanks, true, nullptr);
+  node.conn.publish(node.topicMeta, meta, len, true);
+  publishControlStatus(node, nullptr);
+
+  // publish pertama disebar acak dalam satu interval
+  std::uniform_int_distribution<uint64_t> offset(0,
+                                                 m_opt.intervalMs * 1000ULL);
+  node.nextPublishUs = nowUs() + offset(m_rng);
+}
+
+// sama dengan handleCommand() di main_mqtt.cpp
+void Fleet::onCommand(Node& node, const char* payload, size_t len) {
+  CommandTiming timing;
+  timing.receivedUs = static_cast<uint32_t>(nowUs());
+
+  JsonDocument doc;
+  if (deserializeJson(doc, payload, len)) return;
+
+  AquaCommand cmd;
+  bool valid = AquaProto::parseCommand(doc, cmd);
+  timing.id = cmd.id;
+  timing.parsedUs = static_cast<uint32_t>(nowUs());
+
+  if (cmd.type == AquaCommandType::HEARTBEAT) {
+    publishSensor(node);
+    return;
+  }
+  if (cmd.type != AquaCommandType::CONTROL || !valid ||
+      cmd.device == AquaDevice::UNKNOWN || cmd.tank >= m_opt.tanks)
+    return;
+
+  uint8_t& mask = cmd.device == AquaDevice::LED ? node.led : node.pump;
+  if (cmd.on)
+    mask |= 1 << cmd.tank;
+  else
+    mask &= ~(1 << cmd.tank);
+  timing.actuatedUs = static_cast<uint32_t>(nowUs());
+  publishControlStatus(node, &timing);
+}
+
+void Fleet::publishSensor(Node& node) {
+  if (node.conn.queued() > m_opt.maxQueue) {
+    m_total.dropped++;
+    return;
+  }
+
+  std::normal_distribution<float> drift(0, 0.02f);
+  for (uint8_t t = 0; t < m_opt.tanks; t++) {
+    node.temp[t] += drift(m_rng);
+    node.level[t] += drift(m_rng);
+  }
+
+  char buffer[64 + 32 * LOADGEN_TANK_MAX];
+  size_t len = AquaProto::encodeSensor(buffer, sizeof(buffer), node.temp,
+                                       node.level, m_opt.tanks,
+                                       elapsedMs(nowUs()));
+  node.conn.publish(node.topicSensor, buffer, len, false);
+  m_total.published++;
+}
+
+void Fleet::publishControlStatus(Node& node, const CommandTiming* timing) {
+  char buffer[128 + 32 * LOADGEN_TANK_MAX];
+  size_t len = AquaProto::encodeControlStatus(
+      buffer, sizeof(buffer), node.led, node.pump, m_opt.tanks, timing,
+      static_cast<uint32_t>(nowUs()));
+  node.conn.publish(node.topicControl, buffer, len, true);
+}
+
+void Fleet::onObserved(const std::string& topic, const char* payload,
+                       size_t len) {
+  uint64_t now = nowUs();
+  char device[AQUA_DEVICE_ID_SIZE];
+  AquaTopic leaf;
+  if (!AquaProto::parseTopic(topic.c_str(), device, sizeof(device), leaf))
+    return;
+  // meta retained yang dihapus
+  if (len == 0) return;
+
+  JsonDocument doc;
+  if (deserializeJson(doc, payload, len)) return;
+
+  if (leaf == AquaTopic::META) {
+    if ((doc["online"] | false) && m_observer->discovered.insert(device).second)
+      m_total.births++;
+    return;
+  }
+
+  if (leaf == AquaTopic::SENSOR) {
+    uint32_t timestamp = doc["timestamp"] | 0;
+    m_total.received++;
+    m_delivery.add(static_cast<double>(elapsedMs(now) - timestamp));
+    return;
+  }
+
+  // status retained dan jawaban tanpa id tidak dihitung
+  uint32_t id = doc["id"] | 0;
+  auto it = m_observer->pending.find(id);
+  if (leaf != AquaTopic::CONTROL || id == 0 ||
+      it == m_observer->pending.end())
+    return;
+  it->second.replies++;
+  m_total.replies++;
+  m_rtt.add((now - it->second.sentUs) / 1000.0);
+}
+
+// seperti handleClientMessage() di web/mqtt/server.js, ke satu node acak
+// yang sedang online
+void Fleet::sendCommand(uint64_t now) {
+  static const char* const DEVICES[] = {"led", "pump"};
+  std::uniform_int_distribution<int> coin(0, 1);
+  std::uniform_int_distribution<int> tank(1, m_opt.tanks);
+  std::uniform_int_distribution<size_t> pick(0, m_nodes.size() - 1);
+
+  const Node* target = nullptr;
+  size_t start = pick(m_rng);
+  for (size_t i = 0; i < m_nodes.size() && !target; i++) {
+    const Node& node = *m_nodes[(start + i) % m_nodes.size()];
+    if (node.online) target = &node;
+  }
+  if (!target) return;
+
+  Observer& observer = *m_observer;
+  uint32_t id = observer.nextId++;
+  if (observer.nextId == 0) observer.nextId = 1;
+
+  char buffer[128];
+  int len = snprintf(buffer, sizeof(buffer),
+                     "{\"type\":\"control\",\"device\":\"%s\","
+                     "\"state\":\"%s\",\"tank\":%d,\"id\":%lu}",
+                     DEVICES[coin(m_rng)], coin(m_rng) ? "on" : "off",
+                     tank(m_rng), static_cast<unsigned long>(id));
+  observer.pending[id] = {now, 0};
+  observer.conn.publish(target->topicCommand, buffer, len, false);
+  m_total.commands++;
+}
+
+uint32_t Fleet::elapsedMs(uint64_t now) const {
+  return static_cast<uint32_t>((now - m_startUs) / 1000);
+}
+
+uint32_t Fleet::connectedNodes() const {
+  uint32_t count = 0;
+  for (const std::unique_ptr<Node>& node : m_nodes) count += node->online;
+  return count;
+}
+
+void Fleet::report(uint64_t now) {
+  uint64_t stalls = m_observer->conn.stalls();
+  for (const std::unique_ptr<Node>& node : m_nodes)
+    stalls += node->conn.stalls();
+  m_total.stalls = stalls;
+
+  double seconds = (now - m_lastReportUs) / 1e6;
+  printf("[%4us] node %u/%u  pub %.1f/s  terima %.1f/s  buang %lu  "
+         "stall %lu  antrean %zu B  lag %.0f ms  rtt p50 %.1f p99 %.1f ms  "
+         "kirim p50 %.0f p99 %.0f ms\n",
+         elapsedMs(now) / 1000, connectedNodes(), m_opt.nodes,
+         (m_total.published - m_last.published) / seconds,
+         (m_total.received - m_last.received) / seconds,
+         static_cast<unsigned long>(m_total.dropped - m_last.dropped),
+         static_cast<unsigned long>(m_total.stalls - m_last.stalls),
+         m_queuePeak, m_lagPeak, m_rtt.percentile(50), m_rtt.percentile(99),
+         m_delivery.percentile(50), m_delivery.percentile(99));
+  fflush(stdout);
+
+  m_rttAll.merge(m_rtt);
+  m_deliveryAll.merge(m_delivery);
+  m_queuePeakAll = std::max(m_queuePeakAll, m_queuePeak);
+  m_lagPeakAll = std::max(m_lagPeakAll, m_lagPeak);
+  m_rtt.clear();
+  m_delivery.clear();
+  m_queuePeak = 0;
+  m_lagPeak = 0;
+  m_last = m_total;
+  m_lastReportUs = now;
+}
+
+void Fleet::summary(uint64_t now) {
+  report(now);
+
+  double seconds = (now - m_startUs) / 1e6;
+  double replies = m_total.commands
+                       ? static_cast<double>(m_total.replies) /
+                             m_total.commands
+                       : 0;
+  double received = m_total.published
+                        ? 100.0 * m_total.received / m_total.published
+                        : 0;
+  printf("\nringkasan %.0f s\n", seconds);
+  printf("  node tersambung   %u/%u, putus %lu, ditemukan lewat meta %lu\n",
+         connectedNodes(), m_opt.nodes,
+         static_cast<unsigned long>(m_total.disconnects),
+         static_cast<unsigned long>(m_total.births));
+  printf("  data sensor       %lu (%.1f/s), dibuang %lu, diterima %.1f%%\n",
+         static_cast<unsigned long>(m_total.published),
+         m_total.published / seconds,
+         static_cast<unsigned long>(m_total.dropped), received);
+  printf("  perintah          %lu, jawaban %lu (%.2f per perintah), "
+         "timeout %lu\n",
+         static_cast<unsigned long>(m_total.commands),
+         static_cast<unsigned long>(m_total.replies), replies,
+         static_cast<unsigned long>(m_total.timeouts));
+  printf("  rtt perintah      p50 %.1f  p90 %.1f  p99 %.1f  maks %.1f ms\n",
+         m_rttAll.percentile(50), m_rttAll.percentile(90),
+         m_rttAll.percentile(99), m_rttAll.percentile(100));
+  printf("  kirim sensor      p50 %.0f  p90 %.0f  p99 %.0f  maks %.0f ms\n",
+         m_deliveryAll.percentile(50), m_deliveryAll.percentile(90),
+         m_deliveryAll.percentile(99), m_deliveryAll.percentile(100));
+  printf("  backpressure      stall %lu, antrean maks %zu B, lag loop maks "
+         "%.0f ms\n",
+         static_cast<unsigned long>(m_total.stalls), m_queuePeakAll,
+         m_lagPeakAll);
+}
+
+// meta dan status retained milik node dihapus, lalu DISCONNECT agar will
+// offline tidak menimpanya lagi
+void Fleet::shutdown() {
+  for (std::unique_ptr<Node>& node : m_nodes) {
+    if (!node->online) continue;
+    node->conn.publish(node->topicMeta, "", 0, true);
+    node->conn.publish(node->topicControl, "", 0, true);
+    node->conn.disconnect();
+    watch(node->conn, node->index, node->wantWrite);
+  }
+
+  epoll_event events[MAX_EVENTS];
+  uint64_t endUs = nowUs() + SHUTDOWN_US;
+  while (nowUs() < endUs) {
+    bool pending = false;
+    for (const std::unique_ptr<Node>& node : m_nodes)
+      pending |= node->online && node->conn.queued() > 0;
+    if (!pending) break;
+    int n = epoll_wait(m_epoll, events, MAX_EVENTS, TICK_US / 1000);
+    for (int i = 0; i < n; i++) {
+      // hanya antrean keluar yang diselesaikan
+      uint32_t key = events[i].data.u32;
+      if (key >= m_nodes.size() || !(events[i].events & EPOLLOUT)) continue;
+      Node& node = *m_nodes[key];
+      if (node.conn.fd() < 0 || !node.conn.onWritable()) node.online = false;
+    }
+  }
+
+  for (std::unique_ptr<Node>& node : m_nodes) node->conn.close();
+  m_observer->conn.close();
+}
+}  // namespace LoadGen
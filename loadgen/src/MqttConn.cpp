@@ -0,0 +1,254 @@
+#include "MqttConn.h"
+
+#include <errno.h>
+#include <netinet/tcp.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#define MQTT_CONNECT 0x10
+#define MQTT_PUBLISH 0x30
+#define MQTT_SUBSCRIBE 0x82
+#define MQTT_PINGREQ 0xC0
+#define MQTT_DISCONNECT 0xE0
+
+#define TYPE_CONNACK 2
+#define TYPE_PUBLISH 3
+
+#define READ_CHUNK 4096
+
+namespace LoadGen {
+
+uint64_t nowUs() {
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return static_cast<uint64_t>(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000;
+}
+
+// constructor
+MqttConn::MqttConn()
+    : m_fd(-1),
+      m_tcpUp(false),
+      m_connected(false),
+      m_outPos(0),
+      m_packetId(0),
+      m_lastSendUs(0),
+      m_stalls(0),
+      m_willRetain(false) {}
+
+MqttConn::~MqttConn() { close(); }
+
+void MqttConn::setWill(const std::string& topic, const std::string& payload,
+                       bool retain) {
+  m_willTopic = topic;
+  m_willPayload = payload;
+  m_willRetain = retain;
+}
+
+bool MqttConn::open(const sockaddr_in& broker, const std::string& clientId,
+                    const char* user, const char* password,
+                    uint16_t keepAlive) {
+  close();
+  m_fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (m_fd < 0) return false;
+
+  int one = 1;
+  setsockopt(m_fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+  if (connect(m_fd, reinterpret_cast<const sockaddr*>(&broker),
+              sizeof(broker)) == 0) {
+    m_tcpUp = true;
+  } else if (errno != EINPROGRESS) {
+    close();
+    return false;
+  }
+
+  size_t userLen = user ? strlen(user) : 0;
+  size_t passwordLen = password ? strlen(password) : 0;
+  uint8_t flags = 0x02;  // clean session
+  if (userLen > 0) flags |= 0x80;
+  if (passwordLen > 0) flags |= 0x40;
+  bool will = !m_willTopic.empty();
+  if (will) flags |= m_willRetain ? 0x24 : 0x04;  // will flag, will retain
+
+  size_t remaining = 10 + 2 + clientId.size();
+  if (will) remaining += 4 + m_willTopic.size() + m_willPayload.size();
+  if (userLen > 0) remaining += 2 + userLen;
+  if (passwordLen > 0) remaining += 2 + passwordLen;
+
+  begin(MQTT_CONNECT, remaining);
+  putString("MQTT", 4);
+  m_out.push_back(4);  // protocol level 3.1.1
+  m_out.push_back(flags);
+  putU16(keepAlive);
+  putString(clientId.data(), clientId.size());
+  if (will) {
+    putString(m_willTopic.data(), m_willTopic.size());
+    putString(m_willPayload.data(), m_willPayload.size());
+  }
+  if (userLen > 0) putString(user, userLen);
+  if (passwordLen > 0) putString(password, passwordLen);
+  return true;
+}
+
+void MqttConn::close() {
+  if (m_fd >= 0) ::close(m_fd);
+  m_fd = -1;
+  m_tcpUp = false;
+  m_connected = false;
+  m_out.clear();
+  m_outPos = 0;
+  m_in.clear();
+}
+
+void MqttConn::subscribe(const char* topic) {
+  size_t len = strlen(topic);
+  begin(MQTT_SUBSCRIBE, 2 + 2 + len + 1);
+  if (++m_packetId == 0) m_packetId = 1;
+  putU16(m_packetId);
+  putString(topic, len);
+  m_out.push_back(0);  // QoS 0
+  flush();
+}
+
+void MqttConn::publish(const char* topic, const char* payload, size_t len,
+                       bool retain) {
+  size_t topicLen = strlen(topic);
+  begin(MQTT_PUBLISH | (retain ? 0x01 : 0), 2 + topicLen + len);
+  putString(topic, topicLen);
+  m_out.insert(m_out.end(), payload, payload + len);
+  flush();
+}
+
+void MqttConn::ping() {
+  begin(MQTT_PINGREQ, 0);
+  flush();
+}
+
+void MqttConn::disconnect() {
+  begin(MQTT_DISCONNECT, 0);
+  flush();
+}
+
+bool MqttConn::onWritable() {
+  if (!m_tcpUp) {
+    int error = 0;
+    socklen_t len = sizeof(error);
+    if (getsockopt(m_fd, SOL_SOCKET, SO_ERROR, &error, &len) < 0 || error)
+      return false;
+    m_tcpUp = true;
+  }
+  return flush();
+}
+
+bool MqttConn::onReadable(const PublishHandler& handler) {
+  uint8_t chunk[READ_CHUNK];
+  while (true) {
+    ssize_t n = recv(m_fd, chunk, sizeof(chunk), 0);
+    if (n > 0) {
+      m_in.insert(m_in.end(), chunk, chunk + n);
+      continue;
+    }
+    if (n == 0) return false;
+    if (errno == EINTR) continue;
+    if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+    return false;
+  }
+  return parse(handler);
+}
+
+void MqttConn::begin(uint8_t header, size_t remaining) {
+  m_out.push_back(header);
+  // remaining length: 7 bit per byte, bit 7 menandakan byte lanjutan
+  do {
+    uint8_t byte = remaining & 0x7F;
+    remaining >>= 7;
+    m_out.push_back(remaining > 0 ? byte | 0x80 : byte);
+  } while (remaining > 0);
+}
+
+void MqttConn::putString(const char* str, size_t len) {
+  putU16(len);
+  m_out.insert(m_out.end(), str, str + len);
+}
+
+void MqttConn::putU16(uint16_t value) {
+  m_out.push_back(value >> 8);
+  m_out.push_back(value & 0xFF);
+}
+
+bool MqttConn::flush() {
+  if (!m_tcpUp || m_fd < 0) return true;
+
+  while (m_outPos < m_out.size()) {
+    ssize_t n = send(m_fd, m_out.data() + m_outPos, m_out.size() - m_outPos,
+                     MSG_NOSIGNAL);
+    if (n > 0) {
+      m_outPos += n;
+      m_lastSendUs = nowUs();
+      continue;
+    }
+    if (n < 0 && errno == EINTR) continue;
+    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      m_stalls++;
+      break;
+    }
+    return false;
+  }
+
+  if (m_outPos == m_out.size()) {
+    m_out.clear();
+    m_outPos = 0;
+  } else if (m_outPos > m_out.size() / 2) {
+    m_out.erase(m_out.begin(), m_out.begin() + m_outPos);
+    m_outPos = 0;
+  }
+  return true;
+}
+
+bool MqttConn::parse(const PublishHandler& handler) {
+  size_t pos = 0;
+  while (m_in.size() - pos >= 2) {
+    size_t remaining = 0;
+    size_t headerLen = 1;
+    bool complete = false;
+    for (uint8_t shift = 0; shift < 28; shift += 7) {
+      if (pos + headerLen >= m_in.size()) break;
+      uint8_t byte = m_in[pos + headerLen++];
+      remaining |= static_cast<size_t>(byte & 0x7F) << shift;
+      if (!(byte & 0x80)) {
+        complete = true;
+        break;
+      }
+    }
+    if (!complete || m_in.size() - pos - headerLen < remaining) break;
+
+    uint8_t header = m_in[pos];
+    const uint8_t* body = m_in.data() + pos + headerLen;
+    switch (header >> 4) {
+      case TYPE_CONNACK:
+        if (remaining < 2 || body[1] != 0) return false;
+        m_connected = true;
+        break;
+      case TYPE_PUBLISH: {
+        if (remaining < 2) return false;
+        size_t topicLen = (body[0] << 8) | body[1];
+        size_t offset = 2 + topicLen;
+        if (header & 0x06) offset += 2;  // packet id QoS > 0
+        if (offset > remaining) return false;
+        std::string topic(reinterpret_cast<const char*>(body + 2), topicLen);
+        handler(topic, reinterpret_cast<const char*>(body + offset),
+                remaining - offset);
+        break;
+      }
+      default:
+        // SUBACK dan PINGRESP tidak perlu diproses
+        break;
+    }
+    pos += headerLen + remaining;
+  }
+
+  m_in.erase(m_in.begin(), m_in.begin() + pos);
+  return true;
+}
+}  // namespace LoadGen
@@ -0,0 +1,86 @@
+/**
+ * Load generator armada MQTT: mensimulasikan ratusan node akuarium dengan
+ * skema topik dan payload firmware terhadap broker lokal, untuk melihat
+ * perilaku broker dan bridge web/mqtt/server.js pada skala besar.
+ *
+ * Setiap interval laporan mencetak throughput publish, data sensor yang
+ * sampai kembali di pengamat, percentile round-trip perintah kontrol dan
+ * latency pengiriman sensor, serta tanda backpressure broker: publish yang
+ * dibuang karena antrean koneksi penuh, write() yang tertahan (stall),
+ * antrean terbesar, dan keterlambatan event loop sendiri (lag).
+ *
+ * Pemakaian:
+ *   program [--host H] [--port N] [--user U] [--password P] [--nodes N]
+ *           [--tanks N] [--interval MS] [--duration S] [--commands PER_S]
+ *           [--max-queue BYTES] [--ramp PER_S] [--report S] [--seed N]
+ *
+ * Node memakai ID load-<pid>-<n>, sehingga setiap perintah hanya dijawab
+ * oleh node tujuannya.
+ */
+
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Fleet.h"
+
+namespace {
+void printUsage(const char* prog) {
+  printf("pemakaian: %s [--host H] [--port N] [--user U] [--password P] "
+         "[--nodes N] [--tanks N] [--interval MS] [--duration S] "
+         "[--commands PER_S] [--max-queue BYTES] "
+         "[--ramp PER_S] [--report S] [--seed N]\n",
+         prog);
+}
+
+void onSignal(int) { LoadGen::Fleet::stop(); }
+}  // namespace
+
+int main(int argc, char** argv) {
+  LoadGen::FleetOptions options = LoadGen::DEFAULT_FLEET;
+  for (int i = 1; i < argc; i++) {
+    bool hasValue = i + 1 < argc;
+    if (strcmp(argv[i], "--host") == 0 && hasValue) {
+      options.host = argv[++i];
+    } else if (strcmp(argv[i], "--port") == 0 && hasValue) {
+      options.port = strtoul(argv[++i], nullptr, 10);
+    } else if (strcmp(argv[i], "--user") == 0 && hasValue) {
+      options.user = argv[++i];
+    } else if (strcmp(argv[i], "--password") == 0 && hasValue) {
+      options.password = argv[++i];
+    } else if (strcmp(argv[i], "--nodes") == 0 && hasValue) {
+      options.nodes = strtoul(argv[++i], nullptr, 10);
+    } else if (strcmp(argv[i], "--tanks") == 0 && hasValue) {
+      options.tanks = strtoul(argv[++i], nullptr, 10);
+    } else if (strcmp(argv[i], "--interval") == 0 && hasValue) {
+      options.intervalMs = strtoul(argv[++i], nullptr, 10);
+    } else if (strcmp(argv[i], "--duration") == 0 && hasValue) {
+      options.durationS = strtoul(argv[++i], nullptr, 10);
+    } else if (strcmp(argv[i], "--commands") == 0 && hasValue) {
+      options.commandRate = atof(argv[++i]);
+    } else if (strcmp(argv[i], "--max-queue") == 0 && hasValue) {
+      options.maxQueue = strtoul(argv[++i], nullptr, 10);
+    } else if (strcmp(argv[i], "--ramp") == 0 && hasValue) {
+      options.rampPerS = strtoul(argv[++i], nullptr, 10);
+    } else if (strcmp(argv[i], "--report") == 0 && hasValue) {
+      options.reportS = strtoul(argv[++i], nullptr, 10);
+    } else if (strcmp(argv[i], "--seed") == 0 && hasValue) {
+      options.seed = strtoul(argv[++i], nullptr, 10);
+    } else {
+      printUsage(argv[0]);
+      return 2;
+    }
+  }
+  if (options.nodes == 0 || options.intervalMs == 0) {
+    printUsage(argv[0]);
+    return 2;
+  }
+
+  // Ctrl-C tetap mencetak ringkasan
+  signal(SIGINT, onSignal);
+  signal(SIGTERM, onSignal);
+
+  LoadGen::Fleet fleet(options);
+  return fleet.run() ? 0 : 1;
+}
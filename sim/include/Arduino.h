@@ -0,0 +1,208 @@
+#pragma once
+
+/**
+ * Pengganti Arduino core untuk simulator host (env:sim). Semua fungsi waktu
+ * memakai jam virtual Sim::clock, delay() dan yield() memajukan jam tersebut
+ * sehingga firmware berjalan jauh lebih cepat dari waktu nyata.
+ *
+ * Hanya API yang dipakai firmware ini yang disediakan.
+ */
+
+#include <math.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <functional>
+#include <string>
+
+#include "Sim.h"
+
+#define HIGH 0x1
+#define LOW 0x0
+
+#define INPUT 0x0
+#define OUTPUT 0x1
+
+// penomoran pin NodeMCU (ESP8266), dipakai pins.h
+#define D0 16
+#define D1 5
+#define D2 4
+#define D5 14
+#define A0 17
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+inline uint32_t millis() { return Sim::clock.millis(); }
+inline uint32_t micros() { return Sim::clock.micros(); }
+inline void delay(uint32_t ms) { Sim::clock.advanceUs(ms * 1000ULL); }
+inline void delayMicroseconds(uint32_t us) { Sim::clock.advanceUs(us); }
+// loop yang hanya memanggil yield() tetap maju walau tanpa delay()
+inline void yield() { Sim::clock.advanceUs(SIM_YIELD_US); }
+
+inline void pinMode(uint8_t pin, uint8_t mode) { Sim::gpio.mode(pin, mode); }
+inline void digitalWrite(uint8_t pin, uint8_t value) {
+  Sim::gpio.write(pin, value);
+}
+inline int digitalRead(uint8_t pin) { return Sim::gpio.read(pin); }
+inline int analogRead(uint8_t pin) { return Sim::gpio.analog(pin); }
+
+// jam host dipakai apa adanya, sudah melewati NTP_MIN_VALID_EPOCH
+inline void configTime(int, int, const char*, const char* = nullptr,
+                       const char* = nullptr) {}
+
+class String {
+ private:
+  std::string m_str;
+
+ public:
+  String() {}
+  String(const char* str) : m_str(str ? str : "") {}
+  String(const std::string& str) : m_str(str) {}
+  String(char c) : m_str(1, c) {}
+  String(int value) : m_str(std::to_string(value)) {}
+  String(unsigned int value) : m_str(std::to_string(value)) {}
+  String(long value) : m_str(std::to_string(value)) {}
+  String(unsigned long value) : m_str(std::to_string(value)) {}
+  String(float value, unsigned int decimals = 2) { setFloat(value, decimals); }
+  String(double value, unsigned int decimals = 2) {
+    setFloat(value, decimals);
+  }
+
+  String& operator=(const char* str) {
+    m_str = str ? str : "";
+    return *this;
+  }
+
+  const char* c_str() const { return m_str.c_str(); }
+  unsigned int length() const { return m_str.length(); }
+  bool isEmpty() const { return m_str.empty(); }
+  void reserve(unsigned int size) { m_str.reserve(size); }
+
+  bool concat(const char* str) {
+    if (str) m_str += str;
+    return true;
+  }
+  bool concat(const char* str, unsigned int len) {
+    m_str.append(str, len);
+    return true;
+  }
+  bool concat(char c) {
+    m_str += c;
+    return true;
+  }
+
+  String& operator+=(const String& str) {
+    m_str += str.m_str;
+    return *this;
+  }
+  String& operator+=(const char* str) {
+    concat(str);
+    return *this;
+  }
+  String& operator+=(char c) {
+    m_str += c;
+    return *this;
+  }
+  String& operator+=(int value) { return *this += String(value); }
+  String& operator+=(unsigned int value) { return *this += String(value); }
+  String& operator+=(long value) { return *this += String(value); }
+  String& operator+=(unsigned long value) { return *this += String(value); }
+
+  bool operator==(const String& other) const { return m_str == other.m_str; }
+  bool operator==(const char* other) const {
+    return m_str == (other ? other : "");
+  }
+  bool operator!=(const String& other) const { return !(*this == other); }
+  bool operator!=(const char* other) const { return !(*this == other); }
+
+  char operator[](unsigned int index) const { return m_str[index]; }
+  bool startsWith(const char* prefix) const {
+    return m_str.compare(0, strlen(prefix), prefix) == 0;
+  }
+  int indexOf(const char* str) const {
+    size_t pos = m_str.find(str);
+    return pos == std::string::npos ? -1 : static_cast<int>(pos);
+  }
+  String substring(unsigned int from) const { return m_str.substr(from); }
+
+  friend String operator+(String lhs, const String& rhs) { return lhs += rhs; }
+  friend String operator+(String lhs, const char* rhs) { return lhs += rhs; }
+  friend String operator+(const char* lhs, const String& rhs) {
+    return String(lhs) += rhs;
+  }
+
+ private:
+  void setFloat(double value, unsigned int decimals) {
+    char buf[48];
+    snprintf(buf, sizeof(buf), "%.*f", decimals, value);
+    m_str = buf;
+  }
+};
+
+// keluaran Serial firmware, diteruskan ke Sim::console
+class HardwareSerial {
+ public:
+  void begin(unsigned long) {}
+  void flush() {}
+  int availableForWrite() { return 1024; }
+
+  size_t write(uint8_t c) { return write(&c, 1); }
+  size_t write(const uint8_t* data, size_t len) {
+    Sim::console.write(reinterpret_cast<const char*>(data), len);
+    return len;
+  }
+  size_t print(const char* str) { return write(str, strlen(str)); }
+  size_t print(const String& str) { return print(str.c_str()); }
+  size_t println(const char* str = "") { return print(str) + print("\n"); }
+  size_t println(const String& str) { return println(str.c_str()); }
+  size_t printf(const char* fmt, ...) __attribute__((format(printf, 2, 3))) {
+    char buf[256];
+    va_list args;
+    va_start(args, fmt);
+    int len = vsnprintf(buf, sizeof(buf), fmt, args);
+    va_end(args);
+    if (len < 0) return 0;
+    return print(buf);
+  }
+
+ private:
+  size_t write(const char* data, size_t len) {
+    return write(reinterpret_cast<const uint8_t*>(data), len);
+  }
+};
+
+extern HardwareSerial Serial;
+
+// ESP.* yang dipakai MemTelemetry dan FastBoot
+class EspClass {
+ public:
+  uint32_t getFreeHeap() { return SIM_FREE_HEAP; }
+  bool rtcUserMemoryRead(uint32_t offset, uint32_t* data, size_t size);
+  bool rtcUserMemoryWrite(uint32_t offset, uint32_t* data, size_t size);
+  void restart() { exit(0); }
+};
+
+extern EspClass ESP;
+
+class IPAddress {
+ private:
+  uint32_t m_addr;
+
+ public:
+  IPAddress(uint32_t addr = 0) : m_addr(addr) {}
+  IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d)
+      : m_addr(a | b << 8 | c << 16 | static_cast<uint32_t>(d) << 24) {}
+  operator uint32_t() const { return m_addr; }
+  String toString() const {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%u.%u.%u.%u", m_addr & 0xFF,
+             (m_addr >> 8) & 0xFF, (m_addr >> 16) & 0xFF, m_addr >> 24);
+    return buf;
+  }
+};
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <OneWire.h>
+
+#include "Plant.h"
+
+#define DEVICE_DISCONNECTED_C -127
+
+// DS18B20 membaca suhu dari model plant, termasuk noise dan resolusi 12 bit
+class DallasTemperature {
+ private:
+  float m_lastTemp = DEVICE_DISCONNECTED_C;
+
+ public:
+  explicit DallasTemperature(OneWire*) {}
+  void begin() {}
+  void requestTemperatures() { m_lastTemp = Sim::plant.readTemperature(); }
+  float getTempCByIndex(uint8_t) const { return m_lastTemp; }
+};
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <Arduino.h>
+#include <WiFiClientSecure.h>
+
+#include <string>
+
+// HTTPClient blocking: jam virtual dimajukan sebesar latency jaringan
+class HTTPClient {
+ private:
+  std::string m_url;
+  String m_response;
+
+ public:
+  bool begin(WiFiClientSecure&, const String& url) {
+    m_url = url.c_str();
+    return true;
+  }
+  void addHeader(const char*, const char*) {}
+  int GET() { return request(""); }
+  int POST(const String& payload) { return request(payload.c_str()); }
+  String getString() { return m_response; }
+  void end() {}
+
+ private:
+  int request(const std::string& body);
+};
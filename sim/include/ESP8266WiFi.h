@@ -0,0 +1,58 @@
+#pragma once
+
+#include <Arduino.h>
+#include <WiFiClientSecure.h>
+
+// WiFi tersambung SIM_WIFI_CONNECT_MS setelah begin(), cukup untuk FastBoot
+#define SIM_WIFI_CONNECT_MS 1500
+
+enum WiFiMode_t { WIFI_OFF, WIFI_STA, WIFI_AP, WIFI_AP_STA };
+enum wl_status_t { WL_IDLE_STATUS = 0, WL_CONNECTED = 3, WL_DISCONNECTED = 6 };
+
+class SimWiFi {
+ private:
+  bool m_begun = false;
+  uint32_t m_beginMs = 0;
+  uint8_t m_bssid[6] = {0x02, 0x51, 0x4D, 0x00, 0x00, 0x01};
+
+ public:
+  void persistent(bool) {}
+  void mode(WiFiMode_t) {}
+  bool config(IPAddress, IPAddress, IPAddress, IPAddress = IPAddress()) {
+    return true;
+  }
+
+  void begin(const char*, const char*, int32_t = 0,
+             const uint8_t* = nullptr) {
+    m_begun = true;
+    m_beginMs = millis();
+  }
+  bool disconnect(bool = false) {
+    m_begun = false;
+    return true;
+  }
+
+  wl_status_t status() const {
+    return isConnected() ? WL_CONNECTED : WL_DISCONNECTED;
+  }
+  bool isConnected() const {
+    return m_begun && millis() - m_beginMs >= SIM_WIFI_CONNECT_MS;
+  }
+
+  IPAddress localIP() const { return IPAddress(192, 168, 4, 2); }
+  IPAddress gatewayIP() const { return IPAddress(192, 168, 4, 1); }
+  IPAddress subnetMask() const { return IPAddress(255, 255, 255, 0); }
+  IPAddress dnsIP() const { return IPAddress(192, 168, 4, 1); }
+  const uint8_t* BSSID() const { return m_bssid; }
+  int32_t channel() const { return 6; }
+};
+
+extern SimWiFi WiFi;
+
+// server webhook tidak dipakai simulator, tidak pernah ada koneksi masuk
+class WiFiServer {
+ public:
+  explicit WiFiServer(uint16_t) {}
+  void begin() {}
+  WiFiClient accept() { return WiFiClient(); }
+};
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+/**
+ * Server Bot API Telegram palsu di dalam simulator. Melayani getMe,
+ * getUpdates, sendMessage, editMessageText, pinChatMessage dan sendDocument
+ * (multipart, biasanya chunked) baik lewat HTTPClient (blocking) maupun
+ * WiFiClientSecure (AsyncHttp), dengan latency jaringan dalam waktu virtual.
+ */
+
+namespace Sim {
+
+struct SentMessage {
+  uint64_t timeUs;
+  std::string text;
+};
+
+struct SentDocument {
+  uint64_t timeUs;
+  std::string filename;
+  std::string caption;
+  std::string content;
+};
+
+typedef void (*SentListener)(const SentMessage& msg);
+
+class FakeTelegram {
+ private:
+  uint32_t m_latencyMs = 300;
+  uint32_t m_updateId = 0;
+  uint32_t m_servedId = 0;
+  std::string m_lastText;
+  std::vector<SentMessage> m_sent;
+  SentListener m_listener = nullptr;
+  uint32_t m_requests = 0;
+  uint32_t m_edits = 0;
+  uint32_t m_pins = 0;
+  size_t m_pinnedId = 0;
+  std::vector<SentDocument> m_documents;
+
+ public:
+  void setLatency(uint32_t ms) { m_latencyMs = ms; }
+  uint32_t latencyMs() const { return m_latencyMs; }
+
+  // return status HTTP, path berbentuk ".../bot<token>/<method>"
+  int handle(const std::string& path, const std::string& body,
+             std::string& response);
+
+  // pesan baru dari pengguna, dibaca firmware lewat getUpdates berikutnya
+  void inject(const char* text);
+  // update terakhir sudah diambil firmware
+  bool delivered() const { return m_servedId == m_updateId; }
+
+  const std::vector<SentMessage>& sent() const { return m_sent; }
+  uint32_t requests() const { return m_requests; }
+  // editMessageText ke pesan yang pernah dikirim, tidak memanggil listener
+  uint32_t edits() const { return m_edits; }
+  uint32_t pins() const { return m_pins; }
+  // teks terbaru pesan yang terakhir dipin, kosong jika belum ada
+  std::string pinnedText() const {
+    return m_pinnedId ? m_sent[m_pinnedId - 1].text : std::string();
+  }
+  const std::vector<SentDocument>& documents() const { return m_documents; }
+  void setSentListener(SentListener listener) { m_listener = listener; }
+
+ private:
+  static bool parseDocument(const std::string& body, SentDocument& doc);
+};
+
+extern FakeTelegram telegram;
+}  // namespace Sim
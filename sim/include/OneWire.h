@@ -0,0 +1,8 @@
+#pragma once
+
+#include <stdint.h>
+
+class OneWire {
+ public:
+  explicit OneWire(uint8_t) {}
+};
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <random>
+
+/**
+ * Model akuarium untuk simulator: suhu air (pemanas bertermostat, lampu,
+ * drift suhu ruangan harian) dan tinggi air (penguapan, bocor, isi ulang
+ * oleh pompa), dibaca lewat DS18B20 dan ADC palsu beserta noise-nya.
+ *
+ * State diintegrasikan secara lazy sampai jam virtual saat sensor dibaca
+ * atau relay berubah.
+ */
+
+struct PlantConfig {
+  float ambientMean;       // suhu ruangan rata-rata (C)
+  float ambientSwing;      // amplitudo siklus harian (C)
+  float ambientPeakHour;   // jam suhu ruangan tertinggi
+  float couplingHours;     // konstanta waktu air terhadap suhu ruangan
+
+  bool heaterWorking;
+  float heaterSetpoint;    // termostat pemanas (C), histeresis 0.5 C
+  float heaterPerHour;     // kenaikan suhu saat pemanas menyala (C/jam)
+  float lampPerHour;       // panas tambahan dari lampu LED (C/jam)
+
+  float evapPerDay;        // penguapan pada 26 C (% per hari)
+  float evapPerDegree;     // tambahan relatif penguapan per derajat
+  float leakPerDay;        // kebocoran (% per hari)
+  float refillPerHour;     // debit pompa isi ulang (% per jam)
+
+  float tempNoise;         // simpangan baku noise DS18B20 (C)
+  float levelNoise;        // simpangan baku noise ADC (count)
+  float dropoutRate;       // peluang DS18B20 terbaca -127 per pembacaan
+
+  float initialTemp;
+  float initialLevel;
+  uint32_t seed;
+};
+
+extern const PlantConfig DEFAULT_PLANT;
+
+struct PlantStats {
+  float minTemp;
+  float maxTemp;
+  float minLevel;
+  float maxLevel;
+  double pumpHours;
+  double heaterHours;
+  double overflowHours;  // pompa menyala saat air sudah penuh
+};
+
+namespace Sim {
+
+class Plant {
+ private:
+  PlantConfig m_cfg;
+  uint64_t m_lastUs;
+  double m_temp;
+  double m_level;
+  bool m_heaterOn;
+  bool m_lampOn;
+  bool m_pumpOn;
+  PlantStats m_stats;
+  std::mt19937 m_rng;
+  std::normal_distribution<float> m_normal;
+  std::uniform_real_distribution<float> m_uniform;
+
+ public:
+  Plant();
+  void begin(const PlantConfig& config);
+  void setConfig(const PlantConfig& config) { m_cfg = config; }
+  const PlantConfig& config() const { return m_cfg; }
+
+  // integrasi sampai jam virtual saat ini
+  void update();
+  void onPinWrite(uint8_t pin, uint8_t value);
+
+  float readTemperature();
+  int readLevelRaw();
+
+  float temperature() const { return m_temp; }
+  float level() const { return m_level; }
+  bool pumpOn() const { return m_pumpOn; }
+  bool lampOn() const { return m_lampOn; }
+  const PlantStats& stats() const { return m_stats; }
+
+ private:
+  float ambient(double hours) const;
+  void step(double hours, double dtHours);
+};
+
+extern Plant plant;
+}  // namespace Sim
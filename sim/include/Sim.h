@@ -0,0 +1,64 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Inti simulator: jam virtual, GPIO dan konsol. Shim Arduino/ESP memanggil
+ * objek-objek ini, model plant (Plant.h) dan server Telegram palsu
+ * (FakeTelegram.h) berlangganan perubahan GPIO dan waktu.
+ */
+
+#define SIM_YIELD_US 10
+#define SIM_FREE_HEAP 40000
+
+namespace Sim {
+
+class Clock {
+ private:
+  uint64_t m_us = 0;
+
+ public:
+  uint32_t millis() const { return static_cast<uint32_t>(m_us / 1000); }
+  uint32_t micros() const { return static_cast<uint32_t>(m_us); }
+  uint64_t nowUs() const { return m_us; }
+  double hours() const { return m_us / 3.6e9; }
+  void advanceUs(uint64_t us) { m_us += us; }
+};
+
+// dipanggil sebelum pin berubah agar model plant diintegrasikan sampai
+// waktu perubahan dengan kondisi relay yang lama
+typedef void (*PinListener)(uint8_t pin, uint8_t value);
+typedef int (*AnalogSource)(uint8_t pin);
+
+class Gpio {
+ private:
+  uint8_t m_levels[32] = {0};
+  PinListener m_listener = nullptr;
+  AnalogSource m_analog = nullptr;
+
+ public:
+  void mode(uint8_t, uint8_t) {}
+  void write(uint8_t pin, uint8_t value);
+  int read(uint8_t pin) const { return pin < 32 ? m_levels[pin] : 0; }
+  int analog(uint8_t pin) const { return m_analog ? m_analog(pin) : 0; }
+
+  void setListener(PinListener listener) { m_listener = listener; }
+  void setAnalogSource(AnalogSource source) { m_analog = source; }
+};
+
+// baris log firmware, diberi prefix waktu virtual jika verbose
+class Console {
+ private:
+  bool m_verbose = false;
+  bool m_lineStart = true;
+
+ public:
+  void setVerbose(bool verbose) { m_verbose = verbose; }
+  void write(const char* data, size_t len);
+};
+
+extern Clock clock;
+extern Gpio gpio;
+extern Console console;
+}  // namespace Sim
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include <string>
+
+// koneksi TLS palsu ke FakeTelegram, response tersedia setelah latency
+// jaringan berlalu dalam waktu virtual
+class WiFiClientSecure {
+ private:
+  bool m_connected = false;
+  std::string m_request;
+  std::string m_response;
+  size_t m_readPos = 0;
+  uint64_t m_readyAtUs = 0;
+
+ public:
+  void setInsecure() {}
+  void setCACert(const char*) {}
+  void setTimeout(unsigned long) {}
+  void setHandshakeTimeout(unsigned long) {}
+  void setNoDelay(bool) {}
+
+  int connect(const char* host, uint16_t port);
+  bool connected() const { return m_connected; }
+  void stop();
+
+  size_t write(const uint8_t* data, size_t len);
+  int available();
+  int read();
+  int read(uint8_t* buf, size_t len);
+
+ private:
+  void handleRequest();
+};
+
+typedef WiFiClientSecure WiFiClient;
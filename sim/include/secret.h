@@ -0,0 +1,4 @@
+#pragma once
+
+// kredensial palsu untuk simulator, src/secret.h tetap didahulukan jika ada
+#include "../../src/secret.example.h"
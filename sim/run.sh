@@ -0,0 +1,18 @@
+#!/bin/sh
+# jalankan semua skenario simulator, satu proses per skenario karena state
+# global firmware tidak bisa direset. argumen tambahan diteruskan ke setiap
+# skenario, contoh: sim/run.sh --seed 7 --latency 800
+set -e
+cd "$(dirname "$0")/.."
+
+pio run -e sim
+PROGRAM=.pio/build/sim/program
+
+failed=0
+for scenario in $($PROGRAM --list); do
+  $PROGRAM "$scenario" "$@" || failed=$((failed + 1))
+  echo
+done
+
+echo "skenario gagal: $failed"
+exit $failed
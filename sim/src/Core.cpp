@@ -0,0 +1,57 @@
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+
+#include "Plant.h"
+
+namespace Sim {
+Clock clock;
+Gpio gpio;
+Console console;
+
+void Gpio::write(uint8_t pin, uint8_t value) {
+  if (pin >= 32) return;
+  if (m_listener && m_levels[pin] != value) m_listener(pin, value);
+  m_levels[pin] = value;
+}
+
+void Console::write(const char* data, size_t len) {
+  if (!m_verbose) return;
+
+  for (size_t i = 0; i < len; i++) {
+    if (m_lineStart) {
+      uint64_t ms = clock.nowUs() / 1000;
+      printf("%4llu:%02llu:%02llu.%03llu | ",
+             static_cast<unsigned long long>(ms / 3600000),
+             static_cast<unsigned long long>(ms / 60000 % 60),
+             static_cast<unsigned long long>(ms / 1000 % 60),
+             static_cast<unsigned long long>(ms % 1000));
+      m_lineStart = false;
+    }
+    putchar(data[i]);
+    if (data[i] == '\n') m_lineStart = true;
+  }
+}
+}  // namespace Sim
+
+HardwareSerial Serial;
+EspClass ESP;
+SimWiFi WiFi;
+
+namespace {
+// RTC user memory ESP8266: 128 blok 4 byte, bertahan selama proses berjalan
+uint32_t rtcMemory[128];
+}  // namespace
+
+bool EspClass::rtcUserMemoryRead(uint32_t offset, uint32_t* data,
+                                 size_t size) {
+  if (offset * 4 + size > sizeof(rtcMemory)) return false;
+  memcpy(data, reinterpret_cast<uint8_t*>(rtcMemory) + offset * 4, size);
+  return true;
+}
+
+bool EspClass::rtcUserMemoryWrite(uint32_t offset, uint32_t* data,
+                                  size_t size) {
+  if (offset * 4 + size > sizeof(rtcMemory)) return false;
+  memcpy(reinterpret_cast<uint8_t*>(rtcMemory) + offset * 4, data, size);
+  return true;
+}
@@ -0,0 +1,263 @@
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <ESP8266HTTPClient.h>
+#include <WiFiClientSecure.h>
+
+#include "FakeTelegram.h"
+
+// seperti API asli, id pengirim berupa angka
+#define SIM_USER_ID 123456789
+
+namespace Sim {
+FakeTelegram telegram;
+
+int FakeTelegram::handle(const std::string& path, const std::string& body,
+                         std::string& response) {
+  m_requests++;
+  size_t slash = path.rfind('/');
+  std::string method =
+      slash == std::string::npos ? path : path.substr(slash + 1);
+
+  if (method == "getMe") {
+    response = R"({"ok":true,"result":{"id":1,"is_bot":true,)"
+               R"("username":"aqua_sim_bot"}})";
+    return 200;
+  }
+
+  if (method == "getUpdates") {
+    // offset -1 limit 1: selalu update terakhir, firmware menyaring update_id
+    if (m_updateId == 0) {
+      response = R"({"ok":true,"result":[]})";
+      return 200;
+    }
+    JsonDocument doc;
+    doc["ok"] = true;
+    JsonObject update = doc["result"].add<JsonObject>();
+    update["update_id"] = m_updateId;
+    JsonObject message = update["message"].to<JsonObject>();
+    message["text"] = m_lastText.c_str();
+    message["from"]["id"] = SIM_USER_ID;
+    message["from"]["username"] = "sim";
+    m_servedId = m_updateId;
+    String out;
+    serializeJson(doc, out);
+    response = out.c_str();
+    return 200;
+  }
+
+  if (method == "sendMessage") {
+    JsonDocument doc;
+    if (deserializeJson(doc, body.c_str())) {
+      response = R"({"ok":false,"description":"Bad Request"})";
+      return 400;
+    }
+    SentMessage msg = {clock.nowUs(), doc["text"] | ""};
+    m_sent.push_back(msg);
+    if (m_listener) m_listener(msg);
+    // message_id dimulai dari 1 sesuai urutan pesan
+    response = R"({"ok":true,"result":{"message_id":)" +
+               std::to_string(m_sent.size()) + "}}";
+    return 200;
+  }
+
+  if (method == "editMessageText" || method == "pinChatMessage") {
+    JsonDocument doc;
+    if (deserializeJson(doc, body.c_str())) {
+      response = R"({"ok":false,"description":"Bad Request"})";
+      return 400;
+    }
+    size_t id = doc["message_id"] | 0;
+    if (id == 0 || id > m_sent.size()) {
+      response = R"({"ok":false,"description":"message not found"})";
+      return 400;
+    }
+    if (method == "pinChatMessage") {
+      m_pins++;
+      m_pinnedId = id;
+      response = R"({"ok":true,"result":true})";
+      return 200;
+    }
+    std::string text = doc["text"] | "";
+    if (text == m_sent[id - 1].text) {
+      response = R"({"ok":false,"description":"message is not modified"})";
+      return 400;
+    }
+    m_sent[id - 1].text = text;
+    m_edits++;
+    response = R"({"ok":true,"result":{"message_id":)" + std::to_string(id) +
+               "}}";
+    return 200;
+  }
+
+  if (method == "sendDocument") {
+    SentDocument doc;
+    if (!parseDocument(body, doc)) {
+      response = R"({"ok":false,"description":"Bad Request"})";
+      return 400;
+    }
+    doc.timeUs = clock.nowUs();
+    m_documents.push_back(doc);
+    // dokumen tidak pernah diedit, message_id tidak dibutuhkan firmware
+    response = R"({"ok":true,"result":{}})";
+    return 200;
+  }
+
+  response = R"({"ok":false,"description":"Not Found"})";
+  return 404;
+}
+
+// multipart/form-data dengan boundary dari baris pertama body, hanya
+// field caption dan part document yang diambil
+bool FakeTelegram::parseDocument(const std::string& body, SentDocument& doc) {
+  size_t lineEnd = body.find("\r\n");
+  if (body.compare(0, 2, "--") != 0 || lineEnd == std::string::npos)
+    return false;
+  std::string delimiter = "\r\n" + body.substr(0, lineEnd);
+
+  size_t pos = lineEnd + 2;
+  bool found = false;
+  while (pos < body.size()) {
+    size_t headerEnd = body.find("\r\n\r\n", pos);
+    size_t partEnd = body.find(delimiter, pos);
+    if (headerEnd == std::string::npos || partEnd == std::string::npos)
+      return false;
+    std::string header = body.substr(pos, headerEnd - pos);
+    std::string content =
+        body.substr(headerEnd + 4, partEnd - headerEnd - 4);
+
+    if (header.find("name=\"caption\"") != std::string::npos) {
+      doc.caption = content;
+    } else if (header.find("name=\"document\"") != std::string::npos) {
+      size_t name = header.find("filename=\"");
+      if (name == std::string::npos) return false;
+      name += 10;
+      doc.filename = header.substr(name, header.find('"', name) - name);
+      doc.content = content;
+      found = true;
+    }
+
+    pos = partEnd + delimiter.size();
+    // boundary penutup diakhiri "--"
+    if (body.compare(pos, 2, "--") == 0) break;
+    pos += 2;
+  }
+  return found;
+}
+
+void FakeTelegram::inject(const char* text) {
+  m_updateId++;
+  m_lastText = text;
+}
+}  // namespace Sim
+
+int WiFiClientSecure::connect(const char*, uint16_t) {
+  m_connected = true;
+  m_request.clear();
+  m_response.clear();
+  m_readPos = 0;
+  return 1;
+}
+
+void WiFiClientSecure::stop() {
+  m_connected = false;
+  m_request.clear();
+  m_response.clear();
+  m_readPos = 0;
+}
+
+size_t WiFiClientSecure::write(const uint8_t* data, size_t len) {
+  if (!m_connected) return 0;
+  m_request.append(reinterpret_cast<const char*>(data), len);
+  handleRequest();
+  return len;
+}
+
+// body chunked yang dimulai di pos, return panjang request sampai chunk
+// penutup atau 0 jika belum lengkap
+size_t decodeChunked(const std::string& request, size_t pos,
+                     std::string& body) {
+  body.clear();
+  while (true) {
+    size_t lineEnd = request.find("\r\n", pos);
+    if (lineEnd == std::string::npos) return 0;
+    size_t size = strtoul(request.c_str() + pos, nullptr, 16);
+    pos = lineEnd + 2;
+    if (size == 0) return request.size() >= pos + 2 ? pos + 2 : 0;
+    if (request.size() < pos + size + 2) return 0;
+    body.append(request, pos, size);
+    pos += size + 2;
+  }
+}
+
+// request lengkap jika header selesai dan body sepanjang Content-Length,
+// atau sampai chunk penutup untuk Transfer-Encoding chunked
+void WiFiClientSecure::handleRequest() {
+  size_t headerEnd = m_request.find("\r\n\r\n");
+  if (headerEnd == std::string::npos) return;
+
+  std::string body;
+  size_t requestLen;
+  size_t chunkedPos = m_request.find("Transfer-Encoding: chunked");
+  if (chunkedPos != std::string::npos && chunkedPos < headerEnd) {
+    requestLen = decodeChunked(m_request, headerEnd + 4, body);
+    if (requestLen == 0) return;
+  } else {
+    size_t bodyLen = 0;
+    size_t lengthPos = m_request.find("Content-Length: ");
+    if (lengthPos != std::string::npos && lengthPos < headerEnd)
+      bodyLen = strtoul(m_request.c_str() + lengthPos + 16, nullptr, 10);
+    if (m_request.size() < headerEnd + 4 + bodyLen) return;
+    body = m_request.substr(headerEnd + 4, bodyLen);
+    requestLen = headerEnd + 4 + bodyLen;
+  }
+
+  size_t pathStart = m_request.find(' ') + 1;
+  std::string path =
+      m_request.substr(pathStart, m_request.find(' ', pathStart) - pathStart);
+  m_request.erase(0, requestLen);
+
+  std::string payload;
+  int status = Sim::telegram.handle(path, body, payload);
+  char header[128];
+  snprintf(header, sizeof(header),
+           "HTTP/1.1 %d OK\r\nContent-Type: application/json\r\n"
+           "Content-Length: %zu\r\nConnection: keep-alive\r\n\r\n",
+           status, payload.size());
+  m_response.erase(0, m_readPos);
+  m_readPos = 0;
+  m_response += header;
+  m_response += payload;
+  m_readyAtUs = Sim::clock.nowUs() + Sim::telegram.latencyMs() * 1000ULL;
+}
+
+int WiFiClientSecure::available() {
+  if (Sim::clock.nowUs() < m_readyAtUs) return 0;
+  return static_cast<int>(m_response.size() - m_readPos);
+}
+
+int WiFiClientSecure::read() {
+  if (available() <= 0) return -1;
+  return static_cast<uint8_t>(m_response[m_readPos++]);
+}
+
+int WiFiClientSecure::read(uint8_t* buf, size_t len) {
+  int avail = available();
+  if (avail <= 0) return -1;
+  size_t n = len < static_cast<size_t>(avail) ? len : avail;
+  memcpy(buf, m_response.data() + m_readPos, n);
+  m_readPos += n;
+  return static_cast<int>(n);
+}
+
+int HTTPClient::request(const std::string& body) {
+  size_t hostEnd = m_url.find('/', m_url.find("://") + 3);
+  std::string path =
+      hostEnd == std::string::npos ? "/" : m_url.substr(hostEnd);
+
+  std::string payload;
+  int status = Sim::telegram.handle(path, body, payload);
+  // request blocking menahan loop selama round trip
+  delay(Sim::telegram.latencyMs());
+  m_response = payload;
+  return status;
+}
@@ -0,0 +1,135 @@
+#include "Plant.h"
+
+#include <Arduino.h>
+#include <math.h>
+
+#include "../../src/pins.h"
+
+// langkah integrasi Euler, jauh lebih kecil dari konstanta waktu plant
+#define STEP_HOURS (10.0 / 3600.0)
+#define HEATER_HYSTERESIS 0.5
+
+// nilai ADC saat sensor tinggi air terendam penuh, sama dengan firmware
+#define LEVEL_FULL_RAW 260
+#define ADC_MAX 1023
+
+const PlantConfig DEFAULT_PLANT = {
+    29.0f,  // ambientMean
+    1.5f,   // ambientSwing
+    15.0f,  // ambientPeakHour
+    8.0f,   // couplingHours
+    true,   // heaterWorking
+    30.0f,  // heaterSetpoint
+    1.2f,   // heaterPerHour
+    0.15f,  // lampPerHour
+    1.5f,   // evapPerDay
+    0.05f,  // evapPerDegree
+    0.0f,   // leakPerDay
+    30.0f,  // refillPerHour
+    0.05f,  // tempNoise
+    1.5f,   // levelNoise
+    0.0f,   // dropoutRate
+    30.0f,  // initialTemp
+    95.0f,  // initialLevel
+    1,      // seed
+};
+
+namespace Sim {
+Plant plant;
+
+Plant::Plant() : m_normal(0.0f, 1.0f), m_uniform(0.0f, 1.0f) {
+  begin(DEFAULT_PLANT);
+}
+
+void Plant::begin(const PlantConfig& config) {
+  m_cfg = config;
+  m_lastUs = clock.nowUs();
+  m_temp = config.initialTemp;
+  m_level = config.initialLevel;
+  m_heaterOn = false;
+  m_lampOn = false;
+  m_pumpOn = false;
+  m_stats = {m_cfg.initialTemp, m_cfg.initialTemp, m_cfg.initialLevel,
+             m_cfg.initialLevel, 0, 0, 0};
+  m_rng.seed(config.seed);
+}
+
+float Plant::ambient(double hours) const {
+  double phase = (hours - m_cfg.ambientPeakHour) / 24.0 * 2 * M_PI;
+  return m_cfg.ambientMean + m_cfg.ambientSwing * cos(phase);
+}
+
+void Plant::step(double hours, double dtHours) {
+  // termostat pemanas bekerja sendiri, tidak dikendalikan firmware
+  if (m_cfg.heaterWorking) {
+    if (m_temp < m_cfg.heaterSetpoint - HEATER_HYSTERESIS) m_heaterOn = true;
+    if (m_temp > m_cfg.heaterSetpoint + HEATER_HYSTERESIS) m_heaterOn = false;
+  } else {
+    m_heaterOn = false;
+  }
+
+  double dTemp = (ambient(hours) - m_temp) / m_cfg.couplingHours;
+  if (m_heaterOn) dTemp += m_cfg.heaterPerHour;
+  if (m_lampOn) dTemp += m_cfg.lampPerHour;
+  m_temp += dTemp * dtHours;
+
+  double evap = m_cfg.evapPerDay / 24.0 *
+                (1.0 + m_cfg.evapPerDegree * (m_temp - 26.0));
+  if (evap < 0) evap = 0;
+  double dLevel = -evap - m_cfg.leakPerDay / 24.0;
+  if (m_pumpOn) dLevel += m_cfg.refillPerHour;
+  m_level += dLevel * dtHours;
+  if (m_level < 0) m_level = 0;
+  if (m_level > 100) {
+    m_level = 100;
+    if (m_pumpOn) m_stats.overflowHours += dtHours;
+  }
+
+  if (m_pumpOn) m_stats.pumpHours += dtHours;
+  if (m_heaterOn) m_stats.heaterHours += dtHours;
+  if (m_temp < m_stats.minTemp) m_stats.minTemp = m_temp;
+  if (m_temp > m_stats.maxTemp) m_stats.maxTemp = m_temp;
+  if (m_level < m_stats.minLevel) m_stats.minLevel = m_level;
+  if (m_level > m_stats.maxLevel) m_stats.maxLevel = m_level;
+}
+
+void Plant::update() {
+  uint64_t now = clock.nowUs();
+  double hours = m_lastUs / 3.6e9;
+  double remaining = (now - m_lastUs) / 3.6e9;
+  m_lastUs = now;
+
+  while (remaining > 0) {
+    double dt = remaining < STEP_HOURS ? remaining : STEP_HOURS;
+    step(hours, dt);
+    hours += dt;
+    remaining -= dt;
+  }
+}
+
+void Plant::onPinWrite(uint8_t pin, uint8_t value) {
+  update();
+  // relay aktif LOW
+  if (pin == LED_RELAY) m_lampOn = value == LOW;
+  if (pin == PUMP_RELAY) m_pumpOn = value == LOW;
+}
+
+float Plant::readTemperature() {
+  update();
+  if (m_cfg.dropoutRate > 0 && m_uniform(m_rng) < m_cfg.dropoutRate)
+    return -127.0f;
+
+  // resolusi DS18B20 12 bit = 0.0625 C
+  float value = m_temp + m_normal(m_rng) * m_cfg.tempNoise;
+  return roundf(value * 16.0f) / 16.0f;
+}
+
+int Plant::readLevelRaw() {
+  update();
+  float raw = m_level / 100.0f * LEVEL_FULL_RAW +
+              m_normal(m_rng) * m_cfg.levelNoise;
+  int value = static_cast<int>(lroundf(raw));
+  if (value < 0) return 0;
+  return value > ADC_MAX ? ADC_MAX : value;
+}
+}  // namespace Sim
@@ -0,0 +1,425 @@
+/**
+ * Simulator akuarium: menjalankan firmware main_telegram (jalur scheduler
+ * ESP8266) di host terhadap model plant dan server Telegram palsu, dengan
+ * jam virtual sehingga beberapa hari simulasi selesai dalam hitungan detik.
+ *
+ * Setiap skenario mengatur plant, pesan pengguna yang dijadwalkan atau
+ * dipicu oleh peringatan, lalu memeriksa perilaku firmware. Exit code
+ * bukan nol jika ada pemeriksaan yang gagal, sehingga bisa dipakai sebagai
+ * regression test di CI.
+ *
+ * Pemakaian:
+ *   program --list
+ *   program <skenario> [--hours H] [--seed N] [--latency MS]
+ *                      [--dropout P] [--verbose]
+ */
+
+#include <Arduino.h>
+#include <stdio.h>
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "../../src/pins.h"
+#include "FakeTelegram.h"
+#include "Plant.h"
+
+// firmware, src/main_telegram.cpp
+void setup();
+void loop();
+
+// pengingat peringatan firmware, sama dengan ALERT_REMIND_INTERVAL
+#define REPORT_INTERVAL_HOURS 0.5
+// jeda minimal edit live status, sama dengan LIVE_EDIT_INTERVAL
+#define LIVE_EDIT_SECONDS 10
+// kapasitas log sampel /unduh_log, sama dengan SAMPLE_LOG_SIZE
+#define SAMPLE_LOG_RECORDS 384
+
+enum class Alert : uint8_t { TEMP_LOW, TEMP_HIGH, LEVEL_LOW, TREND, COUNT };
+
+static const char* const ALERT_NAMES[] = {"suhu rendah", "suhu tinggi",
+                                          "air rendah", "tren"};
+
+struct AlertLog {
+  uint32_t count;
+  double firstHour;
+  double lastHour;
+  double minGapHours;
+};
+
+// pesan pengguna, jam relatif terhadap awal simulasi atau terhadap pemicu
+struct UserMessage {
+  double hour;
+  const char* text;
+};
+
+// balasan pengguna atas peringatan pertama jenis tertentu
+struct Reaction {
+  Alert trigger;
+  std::vector<UserMessage> messages;
+};
+
+struct Result;
+class Checker;
+
+struct Scenario {
+  const char* name;
+  const char* description;
+  double hours;
+  std::function<void(PlantConfig&)> configure;
+  std::vector<UserMessage> script;
+  std::vector<Reaction> reactions;
+  std::function<void(const Result&, Checker&)> check;
+};
+
+struct Result {
+  AlertLog alerts[static_cast<uint8_t>(Alert::COUNT)];
+  uint32_t messages;
+  uint32_t requests;
+  uint32_t edits;
+  uint32_t pins;
+  std::string pinnedText;
+  std::vector<Sim::SentDocument> documents;
+  double hours;
+  double firstReactionHour;
+  PlantStats plant;
+  float finalTemp;
+  float finalLevel;
+
+  const AlertLog& alert(Alert kind) const {
+    return alerts[static_cast<uint8_t>(kind)];
+  }
+};
+
+class Checker {
+ private:
+  uint32_t m_failed = 0;
+
+ public:
+  void expect(bool ok, const char* fmt, ...) {
+    char msg[160];
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(msg, sizeof(msg), fmt, args);
+    va_end(args);
+    printf("  [%s] %s\n", ok ? "OK" : "GAGAL", msg);
+    if (!ok) m_failed++;
+  }
+  uint32_t failed() const { return m_failed; }
+};
+
+namespace {
+
+Result result;
+std::vector<UserMessage> pending;
+std::vector<bool> reacted;
+const Scenario* active = nullptr;
+
+void checkAlertGap(const Result& r, Alert kind, Checker& check) {
+  const AlertLog& log = r.alert(kind);
+  if (log.count < 2) return;
+  // toleransi satu interval pengecekan peringatan
+  check.expect(log.minGapHours >= REPORT_INTERVAL_HOURS - 5.0 / 3600,
+               "jarak peringatan %s minimal %.1f menit (%.1f menit)",
+               ALERT_NAMES[static_cast<uint8_t>(kind)],
+               REPORT_INTERVAL_HOURS * 60, log.minGapHours * 60);
+}
+
+const Scenario SCENARIOS[] = {
+    {"normal",
+     "kondisi normal tiga hari, tidak boleh ada peringatan",
+     72,
+     [](PlantConfig&) {},
+     {{1.0, "/status_sensor"}, {25.0, "/led_on"}, {37.0, "/led_off"}},
+     {},
+     [](const Result& r, Checker& check) {
+       for (uint8_t i = 0; i < static_cast<uint8_t>(Alert::COUNT); i++)
+         check.expect(r.alerts[i].count == 0, "tanpa peringatan %s (%u)",
+                      ALERT_NAMES[i], r.alerts[i].count);
+       check.expect(r.plant.minTemp > 28 && r.plant.maxTemp < 34,
+                    "suhu tetap di rentang aman (%.2f - %.2f C)",
+                    r.plant.minTemp, r.plant.maxTemp);
+     }},
+
+    {"heater_fail",
+     "pemanas rusak di ruangan 25 C, peringatan suhu rendah tanpa spam",
+     48,
+     [](PlantConfig& cfg) {
+       cfg.heaterWorking = false;
+       cfg.ambientMean = 25;
+       cfg.ambientSwing = 1;
+     },
+     {},
+     {},
+     [](const Result& r, Checker& check) {
+       const AlertLog& low = r.alert(Alert::TEMP_LOW);
+       check.expect(low.count > 0 && low.firstHour < 6,
+                    "peringatan suhu rendah dalam 6 jam (jam %.2f)",
+                    low.firstHour);
+       check.expect(r.alert(Alert::TEMP_HIGH).count == 0,
+                    "tanpa peringatan suhu tinggi");
+       const AlertLog& trend = r.alert(Alert::TREND);
+       check.expect(trend.count > 0 && trend.firstHour < low.firstHour,
+                    "peringatan tren sebelum batas terlewati (jam %.2f)",
+                    trend.firstHour);
+       check.expect(low.count <= r.hours / REPORT_INTERVAL_HOURS + 1,
+                    "peringatan suhu rendah tidak spam (%u)", low.count);
+       checkAlertGap(r, Alert::TEMP_LOW, check);
+     }},
+
+    {"heatwave",
+     "gelombang panas 36 C, peringatan suhu tinggi",
+     48,
+     [](PlantConfig& cfg) {
+       cfg.ambientMean = 36;
+       cfg.ambientSwing = 2;
+     },
+     {},
+     {},
+     [](const Result& r, Checker& check) {
+       const AlertLog& high = r.alert(Alert::TEMP_HIGH);
+       check.expect(high.count > 0 && high.firstHour < 14,
+                    "peringatan suhu tinggi dalam 14 jam (jam %.2f)",
+                    high.firstHour);
+       check.expect(r.alert(Alert::TEMP_LOW).count == 0,
+                    "tanpa peringatan suhu rendah");
+       checkAlertGap(r, Alert::TEMP_HIGH, check);
+     }},
+
+    {"evaporation_refill",
+     "penguapan tinggi, pengguna mengisi ulang lewat /pompa_toggle",
+     72,
+     [](PlantConfig& cfg) {
+       cfg.initialLevel = 84;
+       cfg.evapPerDay = 4;
+     },
+     {},
+     {{Alert::LEVEL_LOW, {{10.0 / 60, "/pompa_toggle"},
+                          {40.0 / 60, "/pompa_toggle"}}}},
+     [](const Result& r, Checker& check) {
+       const AlertLog& low = r.alert(Alert::LEVEL_LOW);
+       check.expect(low.count > 0, "peringatan tinggi air rendah (%u)",
+                    low.count);
+       check.expect(r.plant.pumpHours > 0.4 && r.plant.pumpHours < 0.6,
+                    "pompa menyala sekitar 30 menit (%.2f jam)",
+                    r.plant.pumpHours);
+       check.expect(r.plant.overflowHours == 0, "air tidak meluap");
+       check.expect(r.plant.minLevel > 75, "tinggi air minimum %.1f%%",
+                    r.plant.minLevel);
+       check.expect(low.lastHour < r.firstReactionHour + 1,
+                    "peringatan berhenti setelah isi ulang (jam %.2f)",
+                    low.lastHour);
+       check.expect(r.finalLevel > 80, "tinggi air akhir %.1f%%",
+                    r.finalLevel);
+     }},
+
+    {"live_status",
+     "status dipin lewat /live_on dan diedit di tempat tanpa pesan baru",
+     24,
+     [](PlantConfig&) {},
+     {{0.1, "/live_on"}, {6.0, "/led_on"}, {6.5, "/led_off"}},
+     {},
+     [](const Result& r, Checker& check) {
+       check.expect(r.pins == 1, "satu pesan dipin (%u)", r.pins);
+       check.expect(r.edits > 0, "pesan status diedit (%u kali)", r.edits);
+       check.expect(r.edits <= (r.hours - 0.1) * 3600 / LIVE_EDIT_SECONDS,
+                    "edit tidak melebihi satu per %u detik", LIVE_EDIT_SECONDS);
+       // Aqua Ready, pesan live, balasan /led_on dan /led_off
+       check.expect(r.messages <= 4, "tanpa pesan status baru (%u pesan)",
+                    r.messages);
+       check.expect(r.pinnedText.find("LED OFF") != std::string::npos,
+                    "status terakhir sesuai relay");
+     }},
+
+    {"unduh_log",
+     "log sampel diunduh sebagai CSV lewat /unduh_log saat ring sudah penuh",
+     8,
+     [](PlantConfig&) {},
+     {{7.0, "/unduh_log"}},
+     {},
+     [](const Result& r, Checker& check) {
+       check.expect(r.documents.size() == 1, "satu dokumen terkirim (%zu)",
+                    r.documents.size());
+       if (r.documents.empty()) return;
+       const Sim::SentDocument& doc = r.documents[0];
+       check.expect(doc.filename == "aqua_log.csv", "nama file %s",
+                    doc.filename.c_str());
+       size_t header = doc.content.find("tank,suhu_c,tinggi_pct");
+       check.expect(header != std::string::npos, "header CSV");
+       size_t rows = 0;
+       for (char c : doc.content) rows += c == '\n';
+       // baris pertama header, record terlama sudah tertimpa
+       check.expect(rows - 1 == SAMPLE_LOG_RECORDS,
+                    "%zu baris data, sama dengan kapasitas ring", rows - 1);
+       // Aqua Ready saja, caption ikut di dokumen
+       check.expect(r.messages == 1, "tanpa pesan tambahan (%u pesan)",
+                    r.messages);
+     }},
+};
+
+void onPinWrite(uint8_t pin, uint8_t value) {
+  Sim::plant.onPinWrite(pin, value);
+}
+
+int readAnalog(uint8_t pin) {
+  return pin == WATER_LEVEL_SIGNAL_PIN ? Sim::plant.readLevelRaw() : 0;
+}
+
+void schedule(double hour, const char* text) {
+  pending.push_back({hour, text});
+}
+
+void recordAlert(Alert kind, double hour) {
+  AlertLog& log = result.alerts[static_cast<uint8_t>(kind)];
+  if (log.count == 0) {
+    log.firstHour = hour;
+  } else if (hour - log.lastHour < log.minGapHours) {
+    log.minGapHours = hour - log.lastHour;
+  }
+  log.lastHour = hour;
+  log.count++;
+
+  for (size_t i = 0; i < active->reactions.size(); i++) {
+    const Reaction& reaction = active->reactions[i];
+    if (reacted[i] || reaction.trigger != kind) continue;
+    reacted[i] = true;
+    if (result.firstReactionHour < 0) result.firstReactionHour = hour;
+    for (const UserMessage& m : reaction.messages)
+      schedule(hour + m.hour, m.text);
+  }
+}
+
+void onSent(const Sim::SentMessage& msg) {
+  result.messages++;
+  if (msg.text.find("Peringatan") == std::string::npos) return;
+
+  // satu pesan bisa berisi beberapa peringatan
+  double hour = msg.timeUs / 3.6e9;
+  if (msg.text.find("Suhu air di bawah") != std::string::npos)
+    recordAlert(Alert::TEMP_LOW, hour);
+  if (msg.text.find("Suhu air di atas") != std::string::npos)
+    recordAlert(Alert::TEMP_HIGH, hour);
+  if (msg.text.find("Tinggi air di bawah") != std::string::npos)
+    recordAlert(Alert::LEVEL_LOW, hour);
+  if (msg.text.find("diperkirakan") != std::string::npos)
+    recordAlert(Alert::TREND, hour);
+}
+
+// kirim pesan pengguna yang sudah jatuh tempo, satu per getUpdates karena
+// firmware hanya membaca update terakhir
+void deliverPending() {
+  if (!Sim::telegram.delivered()) return;
+  double now = Sim::clock.hours();
+  for (auto it = pending.begin(); it != pending.end(); ++it) {
+    if (it->hour > now) continue;
+    Sim::telegram.inject(it->text);
+    pending.erase(it);
+    return;
+  }
+}
+
+void printUsage(const char* prog) {
+  printf("pemakaian: %s --list | <skenario> [--hours H] [--seed N] "
+         "[--latency MS] [--dropout P] [--verbose]\n",
+         prog);
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    printUsage(argv[0]);
+    return 2;
+  }
+
+  if (strcmp(argv[1], "--list") == 0) {
+    for (const Scenario& s : SCENARIOS) printf("%s\n", s.name);
+    return 0;
+  }
+
+  for (const Scenario& s : SCENARIOS)
+    if (strcmp(argv[1], s.name) == 0) active = &s;
+  if (active == nullptr) {
+    printf("skenario tidak dikenal: %s\n", argv[1]);
+    printUsage(argv[0]);
+    return 2;
+  }
+
+  PlantConfig config = DEFAULT_PLANT;
+  active->configure(config);
+  double hours = active->hours;
+  for (int i = 2; i < argc; i++) {
+    bool hasValue = i + 1 < argc;
+    if (strcmp(argv[i], "--verbose") == 0) {
+      Sim::console.setVerbose(true);
+    } else if (strcmp(argv[i], "--hours") == 0 && hasValue) {
+      hours = atof(argv[++i]);
+    } else if (strcmp(argv[i], "--seed") == 0 && hasValue) {
+      config.seed = strtoul(argv[++i], nullptr, 10);
+    } else if (strcmp(argv[i], "--latency") == 0 && hasValue) {
+      Sim::telegram.setLatency(strtoul(argv[++i], nullptr, 10));
+    } else if (strcmp(argv[i], "--dropout") == 0 && hasValue) {
+      config.dropoutRate = atof(argv[++i]);
+    } else {
+      printUsage(argv[0]);
+      return 2;
+    }
+  }
+
+  printf("skenario %s: %s (%.0f jam)\n", active->name, active->description,
+         hours);
+
+  for (AlertLog& log : result.alerts) log = {0, -1, -1, 1e9};
+  result.hours = hours;
+  result.firstReactionHour = -1;
+  reacted.assign(active->reactions.size(), false);
+  for (const UserMessage& m : active->script) schedule(m.hour, m.text);
+
+  Sim::plant.begin(config);
+  Sim::gpio.setListener(onPinWrite);
+  Sim::gpio.setAnalogSource(readAnalog);
+  Sim::telegram.setSentListener(onSent);
+
+  auto wallStart = std::chrono::steady_clock::now();
+  uint64_t endUs = static_cast<uint64_t>(hours * 3.6e9);
+  setup();
+  while (Sim::clock.nowUs() < endUs) {
+    deliverPending();
+    loop();
+  }
+  double wallSec = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - wallStart)
+                       .count();
+
+  Sim::plant.update();
+  result.plant = Sim::plant.stats();
+  result.finalTemp = Sim::plant.temperature();
+  result.finalLevel = Sim::plant.level();
+  result.requests = Sim::telegram.requests();
+  result.edits = Sim::telegram.edits();
+  result.pins = Sim::telegram.pins();
+  result.pinnedText = Sim::telegram.pinnedText();
+  result.documents = Sim::telegram.documents();
+
+  printf("  %.1f jam virtual dalam %.2f s (%.0fx), %u request, %u pesan, "
+         "%u edit\n",
+         hours, wallSec, hours * 3600 / (wallSec > 0 ? wallSec : 1e-6),
+         result.requests, result.messages, result.edits);
+  printf("  suhu %.2f - %.2f C, tinggi air %.1f - %.1f%%, pompa %.2f jam, "
+         "pemanas %.1f jam\n",
+         result.plant.minTemp, result.plant.maxTemp, result.plant.minLevel,
+         result.plant.maxLevel, result.plant.pumpHours,
+         result.plant.heaterHours);
+  for (uint8_t i = 0; i < static_cast<uint8_t>(Alert::COUNT); i++) {
+    const AlertLog& log = result.alerts[i];
+    if (log.count == 0) continue;
+    printf("  peringatan %s: %u kali, pertama jam %.2f, terakhir jam %.2f\n",
+           ALERT_NAMES[i], log.count, log.firstHour, log.lastHour);
+  }
+
+  Checker check;
+  active->check(result, check);
+  printf("%s: %s\n", active->name, check.failed() ? "GAGAL" : "LULUS");
+  return check.failed() ? 1 : 0;
+}
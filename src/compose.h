@@ -0,0 +1,301 @@
+#pragma once
+
+/**
+ * Komposisi firmware gabungan saat kompilasi. Satu varian firmware adalah
+ * satu kombinasi tipe policy, misalnya:
+ *
+ *   typedef Firmware<Sensors<true, true>,
+ *                    Transports<MqttTelemetry<RelayControl>, ThingSpeakUpload>,
+ *                    Logging<LOG_LEVEL_WARN>>
+ *       Aquarium;
+ *
+ * - Sensors<TEMP, LEVEL>  sensor yang terpasang, cabang sampling dibuang
+ *                         dengan if constexpr
+ * - Transports<Ts...>     sink fan-out yang aktif (lihat transports.h)
+ * - Logging<LEVEL>        level log firmware ini, tidak bisa melebihi
+ *                         LOG_LEVEL yang menjadi batas semua lib
+ *
+ * Objek transport, sensor dan analitik dibuat sebagai static lokal di dalam
+ * fungsi template, jadi bagian yang tidak dipilih varian tidak pernah
+ * di-instansiasi dan tidak ikut di-link (TLS, parser JSON, client HTTP).
+ *
+ * Setiap transport adalah struct dengan fungsi static:
+ *   ALERTS            true jika butuh alarm analitik di snapshot
+ *   sink()            Sink fan-out milik transport
+ *   begin()           daftarkan sink dan siapkan client, sebelum WiFi
+ *   start(scheduler)  buat task atau job sink
+ *   connected(up)     status WiFi berubah
+ *   applyConfig(c)    konfigurasi runtime berubah
+ *   telemetry()       dipanggil periodik setelah statistik sink dicatat
+ */
+#ifndef ESP32
+#error "firmware gabungan membutuhkan RAM ESP32 untuk TLS, MQTT dan HTTP"
+#endif
+
+#include <Analytics.h>
+#include <Arduino.h>
+#include <Config.h>
+#include <DallasTemperature.h>
+#include <Fanout.h>
+#include <FastBoot.h>
+#include <Log.h>
+#include <MemTelemetry.h>
+#include <OneWire.h>
+#include <Scheduler.h>
+#include <Shadow.h>
+#include <Stats.h>
+#include <Tanks.h>
+#include <Trace.h>
+#include <WiFi.h>
+
+#include "secret.h"
+#include "tanks.h"
+
+// jeda polling antrean sink saat kosong
+#define SINK_POLL_INTERVAL 50
+#define MEM_SAMPLE_INTERVAL 1000
+#define WIFI_POLL_INTERVAL 100
+#define SHADOW_PERSIST_INTERVAL 1000
+
+// ukuran stack task dalam byte, sesuaikan dengan hasil /mem setelah soak test
+#define SAMPLER_STACK 3072
+
+template <bool HasTemp, bool HasLevel>
+struct Sensors {
+  static_assert(HasTemp || HasLevel, "minimal satu sensor per tank");
+  static constexpr bool TEMP = HasTemp;
+  static constexpr bool LEVEL = HasLevel;
+};
+
+template <uint8_t Level>
+struct Logging {
+  static_assert(Level <= LOG_LEVEL,
+                "level di atas LOG_LEVEL tidak ikut dikompilasi");
+  static constexpr uint8_t LEVEL = Level;
+};
+
+// perintah kontrol relay yang diterima transport
+struct RelayControl {
+  static constexpr bool ENABLED = true;
+};
+struct NoControl {
+  static constexpr bool ENABLED = false;
+};
+
+template <class... Ts>
+struct Transports {
+  static_assert(sizeof...(Ts) > 0, "minimal satu transport");
+  static_assert(sizeof...(Ts) <= FANOUT_MAX_SINKS, "naikkan FANOUT_MAX_SINKS");
+  static constexpr bool ALERTS = (Ts::ALERTS || ...);
+
+  static void begin() { (Ts::begin(), ...); }
+  static void start(Scheduler& scheduler) { (Ts::start(scheduler), ...); }
+  static void connected(bool up) { (Ts::connected(up), ...); }
+  static void applyConfig(const AquaConfig& config) {
+    (Ts::applyConfig(config), ...);
+  }
+  static void telemetry() { (Ts::telemetry(), ...); }
+
+  template <class Func>
+  static void forEachSink(Func func) {
+    (func(Ts::sink()), ...);
+  }
+};
+
+// state perangkat yang dipakai bersama oleh sampler dan transport
+namespace Device {
+const ChannelConfig TEMP_ANALYTICS = {
+    -55, 125,  // rentang DS18B20, -127 berarti sensor terputus
+    Config::DEFAULTS.tempMin, Config::DEFAULTS.tempMax,
+    0.5f,                             // histeresis
+    0.1f,                             // alpha EWMA
+    Config::DEFAULTS.sensorUpdateMs,  // interval sampling
+    20,                               // slope window 30 menit
+    2,                                // horizon tren (jam)
+    0.1f,                             // tren minimum per jam
+    2, 2,                             // laju naik/turun maksimum per jam
+    6, 0.0625f,                       // outlier 6 sigma, resolusi 12 bit
+};
+const ChannelConfig LEVEL_ANALYTICS = {
+    0, 100,  // persentase
+    Config::DEFAULTS.levelMin, NAN,
+    2,                                // histeresis
+    0.1f,                             // alpha EWMA
+    Config::DEFAULTS.sensorUpdateMs,  // interval sampling
+    40,                               // slope window 60 menit
+    3,                                // horizon tren (jam)
+    0.1f,                             // tren minimum per jam
+    0, 5,                             // turun > 5% per jam berarti bocor
+    6, 0.4f,                          // outlier 6 sigma, resolusi ADC
+};
+
+inline TankBank& tanks() {
+  static TankBank bank(TANKS, TANK_COUNT);
+  return bank;
+}
+
+inline DallasTemperature& tempSensor() {
+  static OneWire bus(ONEWIRE_BUS_PIN_1);
+  static DallasTemperature sensor(&bus);
+  return sensor;
+}
+
+// dialokasikan dari setup(), setelah itu hanya ditulis oleh task sampler
+inline SensorChannel& tempChannel(uint8_t tank) {
+  static SensorChannel* channels[TANK_COUNT] = {};
+  if (!channels[tank]) channels[tank] = new SensorChannel(TEMP_ANALYTICS);
+  return *channels[tank];
+}
+
+inline SensorChannel& levelChannel(uint8_t tank) {
+  static SensorChannel* channels[TANK_COUNT] = {};
+  if (!channels[tank]) channels[tank] = new SensorChannel(LEVEL_ANALYTICS);
+  return *channels[tank];
+}
+
+inline Scheduler& scheduler() {
+  static Scheduler scheduler;
+  return scheduler;
+}
+
+inline void runSink(Sink& sink) {
+  while (true) {
+    while (sink.runOnce()) {
+    }
+    vTaskDelay(SINK_POLL_INTERVAL / portTICK_PERIOD_MS);
+  }
+}
+}  // namespace Device
+
+template <class SensorSet, class TransportSet, class LogPolicy>
+class Firmware {
+ public:
+  static void setup() {
+    Serial.begin(115200);
+    Serial.println("\n=== Smart Aquarium ===");
+#ifdef TRACE_ENABLE
+    Trace::begin();
+    Trace::dumpPrevious();
+#endif
+    Log::begin();
+    Config::begin();
+    Config::onChange(applyConfig);
+    applyConfig(Config::get(), 0);
+
+    // relay dipulihkan dari shadow tersimpan, semua mati jika belum ada
+    Device::tanks().begin();
+    Shadow::begin(Device::tanks());
+    if constexpr (SensorSet::TEMP) Device::tempSensor().begin();
+
+    TransportSet::begin();
+    FastBoot::begin(WIFI_SSID, WIFI_PASSWORD);
+    if constexpr (LogPolicy::LEVEL >= LOG_LEVEL_INFO)
+      LOG_I("Mencoba menyambungkan ke jaringan WiFi...");
+
+    TaskHandle_t samplerHandle = NULL;
+    xTaskCreatePinnedToCore(sampler, "sampler", SAMPLER_STACK, NULL, 2,
+                            &samplerHandle, 1);
+    MemTelemetry::registerTask("loopTask", xTaskGetCurrentTaskHandle(),
+                               CONFIG_ARDUINO_LOOP_STACK_SIZE);
+    MemTelemetry::registerTask("sampler", samplerHandle, SAMPLER_STACK);
+    MemTelemetry::registerTask("logDrain", Log::taskHandle(), LOG_TASK_STACK);
+
+    Scheduler& scheduler = Device::scheduler();
+    TransportSet::start(scheduler);
+    scheduler.scheduleFixedRate("wifi", WIFI_POLL_INTERVAL, wifiPoll);
+    // relay diubah dari task transport, NVS hanya ditulis dari loop()
+    scheduler.scheduleFixedDelay("shadow", SHADOW_PERSIST_INTERVAL,
+                                 [](void*) { Shadow::persist(); });
+    scheduler.scheduleFixedRate("memSample", MEM_SAMPLE_INTERVAL,
+                                [](void*) { MemTelemetry::sample(); });
+    scheduler.scheduleFixedRate("telemetry", Config::get().publishMs,
+                                telemetry, nullptr, Config::get().publishMs);
+  }
+
+  static void loop() {
+    Scheduler& scheduler = Device::scheduler();
+    scheduler.idle(scheduler.run());
+  }
+
+ private:
+  // batas aman berlaku untuk semua tank
+  static void applyConfig(const AquaConfig& config, uint32_t changed) {
+    if constexpr (TransportSet::ALERTS) {
+      for (uint8_t i = 0; i < TANK_COUNT; i++) {
+        if constexpr (SensorSet::TEMP) {
+          Device::tempChannel(i).setLimits(config.tempMin, config.tempMax);
+          Device::tempChannel(i).setSampleInterval(config.sensorUpdateMs);
+        }
+        if constexpr (SensorSet::LEVEL) {
+          Device::levelChannel(i).setLimits(config.levelMin, NAN);
+          Device::levelChannel(i).setSampleInterval(config.sensorUpdateMs);
+        }
+      }
+    }
+    TransportSet::applyConfig(config);
+    (void)changed;
+  }
+
+  static void wifiPoll(void*) {
+    static bool wasConnected = false;
+    bool isConnected = FastBoot::poll();
+
+    if (isConnected != wasConnected) {
+      if (isConnected) {
+        if constexpr (LogPolicy::LEVEL >= LOG_LEVEL_INFO)
+          LOG_I("WiFi koneksi tersambung, IP: %s",
+                WiFi.localIP().toString().c_str());
+      } else {
+        if constexpr (LogPolicy::LEVEL >= LOG_LEVEL_WARN)
+          LOG_W("WiFi koneksi terputus");
+      }
+      TRACE(WIFI, isConnected);
+      TransportSet::connected(isConnected);
+    }
+    wasConnected = isConnected;
+  }
+
+  // satu-satunya pembaca sensor, sink menerima salinan snapshot
+  static void sampler(void*) {
+    TankBank& tanks = Device::tanks();
+    Snapshot snapshot = {};
+    while (true) {
+      {
+        STATS_SCOPE(SENSOR_UPDATE);
+        if constexpr (SensorSet::TEMP) tanks.sampleTemp(Device::tempSensor());
+        if constexpr (SensorSet::LEVEL) tanks.sampleLevel();
+      }
+      FastBoot::markFirstSample();
+
+      snapshot.timestamp = millis();
+      snapshot.count = TANK_COUNT;
+      snapshot.led = tanks.relayMask(TankRelay::LED);
+      snapshot.pump = tanks.relayMask(TankRelay::PUMP);
+      for (uint8_t i = 0; i < TANK_COUNT; i++) {
+        snapshot.temp[i] = SensorSet::TEMP ? tanks.temp(i) : NAN;
+        snapshot.level[i] = SensorSet::LEVEL ? tanks.level(i) : NAN;
+        if constexpr (TransportSet::ALERTS && SensorSet::TEMP)
+          snapshot.tempAlarms[i] = Device::tempChannel(i).add(tanks.temp(i));
+        if constexpr (TransportSet::ALERTS && SensorSet::LEVEL)
+          snapshot.levelAlarms[i] =
+              Device::levelChannel(i).add(tanks.level(i));
+      }
+      Fanout::publish(snapshot);
+
+      vTaskDelay(Config::get().sensorUpdateMs / portTICK_PERIOD_MS);
+    }
+  }
+
+  static void telemetry(void*) {
+    if constexpr (LogPolicy::LEVEL >= LOG_LEVEL_INFO) {
+      TransportSet::forEachSink([](const Sink& sink) {
+        SinkStats stats = sink.stats();
+        LOG_I("sink %s: buang %lu, gagal %lu, lag maks %lums", sink.name(),
+              static_cast<unsigned long>(stats.dropped),
+              static_cast<unsigned long>(stats.failed),
+              static_cast<unsigned long>(stats.maxLagMs));
+      });
+    }
+    TransportSet::telemetry();
+  }
+};
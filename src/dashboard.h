@@ -0,0 +1,272 @@
+#pragma once
+
+/**
+ * Sink LanDashboard untuk Firmware<> di compose.h, terpisah dari
+ * transports.h agar varian tanpa dashboard (main_combined_lite.cpp) tidak
+ * membutuhkan ESPAsyncWebServer.
+ */
+#include <AquaProto.h>
+#include <ArduinoJson.h>
+#include <ESPAsyncWebServer.h>
+#include <JsonArena.h>
+#include <LittleFS.h>
+
+#include "compose.h"
+
+#define DASHBOARD_PORT 80
+#define DASHBOARD_MAX_CLIENTS 4
+// aset hanya berubah lewat uploadfs, browser cukup revalidasi tiap 10 menit
+#define DASHBOARD_CACHE_CONTROL "max-age=600"
+
+// statistik per client WebSocket dashboard
+struct DashboardClient {
+  uint32_t id;  // 0 jika slot kosong
+  uint32_t sent;
+  uint32_t dropped;  // antrean client penuh, frame tidak dikirim
+};
+
+/**
+ * Dashboard web/mqtt/public dilayani langsung dari perangkat: aset gzip dari
+ * LittleFS (lihat tools/dashboard_fs.py) dan frame init/update di WebSocket
+ * /aqua dengan bentuk yang sama dengan web/mqtt/server.js. Setiap snapshot
+ * langsung dikirim ke semua client, client yang lambat hanya kehilangan
+ * frame miliknya sendiri.
+ *
+ * Callback WebSocket berjalan di task async_tcp, tabel client dan snapshot
+ * terakhir dijaga dengan lock.
+ */
+struct LanDashboard {
+  static constexpr bool ALERTS = false;
+
+  static Sink& sink() {
+    // cadence 0: setiap snapshot diterima
+    static Sink sink("dashboard", deliver, 0);
+    return sink;
+  }
+
+  static void begin() {
+    if (!LittleFS.begin()) LOG_W("LittleFS gagal, aset dashboard tidak ada");
+
+    AsyncWebServer& http = server();
+    AsyncWebSocket& ws = socket();
+    ws.onEvent(onEvent);
+    http.addHandler(&ws);
+    http.on("/clients", HTTP_GET, [](AsyncWebServerRequest* request) {
+      char buffer[64 + 64 * DASHBOARD_MAX_CLIENTS];
+      toJson(buffer, sizeof(buffer));
+      request->send(200, "application/json", buffer);
+    });
+    // file.gz dikirim dengan Content-Encoding: gzip jika file asli tidak ada
+    http.serveStatic("/", LittleFS, "/")
+        .setDefaultFile("index.html")
+        .setCacheControl(DASHBOARD_CACHE_CONTROL);
+    Fanout::addSink(sink());
+  }
+
+  static void start(Scheduler& scheduler) {
+    scheduler.scheduleFixedDelay("dashboardSink", SINK_POLL_INTERVAL,
+                                 [](void*) {
+                                   while (sink().runOnce()) {
+                                   }
+                                 });
+  }
+
+  static void connected(bool up) {
+    if (up) server().begin();
+  }
+
+  static void applyConfig(const AquaConfig&) {}
+
+  static void telemetry() {
+    socket().cleanupClients(DASHBOARD_MAX_CLIENTS);
+    DashboardClient clients[DASHBOARD_MAX_CLIENTS];
+    copyClients(clients);
+    for (const DashboardClient& client : clients) {
+      if (client.id == 0) continue;
+      LOG_I("dashboard client %lu: kirim %lu, buang %lu",
+            static_cast<unsigned long>(client.id),
+            static_cast<unsigned long>(client.sent),
+            static_cast<unsigned long>(client.dropped));
+    }
+  }
+
+ private:
+  static AsyncWebServer& server() {
+    static AsyncWebServer server(DASHBOARD_PORT);
+    return server;
+  }
+
+  static AsyncWebSocket& socket() {
+    static AsyncWebSocket socket("/aqua");
+    return socket;
+  }
+
+  static portMUX_TYPE& lock() {
+    static portMUX_TYPE lock = portMUX_INITIALIZER_UNLOCKED;
+    return lock;
+  }
+
+  static DashboardClient* clients() {
+    static DashboardClient clients[DASHBOARD_MAX_CLIENTS] = {};
+    return clients;
+  }
+
+  static Snapshot& latest() {
+    static Snapshot snapshot = {};
+    return snapshot;
+  }
+
+  static void copyClients(DashboardClient* out) {
+    portENTER_CRITICAL(&lock());
+    memcpy(out, clients(), sizeof(DashboardClient) * DASHBOARD_MAX_CLIENTS);
+    portEXIT_CRITICAL(&lock());
+  }
+
+  static size_t toJson(char* buf, size_t len) {
+    DashboardClient clients[DASHBOARD_MAX_CLIENTS];
+    copyClients(clients);
+    size_t pos = snprintf(buf, len, "{\"type\":\"dashboard\",\"clients\":[");
+    bool first = true;
+    for (const DashboardClient& client : clients) {
+      if (client.id == 0 || pos >= len) continue;
+      pos += snprintf(buf + pos, len - pos,
+                      "%s{\"id\":%lu,\"sent\":%lu,\"dropped\":%lu}",
+                      first ? "" : ",", static_cast<unsigned long>(client.id),
+                      static_cast<unsigned long>(client.sent),
+                      static_cast<unsigned long>(client.dropped));
+      first = false;
+    }
+    if (pos < len) pos += snprintf(buf + pos, len - pos, "]}");
+    return pos < len ? pos : len - 1;
+  }
+
+  // frame dikirim ke setiap client terdaftar, hasil text() false berarti
+  // antrean client penuh dan frame dihitung sebagai drop
+  static void broadcast(const char* frame, size_t len) {
+    DashboardClient slots[DASHBOARD_MAX_CLIENTS];
+    copyClients(slots);
+    for (uint8_t i = 0; i < DASHBOARD_MAX_CLIENTS; i++) {
+      if (slots[i].id == 0) continue;
+      AsyncWebSocketClient* client = socket().client(slots[i].id);
+      bool sent = client && client->text(frame, len);
+
+      portENTER_CRITICAL(&lock());
+      if (clients()[i].id == slots[i].id) {
+        if (sent)
+          clients()[i].sent++;
+        else
+          clients()[i].dropped++;
+      }
+      portEXIT_CRITICAL(&lock());
+    }
+  }
+
+  static size_t encode(char* buf, size_t len, const char* type,
+                       const Snapshot& snapshot) {
+    return AquaProto::encodeDashboard(buf, len, type, snapshot.temp,
+                                      snapshot.level, snapshot.led,
+                                      snapshot.pump, snapshot.count,
+                                      snapshot.timestamp);
+  }
+
+  static bool deliver(const Snapshot& snapshot, void*) {
+    portENTER_CRITICAL(&lock());
+    latest() = snapshot;
+    portEXIT_CRITICAL(&lock());
+
+    char frame[128 + 96 * TANK_COUNT];
+    size_t len = encode(frame, sizeof(frame), "update", snapshot);
+    broadcast(frame, len);
+    return true;
+  }
+
+  static void onEvent(AsyncWebSocket*, AsyncWebSocketClient* client,
+                      AwsEventType type, void* arg, uint8_t* data,
+                      size_t len) {
+    if (type == WS_EVT_CONNECT) {
+      onConnect(client);
+    } else if (type == WS_EVT_DISCONNECT) {
+      portENTER_CRITICAL(&lock());
+      for (uint8_t i = 0; i < DASHBOARD_MAX_CLIENTS; i++)
+        if (clients()[i].id == client->id()) clients()[i] = {};
+      portEXIT_CRITICAL(&lock());
+    } else if (type == WS_EVT_DATA) {
+      AwsFrameInfo* info = static_cast<AwsFrameInfo*>(arg);
+      // perintah dashboard kecil, frame terpecah diabaikan
+      if (info->final && info->index == 0 && info->len == len &&
+          info->opcode == WS_TEXT)
+        onMessage(reinterpret_cast<const char*>(data), len);
+    }
+  }
+
+  static void onConnect(AsyncWebSocketClient* client) {
+    bool registered = false;
+    Snapshot snapshot;
+    portENTER_CRITICAL(&lock());
+    for (uint8_t i = 0; i < DASHBOARD_MAX_CLIENTS && !registered; i++) {
+      if (clients()[i].id != 0) continue;
+      clients()[i] = {client->id(), 0, 0};
+      registered = true;
+    }
+    snapshot = latest();
+    portEXIT_CRITICAL(&lock());
+
+    if (!registered) {
+      LOG_W("dashboard penuh, client %lu ditolak",
+            static_cast<unsigned long>(client->id()));
+      client->close();
+      return;
+    }
+
+    // sebelum sampel pertama hanya status relay yang dikirim
+    char frame[128 + 96 * TANK_COUNT];
+    TankBank& tanks = Device::tanks();
+    size_t len =
+        snapshot.count > 0
+            ? encode(frame, sizeof(frame), "init", snapshot)
+            : AquaProto::encodeDashboard(
+                  frame, sizeof(frame), "init", nullptr, nullptr,
+                  tanks.relayMask(TankRelay::LED),
+                  tanks.relayMask(TankRelay::PUMP), TANK_COUNT, 0);
+    client->text(frame, len);
+  }
+
+  // {"action":"control","control":"lamp","state":true,"tank":2}, tank
+  // opsional dengan default 1. heartbeat tidak perlu dijawab
+  static void onMessage(const char* data, size_t len) {
+    static StaticJsonArena<256> arena("dashboard");
+    JsonArenaScope arenaScope(arena);
+    JsonDocument doc(&arena);
+    if (deserializeJson(doc, data, len)) return;
+
+    const char* action = doc["action"] | "";
+    const char* control = doc["control"] | "";
+    if (strcmp(action, "control") != 0) return;
+
+    int tank = doc["tank"] | 1;
+    TankRelay relay;
+    if (strcmp(control, "lamp") == 0)
+      relay = TankRelay::LED;
+    else if (strcmp(control, "pump") == 0)
+      relay = TankRelay::PUMP;
+    else
+      return;
+
+    // shadow MQTT ikut diperbarui oleh MqttTelemetry jika ada
+    TankBank& tanks = Device::tanks();
+    // dicek sebelum dipersempit ke uint8_t, tank 257 tidak boleh menjadi 1
+    if (tank < 1 || tank > TANK_COUNT ||
+        Shadow::set(tank - 1, relay, doc["state"] | false) ==
+            ShadowResult::INVALID) {
+      LOG_W("Perintah dashboard tidak valid");
+      return;
+    }
+
+    char frame[64 + 32 * TANK_COUNT];
+    size_t frameLen = AquaProto::encodeDashboard(
+        frame, sizeof(frame), "update", nullptr, nullptr,
+        tanks.relayMask(TankRelay::LED), tanks.relayMask(TankRelay::PUMP),
+        TANK_COUNT, 0);
+    broadcast(frame, frameLen);
+  }
+};
@@ -0,0 +1,47 @@
+/*
+ * Smart Aquarium - firmware gabungan (ESP32)
+ *
+ * Satu pipeline sampling untuk semua tank, setiap snapshot dibagikan ke
+ * empat sink lewat lib/Fanout, masing-masing dengan antrean dan cadence
+ * sendiri:
+ *   - telegram   peringatan alarm analitik (lihat main_telegram.cpp)
+ *   - mqtt       data sensor di aquarium/<id>/sensor (lihat main_mqtt.cpp)
+ *   - thingspeak upload field per tank (lihat main_thingspeak.cpp)
+ *   - dashboard  web/mqtt/public dilayani langsung di http://<ip-perangkat>/
+ *                dengan push WebSocket di /aqua, tetap jalan tanpa broker
+ *
+ * Sink yang lambat hanya membuang snapshot terlama di antreannya sendiri,
+ * sampling dan sink lain tetap berjalan. Varian dengan transport lain
+ * cukup mengganti tipe Aquarium (lihat src/compose.h dan
+ * main_combined_lite.cpp).
+ *
+ * Topik MQTT tambahan:
+ * - aquarium/<id>/fanout  (publish)   - Counter per sink:
+ *   {"type": "fanout", "sinks": {"mqtt": {"accepted": 10, "skipped": 20,
+ *    "dropped": 0, "delivered": 10, "failed": 0, "lag_ms": 3, ...}, ...}}
+ *
+ * Endpoint dashboard:
+ * - GET /clients      - Frame terkirim dan terbuang per client WebSocket:
+ *   {"type": "dashboard", "clients": [{"id": 1, "sent": 120, "dropped": 2}]}
+ *
+ * Aset dashboard dikemas oleh tools/dashboard_fs.py dan diunggah dengan
+ * `pio run -e combined -t uploadfs`.
+ *
+ * Perintah kontrol, shadow relay dan topik birth/last will MQTT sama dengan
+ * main_mqtt.cpp. Relay yang diubah dari dashboard LAN ikut menaikkan versi
+ * shadow.
+ * Bot Telegram di firmware ini hanya mengirim peringatan, tidak menerima
+ * perintah.
+ */
+#include "dashboard.h"
+#include "transports.h"
+
+typedef Firmware<Sensors<true, true>,
+                 Transports<TelegramAlerts, MqttTelemetry<RelayControl>,
+                            ThingSpeakUpload, LanDashboard>,
+                 Logging<LOG_LEVEL>>
+    Aquarium;
+
+void setup() { Aquarium::setup(); }
+
+void loop() { Aquarium::loop(); }
@@ -0,0 +1,18 @@
+/*
+ * Smart Aquarium - firmware gabungan tanpa Telegram (ESP32)
+ *
+ * Sama dengan main_combined.cpp tanpa sink Telegram, jadi TLS, client bot
+ * dan analitik alarm tidak ikut di-link. Peringatan diturunkan dari data
+ * aquarium/<id>/sensor oleh broker atau dashboard. Log firmware hanya
+ * warning ke atas, sesuai LOG_LEVEL env combined_lite.
+ */
+#include "transports.h"
+
+typedef Firmware<Sensors<true, true>,
+                 Transports<MqttTelemetry<RelayControl>, ThingSpeakUpload>,
+                 Logging<LOG_LEVEL_WARN>>
+    Aquarium;
+
+void setup() { Aquarium::setup(); }
+
+void loop() { Aquarium::loop(); }
@@ -1,30 +1,82 @@
 /*
  * Smart Aquarium
  *
- * Topik MQTT:
- * - aquarium/command  (subscribe) - Menerima perintah kontrol
- * - aquarium/sensor   (publish)   - Mempublikasikan data sensor
- * - aquarium/control  (publish)   - Mempublikasikan status perangkat
+ * Topik MQTT, <id> dari MQTT_DEVICE_ID di secret.h atau chip ID (lihat
+ * lib/DeviceTopics):
+ * - aquarium/<id>/command  (subscribe) - Menerima perintah kontrol
+ * - aquarium/all/command   (subscribe) - Perintah untuk semua perangkat
+ * - aquarium/<id>/sensor   (publish)   - Mempublikasikan data sensor
+ * - aquarium/<id>/control  (publish)   - Mempublikasikan status perangkat
+ * - aquarium/<id>/stats    (publish)   - Mempublikasikan statistik latency
+ * - aquarium/<id>/mem      (publish)   - Mempublikasikan telemetri heap/stack
+ * - aquarium/<id>/config   (subscribe) - Mengubah konfigurasi runtime
+ * - aquarium/<id>/config/state (publish, retained) - Konfigurasi yang berlaku
+ * - aquarium/<id>/meta     (publish, retained) - Birth dan last will
+ * - aquarium/<id>/shadow/desired  (subscribe, retained) - Relay diinginkan
+ * - aquarium/<id>/shadow/reported (publish, retained)   - Relay terpasang
+ *
+ * Dashboard menemukan perangkat dengan berlangganan aquarium/+/meta:
+ *   {"type": "meta", "id": "a1b2c3", "online": true, "tanks": 2,
+ *    "control": true, "ip": "192.168.1.20"}
+ * Saat koneksi putus tanpa DISCONNECT, broker mengganti pesan itu dengan
+ * last will {"type": "meta", "id": "a1b2c3", "online": false}.
  *
  * Payload JSON:
  *
- * Perintah (diterima di aquarium/command):
+ * Perintah (diterima di aquarium/<id>/command):
  *   Heartbeat:
  *     {"type": "heartbeat"}
  *
- *   Kontrol perangkat:
- *     {"type": "control", "device": "led|pump", "state": "on|off"}
+ *   Kontrol perangkat, "tank" opsional (default 1, lihat src/tanks.h), "id"
+ *   opsional sebagai correlation ID, "version" opsional: perintah hanya
+ *   diterapkan jika lebih baru dari versi shadow (tanpa version berarti
+ *   versi sekarang + 1):
+ *     {"type": "control", "device": "led|pump", "state": "on|off",
+ *      "tank": 2, "id": 42, "version": 8}
+ *
+ * Data sensor (dipublikasikan di aquarium/<id>/sensor), satu elemen per tank:
+ *   {"type": "sensor", "tanks": [{"temp": 25.5, "level": 85.2}, ...],
+ *    "timestamp": 12345}
+ *
+ * Status kontrol (dipublikasikan di aquarium/<id>/control), jawaban perintah
+ * dengan id membawa id yang sama dan latency per tahap di device (us sejak
+ * pesan diterima):
+ *   {"type": "control_status", "tanks": [{"led": "on|off", "pump": "on|off"},
+ *    ...], "id": 42, "lat": {"parse": 900, "act": 950, "pub": 1800}}
+ *
+ * Shadow relay (lihat lib/Shadow), desired dan reported berbentuk sama:
+ *   {"type": "shadow", "version": 7, "tanks": [{"led": "on", "pump": "off"},
+ *    ...]}
+ * Desired retained yang diterima setelah subscribe hanya diterapkan jika
+ * versinya lebih baru. Jika lebih lama (relay diubah saat offline),
+ * perangkat mempublikasikan desired miliknya sebagai gantinya. Perubahan
+ * lokal mempublikasikan desired dan reported baru.
+ *
+ * Statistik latency (dipublikasikan di aquarium/<id>/stats, jika
+ * STATS_ENABLE):
+ *   {"type": "stats", "latency_us": {...}, "counters": {...}}
  *
- * Data sensor (dipublikasikan di aquarium/sensor):
- *   {"type": "sensor", "temp": 25.5, "level": 85.2, "timestamp": 12345}
+ * Konfigurasi (diterima di aquarium/<id>/config), semua key diterapkan
+ * sekaligus atau tidak sama sekali, key sama dengan perintah /config bot
+ * telegram:
+ *   {"sensor_ms": 5000, "publish_ms": 30000, "suhu_min": 27.5}
+ * Jawaban di aquarium/<id>/config/state, "error" hanya ada jika ditolak:
+ *   {"type": "config", "suhu_min": 27.5, ..., "error": "nilai di luar rentang"}
  *
- * Status kontrol (dipublikasikan di aquarium/control):
- *   {"type": "control_status", "led": "on|off", "pump": "on|off"}
+ * Telemetri memori (dipublikasikan di aquarium/<id>/mem):
+ *   {"type": "mem", "free": 30000, "largest": 20000, "frag": 33, ...}
+ *   {"type": "json_arena", "mqtt": {"capacity": 1024, "peak": 320, ...}}
  */
 #include <Arduino.h>
+#include <AquaProto.h>
 #include <ArduinoJson.h>
 #include <AsyncMqttClient.h>
+#include <Config.h>
 #include <DallasTemperature.h>
+#include <DeviceTopics.h>
+#include <JsonArena.h>
+#include <Log.h>
+#include <MemTelemetry.h>
 #ifdef ESP32
 #include <WiFi.h>
 #else
@@ -32,23 +84,37 @@
 #include <ESP8266WiFiType.h>
 #endif
 #include <OneWire.h>
+#include <Scheduler.h>
+#include <Shadow.h>
+#include <Stats.h>
+#include <Tanks.h>
 #include <Ticker.h>
+#include <Trace.h>
 #include <Utils.h>
 
-#include "pins.h"
 #include "secret.h"
+#include "tanks.h"
 
-#define SENSOR_UPDATE_INTERVAL 3000
+// interval sensor dan telemetri ada di lib/Config (sensor_ms, publish_ms)
+#define MEM_SAMPLE_INTERVAL 1000
+#define CONFIG_APPLY_INTERVAL 250
+#define SHADOW_PERSIST_INTERVAL 1000
 
-const char* TOPIC_COMMAND = "aquarium/command";
-const char* TOPIC_SENSOR = "aquarium/sensor";
-const char* TOPIC_CONTROL = "aquarium/control";
-
-float waterLevel = 0;
-float waterTemp = 0;
+TankBank tanks(TANKS, TANK_COUNT);
 bool shouldPublishSensor = false;
 
+// konfigurasi dari callback MQTT diterapkan oleh job "config" di loop(),
+// penulisan flash tidak dilakukan dari konteks callback jaringan
+AquaConfig pendingConfig;
+ConfigError pendingConfigError = ConfigError::NONE;
+volatile bool configPending = false;
+
 AsyncMqttClient mqttClient;
+Scheduler scheduler;
+Scheduler::JobId sensorJobId;
+Scheduler::JobId telemetryJobId;
+// semua JsonDocument MQTT memakai arena statis, direset setelah tiap pesan
+StaticJsonArena<1024> mqttArena("mqtt");
 Ticker mqttReconnectTimer;
 Ticker wifiReconnectTimer;
 
@@ -63,24 +129,42 @@ void onMqttDisconnect(AsyncMqttClientDisconnectReason reason);
 void onMqttMessage(char* topic, char* payload,
                    AsyncMqttClientMessageProperties properties, size_t len,
                    size_t index, size_t total);
-void handleCommand(const JsonDocument& doc);
+void handleCommand(const JsonDocument& doc, CommandTiming& timing);
+void handleConfig(const JsonDocument& doc);
+void handleShadow(const JsonDocument& doc);
+void applyPendingConfig(void*);
+void applyConfig(const AquaConfig& config, uint32_t changed);
+void publishConfigState(ConfigError error);
+void publishBirth();
 void publishSensorData();
-void publishControlStatus();
+void publishControlStatus(const CommandTiming* timing = nullptr);
+void publishShadow(AquaTopic leaf, const ShadowState& state);
 void sensorUpdate();
+void sensorJob(void*);
+void publishTelemetry(void*);
+void publishTrace();
 
 void setup() {
   Serial.begin(115200);
   Serial.println("\n=== Smart Aquarium MQTT ===");
-
-  pinMode(LED_RELAY, OUTPUT);
-  pinMode(PUMP_RELAY, OUTPUT);
-#ifdef ESP32
-  analogSetPinAttenuation(WATER_LEVEL_SIGNAL_PIN, ADC_11db);
+#ifdef TRACE_ENABLE
+  Trace::begin();
+  Trace::dumpPrevious();
 #endif
+  Log::begin();
+  Config::begin();
+  Config::onChange(applyConfig);
 
-  // Initial relay state: OFF
-  digitalWrite(LED_RELAY, HIGH);
-  digitalWrite(PUMP_RELAY, HIGH);
+  // relay dipulihkan dari shadow tersimpan, semua mati jika belum ada
+  tanks.begin();
+  Shadow::begin(tanks);
+  tempSensor.begin();
+
+#ifdef MQTT_DEVICE_ID
+  DeviceTopics::begin(tanks.count(), true, MQTT_DEVICE_ID);
+#else
+  DeviceTopics::begin(tanks.count(), true);
+#endif
 
   // MQTT callbacks
   mqttClient.onConnect(onMqttConnect);
@@ -88,21 +172,25 @@ void setup() {
   mqttClient.onMessage(onMqttMessage);
   mqttClient.setServer(MQTT_HOST, MQTT_PORT);
   mqttClient.setCredentials(MQTT_USER, MQTT_PASSWORD);
+  mqttClient.setClientId(DeviceTopics::id());
+  mqttClient.setWill(DeviceTopics::get(AquaTopic::META), 1, true,
+                     DeviceTopics::will());
 
   // WiFi event handlers
 #ifdef ESP32
   WiFi.onEvent(
       [](WiFiEvent_t event, WiFiEventInfo_t info) {
-        Serial.println("WiFi koneksi tersambung");
-        Serial.print("IP: ");
-        Serial.println(WiFi.localIP());
+        LOG_I("WiFi koneksi tersambung, IP: %s",
+              WiFi.localIP().toString().c_str());
+        TRACE(WIFI, 1);
         connectToMqtt();
       },
       WiFiEvent_t::ARDUINO_EVENT_WIFI_STA_GOT_IP);
 
   WiFi.onEvent(
       [](WiFiEvent_t event, WiFiEventInfo_t info) {
-        Serial.println("WiFi koneksi terputus");
+        LOG_W("WiFi koneksi terputus");
+        TRACE(WIFI, 0);
         mqttReconnectTimer.detach();
         wifiReconnectTimer.once(2, connectToWifi);
       },
@@ -113,59 +201,92 @@ void setup() {
 
   wifiConnectHandler =
       WiFi.onStationModeGotIP([](const WiFiEventStationModeGotIP& event) {
-        Serial.println("WiFi koneksi tersambung");
-        Serial.print("IP: ");
-        Serial.println(WiFi.localIP());
+        LOG_I("WiFi koneksi tersambung, IP: %s",
+              WiFi.localIP().toString().c_str());
+        TRACE(WIFI, 1);
         connectToMqtt();
       });
 
   wifiDisconnectHandler = WiFi.onStationModeDisconnected(
       [](const WiFiEventStationModeDisconnected& event) {
-        Serial.println("WiFi koneksi terputus");
+        LOG_W("WiFi koneksi terputus");
+        TRACE(WIFI, 0);
         mqttReconnectTimer.detach();
         wifiReconnectTimer.once(2, connectToWifi);
       });
 #endif
 
+  sensorJobId = scheduler.scheduleFixedRate(
+      "sensor", Config::get().sensorUpdateMs, sensorJob);
+  scheduler.setTraced(sensorJobId, true);
+  scheduler.scheduleFixedRate("memSample", MEM_SAMPLE_INTERVAL,
+                              [](void*) { MemTelemetry::sample(); });
+  telemetryJobId = scheduler.scheduleFixedRate(
+      "telemetry", Config::get().publishMs, publishTelemetry, nullptr,
+      Config::get().publishMs);
+  scheduler.scheduleFixedDelay("config", CONFIG_APPLY_INTERVAL,
+                               applyPendingConfig);
+  // flash tidak ditulis dari callback MQTT, perubahan beruntun digabung
+  scheduler.scheduleFixedDelay("shadow", SHADOW_PERSIST_INTERVAL,
+                               [](void*) { Shadow::persist(); });
+#ifdef ESP32
+  MemTelemetry::registerTask("loopTask", xTaskGetCurrentTaskHandle(),
+                             CONFIG_ARDUINO_LOOP_STACK_SIZE);
+  MemTelemetry::registerTask("logDrain", Log::taskHandle(), LOG_TASK_STACK);
+#else
+  MemTelemetry::registerTask("cont", nullptr, 4096);
+  scheduler.scheduleFixedRate("log", LOG_DRAIN_INTERVAL,
+                              [](void*) { Log::drain(); });
+#endif
+
   connectToWifi();
 }
 
-void loop() {
-  static uint32_t lastSensorUpdate = 0;
+void loop() { scheduler.idle(scheduler.run()); }
 
-  if (millis() - lastSensorUpdate >= SENSOR_UPDATE_INTERVAL) {
-    sensorUpdate();
-
-    if (shouldPublishSensor) {
-      publishSensorData();
-      shouldPublishSensor = false;
-    }
+void sensorJob(void*) {
+  sensorUpdate();
 
-    lastSensorUpdate = millis();
+  if (shouldPublishSensor) {
+    publishSensorData();
+    shouldPublishSensor = false;
   }
-
-  delay(20);
 }
 
 void connectToWifi() {
-  Serial.println("Mencoba menyambungkan ke jaringan WiFi...");
+  LOG_I("Mencoba menyambungkan ke jaringan WiFi...");
   WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
 }
 
 void connectToMqtt() { mqttClient.connect(); }
 
 void onMqttConnect(bool sessionPresent) {
-  Serial.println("MQTT koneksi tersambung");
+  LOG_I("MQTT koneksi tersambung");
+  TRACE(MQTT_CONNECT, sessionPresent);
 
-  // Subscribe to command topic
-  mqttClient.subscribe(TOPIC_COMMAND, 0);
+  for (uint8_t i = 0; i < DeviceTopics::subscriptionCount(); i++) {
+    const TopicSubscription& sub = DeviceTopics::subscription(i);
+    mqttClient.subscribe(sub.filter, sub.qos);
+  }
 
-  // Publish initial status
+  // Publish initial status. Desired retained datang setelah subscribe di
+  // atas dan ditangani handleShadow()
+  publishBirth();
+  publishShadow(AquaTopic::SHADOW_REPORTED, Shadow::reported());
   publishControlStatus();
+  publishConfigState(ConfigError::NONE);
+
+  // trace sesi sebelum reset cukup dikirim sekali per boot
+  static bool tracePublished = false;
+  if (!tracePublished) {
+    publishTrace();
+    tracePublished = true;
+  }
 }
 
 void onMqttDisconnect(AsyncMqttClientDisconnectReason reason) {
-  Serial.println("MQTT koneksi terputus");
+  LOG_W("MQTT koneksi terputus");
+  TRACE(MQTT_DISCONNECT, static_cast<uint8_t>(reason));
 
   if (WiFi.isConnected()) {
     mqttReconnectTimer.once(2, connectToMqtt);
@@ -175,106 +296,262 @@ void onMqttDisconnect(AsyncMqttClientDisconnectReason reason) {
 void onMqttMessage(char* topic, char* payload,
                    AsyncMqttClientMessageProperties properties, size_t len,
                    size_t index, size_t total) {
+  CommandTiming timing;
+  timing.receivedUs = micros();
+
+  AquaTopic leaf;
+  if (!DeviceTopics::route(topic, leaf)) {
+    LOG_W("topik tidak dikenal: %s", topic);
+    return;
+  }
+
+  // desired retained yang dihapus
+  if (len == 0) return;
+
+  MEM_SCOPE(MQTT);
+  MEM_COUNT_ALLOC(MQTT, len + 1);
+
   // Create null-terminated string
   char message[len + 1];
   memcpy(message, payload, len);
   message[len] = '\0';
-  Serial.print("< ");
-  JsonDocument doc;
+  LOG_D("< %s", message);
+  JsonArenaScope arenaScope(mqttArena);
+  JsonDocument doc(&mqttArena);
   DeserializationError error = deserializeJson(doc, message);
 
   if (error) {
-    Serial.print("JSON parse error: ");
-    Serial.println(error.c_str());
+    LOG_E("JSON parse error: %s", error.c_str());
     return;
   }
 
-  handleCommand(doc);
+  if (leaf == AquaTopic::CONFIG)
+    handleConfig(doc);
+  else if (leaf == AquaTopic::SHADOW_DESIRED)
+    handleShadow(doc);
+  else
+    handleCommand(doc, timing);
 }
 
-void handleCommand(const JsonDocument& doc) {
-  const char* type = doc["type"];
-
-  if (!type) {
-    Serial.println("Missing 'type' field");
+void handleShadow(const JsonDocument& doc) {
+  ShadowState desired = Shadow::desired();
+  if (!AquaProto::parseShadow(doc, desired.version, desired.led,
+                              desired.pump, tanks.count())) {
+    LOG_W("shadow desired tidak valid");
     return;
   }
 
-  if (streq(type, "heartbeat")) {
-    Serial.println("Heartbeat diterima dari klien");
-    shouldPublishSensor = true;
+  ShadowResult result = Shadow::apply(desired);
+  LOG_I("shadow desired v%lu: %s",
+        static_cast<unsigned long>(desired.version),
+        Shadow::resultName(result));
+  if (result == ShadowResult::APPLIED) {
+    publishShadow(AquaTopic::SHADOW_REPORTED, Shadow::reported());
+    publishControlStatus();
+  } else if (result == ShadowResult::STALE) {
+    // relay diubah saat offline, desired di broker diganti milik perangkat
+    publishShadow(AquaTopic::SHADOW_DESIRED, Shadow::desired());
+  }
+}
 
-  } else if (streq(type, "control")) {
-    const char* device = doc["device"];
-    const char* state = doc["state"];
+void handleConfig(const JsonDocument& doc) {
+  // perubahan sebelumnya yang belum diterapkan digantikan
+  AquaConfig draft = Config::get();
+  ConfigError error = ConfigError::NONE;
+
+  for (JsonPairConst kv : doc.as<JsonObjectConst>()) {
+    char value[16];
+    if (kv.value().is<const char*>())
+      snprintf(value, sizeof(value), "%s", kv.value().as<const char*>());
+    else
+      serializeJson(kv.value(), value, sizeof(value));
+
+    error = Config::set(draft, kv.key().c_str(), value);
+    if (error != ConfigError::NONE) {
+      LOG_W("config %s=%s ditolak: %s", kv.key().c_str(), value,
+            Config::errorName(error));
+      break;
+    }
+  }
+
+  pendingConfig = draft;
+  pendingConfigError = error;
+  configPending = true;
+}
 
-    if (!device || !state) {
-      Serial.println("Missing 'device' or 'state' field");
+void applyPendingConfig(void*) {
+  if (!configPending) return;
+  configPending = false;
+
+  ConfigError error = pendingConfigError;
+  if (error == ConfigError::NONE) error = Config::commit(pendingConfig);
+  publishConfigState(error);
+}
+
+// job berikutnya memakai interval baru tanpa restart
+void applyConfig(const AquaConfig& config, uint32_t changed) {
+  if (changed & configBit(ConfigField::SENSOR_UPDATE))
+    scheduler.setPeriod(sensorJobId, config.sensorUpdateMs);
+  if (changed & configBit(ConfigField::PUBLISH))
+    scheduler.setPeriod(telemetryJobId, config.publishMs);
+}
+
+void publishConfigState(ConfigError error) {
+  if (!mqttClient.connected()) return;
+
+  JsonArenaScope arenaScope(mqttArena);
+  JsonDocument doc(&mqttArena);
+  doc["type"] = "config";
+  char value[16];
+  for (uint8_t i = 0; i < static_cast<uint8_t>(ConfigField::COUNT); i++) {
+    ConfigField field = static_cast<ConfigField>(i);
+    Config::formatValue(value, sizeof(value), Config::get(), field);
+    doc[Config::key(field)] = serialized(value);
+  }
+  if (error != ConfigError::NONE) doc["error"] = Config::errorName(error);
+
+  char buffer[256];
+  size_t len = serializeJson(doc, buffer);
+  mqttClient.publish(DeviceTopics::get(AquaTopic::CONFIG_STATE), 0, true,
+                     buffer, len);
+}
+
+void handleCommand(const JsonDocument& doc, CommandTiming& timing) {
+  AquaCommand cmd;
+  bool valid = AquaProto::parseCommand(doc, cmd);
+  timing.id = cmd.id;
+  timing.parsedUs = micros();
+
+  if (cmd.type == AquaCommandType::HEARTBEAT) {
+    LOG_D("Heartbeat diterima dari klien");
+    shouldPublishSensor = true;
+
+  } else if (cmd.type == AquaCommandType::CONTROL) {
+    if (!valid) {
+      LOG_W("Missing 'device' or 'state' field");
       return;
     }
 
-    bool turnOn = streq(state, "on");
+    if (cmd.tank >= tanks.count()) {
+      LOG_W("Unknown tank: %u", cmd.tank + 1);
+      return;
+    }
 
-    if (streq(device, "led")) {
-      digitalWrite(LED_RELAY, turnOn ? LOW : HIGH);
-      Serial.printf("LED: %s\n", turnOn ? "ON" : "OFF");
-      publishControlStatus();
+    if (cmd.device == AquaDevice::UNKNOWN) {
+      const char* device = doc["device"];
+      LOG_W("Unknown device: %s", device);
+      return;
+    }
 
-    } else if (streq(device, "pump")) {
-      digitalWrite(PUMP_RELAY, turnOn ? LOW : HIGH);
-      Serial.printf("Pump: %s\n", turnOn ? "ON" : "OFF");
-    } else {
-      Serial.print("Unknown device: ");
-      Serial.println(device);
+    TankRelay relay =
+        cmd.device == AquaDevice::LED ? TankRelay::LED : TankRelay::PUMP;
+    ShadowResult result = Shadow::set(cmd.tank, relay, cmd.on, cmd.version);
+    timing.actuatedUs = micros();
+    LOG_I("%s %u: %s (%s)", cmd.device == AquaDevice::LED ? "LED" : "Pump",
+          cmd.tank + 1, cmd.on ? "ON" : "OFF", Shadow::resultName(result));
+
+    // selalu dijawab agar pengirim tahu state sebenarnya
+    publishControlStatus(&timing);
+    if (result == ShadowResult::APPLIED) {
+      publishShadow(AquaTopic::SHADOW_DESIRED, Shadow::desired());
+      publishShadow(AquaTopic::SHADOW_REPORTED, Shadow::reported());
     }
+  } else if (!valid) {
+    LOG_W("Missing 'type' field");
   } else {
-    Serial.print("Unknown command type: ");
-    Serial.println(type);
+    const char* type = doc["type"];
+    LOG_W("Unknown command type: %s", type);
   }
 }
 
-void publishSensorData() {
-  JsonDocument doc;
-  doc["type"] = "sensor";
-  doc["temp"] = waterTemp;
-  doc["level"] = waterLevel;
-  doc["timestamp"] = millis();
-
+void publishBirth() {
   char buffer[128];
-  size_t len = serializeJson(doc, buffer);
+  size_t len = DeviceTopics::birth(buffer, sizeof(buffer),
+                                   WiFi.localIP().toString().c_str());
+  mqttClient.publish(DeviceTopics::get(AquaTopic::META), 1, true, buffer, len);
+}
 
-  mqttClient.publish(TOPIC_SENSOR, 0, false, buffer, len);
-  Serial.print("> ");
-  Serial.println(buffer);
+void publishSensorData() {
+  // sekitar 32 byte per tank
+  char buffer[64 + 32 * TANK_COUNT];
+  size_t len =
+      AquaProto::encodeSensor(buffer, sizeof(buffer), tanks.temps(),
+                              tanks.levels(), tanks.count(), millis());
+
+  STATS_SCOPE(MQTT_PUBLISH);
+  if (!mqttClient.publish(DeviceTopics::get(AquaTopic::SENSOR), 0, false,
+                          buffer, len))
+    STATS_COUNT(MQTT_PUBLISH_FAIL);
+  LOG_D("> sensor %u tank", tanks.count());
 }
 
-void publishControlStatus() {
-  JsonDocument doc;
-  doc["type"] = "control_status";
-  doc["led"] = (digitalRead(LED_RELAY) == LOW) ? "on" : "off";
-  doc["pump"] = (digitalRead(PUMP_RELAY) == LOW) ? "on" : "off";
+void publishControlStatus(const CommandTiming* timing) {
+  char buffer[128 + 32 * TANK_COUNT];
+  size_t len = AquaProto::encodeControlStatus(
+      buffer, sizeof(buffer), tanks.relayMask(TankRelay::LED),
+      tanks.relayMask(TankRelay::PUMP), tanks.count(), timing, micros());
 
-  char buffer[128];
-  size_t len = serializeJson(doc, buffer);
+  STATS_SCOPE(MQTT_PUBLISH);
+  if (!mqttClient.publish(DeviceTopics::get(AquaTopic::CONTROL), 0, true,
+                          buffer, len))
+    STATS_COUNT(MQTT_PUBLISH_FAIL);
+}
 
-  mqttClient.publish(TOPIC_CONTROL, 0, true, buffer, len);
+void publishShadow(AquaTopic leaf, const ShadowState& state) {
+  char buffer[64 + 32 * TANK_COUNT];
+  size_t len = AquaProto::encodeShadow(buffer, sizeof(buffer), state.version,
+                                       state.led, state.pump, tanks.count());
+  mqttClient.publish(DeviceTopics::get(leaf), 1, true, buffer, len);
 }
 
-void sensorUpdate() {
-  tempSensor.requestTemperatures();
-  waterTemp = tempSensor.getTempCByIndex(0);
+void publishTelemetry(void*) {
+  if (!mqttClient.connected()) return;
 
-  pinMode(WATER_LEVEL_POWER_PIN, OUTPUT);
-  digitalWrite(WATER_LEVEL_POWER_PIN, HIGH);
-  delay(50);
+  char buffer[768];
+  size_t len;
+#ifdef STATS_ENABLE
+  len = Stats::toJson(buffer, sizeof(buffer));
+  mqttClient.publish(DeviceTopics::get(AquaTopic::STATS), 0, false, buffer,
+                     len);
+#endif
 
-  int raw = analogRead(WATER_LEVEL_SIGNAL_PIN);
-  digitalWrite(WATER_LEVEL_POWER_PIN, LOW);
+  len = MemTelemetry::toJson(buffer, sizeof(buffer));
+  mqttClient.publish(DeviceTopics::get(AquaTopic::MEM), 0, false, buffer,
+                     len);
 
-  float percent = (raw / 260.0f) * 100.0f;
-  if (percent > 100.0f) percent = 100.0f;
-  waterLevel = percent;
+  len = JsonArena::toJson(buffer, sizeof(buffer));
+  mqttClient.publish(DeviceTopics::get(AquaTopic::MEM), 0, false, buffer,
+                     len);
+}
+
+// trace sesi sebelumnya dikirim per potongan, decode dengan
+// tools/trace_decode.py
+void publishTrace() {
+#ifdef TRACE_ENABLE
+  char buffer[512];
+  uint16_t next = 0;
+  while (next < Trace::previousCount()) {
+    uint16_t first = next;
+    size_t len = snprintf(buffer, sizeof(buffer),
+                          "{\"type\":\"trace\",\"reason\":%lu,"
+                          "\"first\":%u,\"records\":\"",
+                          static_cast<unsigned long>(Trace::resetReason()),
+                          first);
+    next = Trace::hexDump(buffer + len, sizeof(buffer) - len - 2, first);
+    len += strlen(buffer + len);
+    len += snprintf(buffer + len, sizeof(buffer) - len, "\"}");
+    mqttClient.publish(DeviceTopics::get(AquaTopic::TRACE), 0, false, buffer,
+                       len);
+  }
+#endif
+}
+
+void sensorUpdate() {
+  STATS_SCOPE(SENSOR_UPDATE);
+  tanks.sample(tempSensor);
 
-  Serial.printf("suhu air: %.2f°C, tinggi air: %.2f%%\n", waterTemp,
-                waterLevel);
+  for (uint8_t i = 0; i < tanks.count(); i++) {
+    LOG_I("tank %u suhu air: %.2f°C, tinggi air: %.2f%%", i + 1,
+          tanks.temp(i), tanks.level(i));
+  }
 }
\ No newline at end of file
@@ -19,36 +19,113 @@
  * Telegram, kode ini sudah mendukung di kedua jenis chip atau jenis mcu board
  * yaitu ESP32 dan ESP8266.
  */
+#include <Analytics.h>
 #include <Arduino.h>
 #include <CommandRouter.h>
+#include <Config.h>
 #include <DallasTemperature.h>
+#include <FastBoot.h>
+#include <JsonArena.h>
+#include <LiveMessage.h>
+#include <Log.h>
+#include <MemTelemetry.h>
+#include <SampleLog.h>
 #ifdef ESP32
 #include <WiFi.h>
 #else
 #include <ESP8266WiFi.h>
 #endif
 #include <OneWire.h>
+#ifndef ESP32
+#include <Scheduler.h>
+#endif
+#include <Shadow.h>
+#include <Stats.h>
+#include <Tanks.h>
 #include <Telek.h>
+#include <Trace.h>
 #include <Utils.h>
+#include <WebhookServer.h>
 
 #include <string>
 
-#include "pins.h"
 #include "secret.h"
-
-#define MESSAGE_UPDATE_INTERVAL 2000
-#define SENSOR_UPDATE_INTERVAL 3000
-#define SENSOR_REPORT_INTERVAL 60 * 1000 * 5
-
-// deklarasi konstanta rentang nilai sensor yang aman
-const float WATER_TEMP_SAFE_MIN = 28;  // derajat celcius
-const float WATER_TEMP_SAFE_MAX = 34;
-const float WATER_LEVEL_SAFE_MAX = 100;  // persentase
-const float WATER_LEVEL_SAFE_MIN = 80;
-
-// deklarasi variable state dan nilai sensor
-float waterLevel = 0;  // persentase ketinggian air
-float waterTemp = 0;
+#include "tanks.h"
+
+// interval polling dan batas aman sensor ada di lib/Config, bisa diubah
+// lewat perintah /config tanpa flash ulang
+// peringatan yang masih aktif dikirim ulang setelah interval ini
+#define ALERT_REMIND_INTERVAL (30UL * 60 * 1000)
+#define MEM_SAMPLE_INTERVAL 1000
+#define NTP_MIN_VALID_EPOCH 1735689600  // 2025-01-01, jam dianggap tersinkron
+#define NTP_SYNC_TIMEOUT 5000
+#define WIFI_POLL_INTERVAL 100
+#define COMMAND_WORKER_INTERVAL 50
+// jeda cek koneksi masuk pada mode webhook
+#define WEBHOOK_POLL_INTERVAL 10
+// live status (/live_on): teks dirender ulang setiap LIVE_STATUS_INTERVAL,
+// edit dibatasi satu per LIVE_EDIT_INTERVAL dan nilai sensor yang
+// ditampilkan baru diganti jika berubah melebihi deadband
+#define LIVE_STATUS_INTERVAL 1000
+#define LIVE_EDIT_INTERVAL 10000
+#define LIVE_TEMP_DEADBAND 0.2f
+#define LIVE_LEVEL_DEADBAND 1.0f
+// satu record per tank di log sampel (/unduh_log) setiap interval ini
+#define SAMPLE_LOG_INTERVAL 60000
+
+// ukuran stack task dalam byte, sesuaikan dengan hasil /mem setelah soak test
+#define SENSOR_UPDATER_STACK 2048
+#define MESSAGE_UPDATER_STACK 8192
+#define SENSOR_REPORTER_STACK 4096
+
+// state, nilai sensor dan relay semua tank
+TankBank tanks(TANKS, TANK_COUNT);
+
+// analitik per sampel, batas aman dan interval sampling diperbarui oleh
+// applyConfig()
+const ChannelConfig TEMP_ANALYTICS = {
+    -55, 125,  // rentang DS18B20, -127 berarti sensor terputus
+    Config::DEFAULTS.tempMin, Config::DEFAULTS.tempMax,
+    0.5f,                             // histeresis
+    0.1f,                             // alpha EWMA
+    Config::DEFAULTS.sensorUpdateMs,  // interval sampling
+    20,                               // slope window 30 menit
+    2,                                // horizon tren (jam)
+    0.1f,                             // tren minimum per jam
+    2, 2,                             // laju naik/turun maksimum per jam
+    6, 0.0625f,                       // outlier 6 sigma, resolusi 12 bit
+};
+const ChannelConfig LEVEL_ANALYTICS = {
+    0, 100,  // persentase
+    Config::DEFAULTS.levelMin, NAN,
+    2,                                // histeresis
+    0.1f,                             // alpha EWMA
+    Config::DEFAULTS.sensorUpdateMs,  // interval sampling
+    40,                               // slope window 60 menit
+    3,                                // horizon tren (jam)
+    0.1f,                             // tren minimum per jam
+    0, 5,                             // turun > 5% per jam berarti bocor
+    6, 0.4f,                          // outlier 6 sigma, resolusi ADC
+};
+// satu channel per tank, dialokasikan sekali saat boot
+SensorChannel* tempChannel[TANK_COUNT];
+SensorChannel* levelChannel[TANK_COUNT];
+
+// peringatan hanya dikirim saat alarm baru aktif, sebagai pengingat, dan
+// sekali saat kembali normal
+AlertState tempAlert[TANK_COUNT] = {};
+AlertState levelAlert[TANK_COUNT] = {};
+// true setelah panggilan startup ke API telegram selesai
+volatile bool botOnline = false;
+
+// pesan status yang dipin, nilai sensor terakhir yang ditampilkan
+LiveMessage liveStatus(LIVE_EDIT_INTERVAL);
+float liveTemp[TANK_COUNT];
+float liveLevel[TANK_COUNT];
+
+// riwayat sampel untuk /unduh_log, pembaca CSV harus tetap ada selama upload
+SampleLog sampleLog;
+SampleLogCsv sampleCsv;
 
 // deklarasi struct/class instance
 Telek botClient(BOT_TOKEN);
@@ -56,6 +133,14 @@ MessageBody* msgBody = new MessageBody{};
 CommandRouter router;
 BotCommand botCmd = {0};
 
+#ifdef WEBHOOK_URL
+// mode webhook (lihat secret.example.h): update diterima server HTTP di
+// perangkat, reverse proxy meneruskan WEBHOOK_URL ke port ini. Uji lokal
+// dengan mengirim ulang update yang direkam:
+//   tools/webhook_replay.py http://<ip>:8080/telegram updates.jsonl
+WebhookServer webhook(WEBHOOK_PORT, WEBHOOK_PATH, WEBHOOK_SECRET);
+#endif
+
 // sensor suhu air
 OneWire onewireBus_1(ONEWIRE_BUS_PIN_1);
 DallasTemperature tempSensor(&onewireBus_1);
@@ -71,19 +156,39 @@ const char HELP_MESSAGE[] = R"MSG(*Perintah dasar*
 	*Control*
 		/led\_toggle  =>  Switch lampu led on/off
   /pompa\_toggle => Switch pompa air on/off
+  /pompa\_2\_on => Nyalakan pompa tank 2, juga \_off dan \_toggle
 	*Monitor*
-  /air\_suhu => Mengirim informasi suhu air
+  /air\_suhu => Mengirim informasi suhu air semua tank
   /air\_tinggi => Mengirim informasi level persentase tinggi air
+  /air\_2\_suhu => Mengirim informasi tank 2 saja
   *Status*
   /status\_control => Mengirim status control saat ini
-  /status\_sensor => Mengirim nilai sensor saat ini
+  /status\_sensor => Mengirim nilai sensor beserta statistik dan tren
+  /stats => Mengirim statistik latency firmware
+  /mem => Mengirim telemetri heap dan stack
+  /trace => Mengirim trace event sebelum reset terakhir
+  /live\_on => Pin satu pesan status yang diperbarui otomatis
+  /live\_off => Hentikan pembaruan pesan status
+  /unduh\_log => Mengirim log sampel sensor sebagai file CSV
+  *Konfigurasi*
+  /config => Mengirim konfigurasi saat ini
+  /config\_suhu\_min 27.5 => Mengubah satu nilai konfigurasi
+  /config\_reset => Mengembalikan konfigurasi default
 )MSG";  // pake format markdown biar cakep
 const char COMMAND_START[] = "/start";
 const char COMMAND_HELP[] = "/help";
+// nomor tank opsional setelah perintah, default tank 1: /pompa_2_on
 const char COMMAND_LED[] = "/led";
 const char COMMAND_PUMP[] = "/pompa";
-const char COMMAND_WATER_MONITOR[] = "/air";  // /air_suhu, /air_tinggi
+const char COMMAND_WATER_MONITOR[] = "/air";  // /air_suhu, /air_2_tinggi
 const char COMMAND_STATUS[] = "/status";      // /status_control, /status_sensor
+const char COMMAND_STATS[] = "/stats";
+const char COMMAND_MEM[] = "/mem";
+const char COMMAND_TRACE[] = "/trace";
+const char COMMAND_LIVE[] = "/live";  // /live, /live_on, /live_off
+const char COMMAND_DOWNLOAD[] = "/unduh";  // /unduh_log
+// /config, /config_<key> <nilai>, /config_reset
+const char COMMAND_CONFIG[] = "/config";
 }  // namespace Aqua
 
 // variabel task handle untuk mengatur task seperti delete, suspend/resume dan
@@ -96,8 +201,35 @@ TaskHandle_t sensorReporterHandle = NULL;
 void task_sensorUpdater(void*);
 void task_messageUpdater(void*);
 void task_sensorReporter(void*);
+
+// id task pada trace event TASK_BEGIN
+enum TraceTask : uint8_t {
+  TRACE_TASK_SENSOR_UPDATER,
+  TRACE_TASK_MESSAGE_UPDATER,
+  TRACE_TASK_SENSOR_REPORTER,
+};
+#else
+// pada ESP8266 semua job berjalan secara kooperatif di loop()
+Scheduler scheduler;
+Scheduler::JobId messageJob;
+Scheduler::JobId sensorJob;
+bool co_sensorReporter(Coroutine& co, void*);
+bool co_botPoller(Coroutine& co, void*);
+bool co_botStartup(Coroutine& co, void*);
 #endif
 
+void botStartup();
+void botReady();
+
+void sensorUpdate();
+void messageUpdate();
+void handleIncomingMessage(MessageBody* body);
+void handleWebhook(const char* body, size_t len, String& reply, void*);
+void sensorReport();
+void liveStatusUpdate();
+void memSample();
+void applyConfig(const AquaConfig& config, uint32_t changed);
+
 // deklarasi command handler untuk perintah bot telegram
 void handle_start(Telek& telek, const BotCommand& cmd);
 void handle_help(Telek& telek, const BotCommand& cmd);
@@ -105,171 +237,456 @@ void handle_ctrl_led(Telek& telek, const BotCommand& cmd);
 void handle_ctrl_pump(Telek& telek, const BotCommand& cmd);
 void handle_water_monitor(Telek& telek, const BotCommand& cmd);
 void handle_status(Telek& telek, const BotCommand& cmd);
-
-// map untuk menyimpan perintah bot dan fungsi yang menjalankan perintah
-// tersebut
-CommandMap commandHandlers{
-    {Aqua::COMMAND_START, handle_start},
-    {Aqua::COMMAND_HELP, handle_help},
-    {Aqua::COMMAND_LED, handle_ctrl_led},
-    {Aqua::COMMAND_PUMP, handle_ctrl_pump},
-    {Aqua::COMMAND_WATER_MONITOR, handle_water_monitor},
-    {Aqua::COMMAND_STATUS, handle_status},
+void handle_stats(Telek& telek, const BotCommand& cmd);
+void handle_mem(Telek& telek, const BotCommand& cmd);
+void handle_trace(Telek& telek, const BotCommand& cmd);
+void handle_live(Telek& telek, const BotCommand& cmd);
+void handle_download(Telek& telek, const BotCommand& cmd);
+void handle_config(Telek& telek, const BotCommand& cmd);
+
+// tabel perintah bot dan fungsi yang menjalankan perintah tersebut.
+// Perintah aktuator dijalankan langsung, sisanya lewat antrean worker sesuai
+// prioritas
+const RouteEntry COMMAND_ROUTES[] = {
+    {Aqua::COMMAND_START, handle_start, RouteClass::WORKER},
+    {Aqua::COMMAND_HELP, handle_help, RouteClass::WORKER},
+    {Aqua::COMMAND_LED, handle_ctrl_led, RouteClass::IMMEDIATE},
+    {Aqua::COMMAND_PUMP, handle_ctrl_pump, RouteClass::IMMEDIATE},
+    {Aqua::COMMAND_WATER_MONITOR, handle_water_monitor, RouteClass::WORKER,
+     RoutePriority::URGENT},
+    {Aqua::COMMAND_STATUS, handle_status, RouteClass::WORKER,
+     RoutePriority::URGENT},
+    {Aqua::COMMAND_STATS, handle_stats, RouteClass::WORKER,
+     RoutePriority::BACKGROUND},
+    {Aqua::COMMAND_MEM, handle_mem, RouteClass::WORKER,
+     RoutePriority::BACKGROUND},
+    {Aqua::COMMAND_TRACE, handle_trace, RouteClass::WORKER,
+     RoutePriority::BACKGROUND},
+    {Aqua::COMMAND_LIVE, handle_live, RouteClass::WORKER},
+    {Aqua::COMMAND_DOWNLOAD, handle_download, RouteClass::WORKER,
+     RoutePriority::BACKGROUND},
+    {Aqua::COMMAND_CONFIG, handle_config, RouteClass::WORKER},
 };
 
 void setup() {
   Serial.begin(115200);
+#ifdef TRACE_ENABLE
+  Trace::begin();
+  Trace::dumpPrevious();
+#endif
+  Log::begin();
+  Config::begin();
+#ifdef ESP32
+  // channel dibaca task sensorUpdater, perubahan diterapkan di task itu
+  Config::onChange(applyConfig, true);
+#else
+  Config::onChange(applyConfig);
+#endif
   tempSensor.begin();
+  for (uint8_t i = 0; i < TANK_COUNT; i++) {
+    tempChannel[i] = new SensorChannel(TEMP_ANALYTICS);
+    levelChannel[i] = new SensorChannel(LEVEL_ANALYTICS);
+  }
+  // sebelum task sensor berjalan, changed 0 tidak menyentuh job scheduler
+  applyConfig(Config::get(), 0);
 
-  router.setRoutes(commandHandlers);
+  router.setRoutes(COMMAND_ROUTES);
 
-  pinMode(LED_RELAY, OUTPUT);
-  pinMode(PUMP_RELAY, OUTPUT);
-#ifdef ESP32
-  analogSetPinAttenuation(WATER_LEVEL_SIGNAL_PIN, ADC_11db);
-#endif
+  // relay dipulihkan dari shadow tersimpan, semua mati jika belum ada
+  tanks.begin();
+  Shadow::begin(tanks);
 
-  // kondisi awal relay mati semua
-  digitalWrite(LED_RELAY, HIGH);
-  digitalWrite(PUMP_RELAY, HIGH);
+  // sensor dan relay sudah berjalan selama WiFi tersambung di background,
+  // panggilan startup ke API telegram dilakukan setelah tersambung
+  FastBoot::begin(WIFI_SSID, WIFI_PASSWORD);
+  LOG_I("Mencoba menyambungkan ke jaringan WiFi...");
 
-  WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
-  Serial.println("\n\nMencoba menyambungkan ke jaringan WiFi...");
+#ifdef ESP32
+  xTaskCreatePinnedToCore(task_sensorUpdater, "sensorUpdater",
+                          SENSOR_UPDATER_STACK, NULL, 1, &sensorUpdaterHandle,
+                          1);
+  xTaskCreatePinnedToCore(task_messageUpdater, "messageUpdater",
+                          MESSAGE_UPDATER_STACK, NULL, 1, &messageUpdaterHandle,
+                          1);
+  xTaskCreatePinnedToCore(task_sensorReporter, "sensorReporter",
+                          SENSOR_REPORTER_STACK, NULL, 1, &sensorReporterHandle,
+                          1);
+
+  MemTelemetry::registerTask("loopTask", xTaskGetCurrentTaskHandle(),
+                             CONFIG_ARDUINO_LOOP_STACK_SIZE);
+  MemTelemetry::registerTask("sensorUpdater", sensorUpdaterHandle,
+                             SENSOR_UPDATER_STACK);
+  MemTelemetry::registerTask("messageUpdater", messageUpdaterHandle,
+                             MESSAGE_UPDATER_STACK);
+  MemTelemetry::registerTask("sensorReporter", sensorReporterHandle,
+                             SENSOR_REPORTER_STACK);
+  MemTelemetry::registerTask("logDrain", Log::taskHandle(), LOG_TASK_STACK);
+#else
+  MemTelemetry::registerTask("cont", nullptr, 4096);  // stack loop() ESP8266
+  scheduler.scheduleFixedRate("log", LOG_DRAIN_INTERVAL,
+                              [](void*) { Log::drain(); });
+  scheduler.scheduleFixedRate("memSample", MEM_SAMPLE_INTERVAL,
+                              [](void*) { memSample(); });
+#ifdef WEBHOOK_URL
+  messageJob = scheduler.scheduleFixedDelay(
+      "webhook", WEBHOOK_POLL_INTERVAL, [](void*) { messageUpdate(); });
+#else
+  messageJob = scheduler.scheduleFixedDelay(
+      "messageUpdate", Config::get().messageUpdateMs,
+      [](void*) { messageUpdate(); });
+#endif
+  sensorJob = scheduler.scheduleFixedRate("sensorUpdate",
+                                          Config::get().sensorUpdateMs,
+                                          [](void*) { sensorUpdate(); });
+  scheduler.spawn("sensorReporter", co_sensorReporter);
+  // job yang bisa memblokir loop() dicatat di trace untuk analisis watchdog
+#ifndef WEBHOOK_URL
+  scheduler.setTraced(messageJob, true);
+#endif
+  scheduler.setTraced(sensorJob, true);
+  scheduler.scheduleFixedDelay("command", COMMAND_WORKER_INTERVAL,
+                               [](void*) { router.runPending(botClient); });
+  scheduler.scheduleFixedDelay("liveStatus", LIVE_STATUS_INTERVAL,
+                               [](void*) { liveStatusUpdate(); });
+  scheduler.scheduleFixedRate("wifi", WIFI_POLL_INTERVAL,
+                              [](void*) { FastBoot::poll(); });
+  scheduler.spawn("botStartup", co_botStartup);
+#endif
+}
 
-  while (!WiFi.isConnected()) {
-    Serial.println(".");
-    delay(500);
+// dipanggil saat boot dan setiap kali konfigurasi berubah lewat /config,
+// pada ESP32 dari task sensorUpdater lewat Config::dispatch(). Task ESP32
+// membaca interval dari Config::get() di setiap putaran
+void applyConfig(const AquaConfig& config, uint32_t changed) {
+  for (uint8_t i = 0; i < TANK_COUNT; i++) {
+    tempChannel[i]->setLimits(config.tempMin, config.tempMax);
+    levelChannel[i]->setLimits(config.levelMin, NAN);
+    tempChannel[i]->setSampleInterval(config.sensorUpdateMs);
+    levelChannel[i]->setSampleInterval(config.sensorUpdateMs);
   }
 
-  Serial.printf("Tersambung ke jaringan WiFi dengan SSID: %s\n", WIFI_SSID);
-  delay(1000);
+#ifndef ESP32
+#ifndef WEBHOOK_URL
+  if (changed & configBit(ConfigField::MESSAGE_UPDATE))
+    scheduler.setPeriod(messageJob, config.messageUpdateMs);
+#endif
+  if (changed & configBit(ConfigField::SENSOR_UPDATE))
+    scheduler.setPeriod(sensorJob, config.sensorUpdateMs);
+#else
+  (void)changed;
+#endif
+}
 
+// dipanggil sekali setelah WiFi tersambung dan jam tersinkron
+void botStartup() {
   auto botInfo = botClient.getBotInfo();
 
-  Serial.printf("Bot telegram sudah berjalan dengan nama: %s\n",
-                botInfo.username);
+  LOG_I("Tersambung ke jaringan WiFi dengan SSID: %s", WIFI_SSID);
+  LOG_I("Bot telegram sudah berjalan dengan nama: %s", botInfo.username);
 
-  botClient.sendMessage(TELEGRAM_USER_ID, "Aqua Ready!!");
-  botClient.getMessageUpdate(nullptr);
+  botReady();
+}
 
-#ifdef ESP32
-  xTaskCreatePinnedToCore(task_sensorUpdater, "sensorUpdater", 2048, NULL, 1,
-                          &sensorUpdaterHandle, 1);
-  xTaskCreatePinnedToCore(task_messageUpdater, "messageUpdater", 8192, NULL, 1,
-                          &messageUpdaterHandle, 1);
-  xTaskCreatePinnedToCore(task_sensorReporter, "sensorReporter", 4096, NULL, 1,
-                          &sensorReporterHandle, 1);
+// setelah getMe selesai. Pada mode async request di sini hanya masuk antrean
+// dan dikirim co_botPoller
+void botReady() {
+  FastBoot::markOnline();
+  char msg[128];
+  size_t len = snprintf(msg, sizeof(msg), "Aqua Ready!!\n```\n");
+  len += FastBoot::format(msg + len, sizeof(msg) - len);
+  if (len < sizeof(msg)) snprintf(msg + len, sizeof(msg) - len, "```");
+  LOG_I("boot: sampel %lu ms, wifi %lu ms, online %lu ms",
+        static_cast<unsigned long>(FastBoot::firstSampleMs()),
+        static_cast<unsigned long>(FastBoot::connectedMs()),
+        static_cast<unsigned long>(FastBoot::onlineMs()));
+
+  botClient.sendMessage(TELEGRAM_USER_ID, msg);
+#ifdef WEBHOOK_URL
+  botClient.setWebhook(WEBHOOK_URL, WEBHOOK_SECRET);
+  webhook.begin(handleWebhook);
+#else
+  // update_id terakhir dicatat agar perintah lama tidak dijalankan
+  if (botClient.isAsync())
+    botClient.requestMessageUpdate(nullptr, nullptr);
+  else
+    botClient.getMessageUpdate(nullptr);
 #endif
+  botOnline = true;
 }
 
 void sensorUpdate() {
-  constexpr float MAX_SENSOR_VALUE = 260;
-  tempSensor.requestTemperatures();
-  waterTemp = tempSensor.getTempCByIndex(0);
+  STATS_SCOPE(SENSOR_UPDATE);
+  // delay settling probe level di dalamnya memakai vTaskDelay pada ESP32
+  tanks.sample(tempSensor);
+  FastBoot::markFirstSample();
+
+  static uint32_t lastLogMs = 0;
+  static bool logged = false;
+  bool logSample = !logged || millis() - lastLogMs >= SAMPLE_LOG_INTERVAL;
+  if (logSample) {
+    lastLogMs = millis();
+    logged = true;
+  }
 
-  pinMode(WATER_LEVEL_POWER_PIN, OUTPUT);
-  digitalWrite(WATER_LEVEL_POWER_PIN, HIGH);
-#ifdef ESP32
-  vTaskDelay(50 / portTICK_PERIOD_MS);
-#else
-  delay(50);
-#endif
-  auto sensor_raw = analogRead(WATER_LEVEL_SIGNAL_PIN);
-  digitalWrite(WATER_LEVEL_POWER_PIN, LOW);
-  float sensor_persen = (sensor_raw / MAX_SENSOR_VALUE) * 100.0f;
-  if (sensor_persen > 100) sensor_persen = 100;
-  waterLevel = sensor_persen;
-  Serial.printf("suhu air: %.2f, tinggi air: %.2f%%\n", waterTemp, waterLevel);
+  for (uint8_t i = 0; i < TANK_COUNT; i++) {
+    tempChannel[i]->add(tanks.temp(i));
+    levelChannel[i]->add(tanks.level(i));
+    LOG_I("tank %u suhu air: %.2f, tinggi air: %.2f%%", i + 1, tanks.temp(i),
+          tanks.level(i));
+    if (logSample)
+      sampleLog.add(i, tanks.temp(i), tanks.level(i),
+                    tanks.relay(i, TankRelay::LED),
+                    tanks.relay(i, TankRelay::PUMP), lastLogMs / 1000);
+  }
 }
 
 void messageUpdate() {
-  if (botClient.getMessageUpdate(msgBody)) {
-    Serial.printf("pesan masuk: @%s: '%s'\n", msgBody->sender,
-                  msgBody->message);
-    if (botClient.parseCommand(botCmd, msgBody->message)) {
-      if (!router.dispatch(botClient, botCmd)) {
-        Serial.println("gagal menjalankan perintah");
-      }
+  if (!botOnline) return;
+#ifdef WEBHOOK_URL
+  // satu langkah per panggilan, request yang sedang berjalan dilanjutkan
+  // panggilan berikutnya setiap WEBHOOK_POLL_INTERVAL
+  webhook.poll();
+  return;
+#endif
+  // polling ditunda selama heap tidak cukup untuk sesi TLS
+  if (MemTelemetry::degraded()) return;
+
+  if (botClient.isAsync()) {
+    // hasilnya diproses oleh handleIncomingMessage saat response diterima
+    botClient.requestMessageUpdate(
+        msgBody, [](Telek&, MessageBody* body, void*) {
+          handleIncomingMessage(body);
+        });
+    return;
+  }
+
+  if (botClient.getMessageUpdate(msgBody)) handleIncomingMessage(msgBody);
+}
+
+// satu update per request webhook. Balasan pertama, termasuk dari perintah
+// worker yang langsung dijalankan di sini, dikirim di response webhook
+void handleWebhook(const char* body, size_t len, String& reply, void*) {
+  if (!botClient.parseWebhookUpdate(body, len, msgBody)) return;
+
+  botClient.captureReply(&reply);
+  handleIncomingMessage(msgBody);
+  router.runPending(botClient);
+  botClient.captureReply(nullptr);
+}
+
+void handleIncomingMessage(MessageBody* body) {
+  LOG_I("pesan masuk: @%s: '%s'", body->sender, body->message);
+  if (botClient.parseCommand(botCmd, body->message)) {
+    if (!router.dispatch(botClient, botCmd)) {
+      LOG_W("gagal menjalankan perintah");
     }
   }
 }
 
-bool sensorReport() {
-  bool hasWarning = false;
-  if (waterTemp < WATER_TEMP_SAFE_MIN) {
-    String msg = "Peringatan: Suhu air di bawah batas aman!: ";
-    msg += String(waterTemp, 2) + "°C";
-    botClient.sendMessage(msg.c_str());
-    hasWarning = true;
-  } else if (waterTemp > WATER_TEMP_SAFE_MAX) {
-    String msg = "Peringatan: Suhu air di atas batas aman!: ";
-    msg += String(waterTemp, 2) + "°C";
-    botClient.sendMessage(msg.c_str());
-    hasWarning = true;
+void reportChannel(const char* name, const char* unit,
+                   const SensorChannel& channel, AlertState& state) {
+  char msg[256];
+  if (Analytics::alertMessage(msg, sizeof(msg), name, unit, channel,
+                              channel.alarms(), state, millis(),
+                              ALERT_REMIND_INTERVAL))
+    botClient.sendMessage(msg);
+}
+
+void sensorReport() {
+  if (!botOnline || MemTelemetry::degraded()) return;
+
+  char name[24];
+  for (uint8_t i = 0; i < TANK_COUNT; i++) {
+    Tanks::label(name, sizeof(name), "Suhu air", i, TANK_COUNT);
+    reportChannel(name, "°C", *tempChannel[i], tempAlert[i]);
+    Tanks::label(name, sizeof(name), "Tinggi air", i, TANK_COUNT);
+    reportChannel(name, "%", *levelChannel[i], levelAlert[i]);
+  }
+}
+
+// teks live status memakai nilai yang sudah melewati deadband, sehingga hash
+// teks hanya berubah jika ada yang layak diedit
+size_t formatLiveStatus(char* msg, size_t size) {
+  char label[24];
+  char alarms[40];
+  size_t len = snprintf(msg, size, "*Status Live:*\n```\n");
+  for (uint8_t i = 0; i < TANK_COUNT && len < size; i++) {
+    Tanks::label(label, sizeof(label), "Suhu air", i, TANK_COUNT);
+    len += snprintf(msg + len, size - len,
+                    "%s: %.1f°C, tinggi %.0f%%\n  LED %s, pompa %s\n", label,
+                    liveTemp[i], liveLevel[i],
+                    tanks.relay(i, TankRelay::LED) ? "ON" : "OFF",
+                    tanks.relay(i, TankRelay::PUMP) ? "ON" : "OFF");
+    uint8_t tempAlarms = tempChannel[i]->alarms();
+    if (tempAlarms && len < size) {
+      Analytics::formatAlarms(alarms, sizeof(alarms), tempAlarms);
+      len += snprintf(msg + len, size - len, "  alarm suhu %s\n", alarms);
+    }
+    uint8_t levelAlarms = levelChannel[i]->alarms();
+    if (levelAlarms && len < size) {
+      Analytics::formatAlarms(alarms, sizeof(alarms), levelAlarms);
+      len += snprintf(msg + len, size - len, "  alarm air %s\n", alarms);
+    }
   }
+  if (len < size) len += snprintf(msg + len, size - len, "```");
+  return len < size ? len : size - 1;
+}
 
-  if (waterLevel < WATER_LEVEL_SAFE_MIN) {
-    String msg = "Peringatan: Tinggi air di bawah batas aman!: ";
-    msg += String(waterLevel, 2) + "%";
-    botClient.sendMessage(msg.c_str());
-    hasWarning = true;
+// request dijalankan dari konteks yang sama dengan polling bot, pada ESP32
+// task messageUpdater
+void liveStatusUpdate() {
+  if (!botOnline || !liveStatus.active() || MemTelemetry::degraded()) return;
+
+  for (uint8_t i = 0; i < TANK_COUNT; i++) {
+    if (isnan(liveTemp[i]) ||
+        fabsf(tanks.temp(i) - liveTemp[i]) >= LIVE_TEMP_DEADBAND)
+      liveTemp[i] = tanks.temp(i);
+    if (isnan(liveLevel[i]) ||
+        fabsf(tanks.level(i) - liveLevel[i]) >= LIVE_LEVEL_DEADBAND)
+      liveLevel[i] = tanks.level(i);
   }
 
-  return hasWarning;
+  char msg[32 + 128 * TANK_COUNT];
+  formatLiveStatus(msg, sizeof(msg));
+  liveStatus.update(botClient, msg, millis());
+}
+
+void memSample() {
+  bool wasDegraded = MemTelemetry::degraded();
+  MemTelemetry::sample();
+
+  if (MemTelemetry::degraded() != wasDegraded) {
+    const MemSample& mem = MemTelemetry::current();
+    LOG_W("mode degrade %s, free heap: %lu, blok terbesar: %lu",
+          wasDegraded ? "selesai" : "aktif",
+          static_cast<unsigned long>(mem.freeHeap),
+          static_cast<unsigned long>(mem.largestBlock));
+  }
 }
 
 #ifdef ESP32
-void loop() { delay(1000); }
+void loop() {
+  FastBoot::poll();
+  memSample();
+  delay(MEM_SAMPLE_INTERVAL);
+}
 
 void task_sensorUpdater(void*) {
   while (true) {
+    TRACE(TASK_BEGIN, TRACE_TASK_SENSOR_UPDATER);
+    Config::dispatch();
     sensorUpdate();
-    vTaskDelay(SENSOR_UPDATE_INTERVAL / portTICK_PERIOD_MS);
+    vTaskDelay(Config::get().sensorUpdateMs / portTICK_PERIOD_MS);
   }
 }
 
 void task_messageUpdater(void*) {
+  while (!FastBoot::connected())
+    vTaskDelay(WIFI_POLL_INTERVAL / portTICK_PERIOD_MS);
+
+  // jam dibutuhkan untuk cek masa berlaku sertifikat server telegram
+  configTime(0, 0, "pool.ntp.org", "time.nist.gov");
+  uint32_t syncStart = millis();
+  while (time(nullptr) < NTP_MIN_VALID_EPOCH &&
+         millis() - syncStart < NTP_SYNC_TIMEOUT)
+    vTaskDelay(250 / portTICK_PERIOD_MS);
+
+  botStartup();
+
+  uint32_t liveCheckMs = 0;
   while (true) {
+#ifndef WEBHOOK_URL
+    // putaran mode webhook terlalu rapat untuk dicatat di trace
+    TRACE(TASK_BEGIN, TRACE_TASK_MESSAGE_UPDATER);
+#endif
     messageUpdate();
-    vTaskDelay(MESSAGE_UPDATE_INTERVAL / portTICK_PERIOD_MS);
+    // satu perintah worker dan satu balasan per putaran, getUpdates diselipkan
+    // di antaranya agar perintah aktuator tidak menunggu antrean balasan
+    router.runPending(botClient);
+    botClient.flush(1);
+    if (millis() - liveCheckMs >= LIVE_STATUS_INTERVAL) {
+      liveCheckMs = millis();
+      liveStatusUpdate();
+    }
+
+#ifdef WEBHOOK_URL
+    uint32_t idle = WEBHOOK_POLL_INTERVAL;
+#else
+    uint32_t idle = Config::get().messageUpdateMs;
+#endif
+    uint32_t interval = router.pending() || botClient.pendingMessages()
+                            ? COMMAND_WORKER_INTERVAL
+                            : idle;
+    vTaskDelay(interval / portTICK_PERIOD_MS);
   }
 }
 
 void task_sensorReporter(void*) {
-  static uint32_t lastReport = 0;
   while (true) {
-    if (lastReport < 1 || millis() - lastReport >= SENSOR_REPORT_INTERVAL) {
-      if (sensorReport()) {
-        lastReport = millis();
-      }
-    }
-    vTaskDelay(5000 / portTICK_PERIOD_MS);  // Check every 5 seconds
+    TRACE(TASK_BEGIN, TRACE_TASK_SENSOR_REPORTER);
+    sensorReport();
+    vTaskDelay(Config::get().sensorReportMs / portTICK_PERIOD_MS);
   }
 }
 #else
-void loop() {
-  static uint32_t lastMessageUpdate = 0;
-  static uint32_t lastSensorUpdate = 0;
-  static uint32_t lastSensorReport = 0;
+void loop() { scheduler.idle(scheduler.run()); }
 
-  if (millis() - lastMessageUpdate >= MESSAGE_UPDATE_INTERVAL) {
-    messageUpdate();
-    lastMessageUpdate = millis();
+bool co_sensorReporter(Coroutine& co, void*) {
+  CO_BEGIN(co);
+  while (true) {
+    sensorReport();
+    CO_SLEEP(co, Config::get().sensorReportMs);
   }
+  CO_END(co);
+}
 
-  if (millis() - lastSensorUpdate >= SENSOR_UPDATE_INTERVAL) {
-    sensorUpdate();
-    lastSensorUpdate = millis();
-  }
+bool co_botStartup(Coroutine& co, void*) {
+  static uint32_t syncStart;
+  static bool botInfoDone;
+  CO_BEGIN(co);
+  CO_AWAIT(co, FastBoot::connected(), WIFI_POLL_INTERVAL);
+
+  // jam dibutuhkan untuk cek masa berlaku sertifikat server telegram
+  configTime(0, 0, "pool.ntp.org", "time.nist.gov");
+  syncStart = millis();
+  CO_AWAIT(co,
+           time(nullptr) >= NTP_MIN_VALID_EPOCH ||
+               millis() - syncStart >= NTP_SYNC_TIMEOUT,
+           250);
+
+  // satu-satunya koneksi TLS blocking di luar CONNECT AsyncHttp, sekali saat
+  // boot agar poll() tidak pernah memprobe MFLN
+  botClient.probeTls();
+  // batas degrade mengikuti buffer RX yang disetujui server, bukan 16 KB
+  MemTelemetry::setDegradeThreshold(botClient.tlsBlockNeeded());
+  LOG_I("mode degrade di bawah blok %lu B",
+        static_cast<unsigned long>(MemTelemetry::degradeThreshold()));
+
+  // mulai dari sini request bot berjalan non-blocking lewat co_botPoller,
+  // termasuk request startup
+  botClient.enableAsync();
+  scheduler.setTraced(scheduler.spawn("botPoller", co_botPoller), true);
+
+  LOG_I("Tersambung ke jaringan WiFi dengan SSID: %s", WIFI_SSID);
+  // seperti botStartup(), gagal atau tidak bot tetap dijalankan
+  botInfoDone = false;
+  botClient.requestBotInfo(
+      [](Telek&, TelekMethod, bool, int32_t, void*) { botInfoDone = true; });
+  CO_AWAIT(co, botInfoDone, 50);
+  botReady();
+  CO_END(co);
+}
 
-  if (lastSensorReport < 1 ||
-      millis() - lastSensorReport >= SENSOR_REPORT_INTERVAL) {
-    if (sensorReport()) {
-      lastSensorReport = millis();
-    }
+bool co_botPoller(Coroutine& co, void*) {
+  CO_BEGIN(co);
+  while (true) {
+    // poll lebih rapat selama request masih berjalan
+    if (botClient.poll())
+      CO_SLEEP(co, 5);
+    else
+      CO_SLEEP(co, 50);
   }
-
-  delay(20);
+  CO_END(co);
 }
 #endif
 
@@ -281,60 +698,268 @@ void handle_help(Telek& telek, const BotCommand& cmd) {
   telek.sendMessage(Aqua::HELP_MESSAGE);
 }
 
-void handle_ctrl_led(Telek& telek, const BotCommand& cmd) {
-  static bool state = false;
-  if (streq(cmd.parameter, "toggle") && !state) {
-    digitalWrite(LED_RELAY, LOW);
-    telek.sendMessage("Lampu sudah menyala bos!");
-  } else if (state) {
-    digitalWrite(LED_RELAY, HIGH);
-    telek.sendMessage("Siap bos!");
+// /led_toggle, /pompa_on, /pompa_2_off, tanpa nomor tank berarti tank 1
+void controlRelay(Telek& telek, const BotCommand& cmd, TankRelay relay,
+                  const char* name) {
+  uint8_t tank;
+  const char* action;
+  if (!Tanks::parseTarget(cmd.parameter, TANK_COUNT, tank, action)) {
+    telek.sendMessage("Tank tidak ada bos!");
+    return;
   }
 
-  state = !state;
-}
+  bool on;
+  if (streq(action, "toggle")) {
+    on = !tanks.relay(tank, relay);
+  } else if (streq(action, "on") || streq(action, "off")) {
+    on = streq(action, "on");
+  } else {
+    telek.sendMessage("Ngawur ya boss!");
+    return;
+  }
+  // versi shadow ikut naik, state bertahan setelah reset
+  Shadow::set(tank, relay, on);
+  Shadow::persist();
 
-void handle_ctrl_pump(Telek& telek, const BotCommand& cmd) {
-  static bool state = false;
-  if (streq(cmd.parameter, "toggle") && !state) {
-    digitalWrite(PUMP_RELAY, LOW);
-    telek.sendMessage("Pompa air sudah menyala bos!");
-  } else if (state) {
-    digitalWrite(PUMP_RELAY, HIGH);
+  if (!on) {
     telek.sendMessage("Siap bos!");
+    return;
   }
+  char label[24];
+  Tanks::label(label, sizeof(label), name, tank, TANK_COUNT);
+  char msg[48];
+  snprintf(msg, sizeof(msg), "%s sudah menyala bos!", label);
+  telek.sendMessage(msg);
+}
 
-  state = !state;
+void handle_ctrl_led(Telek& telek, const BotCommand& cmd) {
+  controlRelay(telek, cmd, TankRelay::LED, "Lampu");
+}
+
+void handle_ctrl_pump(Telek& telek, const BotCommand& cmd) {
+  controlRelay(telek, cmd, TankRelay::PUMP, "Pompa air");
 }
 
 void handle_water_monitor(Telek& telek, const BotCommand& cmd) {
-  if (streq(cmd.parameter, "suhu")) {
-    char msg[32];
-    sprintf(msg, "Suhu air:  *%.1f°C*", waterTemp);
-    telek.sendMessage(msg);
-  } else if (streq(cmd.parameter, "tinggi")) {
-    char msg[32];
-    sprintf(msg, "Tinggi air:  *%.2f%%*", waterLevel);
-    telek.sendMessage(msg);
-  } else {
+  uint8_t tank;
+  const char* action;
+  if (!Tanks::parseTarget(cmd.parameter, TANK_COUNT, tank, action)) {
+    telek.sendMessage("Tank tidak ada bos!");
+    return;
+  }
+  bool temp = streq(action, "suhu");
+  if (!temp && !streq(action, "tinggi")) {
     telek.sendMessage("Ngawur ya boss!");
+    return;
+  }
+
+  // tanpa nomor tank (action tidak bergeser) dikirim semua tank
+  uint8_t first = action == cmd.parameter ? 0 : tank;
+  uint8_t last = action == cmd.parameter ? TANK_COUNT : tank + 1;
+  char msg[48 * TANK_COUNT];
+  char label[24];
+  size_t len = 0;
+  for (uint8_t i = first; i < last && len < sizeof(msg); i++) {
+    Tanks::label(label, sizeof(label), temp ? "Suhu air" : "Tinggi air", i,
+                 TANK_COUNT);
+    if (temp)
+      len += snprintf(msg + len, sizeof(msg) - len, "%s:  *%.1f°C*\n", label,
+                      tanks.temp(i));
+    else
+      len += snprintf(msg + len, sizeof(msg) - len, "%s:  *%.2f%%*\n", label,
+                      tanks.level(i));
   }
+  telek.sendMessage(msg);
 }
 
 void handle_status(Telek& telek, const BotCommand& cmd) {
+  char label[24];
   if (streq(cmd.parameter, "control")) {
-    char msg[128];
-    const char* ledStatus = digitalRead(LED_RELAY) == LOW ? "ON" : "OFF";
-    const char* pumpStatus = digitalRead(PUMP_RELAY) == LOW ? "ON" : "OFF";
-    sprintf(msg, "*Status Kontrol:*\nLED: %s\nPompa: %s", ledStatus,
-            pumpStatus);
+    char msg[32 + 48 * TANK_COUNT];
+    size_t len = snprintf(msg, sizeof(msg), "*Status Kontrol:*");
+    for (uint8_t i = 0; i < TANK_COUNT && len < sizeof(msg); i++) {
+      Tanks::label(label, sizeof(label), "\nLED", i, TANK_COUNT);
+      len += snprintf(msg + len, sizeof(msg) - len, "%s: %s", label,
+                      tanks.relay(i, TankRelay::LED) ? "ON" : "OFF");
+      if (len >= sizeof(msg)) break;
+      Tanks::label(label, sizeof(label), "\nPompa", i, TANK_COUNT);
+      len += snprintf(msg + len, sizeof(msg) - len, "%s: %s", label,
+                      tanks.relay(i, TankRelay::PUMP) ? "ON" : "OFF");
+    }
     telek.sendMessage(msg);
   } else if (streq(cmd.parameter, "sensor")) {
-    char msg[128];
-    sprintf(msg, "*Status Sensor:*\nSuhu air: %.1f°C\nTinggi air: %.2f%%",
-            waterTemp, waterLevel);
+    char msg[64 + 448 * TANK_COUNT];
+    size_t len = snprintf(msg, sizeof(msg), "*Status Sensor:*\n");
+    for (uint8_t i = 0; i < TANK_COUNT && len < sizeof(msg); i++) {
+      Tanks::label(label, sizeof(label), "Suhu air", i, TANK_COUNT);
+      len += snprintf(msg + len, sizeof(msg) - len, "%s: %.1f°C\n", label,
+                      tanks.temp(i));
+      if (len >= sizeof(msg)) break;
+      Tanks::label(label, sizeof(label), "Tinggi air", i, TANK_COUNT);
+      len += snprintf(msg + len, sizeof(msg) - len, "%s: %.2f%%\n", label,
+                      tanks.level(i));
+    }
+    if (len < sizeof(msg))
+      len += snprintf(msg + len, sizeof(msg) - len, "```\n");
+    for (uint8_t i = 0; i < TANK_COUNT && len < sizeof(msg); i++) {
+      Tanks::label(label, sizeof(label), "suhu", i, TANK_COUNT);
+      len += Analytics::format(msg + len, sizeof(msg) - len, label, "C",
+                               *tempChannel[i]);
+      Tanks::label(label, sizeof(label), "tinggi", i, TANK_COUNT);
+      len += Analytics::format(msg + len, sizeof(msg) - len, label, "%",
+                               *levelChannel[i]);
+    }
+    if (len < sizeof(msg)) snprintf(msg + len, sizeof(msg) - len, "```");
     telek.sendMessage(msg);
   } else {
     telek.sendMessage("Gunakan /status\\_control atau /status\\_sensor");
   }
 }
+
+void handle_stats(Telek& telek, const BotCommand& cmd) {
+#ifdef STATS_ENABLE
+  char msg[768];
+  size_t len = snprintf(msg, sizeof(msg), "*Statistik:*\n```\n");
+  len += Stats::format(msg + len, sizeof(msg) - len);
+#ifndef ESP32
+  for (Scheduler::JobId id = 0; id < SCHED_MAX_JOBS && len < sizeof(msg);
+       id++) {
+    const JobStats* job = scheduler.jobStats(id);
+    if (!job) continue;
+    len += snprintf(msg + len, sizeof(msg) - len,
+                    "job %-14s run max %lums late max %lums\n",
+                    scheduler.jobName(id),
+                    static_cast<unsigned long>(job->maxRunUs / 1000),
+                    static_cast<unsigned long>(job->maxLateMs));
+  }
+#endif
+  if (len < sizeof(msg)) snprintf(msg + len, sizeof(msg) - len, "```");
+  telek.sendMessage(msg);
+#else
+  telek.sendMessage("Statistik tidak aktif pada firmware ini");
+#endif
+
+  // statistik per perintah dikirim terpisah agar muat di buffer pesan
+  char routes[512];
+  size_t pos = snprintf(routes, sizeof(routes), "*Perintah:*\n```\n");
+  pos += router.format(routes + pos, sizeof(routes) - pos);
+  if (pos < sizeof(routes))
+    snprintf(routes + pos, sizeof(routes) - pos, "```");
+  telek.sendMessage(routes);
+}
+
+void handle_mem(Telek& telek, const BotCommand& cmd) {
+  char msg[768];
+  size_t len = snprintf(msg, sizeof(msg), "*Memori:*\n```\n");
+  len += MemTelemetry::format(msg + len, sizeof(msg) - len);
+  len += JsonArena::format(msg + len, sizeof(msg) - len);
+  len += telek.formatTls(msg + len, sizeof(msg) - len);
+  if (len < sizeof(msg)) snprintf(msg + len, sizeof(msg) - len, "```");
+  telek.sendMessage(msg);
+}
+
+void handle_trace(Telek& telek, const BotCommand& cmd) {
+#ifdef TRACE_ENABLE
+  if (Trace::previousCount() == 0) {
+    telek.sendMessage("Tidak ada trace dari sesi sebelumnya");
+    return;
+  }
+
+  // trace dipecah per pesan, decode dengan tools/trace_decode.py
+  char msg[512];
+  uint16_t next = 0;
+  while (next < Trace::previousCount()) {
+    size_t len = snprintf(msg, sizeof(msg), "*Trace* reset %lu, %u-%u\n```\n",
+                          static_cast<unsigned long>(Trace::resetReason()),
+                          next, Trace::previousCount());
+    next = Trace::hexDump(msg + len, sizeof(msg) - len - 4, next);
+    len += strlen(msg + len);
+    snprintf(msg + len, sizeof(msg) - len, "```");
+    telek.sendMessage(msg);
+  }
+#else
+  telek.sendMessage("Trace tidak aktif pada firmware ini");
+#endif
+}
+
+// /live_on mengganti cek status berulang dengan satu pesan yang dipin dan
+// diedit di tempat, /live mengirim statistik edit
+void handle_live(Telek& telek, const BotCommand& cmd) {
+  if (streq(cmd.parameter, "on")) {
+    // pesan dibuat pada liveStatusUpdate() berikutnya, tanpa balasan lain
+    for (uint8_t i = 0; i < TANK_COUNT; i++) liveTemp[i] = liveLevel[i] = NAN;
+    liveStatus.start();
+  } else if (streq(cmd.parameter, "off")) {
+    liveStatus.stop();
+    telek.sendMessage("Siap bos!");
+  } else if (cmd.parameter[0] == '\0') {
+    char msg[160];
+    size_t len = snprintf(msg, sizeof(msg), "*Live status:*\n```\n");
+    len += liveStatus.format(msg + len, sizeof(msg) - len);
+    if (len < sizeof(msg)) snprintf(msg + len, sizeof(msg) - len, "```");
+    telek.sendMessage(msg);
+  } else {
+    telek.sendMessage("Gunakan /live\\_on atau /live\\_off");
+  }
+}
+
+// log dikirim sebagai dokumen, CSV diformat per baris selama upload
+// berjalan sehingga ukuran log tidak menambah pemakaian RAM
+void handle_download(Telek& telek, const BotCommand& cmd) {
+  if (!streq(cmd.parameter, "log")) {
+    telek.sendMessage("Gunakan /unduh\\_log");
+    return;
+  }
+  if (telek.uploading()) {
+    telek.sendMessage("Upload log sebelumnya masih berjalan");
+    return;
+  }
+  if (sampleLog.end() == 0) {
+    telek.sendMessage("Log sampel masih kosong");
+    return;
+  }
+
+  time_t now = time(nullptr);
+  sampleCsv.begin(sampleLog, millis() / 1000,
+                  now >= NTP_MIN_VALID_EPOCH ? now : 0);
+  char caption[64];
+  snprintf(caption, sizeof(caption), "Log sampel %lu record",
+           static_cast<unsigned long>(sampleLog.end() - sampleLog.first()));
+  if (!telek.sendDocument("aqua_log.csv", SampleLogCsv::reader, &sampleCsv,
+                          caption))
+    telek.sendMessage("Gagal mengirim log sampel");
+}
+
+void handle_config(Telek& telek, const BotCommand& cmd) {
+  char msg[384];
+  ConfigError error = ConfigError::NONE;
+
+  if (cmd.parameter[0] == '\0') {
+    size_t len = snprintf(msg, sizeof(msg), "*Konfigurasi:*\n```\n");
+    len += Config::format(msg + len, sizeof(msg) - len);
+    if (len < sizeof(msg)) snprintf(msg + len, sizeof(msg) - len, "```");
+    telek.sendMessage(msg);
+    return;
+  }
+
+  if (streq(cmd.parameter, "reset")) {
+    error = Config::reset();
+  } else {
+    // parameter terpotong di underscore pertama, /config_suhu_min 27.5
+    // menghasilkan parameter "suhu_min" dan value "27.5"
+    AquaConfig draft = Config::get();
+    error = Config::set(draft, cmd.parameter, cmd.value);
+    if (error == ConfigError::NONE) error = Config::commit(draft);
+  }
+
+  if (error != ConfigError::NONE) {
+    snprintf(msg, sizeof(msg), "Gagal bos: %s", Config::errorName(error));
+    telek.sendMessage(msg);
+    return;
+  }
+
+  size_t len = snprintf(msg, sizeof(msg), "Siap bos!\n```\n");
+  len += Config::format(msg + len, sizeof(msg) - len);
+  if (len < sizeof(msg)) snprintf(msg + len, sizeof(msg) - len, "```");
+  telek.sendMessage(msg);
+}
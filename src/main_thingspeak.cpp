@@ -1,121 +1,147 @@
 /*
  * Smart Aquarium - ThingSpeak Integration
  *
- * Channel Configuration (1 channel dengan 4 fields):
+ * Channel Configuration (1 channel, 4 fields per tank, maksimal 2 tank):
  *   Field 1: temp (°C) - Suhu air (write)
  *   Field 2: level (%) - Ketinggian air (write)
  *   Field 3: led_state (0=OFF, 1=ON) - (read/write)
  *   Field 4: pump_state (0=OFF, 1=ON) - (read/write)
+ *   Field 5-8: sama seperti field 1-4 untuk tank 2 (lihat src/tanks.h)
  *
- * Note: Field 3 & 4 dibaca dari ThingSpeak untuk kontrol relay
+ * Note: Field led_state & pump_state dibaca dari ThingSpeak untuk kontrol
+ * relay
  */
 
 #include <Arduino.h>
 #include <DallasTemperature.h>
+#include <FastBoot.h>
+#include <Log.h>
+#include <MemTelemetry.h>
 #ifdef ESP32
 #include <WiFi.h>
 #else
 #include <ESP8266WiFi.h>
 #endif
 #include <OneWire.h>
+#include <Scheduler.h>
+#include <Shadow.h>
+#include <Stats.h>
+#include <Tanks.h>
 #include <ThingSpeak.h>
+#include <Trace.h>
 #include <Utils.h>
 
-#include "pins.h"
 #include "secret.h"
+#include "tanks.h"
 
 #define PUBLISH_INTERVAL 20000  // 20 detik (rate limit ThingSpeak)
 #define READ_INTERVAL 5000      // 5 detik untuk baca kontrol
+#define MEM_SAMPLE_INTERVAL 1000
+#define WIFI_POLL_INTERVAL 100
+// field ThingSpeak per tank: suhu, level, led, pompa
+#define FIELDS_PER_TANK 4
 
-float waterLevel = 0;
-float waterTemp = 0;
-bool ledState = false;
-bool pumpState = false;
+static_assert(TANK_COUNT * FIELDS_PER_TANK <= 8,
+              "satu channel ThingSpeak hanya punya 8 field");
+
+TankBank tanks(TANKS, TANK_COUNT);
 
 WiFiClient wifiClient;
+Scheduler scheduler;
 
 // Sensor
 OneWire onewireBus_1(ONEWIRE_BUS_PIN_1);
 DallasTemperature tempSensor(&onewireBus_1);
 
 void connectToWifi();
+void wifiPoll(void*);
 void sensorUpdate();
-void publishAllData();
-void readControlState();
+void memSample(void*);
+bool co_publishAllData(Coroutine& co, void*);
+bool co_readControlState(Coroutine& co, void*);
 
 void setup() {
   Serial.begin(115200);
   Serial.println("\n=== Smart Aquarium ThingSpeak ===");
-
-  pinMode(LED_RELAY, OUTPUT);
-  pinMode(PUMP_RELAY, OUTPUT);
-#ifdef ESP32
-  analogSetPinAttenuation(WATER_LEVEL_SIGNAL_PIN, ADC_11db);
+#ifdef TRACE_ENABLE
+  Trace::begin();
+  Trace::dumpPrevious();
 #endif
+  Log::begin();
 
-  // Initial relay state: OFF
-  digitalWrite(LED_RELAY, HIGH);
-  digitalWrite(PUMP_RELAY, HIGH);
+  // relay dipulihkan dari shadow tersimpan sampai field ThingSpeak terbaca
+  tanks.begin();
+  Shadow::begin(tanks);
 
   tempSensor.begin();
   connectToWifi();
+  // sampel pertama tidak perlu menunggu WiFi
+  sensorUpdate();
 
   ThingSpeak.begin(wifiClient);
 
-  Serial.println("ThingSpeak client initialized");
-}
+  LOG_I("ThingSpeak client initialized");
 
-void loop() {
-  static uint32_t lastPublish = 0;
-  static uint32_t lastRead = 0;
+  scheduler.scheduleFixedRate("memSample", MEM_SAMPLE_INTERVAL, memSample);
+  scheduler.scheduleFixedRate("wifi", WIFI_POLL_INTERVAL, wifiPoll);
+#ifdef ESP32
+  MemTelemetry::registerTask("loopTask", xTaskGetCurrentTaskHandle(),
+                             CONFIG_ARDUINO_LOOP_STACK_SIZE);
+  MemTelemetry::registerTask("logDrain", Log::taskHandle(), LOG_TASK_STACK);
+#else
+  MemTelemetry::registerTask("cont", nullptr, 4096);
+  scheduler.scheduleFixedRate("log", LOG_DRAIN_INTERVAL,
+                              [](void*) { Log::drain(); });
+#endif
 
   // Read control state from ThingSpeak
-  if (millis() - lastRead >= READ_INTERVAL) {
-    readControlState();
-    lastRead = millis();
-  }
-
+  scheduler.spawn("readControl", co_readControlState);
   // Publish sensor and status data
-  if (millis() - lastPublish >= PUBLISH_INTERVAL) {
-    sensorUpdate();
-    publishAllData();
-    lastPublish = millis();
-  }
-
-  delay(100);
+  scheduler.spawn("publish", co_publishAllData);
 }
 
+void loop() { scheduler.idle(scheduler.run()); }
+
+// non-blocking, koneksi diselesaikan oleh job wifiPoll
 void connectToWifi() {
-  Serial.println("Mencoba menyambungkan ke jaringan WiFi...");
-  WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
+  LOG_I("Mencoba menyambungkan ke jaringan WiFi...");
+  FastBoot::begin(WIFI_SSID, WIFI_PASSWORD);
+}
 
-  while (WiFi.status() != WL_CONNECTED) {
-    delay(500);
-    Serial.print(".");
-  }
+void wifiPoll(void*) {
+  static bool wasConnected = false;
+  bool isConnected = FastBoot::poll();
 
-  Serial.println("\nWiFi koneksi tersambung");
-  Serial.print("IP: ");
-  Serial.println(WiFi.localIP());
+  if (isConnected && !wasConnected) {
+    LOG_I("WiFi koneksi tersambung, IP: %s",
+          WiFi.localIP().toString().c_str());
+  }
+  if (isConnected != wasConnected) TRACE(WIFI, isConnected);
+  wasConnected = isConnected;
 }
 
 void sensorUpdate() {
-  tempSensor.requestTemperatures();
-  waterTemp = tempSensor.getTempCByIndex(0);
+  STATS_SCOPE(SENSOR_UPDATE);
+  tanks.sample(tempSensor);
+  FastBoot::markFirstSample();
 
-  pinMode(WATER_LEVEL_POWER_PIN, OUTPUT);
-  digitalWrite(WATER_LEVEL_POWER_PIN, HIGH);
-  delay(50);
-
-  int raw = analogRead(WATER_LEVEL_SIGNAL_PIN);
-  digitalWrite(WATER_LEVEL_POWER_PIN, LOW);
+  for (uint8_t i = 0; i < tanks.count(); i++) {
+    LOG_I("tank %u suhu air: %.2f°C, tinggi air: %.2f%%", i + 1,
+          tanks.temp(i), tanks.level(i));
+  }
+}
 
-  float percent = (raw / 260.0f) * 100.0f;
-  if (percent > 100.0f) percent = 100.0f;
-  waterLevel = percent;
+void memSample(void*) {
+  bool wasDegraded = MemTelemetry::degraded();
+  MemTelemetry::sample();
 
-  Serial.printf("suhu air: %.2f°C, tinggi air: %.2f%%\n", waterTemp,
-                waterLevel);
+  if (MemTelemetry::degraded() != wasDegraded) {
+    const MemSample& mem = MemTelemetry::current();
+    LOG_W("[Mem] degrade %s, free=%lu, blok terbesar=%lu",
+          wasDegraded ? "selesai" : "aktif",
+          static_cast<unsigned long>(mem.freeHeap),
+          static_cast<unsigned long>(mem.largestBlock));
+  }
 }
 
 inline int writeFields() {
@@ -130,73 +156,109 @@ inline String readStatus() {
   return ThingSpeak.readStatus(THINGSPEAK_CHANNEL_ID);
 }
 
-void readControlState() {
-  float ledValue = readField(3);
-  if (ledValue >= 0) {  // Valid read
-    bool newLedState = (ledValue > 0.5);
-    if (newLedState != ledState) {
-      digitalWrite(LED_RELAY, newLedState ? LOW : HIGH);
-      ledState = newLedState;
-      Serial.printf("[ThingSpeak] LED: %s\n", ledState ? "ON" : "OFF");
-    }
-  }
+inline unsigned int tankField(uint8_t tank, unsigned int field) {
+  return tank * FIELDS_PER_TANK + field;
+}
 
-  delay(500);
+// field 3 (led) dan 4 (pompa) milik tank, relay hanya ditulis jika berubah
+void readRelay(uint8_t tank, TankRelay relay, unsigned int field) {
+  float value = readField(tankField(tank, field));
+  if (value < 0) return;  // Invalid read
 
-  float pumpValue = readField(4);
-  if (pumpValue >= 0) {  // Valid read
-    bool newPumpState = (pumpValue > 0.5);
-    if (newPumpState != pumpState) {
-      digitalWrite(PUMP_RELAY, newPumpState ? LOW : HIGH);
-      pumpState = newPumpState;
-      Serial.printf("[ThingSpeak] Pompa: %s\n", pumpState ? "ON" : "OFF");
+  bool on = value > 0.5;
+  if (Shadow::set(tank, relay, on) != ShadowResult::APPLIED) return;
+  Shadow::persist();
+  LOG_I("[ThingSpeak] %s %u: %s", relay == TankRelay::LED ? "LED" : "Pompa",
+        tank + 1, on ? "ON" : "OFF");
+}
+
+bool co_readControlState(Coroutine& co, void*) {
+  static uint8_t tank;
+  CO_BEGIN(co);
+  while (true) {
+    CO_AWAIT(co, FastBoot::connected(), WIFI_POLL_INTERVAL);
+
+    for (tank = 0; tank < tanks.count(); tank++) {
+      readRelay(tank, TankRelay::LED, 3);
+      CO_SLEEP(co, 500);
+      readRelay(tank, TankRelay::PUMP, 4);
+      if (tank + 1 < tanks.count()) CO_SLEEP(co, 500);
     }
+
+    CO_SLEEP(co, READ_INTERVAL);
   }
+  CO_END(co);
 }
 
-void publishAllData() {
-  ledState = (digitalRead(LED_RELAY) == LOW);
-  pumpState = (digitalRead(PUMP_RELAY) == LOW);
-
-  // Publish all data to single channel (4 fields)
-  ThingSpeak.setField(1, waterTemp);
-  ThingSpeak.setField(2, waterLevel);
-  ThingSpeak.setField(3, ledState ? 1 : 0);
-  ThingSpeak.setField(4, pumpState ? 1 : 0);
+void setAllFields() {
+  for (uint8_t i = 0; i < tanks.count(); i++) {
+    ThingSpeak.setField(tankField(i, 1), tanks.temp(i));
+    ThingSpeak.setField(tankField(i, 2), tanks.level(i));
+    ThingSpeak.setField(tankField(i, 3),
+                        tanks.relay(i, TankRelay::LED) ? 1 : 0);
+    ThingSpeak.setField(tankField(i, 4),
+                        tanks.relay(i, TankRelay::PUMP) ? 1 : 0);
+  }
+}
 
+bool co_publishAllData(Coroutine& co, void*) {
   // Retry logic: 3 attempts with 5 second delay
-  int status = 0;
-  int attempt = 0;
+  static int attempt = 0;
+  static uint32_t cycleStart = 0;
+  // hanya dipakai sebelum CO_SLEEP, tidak perlu bertahan antar resume
+  uint32_t elapsed;
   const int maxAttempts = 3;
   const int retryDelay = 5000;
 
-  while (attempt < maxAttempts) {
-    attempt++;
-    status = writeFields();
-
-    if (status == 200) {
-      Serial.printf(
-          "[ThingSpeak] Suhu=%.2f°C, Level=%.2f%%, LED=%s, Pompa=%s\n",
-          waterTemp, waterLevel, ledState ? "ON" : "OFF",
-          pumpState ? "ON" : "OFF");
-      break;
-    } else {
-      Serial.printf("[ThingSpeak] Error: %d (attempt %d/%d)\n", status, attempt,
-                    maxAttempts);
-
-      if (attempt < maxAttempts) {
-        Serial.printf("[ThingSpeak] Retrying in %d seconds...\n",
-                      retryDelay / 1000);
-        delay(retryDelay);
-
-        // Re-set fields before retry
-        ThingSpeak.setField(1, waterTemp);
-        ThingSpeak.setField(2, waterLevel);
-        ThingSpeak.setField(3, ledState ? 1 : 0);
-        ThingSpeak.setField(4, pumpState ? 1 : 0);
-      } else {
-        Serial.println("[ThingSpeak] Max retries reached, giving up");
+  CO_BEGIN(co);
+  // publish pertama setelah PUBLISH_INTERVAL seperti sebelum scheduler
+  CO_SLEEP(co, PUBLISH_INTERVAL);
+  while (true) {
+    CO_AWAIT(co, FastBoot::connected(), WIFI_POLL_INTERVAL);
+
+    cycleStart = millis();
+    sensorUpdate();
+
+    // Publish all data to single channel (4 fields per tank)
+    setAllFields();
+
+    for (attempt = 1; attempt <= maxAttempts; attempt++) {
+      {
+        int status = writeFields();
+        if (status == 200) {
+          LOG_I("[ThingSpeak] %u tank terkirim, LED=%02x, Pompa=%02x",
+                tanks.count(), tanks.relayMask(TankRelay::LED),
+                tanks.relayMask(TankRelay::PUMP));
+          if (FastBoot::onlineMs() == 0) {
+            FastBoot::markOnline();
+            LOG_I("boot: sampel %lu ms, wifi %lu ms, online %lu ms",
+                  static_cast<unsigned long>(FastBoot::firstSampleMs()),
+                  static_cast<unsigned long>(FastBoot::connectedMs()),
+                  static_cast<unsigned long>(FastBoot::onlineMs()));
+          }
+          break;
+        }
+
+        LOG_W("[ThingSpeak] Error: %d (attempt %d/%d)", status, attempt,
+              maxAttempts);
+        if (attempt >= maxAttempts) {
+          LOG_E("[ThingSpeak] Max retries reached, giving up");
+          break;
+        }
+
+        LOG_I("[ThingSpeak] Retrying in %d seconds...", retryDelay / 1000);
       }
+
+      // job lain tetap berjalan selama menunggu retry
+      CO_SLEEP(co, retryDelay);
+
+      // Re-set fields before retry
+      setAllFields();
     }
+
+    // jaga cadence publish tetap PUBLISH_INTERVAL termasuk waktu retry
+    elapsed = millis() - cycleStart;
+    CO_SLEEP(co, elapsed < PUBLISH_INTERVAL ? PUBLISH_INTERVAL - elapsed : 0);
   }
-}
\ No newline at end of file
+  CO_END(co);
+}
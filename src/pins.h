@@ -1,5 +1,6 @@
 #pragma once
 
+// pin tank kedua dan seterusnya dipakai lewat tabel di tanks.h
 #ifdef ESP32
 // ADC1_6
 #define WATER_LEVEL_SIGNAL_PIN 34
@@ -7,6 +8,11 @@
 #define ONEWIRE_BUS_PIN_1 15
 #define LED_RELAY 22
 #define PUMP_RELAY 23
+// tank 2, ADC1_7
+#define WATER_LEVEL_SIGNAL_PIN_2 35
+#define WATER_LEVEL_POWER_PIN_2 14
+#define LED_RELAY_2 18
+#define PUMP_RELAY_2 19
 #else  // ESP8266
 #define WATER_LEVEL_SIGNAL_PIN A0
 #define WATER_LEVEL_POWER_PIN D2
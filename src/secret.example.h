@@ -4,10 +4,21 @@
 #define BOT_TOKEN "Bot token disini"
 #define TELEGRAM_USER_ID "123456789"
 
+// mode webhook main_telegram: hapus komentar agar update dikirim Telegram ke
+// perangkat lewat reverse proxy (TLS di proxy), tanpa polling getUpdates.
+// proxy meneruskan WEBHOOK_URL ke http://<ip perangkat>:WEBHOOK_PORT
+// WEBHOOK_PATH
+// #define WEBHOOK_URL "https://aqua.example.com/telegram"
+// #define WEBHOOK_PATH "/telegram"
+// #define WEBHOOK_PORT 8080
+// #define WEBHOOK_SECRET "ganti-dengan-token-acak"
+
 #define MQTT_USER "user"
 #define MQTT_PASSWORD "user123"
 #define MQTT_HOST "broker.hivemq.com"
 #define MQTT_PORT 1883
+// id topik aquarium/<id>/..., default chip ID. maks 23 karakter tanpa / + #
+// #define MQTT_DEVICE_ID "akuarium-ruang-tamu"
 
 #define THINGSPEAK_CHANNEL_ID 12345678
 #define THINGSPEAK_API_KEY "QWERTYUIOP"
\ No newline at end of file
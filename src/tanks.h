@@ -0,0 +1,21 @@
+#pragma once
+
+#include <Tanks.h>
+
+#include "pins.h"
+
+// tabel tank yang dikendalikan board ini, satu baris per tank. Semua
+// DS18B20 berbagi bus ONEWIRE_BUS_PIN_1 dan dibedakan dengan indeksnya.
+// ESP8266 hanya punya satu ADC sehingga hanya bisa satu tank
+const TankPins TANKS[] = {
+    // indeks DS18B20, sinyal level, power level, relay LED, relay pompa
+    {0, WATER_LEVEL_SIGNAL_PIN, WATER_LEVEL_POWER_PIN, LED_RELAY, PUMP_RELAY},
+#ifdef ESP32
+// {1, WATER_LEVEL_SIGNAL_PIN_2, WATER_LEVEL_POWER_PIN_2, LED_RELAY_2,
+//  PUMP_RELAY_2},
+#endif
+};
+
+constexpr uint8_t TANK_COUNT = sizeof(TANKS) / sizeof(TANKS[0]);
+static_assert(TANK_COUNT >= 1 && TANK_COUNT <= TANK_MAX,
+              "jumlah tank harus 1 sampai TANK_MAX");
@@ -0,0 +1,411 @@
+#pragma once
+
+/**
+ * Transport untuk Firmware<> di compose.h, satu struct per sink fan-out:
+ *   - TelegramAlerts          peringatan alarm analitik, tanpa perintah masuk
+ *   - MqttTelemetry<Commands> data sensor dan telemetry, perintah kontrol
+ *                             relay dan shadow jika Commands = RelayControl
+ *   - ThingSpeakUpload        upload field per tank
+ *   - LanDashboard            dashboard web di LAN lewat WebSocket, tanpa
+ *                             broker (dashboard.h)
+ *
+ * Sink Telegram dan ThingSpeak memakai HTTP blocking sehingga berjalan di
+ * task sendiri; sink MQTT dan dashboard non-blocking dan berjalan sebagai
+ * job scheduler di loop().
+ */
+#include <AquaProto.h>
+#include <ArduinoJson.h>
+#include <AsyncMqttClient.h>
+#include <DeviceTopics.h>
+#include <JsonArena.h>
+#include <Telek.h>
+#include <ThingSpeak.h>
+#include <Ticker.h>
+
+#include "compose.h"
+
+#define MQTT_SINK_INTERVAL 10000
+#define THINGSPEAK_SINK_INTERVAL 20000  // rate limit ThingSpeak 15 detik
+#define ALERT_REMIND_INTERVAL (30UL * 60 * 1000)
+#define NTP_MIN_VALID_EPOCH 1735689600  // 2025-01-01, jam dianggap tersinkron
+#define NTP_SYNC_TIMEOUT 5000
+#define FIELDS_PER_TANK 4
+
+#define TELEGRAM_SINK_STACK 8192
+#define THINGSPEAK_SINK_STACK 6144
+
+struct TelegramAlerts {
+  static constexpr bool ALERTS = true;
+
+  static Sink& sink() {
+    static Sink sink("telegram", deliver, Config::DEFAULTS.sensorReportMs);
+    return sink;
+  }
+
+  static void begin() {
+    bot().setChatId(TELEGRAM_USER_ID);
+    Fanout::addSink(sink());
+  }
+
+  static void start(Scheduler&) {
+    TaskHandle_t handle = NULL;
+    xTaskCreatePinnedToCore(task, "telegramSink", TELEGRAM_SINK_STACK, NULL, 1,
+                            &handle, 1);
+    MemTelemetry::registerTask("telegramSink", handle, TELEGRAM_SINK_STACK);
+  }
+
+  static void connected(bool) {}
+
+  static void applyConfig(const AquaConfig& config) {
+    sink().setCadence(config.sensorReportMs);
+  }
+
+  static void telemetry() {}
+
+ private:
+  static Telek& bot() {
+    static Telek client(BOT_TOKEN);
+    return client;
+  }
+
+  static volatile bool& online() {
+    static volatile bool online = false;
+    return online;
+  }
+
+  static void task(void*) {
+    // snapshot yang masuk sebelum bot siap dibuang oleh antrean sink
+    while (!FastBoot::connected())
+      vTaskDelay(WIFI_POLL_INTERVAL / portTICK_PERIOD_MS);
+
+    // jam dibutuhkan untuk cek masa berlaku sertifikat server telegram
+    configTime(0, 0, "pool.ntp.org", "time.nist.gov");
+    uint32_t syncStart = millis();
+    while (time(nullptr) < NTP_MIN_VALID_EPOCH &&
+           millis() - syncStart < NTP_SYNC_TIMEOUT)
+      vTaskDelay(250 / portTICK_PERIOD_MS);
+
+    auto botInfo = bot().getBotInfo();
+    LOG_I("Bot telegram sudah berjalan dengan nama: %s", botInfo.username);
+    FastBoot::markOnline();
+    bot().sendMessage("Aqua Ready!!");
+    online() = true;
+
+    Device::runSink(sink());
+  }
+
+  static bool deliver(const Snapshot& snapshot, void*) {
+    // hanya dipakai oleh task sink telegram
+    static AlertState tempAlert[TANK_COUNT] = {};
+    static AlertState levelAlert[TANK_COUNT] = {};
+    if (!online() || MemTelemetry::degraded()) return false;
+
+    char name[24];
+    char msg[256];
+    for (uint8_t i = 0; i < snapshot.count; i++) {
+      Tanks::label(name, sizeof(name), "Suhu air", i, snapshot.count);
+      if (Analytics::alertMessage(msg, sizeof(msg), name, "°C",
+                                  Device::tempChannel(i),
+                                  snapshot.tempAlarms[i], tempAlert[i],
+                                  snapshot.timestamp, ALERT_REMIND_INTERVAL))
+        bot().sendMessage(msg);
+
+      Tanks::label(name, sizeof(name), "Tinggi air", i, snapshot.count);
+      if (Analytics::alertMessage(msg, sizeof(msg), name, "%",
+                                  Device::levelChannel(i),
+                                  snapshot.levelAlarms[i], levelAlert[i],
+                                  snapshot.timestamp, ALERT_REMIND_INTERVAL))
+        bot().sendMessage(msg);
+    }
+    return true;
+  }
+};
+
+template <class Commands>
+struct MqttTelemetry {
+  static constexpr bool ALERTS = false;
+
+  static Sink& sink() {
+    static Sink sink("mqtt", deliver, MQTT_SINK_INTERVAL);
+    return sink;
+  }
+
+  static void begin() {
+#ifdef MQTT_DEVICE_ID
+    DeviceTopics::begin(TANK_COUNT, Commands::ENABLED, MQTT_DEVICE_ID);
+#else
+    DeviceTopics::begin(TANK_COUNT, Commands::ENABLED);
+#endif
+
+    AsyncMqttClient& mqtt = client();
+    mqtt.onConnect(onConnect);
+    mqtt.onDisconnect(onDisconnect);
+    if constexpr (Commands::ENABLED) mqtt.onMessage(onMessage);
+    mqtt.setServer(MQTT_HOST, MQTT_PORT);
+    mqtt.setCredentials(MQTT_USER, MQTT_PASSWORD);
+    mqtt.setClientId(DeviceTopics::id());
+    mqtt.setWill(DeviceTopics::get(AquaTopic::META), 1, true,
+                 DeviceTopics::will());
+    Fanout::addSink(sink());
+  }
+
+  static void start(Scheduler& scheduler) {
+    scheduler.scheduleFixedDelay("mqttSink", SINK_POLL_INTERVAL, [](void*) {
+      while (sink().runOnce()) {
+      }
+      if constexpr (Commands::ENABLED) syncShadow();
+    });
+  }
+
+  static void connected(bool up) {
+    if (up)
+      connect();
+    else
+      reconnectTimer().detach();
+  }
+
+  static void applyConfig(const AquaConfig&) {}
+
+  static void telemetry() {
+    AsyncMqttClient& mqtt = client();
+    if (!mqtt.connected()) return;
+
+    char buffer[768];
+    size_t len = Fanout::toJson(buffer, sizeof(buffer));
+    mqtt.publish(DeviceTopics::get(AquaTopic::FANOUT), 0, false, buffer, len);
+#ifdef STATS_ENABLE
+    len = Stats::toJson(buffer, sizeof(buffer));
+    mqtt.publish(DeviceTopics::get(AquaTopic::STATS), 0, false, buffer, len);
+#endif
+    len = MemTelemetry::toJson(buffer, sizeof(buffer));
+    mqtt.publish(DeviceTopics::get(AquaTopic::MEM), 0, false, buffer, len);
+  }
+
+ private:
+  static AsyncMqttClient& client() {
+    static AsyncMqttClient client;
+    return client;
+  }
+
+  static Ticker& reconnectTimer() {
+    static Ticker timer;
+    return timer;
+  }
+
+  static void connect() { client().connect(); }
+
+  // versi shadow yang terakhir dipublikasikan sebagai desired
+  static uint32_t& publishedVersion() {
+    static uint32_t version = 0;
+    return version;
+  }
+
+  // relay bisa berubah dari perintah MQTT, dashboard LAN atau saat offline;
+  // semuanya dipublikasikan dari job ini setelah versi berubah
+  static void syncShadow() {
+    if (!client().connected()) return;
+    ShadowState desired = Shadow::desired();
+    if (desired.version == publishedVersion()) return;
+
+    publishShadow(AquaTopic::SHADOW_DESIRED, desired);
+    publishShadow(AquaTopic::SHADOW_REPORTED, Shadow::reported());
+    publishedVersion() = desired.version;
+  }
+
+  static void publishShadow(AquaTopic leaf, const ShadowState& state) {
+    char buffer[64 + 32 * TANK_COUNT];
+    size_t len = AquaProto::encodeShadow(buffer, sizeof(buffer),
+                                         state.version, state.led, state.pump,
+                                         TANK_COUNT);
+    client().publish(DeviceTopics::get(leaf), 1, true, buffer, len);
+  }
+
+  static bool deliver(const Snapshot& snapshot, void*) {
+    if (!client().connected()) return false;
+
+    char buffer[64 + 32 * TANK_COUNT];
+    size_t len =
+        AquaProto::encodeSensor(buffer, sizeof(buffer), snapshot.temp,
+                                snapshot.level, snapshot.count,
+                                snapshot.timestamp);
+
+    STATS_SCOPE(MQTT_PUBLISH);
+    if (client().publish(DeviceTopics::get(AquaTopic::SENSOR), 0, false,
+                         buffer, len))
+      return true;
+    STATS_COUNT(MQTT_PUBLISH_FAIL);
+    return false;
+  }
+
+  static void onConnect(bool sessionPresent) {
+    LOG_I("MQTT koneksi tersambung");
+    TRACE(MQTT_CONNECT, sessionPresent);
+
+    char buffer[128];
+    size_t len = DeviceTopics::birth(buffer, sizeof(buffer),
+                                     WiFi.localIP().toString().c_str());
+    client().publish(DeviceTopics::get(AquaTopic::META), 1, true, buffer,
+                     len);
+
+    // konfigurasi lewat MQTT hanya ada di main_mqtt.cpp. Desired retained
+    // dikirim broker setelah subscribe, reported lebih dulu
+    if constexpr (Commands::ENABLED) {
+      for (uint8_t i = 0; i < DeviceTopics::subscriptionCount(); i++) {
+        const TopicSubscription& sub = DeviceTopics::subscription(i);
+        if (sub.leaf == AquaTopic::COMMAND ||
+            sub.leaf == AquaTopic::SHADOW_DESIRED)
+          client().subscribe(sub.filter, sub.qos);
+      }
+      publishShadow(AquaTopic::SHADOW_REPORTED, Shadow::reported());
+      publishControlStatus(nullptr);
+    }
+  }
+
+  static void onDisconnect(AsyncMqttClientDisconnectReason reason) {
+    LOG_W("MQTT koneksi terputus");
+    TRACE(MQTT_DISCONNECT, static_cast<uint8_t>(reason));
+
+    if (FastBoot::connected()) reconnectTimer().once(2, connect);
+  }
+
+  // hanya di-instansiasi jika Commands::ENABLED, parser JSON tidak ikut
+  // di-link pada varian tanpa perintah
+  static void onMessage(char* topic, char* payload,
+                        AsyncMqttClientMessageProperties properties,
+                        size_t len, size_t index, size_t total) {
+    static StaticJsonArena<1024> arena("mqtt");
+    CommandTiming timing;
+    timing.receivedUs = micros();
+
+    AquaTopic leaf;
+    if (!DeviceTopics::route(topic, leaf) ||
+        (leaf != AquaTopic::COMMAND && leaf != AquaTopic::SHADOW_DESIRED)) {
+      LOG_W("topik tidak dikenal: %s", topic);
+      return;
+    }
+    // desired retained yang dihapus
+    if (len == 0) return;
+
+    char message[len + 1];
+    memcpy(message, payload, len);
+    message[len] = '\0';
+    JsonArenaScope arenaScope(arena);
+    JsonDocument doc(&arena);
+    DeserializationError error = deserializeJson(doc, message);
+    if (error) {
+      LOG_E("JSON parse error: %s", error.c_str());
+      return;
+    }
+    if (leaf == AquaTopic::SHADOW_DESIRED) {
+      onShadow(doc);
+      return;
+    }
+
+    AquaCommand cmd;
+    bool valid = AquaProto::parseCommand(doc, cmd);
+    timing.id = cmd.id;
+    timing.parsedUs = micros();
+    if (cmd.type != AquaCommandType::CONTROL) return;
+    if (!valid || cmd.device == AquaDevice::UNKNOWN ||
+        cmd.tank >= TANK_COUNT) {
+      LOG_W("Perintah kontrol tidak valid");
+      return;
+    }
+
+    ShadowResult result = Shadow::set(
+        cmd.tank,
+        cmd.device == AquaDevice::LED ? TankRelay::LED : TankRelay::PUMP,
+        cmd.on, cmd.version);
+    timing.actuatedUs = micros();
+    LOG_I("%s %u: %s (%s)", AquaProto::deviceName(cmd.device), cmd.tank + 1,
+          cmd.on ? "ON" : "OFF", Shadow::resultName(result));
+    publishControlStatus(&timing);
+  }
+
+  // desired hanya diterapkan jika lebih baru. Desired lama di broker berarti
+  // relay diubah saat offline, syncShadow() menimpanya dengan milik perangkat
+  static void onShadow(const JsonDocument& doc) {
+    ShadowState desired = Shadow::desired();
+    if (!AquaProto::parseShadow(doc, desired.version, desired.led,
+                                desired.pump, TANK_COUNT)) {
+      LOG_W("shadow desired tidak valid");
+      return;
+    }
+
+    ShadowResult result = Shadow::apply(desired);
+    LOG_I("shadow desired v%lu: %s",
+          static_cast<unsigned long>(desired.version),
+          Shadow::resultName(result));
+    if (result == ShadowResult::APPLIED) {
+      // desired di broker sudah sama, cukup reported
+      publishedVersion() = desired.version;
+      publishShadow(AquaTopic::SHADOW_REPORTED, Shadow::reported());
+      publishControlStatus(nullptr);
+    } else if (result == ShadowResult::STALE) {
+      publishedVersion() = 0;
+    }
+  }
+
+  static void publishControlStatus(const CommandTiming* timing) {
+    TankBank& tanks = Device::tanks();
+    char buffer[128 + 32 * TANK_COUNT];
+    size_t len = AquaProto::encodeControlStatus(
+        buffer, sizeof(buffer), tanks.relayMask(TankRelay::LED),
+        tanks.relayMask(TankRelay::PUMP), TANK_COUNT, timing, micros());
+
+    STATS_SCOPE(MQTT_PUBLISH);
+    if (!client().publish(DeviceTopics::get(AquaTopic::CONTROL), 0, true,
+                          buffer, len))
+      STATS_COUNT(MQTT_PUBLISH_FAIL);
+  }
+};
+
+struct ThingSpeakUpload {
+  static constexpr bool ALERTS = false;
+  static_assert(TANK_COUNT * FIELDS_PER_TANK <= 8,
+                "satu channel ThingSpeak hanya punya 8 field");
+
+  static Sink& sink() {
+    static Sink sink("thingspeak", deliver, THINGSPEAK_SINK_INTERVAL);
+    return sink;
+  }
+
+  static void begin() {
+    static WiFiClient client;
+    ThingSpeak.begin(client);
+    Fanout::addSink(sink());
+  }
+
+  static void start(Scheduler&) {
+    TaskHandle_t handle = NULL;
+    xTaskCreatePinnedToCore(task, "thingSpeakSink", THINGSPEAK_SINK_STACK,
+                            NULL, 1, &handle, 1);
+    MemTelemetry::registerTask("thingSpeakSink", handle,
+                               THINGSPEAK_SINK_STACK);
+  }
+
+  static void connected(bool) {}
+  static void applyConfig(const AquaConfig&) {}
+  static void telemetry() {}
+
+ private:
+  static void task(void*) { Device::runSink(sink()); }
+
+  static bool deliver(const Snapshot& snapshot, void*) {
+    if (!FastBoot::connected()) return false;
+
+    for (uint8_t i = 0; i < snapshot.count; i++) {
+      unsigned int field = i * FIELDS_PER_TANK;
+      ThingSpeak.setField(field + 1, snapshot.temp[i]);
+      ThingSpeak.setField(field + 2, snapshot.level[i]);
+      ThingSpeak.setField(field + 3, snapshot.led & (1 << i) ? 1 : 0);
+      ThingSpeak.setField(field + 4, snapshot.pump & (1 << i) ? 1 : 0);
+    }
+
+    int status =
+        ThingSpeak.writeFields(THINGSPEAK_CHANNEL_ID, THINGSPEAK_API_KEY);
+    if (status == 200) return true;
+    LOG_W("[ThingSpeak] Error: %d", status);
+    return false;
+  }
+};
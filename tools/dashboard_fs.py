@@ -0,0 +1,51 @@
+#!/usr/bin/env python3
+"""
+Kemas aset web/mqtt/public menjadi file .gz di data/ untuk LittleFS.
+
+LanDashboard melayani file.gz dengan Content-Encoding: gzip, sehingga
+flash dan transfer ke browser cukup versi terkompresi. Dipanggil otomatis
+sebagai pre-script env combined, atau manual sebelum uploadfs:
+
+    python3 tools/dashboard_fs.py
+    pio run -e combined -t uploadfs
+"""
+
+import gzip
+import os
+import shutil
+
+SOURCE = os.path.join("web", "mqtt", "public")
+TARGET = "data"
+
+
+def pack(root):
+    source = os.path.join(root, SOURCE)
+    target = os.path.join(root, TARGET)
+    if os.path.isdir(target):
+        shutil.rmtree(target)
+    os.makedirs(target)
+
+    total = 0
+    for name in sorted(os.listdir(source)):
+        path = os.path.join(source, name)
+        if not os.path.isfile(path):
+            continue
+        with open(path, "rb") as src:
+            data = src.read()
+        # mtime=0 agar isi file stabil dan uploadfs tidak berubah tanpa alasan
+        with open(os.path.join(target, name + ".gz"), "wb") as dst:
+            with gzip.GzipFile(filename=name, mode="wb", fileobj=dst,
+                               mtime=0, compresslevel=9) as gz:
+                gz.write(data)
+        size = os.path.getsize(os.path.join(target, name + ".gz"))
+        print("dashboard: %s %d -> %d B" % (name, len(data), size))
+        total += size
+    return total
+
+
+if __name__ == "__main__":
+    pack(".")
+else:
+    # pre-script PlatformIO
+    Import("env")  # noqa: F821
+    pack(env["PROJECT_DIR"])  # noqa: F821
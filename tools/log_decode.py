@@ -0,0 +1,151 @@
+#!/usr/bin/env python3
+"""
+Decoder log binary firmware (build dengan -DLOG_BINARY).
+
+Setiap frame berisi alamat format string, bukan teksnya. Alamat tersebut
+dicari di section file ELF firmware lalu diformat di host.
+
+    python3 tools/log_decode.py .pio/build/mqtt/firmware.elf capture.bin
+    pio device monitor --raw | python3 tools/log_decode.py firmware.elf -
+"""
+
+import re
+import struct
+import sys
+
+# harus sama dengan lib/Log/Log.h
+LOG_MAX_ARGS = 4
+LOG_STR_SIZE = 48
+MAGIC = b"\xa5\x5a"
+FRAME_SIZE = 2 + 12 + 4 * LOG_MAX_ARGS + LOG_STR_SIZE
+
+LEVELS = "-EWID"
+ARG_INT, ARG_UINT, ARG_FLOAT, ARG_STR = range(4)
+
+SPEC = re.compile(r"%(?:(%)|([-+ #0-9.]*)[hlLqjzt]*([a-zA-Z]))")
+
+
+class Elf:
+    """Membaca isi section yang dimuat (ELF32/ELF64 little-endian)."""
+
+    def __init__(self, path):
+        with open(path, "rb") as f:
+            self.data = f.read()
+        if self.data[:4] != b"\x7fELF":
+            raise ValueError("bukan file ELF: %s" % path)
+
+        is64 = self.data[4] == 2
+        if is64:
+            shoff, = struct.unpack_from("<Q", self.data, 0x28)
+            shentsize, shnum = struct.unpack_from("<HH", self.data, 0x3A)
+            entry = "<IIQQQQIIQQ"
+        else:
+            shoff, = struct.unpack_from("<I", self.data, 0x20)
+            shentsize, shnum = struct.unpack_from("<HH", self.data, 0x2E)
+            entry = "<IIIIIIIIII"
+
+        SHT_NOBITS = 8
+        self.sections = []
+        for i in range(shnum):
+            fields = struct.unpack_from(entry, self.data, shoff + i * shentsize)
+            sh_type, addr, offset, size = fields[1], *fields[3:6]
+            if addr and size and sh_type != SHT_NOBITS:
+                self.sections.append((addr, offset, size))
+
+    def string_at(self, addr):
+        for base, offset, size in self.sections:
+            if base <= addr < base + size:
+                start = offset + addr - base
+                end = self.data.index(b"\0", start, offset + size)
+                return self.data[start:end].decode("utf-8", "replace")
+        return None
+
+
+def format_message(fmt, types, args, strings):
+    index = [0]
+
+    def convert(match):
+        percent, flags, conv = match.groups()
+        if percent:
+            return "%"
+        i = index[0]
+        index[0] += 1
+        if i >= len(args):
+            return "?"
+
+        kind = (types >> (i * 2)) & 0x3
+        value = args[i]
+        if kind == ARG_FLOAT:
+            value, = struct.unpack("<f", struct.pack("<I", value))
+            conv = conv if conv in "eEfFgG" else "f"
+        elif kind == ARG_STR:
+            end = strings.find(b"\0", value)
+            value = strings[value:end if end >= 0 else None].decode(
+                "utf-8", "replace")
+            conv = "s"
+        elif conv == "p":
+            return "0x%08x" % value
+        elif conv == "c":
+            value = chr(value & 0xFF)
+        else:
+            if kind == ARG_INT and value & 0x80000000:
+                value -= 1 << 32
+            conv = conv if conv in "dixXuo" else "d"
+            conv = "d" if conv in "iu" else conv
+        return ("%" + flags + conv) % value
+
+    return SPEC.sub(convert, fmt)
+
+
+def decode(elf, stream, out):
+    buf = b""
+    while True:
+        chunk = stream.read(256)
+        if not chunk:
+            break
+        buf += chunk
+
+        while True:
+            start = buf.find(MAGIC)
+            if start < 0:
+                buf = buf[-1:]
+                break
+            if len(buf) - start < FRAME_SIZE:
+                buf = buf[start:]
+                break
+
+            frame = buf[start:start + FRAME_SIZE]
+            fmt_addr, timestamp, level, argc, types, _ = struct.unpack_from(
+                "<IIBBBB", frame, 2)
+            args = struct.unpack_from("<%dI" % LOG_MAX_ARGS, frame, 14)[:argc]
+            strings = frame[14 + 4 * LOG_MAX_ARGS:]
+
+            fmt = elf.string_at(fmt_addr)
+            if fmt is None or argc > LOG_MAX_ARGS:
+                # bukan frame yang valid, cari magic berikutnya
+                buf = buf[start + 1:]
+                continue
+
+            level_char = LEVELS[level] if level < len(LEVELS) else "-"
+            out.write("[%7d] %s > %s\n" % (
+                timestamp, level_char,
+                format_message(fmt, types, args, strings)))
+            buf = buf[start + FRAME_SIZE:]
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.stderr.write(__doc__)
+        return 1
+
+    elf = Elf(sys.argv[1])
+    if sys.argv[2] == "-":
+        decode(elf, sys.stdin.buffer, sys.stdout)
+    else:
+        with open(sys.argv[2], "rb") as stream:
+            decode(elf, stream, sys.stdout)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,84 @@
+#!/usr/bin/env python3
+"""
+Laporan ukuran flash dan RAM per env PlatformIO.
+
+Membangun setiap env lalu membaca baris "RAM:" dan "Flash:" dari output
+`pio run`. Dengan --baseline, env yang sama dibangun dari git ref lain di
+worktree sementara dan selisihnya ikut dicetak (env yang belum ada di
+baseline ditandai "-").
+
+    python3 tools/size_report.py
+    python3 tools/size_report.py --baseline HEAD~1 combined combined_lite
+"""
+
+import argparse
+import os
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+
+ENVS = ["telegram", "mqtt", "thingspeak", "combined", "combined_lite"]
+
+# RAM:   [==        ]  15.2% (used 49836 bytes from 327680 bytes)
+USAGE = re.compile(r"^(RAM|Flash):.*\(used (\d+) bytes from (\d+) bytes\)",
+                   re.MULTILINE)
+
+
+def build(root, env):
+    result = subprocess.run(["pio", "run", "-e", env], cwd=root,
+                            stdout=subprocess.PIPE, stderr=subprocess.STDOUT,
+                            universal_newlines=True)
+    if result.returncode != 0:
+        sys.stderr.write("gagal build %s di %s\n" % (env, root))
+        return None
+    usage = {kind: int(used) for kind, used, _ in USAGE.findall(result.stdout)}
+    return usage if "RAM" in usage and "Flash" in usage else None
+
+
+def build_baseline(ref, envs):
+    path = tempfile.mkdtemp(prefix="aqua-size-")
+    subprocess.check_call(["git", "worktree", "add", "--detach", path, ref],
+                          stdout=subprocess.DEVNULL)
+    try:
+        # secret.h tidak masuk git
+        secret = os.path.join("src", "secret.h")
+        if os.path.exists(secret):
+            shutil.copy(secret, os.path.join(path, secret))
+        return {env: build(path, env) for env in envs}
+    finally:
+        subprocess.call(["git", "worktree", "remove", "--force", path])
+
+
+def column(value, base):
+    if value is None:
+        return "%10s %8s" % ("-", "")
+    if base is None:
+        return "%10d %8s" % (value, "")
+    return "%10d %+8d" % (value, value - base)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.strip().split("\n")[0])
+    parser.add_argument("envs", nargs="*", default=ENVS)
+    parser.add_argument("--baseline", metavar="REF",
+                        help="git ref pembanding, misalnya HEAD~1")
+    args = parser.parse_args()
+
+    current = {env: build(".", env) for env in args.envs}
+    baseline = build_baseline(args.baseline, args.envs) if args.baseline \
+        else {}
+
+    print("%-16s %19s %19s" % ("env", "flash (B)", "ram (B)"))
+    for env in args.envs:
+        now = current[env] or {}
+        base = baseline.get(env) or {}
+        print("%-16s %s %s" % (env,
+                                column(now.get("Flash"), base.get("Flash")),
+                                column(now.get("RAM"), base.get("RAM"))))
+    return 0 if all(current.values()) else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,93 @@
+#!/usr/bin/env python3
+"""
+Decoder trace RTC firmware (lib/Trace).
+
+Membaca token hex 16 karakter dari teks apa pun: output serial saat boot,
+payload MQTT aquarium/<id>/trace atau pesan /trace dari Telegram.
+
+    python3 tools/trace_decode.py dump.txt
+    mosquitto_sub -t 'aquarium/+/trace' | python3 tools/trace_decode.py -
+"""
+
+import re
+import sys
+
+# urutan harus sama dengan enum TraceEvent di lib/Trace/Trace.h
+EVENTS = [
+    "none", "boot", "task+", "task-", "http", "http_done", "mqtt_up",
+    "mqtt_dn", "wifi", "relay", "heap_low", "degrade", "mark",
+]
+
+HTTP_PHASES = ["idle", "connect", "send", "recv_headers", "recv_body"]
+HTTP_ERRORS = [
+    "ok", "connect_failed", "timeout_connect", "timeout_send",
+    "timeout_headers", "timeout_body", "connection_closed", "bad_response",
+]
+RELAYS = ["led", "pompa"]
+
+TOKEN = re.compile(r"\b([0-9a-f]{8})([0-9a-f]{8})\b")
+
+
+def describe(event, arg, data):
+    if event == "http":
+        if arg == 0xFF:
+            return "HTTPClient blocking"
+        return HTTP_PHASES[arg] if arg < len(HTTP_PHASES) else str(arg)
+    if event == "http_done":
+        error = HTTP_ERRORS[arg] if arg < len(HTTP_ERRORS) else str(arg)
+        return "%s status %d" % (error, data)
+    if event == "relay":
+        relay = RELAYS[arg] if arg < len(RELAYS) else str(arg)
+        return "%s tank %d %s" % (relay, (data >> 8) + 1,
+                                  "nyala" if data & 1 else "mati")
+    if event == "heap_low":
+        return "free %d B, fragmentasi %d%%" % (data * 16, arg)
+    if event == "degrade":
+        return "%s, blok terbesar %d B" % ("masuk" if arg else "keluar",
+                                           data * 16)
+    if event == "task+":
+        return "id %d" % arg
+    if event == "task-":
+        return "id %d, %d ms" % (arg, data)
+    if event in ("boot", "mqtt_dn"):
+        return "alasan %d" % arg
+    return "arg %d data %d" % (arg, data)
+
+
+def decode(lines, out):
+    start = None
+    prev = None
+    for line in lines:
+        for time_hex, info_hex in TOKEN.findall(line):
+            time = int(time_hex, 16)
+            info = int(info_hex, 16)
+            code, arg, data = info >> 24, (info >> 16) & 0xFF, info & 0xFFFF
+            event = EVENTS[code] if code < len(EVENTS) else "?%d" % code
+
+            if start is None:
+                start = prev = time
+            # micros() 32 bit berputar setiap ~71 menit
+            delta = (time - prev) & 0xFFFFFFFF
+            prev = time
+            start_delta = (time - start) & 0xFFFFFFFF
+
+            out.write("+%12.3f ms (%+10.3f) %-9s %s\n" % (
+                start_delta / 1000.0, delta / 1000.0, event,
+                describe(event, arg, data)))
+
+
+def main():
+    if len(sys.argv) != 2:
+        sys.stderr.write(__doc__)
+        return 1
+
+    if sys.argv[1] == "-":
+        decode(sys.stdin, sys.stdout)
+    else:
+        with open(sys.argv[1]) as f:
+            decode(f, sys.stdout)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
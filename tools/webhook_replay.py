@@ -0,0 +1,72 @@
+#!/usr/bin/env python3
+"""
+Kirim ulang update Telegram yang direkam ke endpoint webhook perangkat.
+
+Input berupa satu objek Update JSON per baris, atau response getUpdates
+utuh ({"ok":true,"result":[...]}). Balasan inline dari perangkat
+({"method":"sendMessage",...}) dicetak apa adanya.
+
+    python3 tools/webhook_replay.py http://192.168.1.20:8080/telegram \\
+        updates.jsonl --secret ganti-dengan-token-acak
+    echo '{"update_id":1,"message":{"from":{"id":123456789},
+        "text":"/status_sensor"}}' | python3 tools/webhook_replay.py URL -
+"""
+
+import argparse
+import json
+import sys
+import time
+import urllib.error
+import urllib.request
+
+SECRET_HEADER = "X-Telegram-Bot-Api-Secret-Token"
+
+
+def updates(stream):
+    text = stream.read().strip()
+    try:
+        data = json.loads(text)
+    except ValueError:
+        return [json.loads(line) for line in text.splitlines() if line.strip()]
+    if isinstance(data, dict) and "result" in data:
+        return data["result"]
+    return data if isinstance(data, list) else [data]
+
+
+def post(url, update, secret):
+    body = json.dumps(update, separators=(",", ":")).encode()
+    request = urllib.request.Request(url, data=body, method="POST")
+    request.add_header("Content-Type", "application/json")
+    if secret:
+        request.add_header(SECRET_HEADER, secret)
+    start = time.time()
+    try:
+        with urllib.request.urlopen(request, timeout=10) as response:
+            status, reply = response.status, response.read().decode()
+    except urllib.error.HTTPError as err:
+        status, reply = err.code, ""
+    return status, reply, (time.time() - start) * 1000
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.strip().split("\n")[0])
+    parser.add_argument("url")
+    parser.add_argument("file", help="file update, - untuk stdin")
+    parser.add_argument("--secret", help="secret_token yang dipakai setWebhook")
+    parser.add_argument("--interval", type=float, default=0.5,
+                        help="jeda antar update dalam detik")
+    args = parser.parse_args()
+
+    stream = sys.stdin if args.file == "-" else open(args.file)
+    failed = 0
+    for update in updates(stream):
+        status, reply, ms = post(args.url, update, args.secret)
+        print("update %s: %d (%.0f ms) %s" % (update.get("update_id"), status,
+                                              ms, reply))
+        failed += status != 200
+        time.sleep(args.interval)
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
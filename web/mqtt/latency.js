@@ -0,0 +1,118 @@
+// Per-hop latency of control commands: browser -> bridge -> broker -> device
+// -> relay -> status -> bridge. Shared by server.js and replay.js.
+
+import { performance } from 'perf_hooks';
+
+export const HOPS = [
+  'bridge',         // ws received -> published to aquarium/<id>/command
+  'device_parse',   // device received -> JSON parsed
+  'device_act',     // device received -> relay digitalWrite
+  'device_pub',     // device received -> status published
+  'network',        // MQTT round trip minus time spent on the device
+  'total',          // ws received -> status forwarded to the browser
+];
+
+const WINDOW = 512;
+const PENDING_TIMEOUT_MS = 30000;
+
+export function now() {
+  return performance.now();
+}
+
+export function percentile(sorted, pct) {
+  if (sorted.length === 0) return null;
+  const index = Math.min(sorted.length - 1,
+                         Math.ceil((pct / 100) * sorted.length) - 1);
+  return sorted[Math.max(0, index)];
+}
+
+export class LatencyTracker {
+  constructor(window = WINDOW) {
+    this.window = window;
+    this.samples = Object.fromEntries(HOPS.map((hop) => [hop, []]));
+    this.pending = new Map();
+    // random start so a retained status from a previous run never matches
+    this.nextId = 1 + Math.floor(Math.random() * 0x7fffffff);
+    this.timeouts = 0;
+  }
+
+  // 32-bit correlation ID, 0 means "no id" on the device
+  begin(receivedAt = now()) {
+    const id = this.nextId;
+    this.nextId = this.nextId >= 0xffffffff ? 1 : this.nextId + 1;
+    this.pending.set(id, { receivedAt, publishedAt: null });
+    this.expire();
+    return id;
+  }
+
+  published(id, publishedAt = now()) {
+    const entry = this.pending.get(id);
+    if (entry) entry.publishedAt = publishedAt;
+  }
+
+  // Device status carrying id and lat (us), returns the hops in ms
+  complete(status, completedAt = now()) {
+    const entry = this.pending.get(status.id);
+    if (!entry || entry.publishedAt === null) return null;
+    this.pending.delete(status.id);
+
+    const lat = status.lat || {};
+    const deviceMs = (lat.pub || 0) / 1000;
+    const hops = {
+      bridge: entry.publishedAt - entry.receivedAt,
+      device_parse: (lat.parse || 0) / 1000,
+      device_act: (lat.act || 0) / 1000,
+      device_pub: deviceMs,
+      network: Math.max(0, completedAt - entry.publishedAt - deviceMs),
+      total: completedAt - entry.receivedAt,
+    };
+    for (const hop of HOPS) this.record(hop, hops[hop]);
+    return hops;
+  }
+
+  record(hop, ms) {
+    const list = this.samples[hop];
+    list.push(ms);
+    if (list.length > this.window) list.shift();
+  }
+
+  expire() {
+    const limit = now() - PENDING_TIMEOUT_MS;
+    for (const [id, entry] of this.pending) {
+      if (entry.receivedAt >= limit) break;
+      this.pending.delete(id);
+      this.timeouts++;
+    }
+  }
+
+  summary() {
+    const hops = {};
+    for (const hop of HOPS) {
+      const sorted = [...this.samples[hop]].sort((a, b) => a - b);
+      hops[hop] = {
+        n: sorted.length,
+        p50: percentile(sorted, 50),
+        p90: percentile(sorted, 90),
+        p99: percentile(sorted, 99),
+        max: sorted.length ? sorted[sorted.length - 1] : null,
+      };
+    }
+    return { hops, pending: this.pending.size, timeouts: this.timeouts };
+  }
+
+  format() {
+    const fmt = (v) => (v === null ? '-' : v.toFixed(1)).padStart(8);
+    const lines = [
+      `${'hop(ms)'.padEnd(13)}${'n'.padStart(6)}${'p50'.padStart(8)}` +
+        `${'p90'.padStart(8)}${'p99'.padStart(8)}${'max'.padStart(8)}`,
+    ];
+    const { hops, pending, timeouts } = this.summary();
+    for (const hop of HOPS) {
+      const h = hops[hop];
+      lines.push(`${hop.padEnd(13)}${String(h.n).padStart(6)}${fmt(h.p50)}` +
+                 `${fmt(h.p90)}${fmt(h.p99)}${fmt(h.max)}`);
+    }
+    lines.push(`pending ${pending}, timeout ${timeouts}`);
+    return lines.join('\n');
+  }
+}
@@ -2,6 +2,8 @@
 let ws = null;
 let reconnectInterval = null;
 let heartbeatInterval = null;
+// Device selected on the MQTT bridge; stays null on the on-device dashboard
+let selectedDevice = null;
 
 // Load saved control states from localStorage
 function loadControlStates() {
@@ -111,6 +113,24 @@ function connectWebSocket() {
 
 // Handle incoming messages from server
 function handleServerMessage(payload) {
+  if (payload.devices) {
+    updateDeviceList(payload.devices);
+  }
+  if (payload.type === 'init' && payload.device !== undefined) {
+    selectedDevice = payload.device;
+    const select = document.getElementById("device-select");
+    if (select && selectedDevice) select.value = selectedDevice;
+  }
+  if (payload.type === 'devices' && !selectedDevice) {
+    // First device appeared after this page connected
+    const first = payload.devices.find((meta) => meta.online) ||
+      payload.devices[0];
+    if (first) selectDevice(first.id);
+  }
+  if (payload.device !== undefined && payload.type === 'update' &&
+      payload.device !== selectedDevice) {
+    return;
+  }
   if (payload.type === 'init' || payload.type === 'update') {
     // Update all data (sensor + control states)
     if (payload.data) {
@@ -180,6 +200,31 @@ function updateControlStates(data) {
 
 
 
+// Fill the device picker from the bridge's device list
+function updateDeviceList(devices) {
+  const picker = document.getElementById("device-picker");
+  const select = document.getElementById("device-select");
+  if (!picker || !select) return;
+
+  select.innerHTML = "";
+  devices.forEach((meta) => {
+    const option = document.createElement("option");
+    option.value = meta.id;
+    option.textContent = meta.id + (meta.online === false ? " (offline)" : "");
+    select.appendChild(option);
+  });
+  if (selectedDevice) select.value = selectedDevice;
+  picker.hidden = devices.length === 0;
+}
+
+// Switch the page to another device
+function selectDevice(device) {
+  selectedDevice = device;
+  if (ws && ws.readyState === WebSocket.OPEN) {
+    ws.send(JSON.stringify({ action: "select", device: device }));
+  }
+}
+
 // Send control command via WebSocket
 function sendControlCommand(control, state) {
   const payload = {
@@ -220,6 +265,13 @@ window.addEventListener("DOMContentLoaded", function () {
   // Load saved control states
   loadControlStates();
 
+  const deviceSelect = document.getElementById("device-select");
+  if (deviceSelect) {
+    deviceSelect.addEventListener("change", function () {
+      selectDevice(this.value);
+    });
+  }
+
   // Control switches event listeners
   document.querySelectorAll(".switch input").forEach((toggle) => {
     toggle.addEventListener("change", function () {
@@ -0,0 +1,153 @@
+// Replays control commands against an MQTT broker and prints the per-hop
+// latency distribution reported by the device.
+//
+//   bun run replay.js [--broker mqtt://localhost:1883] [--count 200]
+//                     [--interval 250] [--device led|pump|both]
+//                     [--node <id>] [--spawn "<command>"] [--csv out.csv]
+//
+// Without --node the first device announcing itself online on
+// aquarium/+/meta is used.
+//
+// --spawn starts the device under test (e.g. the firmware simulator) before
+// the replay and stops it afterwards, so the whole run needs only a local
+// broker such as `mosquitto -p 1883`.
+
+import mqtt from 'mqtt';
+import { spawn } from 'child_process';
+import { writeFileSync } from 'fs';
+import { HOPS, LatencyTracker, now } from './latency.js';
+
+const TOPIC_META = 'aquarium/+/meta';
+const REPLY_TIMEOUT_MS = 5000;
+const DISCOVER_TIMEOUT_MS = 10000;
+const SPAWN_SETTLE_MS = 2000;
+
+function parseArgs(argv) {
+  const options = {
+    broker: process.env.MQTT_BROKER || 'mqtt://localhost:1883',
+    count: 200,
+    interval: 250,
+    device: 'both',
+    node: null,
+    spawn: null,
+    csv: null,
+  };
+  for (let i = 0; i < argv.length; i++) {
+    const key = argv[i].replace(/^--/, '');
+    if (!(key in options)) {
+      console.error(`Unknown option: ${argv[i]}`);
+      process.exit(2);
+    }
+    const value = argv[++i];
+    options[key] = typeof options[key] === 'number' ? Number(value) : value;
+  }
+  return options;
+}
+
+const sleep = (ms) => new Promise((resolve) => setTimeout(resolve, ms));
+
+// First device whose retained meta says online
+function discoverNode(client) {
+  return new Promise((resolve, reject) => {
+    const timer = setTimeout(() => {
+      client.removeListener('message', onMeta);
+      reject(new Error('no device online on ' + TOPIC_META));
+    }, DISCOVER_TIMEOUT_MS);
+    function onMeta(topic, message) {
+      let meta;
+      try {
+        meta = JSON.parse(message.toString());
+      } catch {
+        return;
+      }
+      if (meta.type !== 'meta' || !meta.online) return;
+      clearTimeout(timer);
+      client.removeListener('message', onMeta);
+      client.unsubscribe(TOPIC_META);
+      resolve(topic.split('/')[1]);
+    }
+    client.on('message', onMeta);
+    client.subscribe(TOPIC_META);
+  });
+}
+
+async function main() {
+  const options = parseArgs(process.argv.slice(2));
+
+  let device = null;
+  if (options.spawn) {
+    console.log(`[REPLAY] Starting device: ${options.spawn}`);
+    device = spawn(options.spawn, { shell: true, stdio: 'inherit' });
+    await sleep(SPAWN_SETTLE_MS);
+  }
+
+  const client = mqtt.connect(options.broker, { reconnectPeriod: 0 });
+  await new Promise((resolve, reject) => {
+    client.once('connect', resolve);
+    client.once('error', reject);
+  });
+
+  const node = options.node || await discoverNode(client);
+  const topicCommand = `aquarium/${node}/command`;
+  client.subscribe(`aquarium/${node}/control`);
+
+  const tracker = new LatencyTracker(options.count);
+  const rows = [];
+  const waiters = new Map();
+
+  client.on('message', (topic, message) => {
+    const completedAt = now();
+    let status;
+    try {
+      status = JSON.parse(message.toString());
+    } catch {
+      return;
+    }
+    if (status.type !== 'control_status' || !status.id) return;
+
+    const hops = tracker.complete(status, completedAt);
+    const resolve = waiters.get(status.id);
+    if (hops && resolve) {
+      rows.push({ id: status.id, ...hops });
+      resolve();
+    }
+  });
+
+  console.log(`[REPLAY] ${options.count} commands to ${node} via ` +
+              options.broker);
+  for (let i = 0; i < options.count; i++) {
+    const target = options.device === 'both'
+      ? (i % 2 === 0 ? 'led' : 'pump')
+      : options.device;
+    const state = Math.floor(i / 2) % 2 === 0 ? 'on' : 'off';
+
+    const id = tracker.begin();
+    const reply = new Promise((resolve) => waiters.set(id, resolve));
+    client.publish(topicCommand,
+                   JSON.stringify({ type: 'control', device: target, state, id }));
+    tracker.published(id);
+
+    await Promise.race([reply, sleep(REPLY_TIMEOUT_MS)]);
+    waiters.delete(id);
+    await sleep(options.interval);
+  }
+
+  console.log(tracker.format());
+  console.log(`lost ${options.count - rows.length} of ${options.count}`);
+
+  if (options.csv) {
+    const header = ['id', ...HOPS].join(',');
+    const lines = rows.map((row) =>
+      [row.id, ...HOPS.map((hop) => row[hop].toFixed(3))].join(','));
+    writeFileSync(options.csv, [header, ...lines].join('\n') + '\n');
+    console.log(`[REPLAY] Samples written to ${options.csv}`);
+  }
+
+  client.end();
+  if (device) device.kill();
+}
+
+main().catch((error) => {
+  console.error('[REPLAY] Error:', error.message);
+  process.exit(1);
+});
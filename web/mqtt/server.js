@@ -4,6 +4,7 @@ import { WebSocketServer } from 'ws';
 import { fileURLToPath } from 'url';
 import { dirname } from 'path';
 import dotenv from 'dotenv';
+import { LatencyTracker, now } from './latency.js';
 
 dotenv.config();
 
@@ -14,9 +15,25 @@ const MQTT_BROKER = process.env.MQTT_BROKER || 'mqtt://broker.hivemq.com:1883';
 const MQTT_USER = process.env.MQTT_USER || '';
 const MQTT_PASSWORD = process.env.MQTT_PASSWORD || '';
 
-const TOPIC_COMMAND = 'aquarium/command';
-const TOPIC_SENSOR = 'aquarium/sensor';
-const TOPIC_CONTROL = 'aquarium/control';
+// Every device publishes under aquarium/<id>/...; the bridge follows all of
+// them with wildcards and learns the fleet from retained meta (birth/will)
+const TOPIC_ROOT = 'aquarium';
+const TOPIC_SUBSCRIBE = ['sensor', 'control', 'meta']
+  .map((leaf) => `${TOPIC_ROOT}/+/${leaf}`);
+
+// aquarium/<id>/<leaf> -> { device, leaf }, null for anything else
+function parseTopic(topic) {
+  const parts = topic.split('/');
+  if (parts.length < 3 || parts[0] !== TOPIC_ROOT || !parts[1]) return null;
+  return { device: parts[1], leaf: parts.slice(2).join('/') };
+}
+
+function deviceTopic(device, leaf) {
+  return `${TOPIC_ROOT}/${device}/${leaf}`;
+}
+
+const LATENCY_LOG_INTERVAL = 60000;
+const latency = new LatencyTracker();
 
 const mqttClient = mqtt.connect(MQTT_BROKER, {
   username: MQTT_USER,
@@ -24,39 +41,107 @@ const mqttClient = mqtt.connect(MQTT_BROKER, {
   reconnectPeriod: 2000,
 });
 
-let latestSensorData = {
-  temp: null,
-  level: null,
-  led: null,
-  pump: null,
-  timestamp: null,
-};
+/** @type {Map<string, {meta: object, state: object}>} */
+const devices = new Map();
+
+// Same frame shape as the on-device dashboard (LanDashboard): tank 1 in the
+// flat fields for the existing UI, every tank in `tanks`
+function deviceEntry(id) {
+  let entry = devices.get(id);
+  if (!entry) {
+    entry = {
+      meta: { id, online: null },
+      state: {
+        temp: null,
+        level: null,
+        led: null,
+        pump: null,
+        timestamp: null,
+        tanks: [],
+      },
+    };
+    devices.set(id, entry);
+  }
+  return entry;
+}
+
+// Merge per-tank fields from a device payload into its latest state
+function mergeTanks(state, tanks) {
+  (tanks || []).forEach((tank, i) => {
+    state.tanks[i] = { ...state.tanks[i], ...tank };
+  });
+  const first = state.tanks[0] || {};
+  for (const key of ['temp', 'level', 'led', 'pump']) {
+    if (first[key] !== undefined) state[key] = first[key];
+  }
+}
+
+function deviceList() {
+  return [...devices.values()].map((entry) => entry.meta);
+}
 
 mqttClient.on('connect', () => {
   console.log('[MQTT] Connected');
-  mqttClient.subscribe([TOPIC_SENSOR, TOPIC_CONTROL]);
+  mqttClient.subscribe(TOPIC_SUBSCRIBE);
 });
 
 mqttClient.on('message', (topic, message) => {
+  const parsed = parseTopic(topic);
+  if (!parsed) return;
+  const { device, leaf } = parsed;
+
+  // Retained meta cleared by an empty payload: device removed from the fleet
+  if (leaf === 'meta' && message.length === 0) {
+    if (devices.delete(device)) {
+      broadcastToClients({ type: 'devices', devices: deviceList() });
+    }
+    return;
+  }
+
   try {
     const payload = JSON.parse(message.toString());
-    console.log('[MQTT] <', message.toString());
-
-    if (topic === TOPIC_SENSOR && payload.type === 'sensor') {
-      // Update sensor data and control states together
-      latestSensorData = {
-        temp: payload.temp,
-        level: payload.level,
-        led: payload.led,
-        pump: payload.pump,
-        timestamp: payload.timestamp,
-      };
-      
-      // Broadcast to all connected WebSocket clients
-      broadcastToClients({
+    console.log(`[MQTT] < ${device}`, message.toString());
+    const known = devices.has(device);
+    const entry = deviceEntry(device);
+    if (!known && leaf !== 'meta') {
+      broadcastToClients({ type: 'devices', devices: deviceList() });
+    }
+
+    if (leaf === 'meta' && payload.type === 'meta') {
+      entry.meta = { ...entry.meta, ...payload, id: device };
+      broadcastToClients({ type: 'devices', devices: deviceList() });
+    } else if (leaf === 'sensor' && payload.type === 'sensor') {
+      mergeTanks(entry.state, payload.tanks);
+      entry.state.timestamp = payload.timestamp;
+
+      // Only clients watching this device
+      sendToDevice(device, {
+        type: 'update',
+        device,
+        data: entry.state,
+      });
+    } else if (leaf === 'control' && payload.type === 'control_status') {
+      mergeTanks(entry.state, payload.tanks);
+      sendToDevice(device, {
         type: 'update',
-        data: latestSensorData,
+        device,
+        data: {
+          led: entry.state.led,
+          pump: entry.state.pump,
+          tanks: payload.tanks,
+        },
+        id: payload.id,
       });
+
+      // Correlated reply to a command sent by this bridge
+      if (payload.id) {
+        const hops = latency.complete(payload);
+        if (hops) {
+          console.log(`[LAT] #${payload.id} total ${hops.total.toFixed(1)} ms` +
+                      ` (device ${hops.device_pub.toFixed(1)} ms,` +
+                      ` network ${hops.network.toFixed(1)} ms)`);
+        }
+      }
     }
   } catch (error) {
     console.error('Error parsing MQTT message:', error);
@@ -71,22 +156,68 @@ mqttClient.on('close', () => {
   console.log('[MQTT] Disconnected');
 });
 
-/** @type {Set<WebSocket>} */
-const wsConnections = new Set();
+/**
+ * Selected device per client; null until a device is known
+ * @type {Map<WebSocket, string|null>}
+ */
+const wsConnections = new Map();
 
 // Broadcast to all WebSocket clients
 function broadcastToClients(message) {
   const data = JSON.stringify(message);
-  wsConnections.forEach((client) => {
+  wsConnections.forEach((device, client) => {
     if (client.readyState === 1) { // WebSocket.OPEN
       client.send(data);
     }
   });
 }
 
+// Send to the clients that selected `device`
+function sendToDevice(device, message) {
+  const data = JSON.stringify(message);
+  wsConnections.forEach((selected, client) => {
+    if (selected === device && client.readyState === 1) {
+      client.send(data);
+    }
+  });
+}
+
+// First online device, else the first one seen
+function defaultDevice() {
+  const list = deviceList();
+  const online = list.find((meta) => meta.online);
+  return (online || list[0] || {}).id || null;
+}
+
+// Current state of one device for a (re)selecting client
+function sendInit(ws, device) {
+  ws.send(JSON.stringify({
+    type: 'init',
+    device,
+    devices: deviceList(),
+    data: device ? deviceEntry(device).state : null,
+  }));
+}
+
 // Serve static files
 app.use(express.static('public'));
 
+// Known devices and their last meta (online, tank count, IP)
+app.get('/devices', (req, res) => {
+  res.json(deviceList());
+});
+
+// Per-hop latency percentiles of control commands
+app.get('/latency', (req, res) => {
+  res.json(latency.summary());
+});
+
+setInterval(() => {
+  if (latency.summary().hops.total.n > 0) {
+    console.log('[LAT]\n' + latency.format());
+  }
+}, LATENCY_LOG_INTERVAL);
+
 const server = app.listen(PORT, () => {
   console.log(`Web server running on http://localhost:${PORT}`);
   console.log(`MQTT broker: ${MQTT_BROKER}`);
@@ -97,19 +228,18 @@ const wss = new WebSocketServer({ server, path: '/aqua' });
 
 wss.on('connection', (ws) => {
   console.log('[WS] Client connected');
-  wsConnections.add(ws);
+  const device = defaultDevice();
+  wsConnections.set(ws, device);
 
   // Send current state to new client
-  ws.send(JSON.stringify({
-    type: 'init',
-    data: latestSensorData,
-  }));
+  sendInit(ws, device);
 
   // Handle incoming messages
   ws.on('message', (data) => {
+    const receivedAt = now();
     try {
       const payload = JSON.parse(data.toString());
-      handleClientMessage(payload);
+      handleClientMessage(ws, payload, receivedAt);
     } catch (error) {
       console.error('Error handling WebSocket message:', error);
     }
@@ -127,17 +257,36 @@ wss.on('connection', (ws) => {
 });
 
 // Handle messages from web clients
-function handleClientMessage(payload) {
+function handleClientMessage(ws, payload, receivedAt) {
+  if (payload.action === 'select') {
+    if (typeof payload.device !== 'string' || !devices.has(payload.device)) {
+      return;
+    }
+    wsConnections.set(ws, payload.device);
+    sendInit(ws, payload.device);
+    return;
+  }
+
+  // Commands go to the selected device only
+  let target = wsConnections.get(ws);
+  if (!target) {
+    target = defaultDevice();
+    if (!target) return;
+    wsConnections.set(ws, target);
+  }
+  const topic = deviceTopic(target, 'command');
+
   if (payload.action === 'heartbeat') {
     // Send heartbeat to ESP32 via MQTT
     const msg = JSON.stringify({ type: 'heartbeat' });
-    mqttClient.publish(TOPIC_COMMAND, msg);
+    mqttClient.publish(topic, msg);
   } else if (payload.action === 'control') {
     // Send control command to ESP32 via MQTT
     const command = {
       type: 'control',
       device: payload.control, // 'lamp' or 'pump'
       state: payload.state ? 'on' : 'off',
+      id: latency.begin(receivedAt), // echoed back in control_status
     };
     
     // Map 'lamp' to 'led' for ESP32
@@ -146,9 +295,8 @@ function handleClientMessage(payload) {
     }
     
     const msg = JSON.stringify(command);
-    mqttClient.publish(TOPIC_COMMAND, msg);
-    console.log('[MQTT] >', msg);
+    mqttClient.publish(topic, msg);
+    latency.published(command.id);
+    console.log(`[MQTT] > ${target}`, msg);
   }
 }
-
-